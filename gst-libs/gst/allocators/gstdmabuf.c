@@ -23,6 +23,7 @@
 #endif
 
 #include "gstfdmemory.h"
+#include "gstfdmemory-private.h"
 #include "gstdmabuf.h"
 
 /**
@@ -31,6 +32,13 @@
  * @short_description: Memory wrapper for Linux dmabuf memory
  * @see_also: #GstMemory
  *
+ * The CPU access synchronization of nested maps of the same dmabuf, including
+ * maps of memory shared from it, is coalesced: the access is started when the
+ * first map needs it and ended when the last map is released. An element
+ * that maps the same memory several times in a row can keep the access open
+ * across these maps with gst_dmabuf_memory_begin_cpu_access() and
+ * gst_dmabuf_memory_end_cpu_access().
+ *
  * Since: 1.2
  */
 
@@ -49,54 +57,106 @@ GST_DEBUG_CATEGORY_STATIC (dmabuf_debug);
 G_DEFINE_TYPE_WITH_CODE (GstDmaBufAllocator, gst_dmabuf_allocator,
     GST_TYPE_FD_ALLOCATOR, _do_init);
 
-static gpointer
-gst_dmabuf_mem_map (GstMemory * gmem, GstMapInfo * info, gsize maxsize)
+/* Opens or widens the CPU access window of @gmem for @flags. The window is
+ * tracked on the memory owning the fd, so that shared memory coalesces with
+ * its parent. */
+static void
+gst_dmabuf_mem_begin_sync (GstMemory * gmem, GstMapFlags flags)
 {
   GstAllocator *allocator = gmem->allocator;
-  gpointer ret;
+  GstFdMemory *mem;
+  gint access = flags & GST_MAP_READWRITE;
+
+  mem = (GstFdMemory *) (gmem->parent ? gmem->parent : gmem);
 
+  g_mutex_lock (&mem->lock);
+  if (mem->sync_count == 0 || (mem->sync_flags & access) != access) {
 #ifdef HAVE_LINUX_DMA_BUF_H
-  struct dma_buf_sync sync = { DMA_BUF_SYNC_START };
+    struct dma_buf_sync sync = { DMA_BUF_SYNC_START };
 
-  if (info->flags & GST_MAP_READ)
-    sync.flags |= DMA_BUF_SYNC_READ;
+    access |= mem->sync_flags;
 
-  if (info->flags & GST_MAP_WRITE)
-    sync.flags |= DMA_BUF_SYNC_WRITE;
-#endif
+    if (access & GST_MAP_READ)
+      sync.flags |= DMA_BUF_SYNC_READ;
 
-  ret = allocator->mem_map (gmem, maxsize, info->flags);
+    if (access & GST_MAP_WRITE)
+      sync.flags |= DMA_BUF_SYNC_WRITE;
 
-#ifdef HAVE_LINUX_DMA_BUF_H
-  if (ret) {
-    if (ioctl (gst_fd_memory_get_fd (gmem), DMA_BUF_IOCTL_SYNC, &sync) < 0)
+    if (ioctl (mem->fd, DMA_BUF_IOCTL_SYNC, &sync) < 0)
       GST_WARNING_OBJECT (allocator, "Failed to synchronize DMABuf: %s (%i)",
           g_strerror (errno), errno);
-  }
+#else
+    access |= mem->sync_flags;
 #endif
-
-  return ret;
+    gst_fd_allocator_count (allocator, GST_FD_ALLOCATOR_STAT_SYNC);
+    mem->sync_flags = access;
+  } else {
+    gst_fd_allocator_count (allocator, GST_FD_ALLOCATOR_STAT_SYNC_SKIPPED);
+  }
+  mem->sync_count++;
+  g_mutex_unlock (&mem->lock);
 }
 
 static void
-gst_dmabuf_mem_unmap (GstMemory * gmem, GstMapInfo * info)
+gst_dmabuf_mem_end_sync (GstMemory * gmem)
 {
   GstAllocator *allocator = gmem->allocator;
+  GstFdMemory *mem;
+
+  mem = (GstFdMemory *) (gmem->parent ? gmem->parent : gmem);
+
+  g_mutex_lock (&mem->lock);
+  if (mem->sync_count == 0) {
+    g_mutex_unlock (&mem->lock);
+    g_warning (G_STRLOC ":%s: No CPU access to end on memory %p", G_STRFUNC,
+        gmem);
+    return;
+  }
+
+  if (--mem->sync_count == 0) {
 #ifdef HAVE_LINUX_DMA_BUF_H
-  struct dma_buf_sync sync = { DMA_BUF_SYNC_END };
+    struct dma_buf_sync sync = { DMA_BUF_SYNC_END };
 
-  if (info->flags & GST_MAP_READ)
-    sync.flags |= DMA_BUF_SYNC_READ;
+    if (mem->sync_flags & GST_MAP_READ)
+      sync.flags |= DMA_BUF_SYNC_READ;
 
-  if (info->flags & GST_MAP_WRITE)
-    sync.flags |= DMA_BUF_SYNC_WRITE;
+    if (mem->sync_flags & GST_MAP_WRITE)
+      sync.flags |= DMA_BUF_SYNC_WRITE;
 
-  if (ioctl (gst_fd_memory_get_fd (gmem), DMA_BUF_IOCTL_SYNC, &sync) < 0)
-    GST_WARNING_OBJECT (allocator, "Failed to synchronize DMABuf: %s (%i)",
-        g_strerror (errno), errno);
+    if (ioctl (mem->fd, DMA_BUF_IOCTL_SYNC, &sync) < 0)
+      GST_WARNING_OBJECT (allocator, "Failed to synchronize DMABuf: %s (%i)",
+          g_strerror (errno), errno);
 #else
-  GST_WARNING_OBJECT (allocator, "Using DMABuf without synchronization.");
+    GST_WARNING_OBJECT (allocator, "Using DMABuf without synchronization.");
 #endif
+    gst_fd_allocator_count (allocator, GST_FD_ALLOCATOR_STAT_SYNC);
+    mem->sync_flags = 0;
+  } else {
+    gst_fd_allocator_count (allocator, GST_FD_ALLOCATOR_STAT_SYNC_SKIPPED);
+  }
+  g_mutex_unlock (&mem->lock);
+}
+
+static gpointer
+gst_dmabuf_mem_map (GstMemory * gmem, GstMapInfo * info, gsize maxsize)
+{
+  GstAllocator *allocator = gmem->allocator;
+  gpointer ret;
+
+  ret = allocator->mem_map (gmem, maxsize, info->flags);
+
+  if (ret)
+    gst_dmabuf_mem_begin_sync (gmem, info->flags);
+
+  return ret;
+}
+
+static void
+gst_dmabuf_mem_unmap (GstMemory * gmem, GstMapInfo * info)
+{
+  GstAllocator *allocator = gmem->allocator;
+
+  gst_dmabuf_mem_end_sync (gmem);
 
   allocator->mem_unmap (gmem);
 }
@@ -206,6 +266,45 @@ gst_dmabuf_memory_get_fd (GstMemory * mem)
   return gst_fd_memory_get_fd (mem);
 }
 
+/**
+ * gst_dmabuf_memory_begin_cpu_access:
+ * @mem: dmabuf #GstMemory
+ * @flags: the access to prepare, %GST_MAP_READ and/or %GST_MAP_WRITE
+ *
+ * Start CPU access to @mem and keep it open until
+ * gst_dmabuf_memory_end_cpu_access() is called. Maps of @mem, or of memory
+ * shared from it, with at most @flags access don't synchronize the dmabuf
+ * again in the meantime.
+ *
+ * The device must not access @mem until the CPU access is ended.
+ *
+ * Since: 1.20
+ */
+void
+gst_dmabuf_memory_begin_cpu_access (GstMemory * mem, GstMapFlags flags)
+{
+  g_return_if_fail (gst_is_dmabuf_memory (mem));
+
+  gst_dmabuf_mem_begin_sync (mem, flags);
+}
+
+/**
+ * gst_dmabuf_memory_end_cpu_access:
+ * @mem: dmabuf #GstMemory
+ *
+ * End the CPU access started with gst_dmabuf_memory_begin_cpu_access(). The
+ * dmabuf is synchronized for the device once no map of @mem is left either.
+ *
+ * Since: 1.20
+ */
+void
+gst_dmabuf_memory_end_cpu_access (GstMemory * mem)
+{
+  g_return_if_fail (gst_is_dmabuf_memory (mem));
+
+  gst_dmabuf_mem_end_sync (mem);
+}
+
 /**
  * gst_is_dmabuf_memory:
  * @mem: the memory to be check
@@ -113,6 +113,12 @@ gint           gst_dmabuf_memory_get_fd (GstMemory * mem);
 GST_ALLOCATORS_API
 gboolean       gst_is_dmabuf_memory (GstMemory * mem);
 
+GST_ALLOCATORS_API
+void           gst_dmabuf_memory_begin_cpu_access (GstMemory * mem, GstMapFlags flags);
+
+GST_ALLOCATORS_API
+void           gst_dmabuf_memory_end_cpu_access (GstMemory * mem);
+
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstDmaBufAllocator, gst_object_unref)
 
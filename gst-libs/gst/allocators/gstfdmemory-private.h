@@ -0,0 +1,64 @@
+/* GStreamer fd backed memory
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_FD_MEMORY_PRIVATE_H__
+#define __GST_FD_MEMORY_PRIVATE_H__
+
+#include <gst/gst.h>
+#include "gstfdmemory.h"
+
+G_BEGIN_DECLS
+
+typedef struct
+{
+  GstMemory mem;
+
+  GstFdMemoryFlags flags;
+  gint fd;
+  gpointer data;
+  gint mmapping_flags;
+  gint mmap_count;
+  GMutex lock;
+
+  /* open CPU access window of dmabuf memory, protected by lock */
+  gint sync_count;
+  gint sync_flags;
+
+  /* ATOMIC, set on the parent memory once gst_fd_memory_get_fd() handed
+   * out the fd */
+  gint fd_exported;
+} GstFdMemory;
+
+typedef enum
+{
+  GST_FD_ALLOCATOR_STAT_MAP,
+  GST_FD_ALLOCATOR_STAT_UNMAP,
+  GST_FD_ALLOCATOR_STAT_MMAP,
+  GST_FD_ALLOCATOR_STAT_MUNMAP,
+  GST_FD_ALLOCATOR_STAT_MPROTECT,
+  GST_FD_ALLOCATOR_STAT_SYNC,
+  GST_FD_ALLOCATOR_STAT_SYNC_SKIPPED,
+  GST_FD_ALLOCATOR_STAT_LAST
+} GstFdAllocatorStat;
+
+G_GNUC_INTERNAL
+void gst_fd_allocator_count (GstAllocator * allocator, GstFdAllocatorStat stat);
+
+G_END_DECLS
+
+#endif /* __GST_FD_MEMORY_PRIVATE_H__ */
@@ -24,6 +24,13 @@
  * @short_description: Memory wrapper for fd backed memory
  * @see_also: #GstMemory
  *
+ * Memory allocated with %GST_FD_MEMORY_FLAG_CACHE_MAPPING is mapped once
+ * with all the access its fd allows and stays mapped until it is freed, so
+ * elements that map the same memory one after the other don't cause any
+ * mmap(), munmap() or mprotect() calls. The number of map requests and
+ * syscalls of an allocator can be retrieved with
+ * gst_fd_allocator_get_stats().
+ *
  * Since: 1.4
  */
 
@@ -32,8 +39,10 @@
 #endif
 
 #include "gstfdmemory.h"
+#include "gstfdmemory-private.h"
 
 #ifdef HAVE_MMAP
+#include <fcntl.h>
 #include <sys/mman.h>
 #include <unistd.h>
 #endif
@@ -41,17 +50,27 @@
 GST_DEBUG_CATEGORY_STATIC (gst_fdmemory_debug);
 #define GST_CAT_DEFAULT gst_fdmemory_debug
 
+#define KEEPS_MAPPING(mem) \
+    ((mem)->flags & (GST_FD_MEMORY_FLAG_KEEP_MAPPED | \
+        GST_FD_MEMORY_FLAG_CACHE_MAPPING))
+
 typedef struct
 {
-  GstMemory mem;
+  gsize stats[GST_FD_ALLOCATOR_STAT_LAST];
+} GstFdAllocatorPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (GstFdAllocator, gst_fd_allocator,
+    GST_TYPE_ALLOCATOR);
+
+void
+gst_fd_allocator_count (GstAllocator * allocator, GstFdAllocatorStat stat)
+{
+  GstFdAllocatorPrivate *priv =
+      gst_fd_allocator_get_instance_private (GST_FD_ALLOCATOR_CAST
+      (allocator));
 
-  GstFdMemoryFlags flags;
-  gint fd;
-  gpointer data;
-  gint mmapping_flags;
-  gint mmap_count;
-  GMutex lock;
-} GstFdMemory;
+  g_atomic_pointer_add (&priv->stats[stat], 1);
+}
 
 static void
 gst_fd_mem_free (GstAllocator * allocator, GstMemory * gmem)
@@ -60,11 +79,12 @@ gst_fd_mem_free (GstAllocator * allocator, GstMemory * gmem)
   GstFdMemory *mem = (GstFdMemory *) gmem;
 
   if (mem->data) {
-    if (!(mem->flags & GST_FD_MEMORY_FLAG_KEEP_MAPPED))
+    if (!KEEPS_MAPPING (mem))
       g_warning (G_STRLOC ":%s: Freeing memory %p still mapped", G_STRFUNC,
           mem);
 
     munmap ((void *) mem->data, gmem->maxsize);
+    gst_fd_allocator_count (allocator, GST_FD_ALLOCATOR_STAT_MUNMAP);
   }
   if (mem->fd >= 0 && gmem->parent == NULL
       && !(mem->flags & GST_FD_MEMORY_FLAG_DONT_CLOSE))
@@ -75,6 +95,26 @@ gst_fd_mem_free (GstAllocator * allocator, GstMemory * gmem)
 #endif
 }
 
+#ifdef HAVE_MMAP
+/* Returns the protection to map @mem with so that later maps never need to
+ * change it */
+static gint
+gst_fd_mem_cache_prot (GstFdMemory * mem, gint prot)
+{
+  gint fl;
+
+  /* private mappings are always writable */
+  if (mem->flags & GST_FD_MEMORY_FLAG_MAP_PRIVATE)
+    return PROT_READ | PROT_WRITE;
+
+  fl = fcntl (mem->fd, F_GETFL);
+  if (fl >= 0 && (fl & O_ACCMODE) == O_RDWR)
+    return PROT_READ | PROT_WRITE;
+
+  return prot;
+}
+#endif
+
 static gpointer
 gst_fd_mem_map (GstMemory * gmem, gsize maxsize, GstMapFlags flags)
 {
@@ -86,6 +126,8 @@ gst_fd_mem_map (GstMemory * gmem, gsize maxsize, GstMapFlags flags)
   if (gmem->parent)
     return gst_fd_mem_map (gmem->parent, maxsize, flags);
 
+  gst_fd_allocator_count (gmem->allocator, GST_FD_ALLOCATOR_STAT_MAP);
+
   prot = flags & GST_MAP_READ ? PROT_READ : 0;
   prot |= flags & GST_MAP_WRITE ? PROT_WRITE : 0;
 
@@ -97,12 +139,24 @@ gst_fd_mem_map (GstMemory * gmem, gsize maxsize, GstMapFlags flags)
     if ((mem->mmapping_flags & prot) == prot) {
       ret = mem->data;
       mem->mmap_count++;
+    } else if (mem->flags & GST_FD_MEMORY_FLAG_CACHE_MAPPING) {
+      /* only ever add access, the other users of the mapping (shared
+       * sub-memories) keep the access they mapped with */
+      prot |= mem->mmapping_flags;
+      gst_fd_allocator_count (gmem->allocator, GST_FD_ALLOCATOR_STAT_MPROTECT);
+      if (mprotect (mem->data, gmem->maxsize, prot) == 0) {
+        ret = mem->data;
+        mem->mmapping_flags = prot;
+        mem->mmap_count++;
+      }
     } else if ((mem->flags & GST_FD_MEMORY_FLAG_KEEP_MAPPED)
-        && mem->mmap_count == 0
-        && mprotect (mem->data, gmem->maxsize, prot) == 0) {
-      ret = mem->data;
-      mem->mmapping_flags = prot;
-      mem->mmap_count++;
+        && mem->mmap_count == 0) {
+      gst_fd_allocator_count (gmem->allocator, GST_FD_ALLOCATOR_STAT_MPROTECT);
+      if (mprotect (mem->data, gmem->maxsize, prot) == 0) {
+        ret = mem->data;
+        mem->mmapping_flags = prot;
+        mem->mmap_count++;
+      }
     }
 
     goto out;
@@ -115,7 +169,22 @@ gst_fd_mem_map (GstMemory * gmem, gsize maxsize, GstMapFlags flags)
         (mem->flags & GST_FD_MEMORY_FLAG_MAP_PRIVATE) ? MAP_PRIVATE :
         MAP_SHARED;
 
+    if (mem->flags & GST_FD_MEMORY_FLAG_CACHE_MAPPING) {
+      gint cache_prot = gst_fd_mem_cache_prot (mem, prot);
+
+      /* the fd can still refuse writable mappings, e.g. when it's sealed */
+      if (cache_prot != prot) {
+        mem->data = mmap (0, gmem->maxsize, cache_prot, flags, mem->fd, 0);
+        gst_fd_allocator_count (gmem->allocator, GST_FD_ALLOCATOR_STAT_MMAP);
+        if (mem->data != MAP_FAILED) {
+          prot = cache_prot;
+          goto mapped;
+        }
+      }
+    }
+
     mem->data = mmap (0, gmem->maxsize, prot, flags, mem->fd, 0);
+    gst_fd_allocator_count (gmem->allocator, GST_FD_ALLOCATOR_STAT_MMAP);
     if (mem->data == MAP_FAILED) {
       GstDebugLevel level;
       mem->data = NULL;
@@ -135,6 +204,7 @@ gst_fd_mem_map (GstMemory * gmem, gsize maxsize, GstMapFlags flags)
     }
   }
 
+mapped:
   GST_DEBUG ("%p: fd %d: mapped %p", mem, mem->fd, mem->data);
 
   if (mem->data) {
@@ -160,7 +230,9 @@ gst_fd_mem_unmap (GstMemory * gmem)
   if (gmem->parent)
     return gst_fd_mem_unmap (gmem->parent);
 
-  if (mem->flags & GST_FD_MEMORY_FLAG_KEEP_MAPPED) {
+  gst_fd_allocator_count (gmem->allocator, GST_FD_ALLOCATOR_STAT_UNMAP);
+
+  if (KEEPS_MAPPING (mem)) {
     g_mutex_lock (&mem->lock);
     mem->mmap_count--;
     g_mutex_unlock (&mem->lock);
@@ -170,6 +242,7 @@ gst_fd_mem_unmap (GstMemory * gmem)
   g_mutex_lock (&mem->lock);
   if (mem->data && !(--mem->mmap_count)) {
     munmap ((void *) mem->data, gmem->maxsize);
+    gst_fd_allocator_count (gmem->allocator, GST_FD_ALLOCATOR_STAT_MUNMAP);
     mem->data = NULL;
     mem->mmapping_flags = 0;
     GST_DEBUG ("%p: fd %d unmapped", mem, mem->fd);
@@ -211,8 +284,6 @@ gst_fd_mem_share (GstMemory * gmem, gssize offset, gssize size)
 #endif
 }
 
-G_DEFINE_TYPE (GstFdAllocator, gst_fd_allocator, GST_TYPE_ALLOCATOR);
-
 static void
 gst_fd_allocator_class_init (GstFdAllocatorClass * klass)
 {
@@ -338,8 +409,60 @@ gst_is_fd_memory (GstMemory * mem)
 gint
 gst_fd_memory_get_fd (GstMemory * mem)
 {
+  GstFdMemory *parent;
+
   g_return_val_if_fail (mem != NULL, -1);
   g_return_val_if_fail (GST_IS_FD_ALLOCATOR (mem->allocator), -1);
 
+  /* the fd may now be used outside of the memory, allocators that reuse
+   * their fds must not do that anymore */
+  parent = (GstFdMemory *) (mem->parent ? mem->parent : mem);
+  g_atomic_int_set (&parent->fd_exported, 1);
+
   return ((GstFdMemory *) mem)->fd;
 }
+
+/**
+ * gst_fd_allocator_get_stats:
+ * @allocator: a #GstFdAllocator
+ *
+ * Get the statistics of the memory of @allocator. The returned structure
+ * contains the following #guint64 fields:
+ *
+ *  - "maps": the number of map requests
+ *  - "unmaps": the number of unmap requests
+ *  - "mmaps": the number of mmap() calls
+ *  - "munmaps": the number of munmap() calls
+ *  - "mprotects": the number of mprotect() calls
+ *  - "syncs": the number of dmabuf synchronization ioctls
+ *  - "skipped-syncs": the number of dmabuf synchronizations that were
+ *    coalesced with an already open CPU access
+ *
+ * Returns: (transfer full): a #GstStructure with the statistics.
+ *
+ * Since: 1.20
+ */
+GstStructure *
+gst_fd_allocator_get_stats (GstAllocator * allocator)
+{
+  static const gchar *names[] = { "maps", "unmaps", "mmaps", "munmaps",
+    "mprotects", "syncs", "skipped-syncs"
+  };
+  GstFdAllocatorPrivate *priv;
+  GstStructure *s;
+  guint i;
+
+  G_STATIC_ASSERT (G_N_ELEMENTS (names) == GST_FD_ALLOCATOR_STAT_LAST);
+
+  g_return_val_if_fail (GST_IS_FD_ALLOCATOR (allocator), NULL);
+
+  priv = gst_fd_allocator_get_instance_private (GST_FD_ALLOCATOR_CAST
+      (allocator));
+
+  s = gst_structure_new_empty ("application/x-gst-fd-allocator-stats");
+  for (i = 0; i < G_N_ELEMENTS (names); i++)
+    gst_structure_set (s, names[i], G_TYPE_UINT64,
+        (guint64) (gsize) g_atomic_pointer_get (&priv->stats[i]), NULL);
+
+  return s;
+}
@@ -48,6 +48,10 @@ typedef struct _GstFdAllocatorClass GstFdAllocatorClass;
  *        the default shared mapping.
  * @GST_FD_MEMORY_FLAG_DONT_CLOSE: don't close the file descriptor when
  *        the memory is freed. Since: 1.10
+ * @GST_FD_MEMORY_FLAG_CACHE_MAPPING: map the memory with all the access the
+ *        fd allows and keep it mapped until the memory is destroyed, so that
+ *        later maps, including maps with more access, don't need any
+ *        syscall. Since: 1.20
  *
  * Various flags to control the operation of the fd backed memory.
  *
@@ -58,6 +62,7 @@ typedef enum {
   GST_FD_MEMORY_FLAG_KEEP_MAPPED = (1 << 0),
   GST_FD_MEMORY_FLAG_MAP_PRIVATE = (1 << 1),
   GST_FD_MEMORY_FLAG_DONT_CLOSE  = (1 << 2),
+  GST_FD_MEMORY_FLAG_CACHE_MAPPING = (1 << 3),
 } GstFdMemoryFlags;
 
 /**
@@ -93,6 +98,9 @@ gboolean        gst_is_fd_memory        (GstMemory *mem);
 GST_ALLOCATORS_API
 gint            gst_fd_memory_get_fd    (GstMemory *mem);
 
+GST_ALLOCATORS_API
+GstStructure *  gst_fd_allocator_get_stats (GstAllocator * allocator);
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstFdAllocator, gst_object_unref)
 
 G_END_DECLS
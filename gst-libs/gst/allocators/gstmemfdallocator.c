@@ -0,0 +1,498 @@
+/* GStreamer memfd backed memory
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:gstmemfdallocator
+ * @title: GstMemfdAllocator
+ * @short_description: Allocator for memfd backed memory
+ * @see_also: #GstMemory, #GstFdAllocator
+ *
+ * #GstMemfdAllocator creates #GstFdMemory backed by anonymous files created
+ * with memfd_create(). The file descriptor of such memory can be passed to
+ * other processes, e.g. over a Unix socket, which can then map the same
+ * pages without any copy.
+ *
+ * The size of the files is sealed, so that consumers can map them without
+ * the risk of getting SIGBUS when the producer truncates the file. After
+ * the producer filled the memory it can additionally seal it against writes
+ * with gst_memfd_memory_seal(), consumers are then only able to map it
+ * read-only.
+ *
+ * Allocation sizes are rounded up to size classes and freed memory is kept
+ * in a pool per size class, so that files of the same class can be reused
+ * without creating, resizing and faulting in new files. Only files that
+ * never left the allocator are reused: memory that was sealed against writes
+ * can't be filled again, and the file of memory whose fd was retrieved with
+ * gst_fd_memory_get_fd() might still be used by another process, so neither
+ * is pooled.
+ *
+ * Since: 1.20
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstmemfdallocator.h"
+#include "gstfdmemory-private.h"
+
+#include <string.h>
+
+#ifdef HAVE_MEMFD_CREATE
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+#ifndef MFD_ALLOW_SEALING
+#define MFD_ALLOW_SEALING 0x0002U
+#endif
+#ifndef MFD_HUGETLB
+#define MFD_HUGETLB 0x0004U
+#endif
+#ifndef F_ADD_SEALS
+#define F_ADD_SEALS 1033
+#define F_GET_SEALS 1034
+#define F_SEAL_SEAL 0x0001
+#define F_SEAL_SHRINK 0x0002
+#define F_SEAL_GROW 0x0004
+#define F_SEAL_WRITE 0x0008
+#endif
+#ifndef F_SEAL_FUTURE_WRITE
+#define F_SEAL_FUTURE_WRITE 0x0010
+#endif
+#endif
+
+GST_DEBUG_CATEGORY_STATIC (memfd_debug);
+#define GST_CAT_DEFAULT memfd_debug
+
+/* huge page size used when it can't be read from /proc/meminfo */
+#define DEFAULT_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+/* sizes up to this many pages are rounded to pages, larger ones to a
+ * quarter of their power of two */
+#define PAGE_SIZE_CLASSES 16
+
+struct _GstMemfdAllocatorPrivate
+{
+  GstMemfdAllocatorFlags flags;
+  /* granularity of the size classes, the huge page size with HUGETLB */
+  gsize page_size;
+
+  GMutex lock;
+  /* size class -> GSList of unused fds */
+  GHashTable *pool;
+  gsize pooled_size;
+  gsize max_pooled_size;
+};
+
+#define _do_init                                        \
+    GST_DEBUG_CATEGORY_INIT (memfd_debug,               \
+    "memfd", 0, "memfd memory");
+
+G_DEFINE_TYPE_WITH_CODE (GstMemfdAllocator, gst_memfd_allocator,
+    GST_TYPE_FD_ALLOCATOR, G_ADD_PRIVATE (GstMemfdAllocator) _do_init);
+
+#ifdef HAVE_MEMFD_CREATE
+static gsize
+gst_memfd_get_huge_page_size (void)
+{
+  static gsize huge_page_size = 0;
+
+  if (g_once_init_enter (&huge_page_size)) {
+    gsize size = DEFAULT_HUGE_PAGE_SIZE;
+    gchar *contents = NULL;
+
+    if (g_file_get_contents ("/proc/meminfo", &contents, NULL, NULL)) {
+      const gchar *line = strstr (contents, "Hugepagesize:");
+      guint64 kb;
+
+      if (line) {
+        kb = g_ascii_strtoull (line + strlen ("Hugepagesize:"), NULL, 10);
+        if (kb > 0)
+          size = kb * 1024;
+      }
+      g_free (contents);
+    }
+
+    g_once_init_leave (&huge_page_size, size);
+  }
+
+  return huge_page_size;
+}
+
+/* Rounds @size up to its size class. Small sizes are rounded to pages,
+ * larger sizes to four classes per power of two so that at most 25% of the
+ * memory is unused */
+static gsize
+gst_memfd_allocator_size_class (GstMemfdAllocatorPrivate * priv, gsize size)
+{
+  gsize step = priv->page_size;
+
+  if (size > priv->page_size * PAGE_SIZE_CLASSES) {
+    step = ((gsize) 1 << (g_bit_storage (size - 1) - 1)) / 4;
+    step = MAX (step, priv->page_size);
+  }
+
+  return (size + step - 1) & ~(step - 1);
+}
+
+static gint
+gst_memfd_allocator_create_fd (GstMemfdAllocator * self, gsize size)
+{
+  GstMemfdAllocatorPrivate *priv = self->priv;
+  guint mfd_flags = MFD_CLOEXEC | MFD_ALLOW_SEALING;
+  gint fd;
+
+  if (priv->flags & GST_MEMFD_ALLOCATOR_FLAG_HUGETLB)
+    mfd_flags |= MFD_HUGETLB;
+
+  fd = memfd_create ("gst-memfd", mfd_flags);
+  if (fd < 0) {
+    GST_ERROR_OBJECT (self, "memfd_create failed: %s", g_strerror (errno));
+    return -1;
+  }
+
+  if (ftruncate (fd, size) < 0) {
+    GST_ERROR_OBJECT (self, "ftruncate to %" G_GSIZE_FORMAT " failed: %s",
+        size, g_strerror (errno));
+    close (fd);
+    return -1;
+  }
+
+  /* the size never changes, so consumers can safely map the whole file */
+  if (fcntl (fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW) < 0)
+    GST_WARNING_OBJECT (self, "failed to seal the size of fd %d: %s", fd,
+        g_strerror (errno));
+
+  GST_DEBUG_OBJECT (self, "created fd %d of size %" G_GSIZE_FORMAT, fd, size);
+
+  return fd;
+}
+
+/* Returns an unused fd of @size from the pool or -1 */
+static gint
+gst_memfd_allocator_acquire_pooled_fd (GstMemfdAllocator * self, gsize size)
+{
+  GstMemfdAllocatorPrivate *priv = self->priv;
+  GSList *fds;
+  gint fd = -1;
+
+  g_mutex_lock (&priv->lock);
+  fds = g_hash_table_lookup (priv->pool, GSIZE_TO_POINTER (size));
+  if (fds) {
+    fd = GPOINTER_TO_INT (fds->data);
+    fds = g_slist_delete_link (fds, fds);
+    if (fds)
+      g_hash_table_insert (priv->pool, GSIZE_TO_POINTER (size), fds);
+    else
+      g_hash_table_remove (priv->pool, GSIZE_TO_POINTER (size));
+    priv->pooled_size -= size;
+  }
+  g_mutex_unlock (&priv->lock);
+
+  if (fd >= 0)
+    GST_LOG_OBJECT (self, "reusing fd %d of size %" G_GSIZE_FORMAT, fd, size);
+
+  return fd;
+}
+#endif
+
+static void
+gst_memfd_allocator_release_fd (GstMemfdAllocator * self, gint fd, gsize size,
+    gboolean exported)
+{
+#ifdef HAVE_MEMFD_CREATE
+  GstMemfdAllocatorPrivate *priv = self->priv;
+  gint seals;
+  GSList *fds;
+
+  /* the fd was handed out, another process might still use the file */
+  if (exported)
+    goto close_fd;
+
+  /* memory sealed against writes can't be filled again */
+  seals = fcntl (fd, F_GET_SEALS);
+  if (seals < 0 || (seals & (F_SEAL_WRITE | F_SEAL_FUTURE_WRITE)))
+    goto close_fd;
+
+  g_mutex_lock (&priv->lock);
+  if (priv->pooled_size + size > priv->max_pooled_size) {
+    g_mutex_unlock (&priv->lock);
+    goto close_fd;
+  }
+  fds = g_hash_table_lookup (priv->pool, GSIZE_TO_POINTER (size));
+  fds = g_slist_prepend (fds, GINT_TO_POINTER (fd));
+  g_hash_table_insert (priv->pool, GSIZE_TO_POINTER (size), fds);
+  priv->pooled_size += size;
+  g_mutex_unlock (&priv->lock);
+
+  GST_LOG_OBJECT (self, "pooled fd %d of size %" G_GSIZE_FORMAT, fd, size);
+  return;
+
+close_fd:
+  GST_LOG_OBJECT (self, "closing fd %d", fd);
+  close (fd);
+#endif
+}
+
+static GstMemory *
+gst_memfd_allocator_alloc (GstAllocator * allocator, gsize size,
+    GstAllocationParams * params)
+{
+#ifdef HAVE_MEMFD_CREATE
+  GstMemfdAllocator *self = GST_MEMFD_ALLOCATOR (allocator);
+  GstMemory *mem;
+  gsize maxsize;
+  gint fd;
+
+  maxsize = gst_memfd_allocator_size_class (self->priv,
+      params->prefix + size + params->padding);
+
+  fd = gst_memfd_allocator_acquire_pooled_fd (self, maxsize);
+  if (fd < 0)
+    fd = gst_memfd_allocator_create_fd (self, maxsize);
+  if (fd < 0)
+    return NULL;
+
+  /* the fd is closed or pooled in gst_memfd_allocator_free() */
+  mem = gst_fd_allocator_alloc (allocator, fd, maxsize,
+      GST_FD_MEMORY_FLAG_CACHE_MAPPING | GST_FD_MEMORY_FLAG_DONT_CLOSE);
+  mem->offset = params->prefix;
+  mem->size = size;
+
+  if ((params->flags & (GST_MEMORY_FLAG_ZERO_PREFIXED |
+              GST_MEMORY_FLAG_ZERO_PADDED))
+      && (params->prefix || maxsize > params->prefix + size)) {
+    GstMapInfo info;
+
+    if (gst_memory_map (mem, &info, GST_MAP_WRITE)) {
+      if (params->flags & GST_MEMORY_FLAG_ZERO_PREFIXED)
+        memset (info.data - params->prefix, 0, params->prefix);
+      if (params->flags & GST_MEMORY_FLAG_ZERO_PADDED)
+        memset (info.data + size, 0, maxsize - params->prefix - size);
+      gst_memory_unmap (mem, &info);
+    }
+  }
+
+  return mem;
+#else
+  return NULL;
+#endif
+}
+
+static void
+gst_memfd_allocator_free (GstAllocator * allocator, GstMemory * mem)
+{
+  GstMemfdAllocator *self = GST_MEMFD_ALLOCATOR (allocator);
+  GstFdMemory *fdmem = (GstFdMemory *) mem;
+  gint fd = fdmem->fd;
+  gboolean is_parent = (mem->parent == NULL);
+  gboolean exported = g_atomic_int_get (&fdmem->fd_exported);
+  gsize maxsize = mem->maxsize;
+
+  /* unmaps the memory but keeps the fd open */
+  GST_ALLOCATOR_CLASS (gst_memfd_allocator_parent_class)->free (allocator,
+      mem);
+
+  if (is_parent && fd >= 0)
+    gst_memfd_allocator_release_fd (self, fd, maxsize, exported);
+}
+
+static void
+close_pooled_fds (gpointer key, gpointer value, gpointer user_data)
+{
+#ifdef HAVE_MEMFD_CREATE
+  GSList *l;
+
+  for (l = value; l; l = l->next)
+    close (GPOINTER_TO_INT (l->data));
+#endif
+  g_slist_free (value);
+}
+
+static void
+gst_memfd_allocator_finalize (GObject * object)
+{
+  GstMemfdAllocator *self = GST_MEMFD_ALLOCATOR (object);
+  GstMemfdAllocatorPrivate *priv = self->priv;
+
+  g_hash_table_foreach (priv->pool, close_pooled_fds, NULL);
+  g_hash_table_unref (priv->pool);
+  g_mutex_clear (&priv->lock);
+
+  G_OBJECT_CLASS (gst_memfd_allocator_parent_class)->finalize (object);
+}
+
+static void
+gst_memfd_allocator_class_init (GstMemfdAllocatorClass * klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+  GstAllocatorClass *allocator_class = (GstAllocatorClass *) klass;
+
+  gobject_class->finalize = gst_memfd_allocator_finalize;
+
+  allocator_class->alloc = gst_memfd_allocator_alloc;
+  allocator_class->free = gst_memfd_allocator_free;
+}
+
+static void
+gst_memfd_allocator_init (GstMemfdAllocator * allocator)
+{
+  GstAllocator *alloc = GST_ALLOCATOR_CAST (allocator);
+  GstMemfdAllocatorPrivate *priv;
+
+  priv = allocator->priv = gst_memfd_allocator_get_instance_private (allocator);
+
+  alloc->mem_type = GST_ALLOCATOR_MEMFD;
+
+  /* unlike the plain fd allocator this one can allocate memory itself */
+  GST_OBJECT_FLAG_UNSET (allocator, GST_ALLOCATOR_FLAG_CUSTOM_ALLOC);
+
+  g_mutex_init (&priv->lock);
+  priv->pool = g_hash_table_new (NULL, NULL);
+}
+
+/**
+ * gst_memfd_allocator_new:
+ * @flags: #GstMemfdAllocatorFlags
+ * @max_pooled_size: maximum number of bytes of freed memory to keep for
+ *     reuse, 0 disables pooling
+ *
+ * Return a new memfd allocator.
+ *
+ * Returns: (transfer full) (nullable): a new memfd allocator, or %NULL if
+ *    memfd_create() is not available. Use gst_object_unref() to release the
+ *    allocator after usage
+ *
+ * Since: 1.20
+ */
+GstAllocator *
+gst_memfd_allocator_new (GstMemfdAllocatorFlags flags, gsize max_pooled_size)
+{
+#ifdef HAVE_MEMFD_CREATE
+  GstMemfdAllocator *alloc;
+  GstMemfdAllocatorPrivate *priv;
+
+  alloc = g_object_new (GST_TYPE_MEMFD_ALLOCATOR, NULL);
+  gst_object_ref_sink (alloc);
+
+  priv = alloc->priv;
+  priv->flags = flags;
+  priv->max_pooled_size = max_pooled_size;
+  if (flags & GST_MEMFD_ALLOCATOR_FLAG_HUGETLB)
+    priv->page_size = gst_memfd_get_huge_page_size ();
+  else
+    priv->page_size = sysconf (_SC_PAGESIZE);
+
+  return GST_ALLOCATOR_CAST (alloc);
+#else
+  return NULL;
+#endif
+}
+
+/**
+ * gst_is_memfd_memory:
+ * @mem: #GstMemory
+ *
+ * Check if @mem was allocated by a #GstMemfdAllocator.
+ *
+ * Returns: %TRUE when @mem is memfd backed memory.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_is_memfd_memory (GstMemory * mem)
+{
+  g_return_val_if_fail (mem != NULL, FALSE);
+
+  return GST_IS_MEMFD_ALLOCATOR (mem->allocator);
+}
+
+/**
+ * gst_memfd_memory_seal:
+ * @mem: memfd backed #GstMemory
+ *
+ * Seal the file backing @mem against writes, so that it can only be mapped
+ * read-only by consumers it is shared with. @mem itself becomes read-only
+ * and is not reused once it is freed.
+ *
+ * If supported by the kernel, existing writable mappings stay valid.
+ * Otherwise sealing fails while @mem is mapped.
+ *
+ * Returns: %TRUE if @mem was sealed.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_memfd_memory_seal (GstMemory * mem)
+{
+#ifdef HAVE_MEMFD_CREATE
+  GstFdMemory *fdmem;
+  gint fd, res;
+
+  g_return_val_if_fail (mem != NULL, FALSE);
+  g_return_val_if_fail (gst_is_memfd_memory (mem), FALSE);
+
+  fdmem = (GstFdMemory *) (mem->parent ? mem->parent : mem);
+  fd = fdmem->fd;
+
+  /* F_SEAL_FUTURE_WRITE only prevents new writable mappings and needs
+   * Linux 5.1 */
+  if (fcntl (fd, F_ADD_SEALS, F_SEAL_FUTURE_WRITE) == 0)
+    goto sealed;
+
+  /* F_SEAL_WRITE fails as long as there is any writable mapping, so drop
+   * the mapping that is otherwise kept for the lifetime of the memory. The
+   * next map creates a new one with the access that is still allowed. */
+  g_mutex_lock (&fdmem->lock);
+  if (fdmem->mmap_count > 0) {
+    g_mutex_unlock (&fdmem->lock);
+    GST_WARNING ("can't seal fd %d while it is mapped", fd);
+    return FALSE;
+  }
+  if (fdmem->data) {
+    munmap (fdmem->data, fdmem->mem.maxsize);
+    gst_fd_allocator_count (mem->allocator, GST_FD_ALLOCATOR_STAT_MUNMAP);
+    fdmem->data = NULL;
+    fdmem->mmapping_flags = 0;
+  }
+  res = fcntl (fd, F_ADD_SEALS, F_SEAL_WRITE);
+  g_mutex_unlock (&fdmem->lock);
+
+  if (res < 0) {
+    GST_WARNING ("failed to seal fd %d: %s", fd, g_strerror (errno));
+    return FALSE;
+  }
+
+sealed:
+  GST_MINI_OBJECT_FLAG_SET (mem, GST_MEMORY_FLAG_READONLY);
+  GST_DEBUG ("sealed fd %d", fd);
+
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
@@ -108,6 +108,95 @@ callbacks_unref (Callbacks * callbacks)
   g_free (callbacks);
 }
 
+/* number of samples that are kept around for reuse */
+#define SAMPLE_CACHE_SIZE 8
+
+/* Samples released by the application, shared with the samples as they can
+ * outlive appsink */
+typedef struct
+{
+  gint ref_count;
+  GMutex lock;
+  GstSample *free[SAMPLE_CACHE_SIZE];
+  guint n_free;
+  gboolean closed;
+} SampleCache;
+
+/* qdata of the samples that return to the cache */
+typedef struct
+{
+  SampleCache *cache;
+  /* caps and segment cookies the sample was last updated for */
+  guint caps_cookie;
+  guint segment_cookie;
+} CachedSample;
+
+static GQuark cached_sample_quark;
+
+static SampleCache *
+sample_cache_new (void)
+{
+  SampleCache *cache = g_new0 (SampleCache, 1);
+
+  cache->ref_count = 1;
+  g_mutex_init (&cache->lock);
+
+  return cache;
+}
+
+static SampleCache *
+sample_cache_ref (SampleCache * cache)
+{
+  g_atomic_int_inc (&cache->ref_count);
+
+  return cache;
+}
+
+static void
+sample_cache_unref (SampleCache * cache)
+{
+  if (!g_atomic_int_dec_and_test (&cache->ref_count))
+    return;
+
+  g_mutex_clear (&cache->lock);
+  g_free (cache);
+}
+
+static void
+cached_sample_free (CachedSample * cached)
+{
+  sample_cache_unref (cached->cache);
+  g_free (cached);
+}
+
+/* Called when the last reference to a cached sample is dropped. The buffer
+ * or list is released right away so that no upstream buffers are kept
+ * alive, and the sample goes back into the cache unless appsink is gone */
+static gboolean
+cached_sample_dispose (GstSample * sample)
+{
+  CachedSample *cached;
+  SampleCache *cache;
+
+  cached = gst_mini_object_get_qdata (GST_MINI_OBJECT_CAST (sample),
+      cached_sample_quark);
+  cache = cached->cache;
+
+  g_mutex_lock (&cache->lock);
+  if (cache->closed) {
+    g_mutex_unlock (&cache->lock);
+    return TRUE;
+  }
+
+  gst_sample_ref (sample);
+  gst_sample_set_buffer (sample, NULL);
+  gst_sample_set_buffer_list (sample, NULL);
+  cache->free[cache->n_free++] = sample;
+  g_mutex_unlock (&cache->lock);
+
+  return FALSE;
+}
+
 struct _GstAppSinkPrivate
 {
   GstCaps *caps;
@@ -120,7 +209,11 @@ struct _GstAppSinkPrivate
 
   GCond cond;
   GMutex mutex;
-  GstQueueArray *queue;
+  /* buffers, lists and serialized events. num_buffers is only modified
+   * atomically as the streaming thread pushes to the queue without taking
+   * the mutex in lock-free mode */
+  GstAtomicQueue *queue;
+  gboolean lock_free;
   GstBuffer *preroll_buffer;
   GstCaps *preroll_caps;
   GstCaps *last_caps;
@@ -134,7 +227,17 @@ struct _GstAppSinkPrivate
 
   Callbacks *callbacks;
 
-  GstSample *sample;
+  /* samples released by the application, reused for the next pulls. The
+   * cookies are incremented whenever last_caps/last_segment change */
+  SampleCache *sample_cache;
+  guint n_cached_samples;
+  guint caps_cookie;
+  guint segment_cookie;
+
+  /* buffer list partially returned by gst_app_sink_try_pull_buffer(),
+   * still accounted in num_buffers */
+  GstBufferList *pending_list;
+  guint pending_list_idx;
 };
 
 GST_DEBUG_CATEGORY_STATIC (app_sink_debug);
@@ -162,6 +265,7 @@ enum
 #define DEFAULT_PROP_DROP		FALSE
 #define DEFAULT_PROP_WAIT_ON_EOS	TRUE
 #define DEFAULT_PROP_BUFFER_LIST	FALSE
+#define DEFAULT_PROP_LOCK_FREE		FALSE
 
 enum
 {
@@ -173,6 +277,7 @@ enum
   PROP_DROP,
   PROP_WAIT_ON_EOS,
   PROP_BUFFER_LIST,
+  PROP_LOCK_FREE,
   PROP_LAST
 };
 
@@ -227,6 +332,8 @@ gst_app_sink_class_init (GstAppSinkClass * klass)
 
   GST_DEBUG_CATEGORY_INIT (app_sink_debug, "appsink", 0, "appsink element");
 
+  cached_sample_quark = g_quark_from_static_string ("GstAppSinkCachedSample");
+
   gobject_class->dispose = gst_app_sink_dispose;
   gobject_class->finalize = gst_app_sink_finalize;
 
@@ -280,6 +387,25 @@ gst_app_sink_class_init (GstAppSinkClass * klass)
           DEFAULT_PROP_WAIT_ON_EOS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAppSink:lock-free:
+   *
+   * Hand buffers from the streaming thread to the application without
+   * taking the internal queue lock as long as the queue is below
+   * #GstAppSink:max-buffers. The application is then only woken up when the
+   * queue goes from empty to non-empty, which reduces lock contention and
+   * wakeups at high buffer rates. Full queues, dropping and flushing are
+   * still handled with the lock held so their behaviour is unchanged.
+   *
+   * Can only be changed while the sink is not started.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_LOCK_FREE,
+      g_param_spec_boolean ("lock-free", "Lock Free",
+          "Queue buffers without taking the queue lock when possible",
+          DEFAULT_PROP_LOCK_FREE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstAppSink::eos:
    * @appsink: the appsink element that emitted the signal
@@ -476,6 +602,33 @@ gst_app_sink_class_init (GstAppSinkClass * klass)
   klass->try_pull_sample = gst_app_sink_try_pull_sample;
 }
 
+/* Called with the mutex held */
+static void
+gst_app_sink_free_samples (GstAppSink * appsink)
+{
+  GstAppSinkPrivate *priv = appsink->priv;
+  SampleCache *cache = priv->sample_cache;
+  GstSample *samples[SAMPLE_CACHE_SIZE];
+  guint i, n;
+
+  if (cache == NULL)
+    return;
+
+  /* samples still held by the application are freed when released */
+  g_mutex_lock (&cache->lock);
+  cache->closed = TRUE;
+  n = cache->n_free;
+  memcpy (samples, cache->free, n * sizeof (GstSample *));
+  cache->n_free = 0;
+  g_mutex_unlock (&cache->lock);
+
+  for (i = 0; i < n; i++)
+    gst_sample_unref (samples[i]);
+
+  sample_cache_unref (cache);
+  priv->sample_cache = NULL;
+}
+
 static void
 gst_app_sink_init (GstAppSink * appsink)
 {
@@ -485,14 +638,15 @@ gst_app_sink_init (GstAppSink * appsink)
 
   g_mutex_init (&priv->mutex);
   g_cond_init (&priv->cond);
-  priv->queue = gst_queue_array_new (16);
-  priv->sample = gst_sample_new (NULL, NULL, NULL, NULL);
+  priv->queue = gst_atomic_queue_new (16);
+  priv->sample_cache = sample_cache_new ();
 
   priv->emit_signals = DEFAULT_PROP_EMIT_SIGNALS;
   priv->max_buffers = DEFAULT_PROP_MAX_BUFFERS;
   priv->drop = DEFAULT_PROP_DROP;
   priv->wait_on_eos = DEFAULT_PROP_WAIT_ON_EOS;
   priv->buffer_lists_supported = DEFAULT_PROP_BUFFER_LIST;
+  priv->lock_free = DEFAULT_PROP_LOCK_FREE;
   priv->wait_status = NOONE_WAITING;
 }
 
@@ -512,17 +666,20 @@ gst_app_sink_dispose (GObject * obj)
   GST_OBJECT_UNLOCK (appsink);
 
   g_mutex_lock (&priv->mutex);
+  GST_OBJECT_LOCK (appsink);
   if (priv->callbacks)
     callbacks = g_steal_pointer (&priv->callbacks);
-  while ((queue_obj = gst_queue_array_pop_head (priv->queue)))
+  GST_OBJECT_UNLOCK (appsink);
+  while ((queue_obj = gst_atomic_queue_pop (priv->queue)))
     gst_mini_object_unref (queue_obj);
+  if (priv->pending_list) {
+    gst_buffer_list_unref (priv->pending_list);
+    priv->pending_list = NULL;
+  }
   gst_buffer_replace (&priv->preroll_buffer, NULL);
   gst_caps_replace (&priv->preroll_caps, NULL);
   gst_caps_replace (&priv->last_caps, NULL);
-  if (priv->sample) {
-    gst_sample_unref (priv->sample);
-    priv->sample = NULL;
-  }
+  gst_app_sink_free_samples (appsink);
   g_mutex_unlock (&priv->mutex);
 
   g_clear_pointer (&callbacks, callbacks_unref);
@@ -538,7 +695,7 @@ gst_app_sink_finalize (GObject * obj)
 
   g_mutex_clear (&priv->mutex);
   g_cond_clear (&priv->cond);
-  gst_queue_array_free (priv->queue);
+  gst_atomic_queue_unref (priv->queue);
 
   G_OBJECT_CLASS (parent_class)->finalize (obj);
 }
@@ -569,6 +726,19 @@ gst_app_sink_set_property (GObject * object, guint prop_id,
     case PROP_WAIT_ON_EOS:
       gst_app_sink_set_wait_on_eos (appsink, g_value_get_boolean (value));
       break;
+    case PROP_LOCK_FREE:
+    {
+      GstAppSinkPrivate *priv = appsink->priv;
+
+      g_mutex_lock (&priv->mutex);
+      if (priv->started)
+        g_warning ("Changing the lock-free property of a started appsink "
+            "is not supported");
+      else
+        priv->lock_free = g_value_get_boolean (value);
+      g_mutex_unlock (&priv->mutex);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -611,6 +781,15 @@ gst_app_sink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_WAIT_ON_EOS:
       g_value_set_boolean (value, gst_app_sink_get_wait_on_eos (appsink));
       break;
+    case PROP_LOCK_FREE:
+    {
+      GstAppSinkPrivate *priv = appsink->priv;
+
+      g_mutex_lock (&priv->mutex);
+      g_value_set_boolean (value, priv->lock_free);
+      g_mutex_unlock (&priv->mutex);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -656,9 +835,13 @@ gst_app_sink_flush_unlocked (GstAppSink * appsink)
   GST_DEBUG_OBJECT (appsink, "flush stop appsink");
   priv->is_eos = FALSE;
   gst_buffer_replace (&priv->preroll_buffer, NULL);
-  while ((obj = gst_queue_array_pop_head (priv->queue)))
+  while ((obj = gst_atomic_queue_pop (priv->queue)))
     gst_mini_object_unref (obj);
-  priv->num_buffers = 0;
+  if (priv->pending_list) {
+    gst_buffer_list_unref (priv->pending_list);
+    priv->pending_list = NULL;
+  }
+  g_atomic_int_set (&priv->num_buffers, 0);
   g_cond_signal (&priv->cond);
 }
 
@@ -675,11 +858,8 @@ gst_app_sink_start (GstBaseSink * psink)
   priv->started = TRUE;
   gst_segment_init (&priv->preroll_segment, GST_FORMAT_TIME);
   gst_segment_init (&priv->last_segment, GST_FORMAT_TIME);
-  priv->sample = gst_sample_make_writable (priv->sample);
-  gst_sample_set_buffer (priv->sample, NULL);
-  gst_sample_set_buffer_list (priv->sample, NULL);
-  gst_sample_set_caps (priv->sample, NULL);
-  gst_sample_set_segment (priv->sample, NULL);
+  priv->caps_cookie++;
+  priv->segment_cookie++;
   g_mutex_unlock (&priv->mutex);
 
   return TRUE;
@@ -715,7 +895,7 @@ gst_app_sink_setcaps (GstBaseSink * sink, GstCaps * caps)
 
   g_mutex_lock (&priv->mutex);
   GST_DEBUG_OBJECT (appsink, "receiving CAPS");
-  gst_queue_array_push_tail (priv->queue, gst_event_new_caps (caps));
+  gst_atomic_queue_push (priv->queue, gst_event_new_caps (caps));
   if (!priv->preroll_buffer)
     gst_caps_replace (&priv->preroll_caps, caps);
   g_mutex_unlock (&priv->mutex);
@@ -733,7 +913,7 @@ gst_app_sink_event (GstBaseSink * sink, GstEvent * event)
     case GST_EVENT_SEGMENT:
       g_mutex_lock (&priv->mutex);
       GST_DEBUG_OBJECT (appsink, "receiving SEGMENT");
-      gst_queue_array_push_tail (priv->queue, gst_event_ref (event));
+      gst_atomic_queue_push (priv->queue, gst_event_ref (event));
       if (!priv->preroll_buffer)
         gst_event_copy_segment (event, &priv->preroll_segment);
       g_mutex_unlock (&priv->mutex);
@@ -753,7 +933,8 @@ gst_app_sink_event (GstBaseSink * sink, GstEvent * event)
        * Otherwise we might signal EOS before all buffers are
        * consumed, which is a bit confusing for the application
        */
-      while (priv->num_buffers > 0 && !priv->flushing && priv->wait_on_eos) {
+      while (g_atomic_int_get (&priv->num_buffers) > 0 && !priv->flushing
+          && priv->wait_on_eos) {
         if (priv->unlock) {
           /* we are asked to unlock, call the wait_preroll method */
           g_mutex_unlock (&priv->mutex);
@@ -859,12 +1040,36 @@ dequeue_buffer (GstAppSink * appsink)
   GstAppSinkPrivate *priv = appsink->priv;
   GstMiniObject *obj;
 
+  /* the rest of a list that was partially pulled as buffers */
+  if (priv->pending_list) {
+    GstBufferList *list = priv->pending_list;
+    guint i, len = gst_buffer_list_length (list);
+
+    if (priv->pending_list_idx > 0) {
+      GstBufferList *rest = gst_buffer_list_new_sized (len -
+          priv->pending_list_idx);
+
+      for (i = priv->pending_list_idx; i < len; i++)
+        gst_buffer_list_add (rest, gst_buffer_ref (gst_buffer_list_get (list,
+                    i)));
+      gst_buffer_list_unref (list);
+      list = rest;
+    }
+    priv->pending_list = NULL;
+    g_atomic_int_add (&priv->num_buffers, -1);
+
+    GST_DEBUG_OBJECT (appsink, "dequeued rest of pending list %p", list);
+    return GST_MINI_OBJECT_CAST (list);
+  }
+
   do {
-    obj = gst_queue_array_pop_head (priv->queue);
+    /* never NULL, num_buffers is only incremented after the buffer was
+     * pushed */
+    obj = gst_atomic_queue_pop (priv->queue);
 
     if (GST_IS_BUFFER (obj) || GST_IS_BUFFER_LIST (obj)) {
       GST_DEBUG_OBJECT (appsink, "dequeued buffer/list %p", obj);
-      priv->num_buffers--;
+      g_atomic_int_add (&priv->num_buffers, -1);
       break;
     } else if (GST_IS_EVENT (obj)) {
       GstEvent *event = GST_EVENT_CAST (obj);
@@ -877,14 +1082,12 @@ dequeue_buffer (GstAppSink * appsink)
           gst_event_parse_caps (event, &caps);
           GST_DEBUG_OBJECT (appsink, "activating caps %" GST_PTR_FORMAT, caps);
           gst_caps_replace (&priv->last_caps, caps);
-          priv->sample = gst_sample_make_writable (priv->sample);
-          gst_sample_set_caps (priv->sample, priv->last_caps);
+          priv->caps_cookie++;
           break;
         }
         case GST_EVENT_SEGMENT:
           gst_event_copy_segment (event, &priv->last_segment);
-          priv->sample = gst_sample_make_writable (priv->sample);
-          gst_sample_set_segment (priv->sample, &priv->last_segment);
+          priv->segment_cookie++;
           GST_DEBUG_OBJECT (appsink, "activated segment %" GST_SEGMENT_FORMAT,
               &priv->last_segment);
           break;
@@ -898,6 +1101,179 @@ dequeue_buffer (GstAppSink * appsink)
   return obj;
 }
 
+/* Like dequeue_buffer() but always returns a single buffer. Buffer lists
+ * are returned one buffer at a time and stay accounted in num_buffers until
+ * their last buffer was returned */
+static GstBuffer *
+dequeue_single_buffer (GstAppSink * appsink)
+{
+  GstAppSinkPrivate *priv = appsink->priv;
+  GstBuffer *buffer;
+
+  if (!priv->pending_list) {
+    GstMiniObject *obj = dequeue_buffer (appsink);
+
+    if (GST_IS_BUFFER (obj))
+      return GST_BUFFER_CAST (obj);
+
+    priv->pending_list = GST_BUFFER_LIST_CAST (obj);
+    priv->pending_list_idx = 0;
+    g_atomic_int_inc (&priv->num_buffers);
+  }
+
+  buffer = gst_buffer_list_get (priv->pending_list, priv->pending_list_idx++);
+  gst_buffer_ref (buffer);
+
+  if (priv->pending_list_idx == gst_buffer_list_length (priv->pending_list)) {
+    gst_buffer_list_unref (priv->pending_list);
+    priv->pending_list = NULL;
+    g_atomic_int_add (&priv->num_buffers, -1);
+  }
+
+  return buffer;
+}
+
+/* Called with the mutex held. Wraps @obj, a buffer or buffer list, in a
+ * sample with the current caps and segment. Samples released by the
+ * application are reused, so that usually nothing has to be allocated */
+static GstSample *
+gst_app_sink_make_sample (GstAppSink * appsink, GstMiniObject * obj)
+{
+  GstAppSinkPrivate *priv = appsink->priv;
+  SampleCache *cache = priv->sample_cache;
+  CachedSample *cached;
+  GstSample *sample = NULL;
+
+  g_mutex_lock (&cache->lock);
+  if (cache->n_free > 0)
+    sample = cache->free[--cache->n_free];
+  g_mutex_unlock (&cache->lock);
+
+  if (sample) {
+    cached = gst_mini_object_get_qdata (GST_MINI_OBJECT_CAST (sample),
+        cached_sample_quark);
+
+    if (cached->caps_cookie != priv->caps_cookie) {
+      gst_sample_set_caps (sample, priv->last_caps);
+      cached->caps_cookie = priv->caps_cookie;
+    }
+    if (cached->segment_cookie != priv->segment_cookie) {
+      gst_sample_set_segment (sample, &priv->last_segment);
+      cached->segment_cookie = priv->segment_cookie;
+    }
+  } else {
+    sample = gst_sample_new (NULL, priv->last_caps, &priv->last_segment, NULL);
+
+    /* let the first samples return to the cache when they are released */
+    if (priv->n_cached_samples < SAMPLE_CACHE_SIZE) {
+      cached = g_new (CachedSample, 1);
+      cached->cache = sample_cache_ref (cache);
+      cached->caps_cookie = priv->caps_cookie;
+      cached->segment_cookie = priv->segment_cookie;
+      gst_mini_object_set_qdata (GST_MINI_OBJECT_CAST (sample),
+          cached_sample_quark, cached, (GDestroyNotify) cached_sample_free);
+      GST_MINI_OBJECT_CAST (sample)->dispose =
+          (GstMiniObjectDisposeFunction) cached_sample_dispose;
+      priv->n_cached_samples++;
+    }
+  }
+
+  /* released samples have neither buffer nor list */
+  if (GST_IS_BUFFER (obj)) {
+    GST_DEBUG_OBJECT (appsink, "we have a buffer %p", obj);
+    gst_sample_set_buffer (sample, GST_BUFFER_CAST (obj));
+  } else {
+    GST_DEBUG_OBJECT (appsink, "we have a list %p", obj);
+    gst_sample_set_buffer_list (sample, GST_BUFFER_LIST_CAST (obj));
+  }
+
+  return sample;
+}
+
+/* Called with the mutex held. Waits until a buffer or list can be dequeued,
+ * returns FALSE if the sink is stopped, EOS or @end_time expired */
+static gboolean
+gst_app_sink_wait_for_buffer (GstAppSink * appsink, gboolean timeout_valid,
+    gint64 end_time)
+{
+  GstAppSinkPrivate *priv = appsink->priv;
+
+  while (TRUE) {
+    GST_DEBUG_OBJECT (appsink, "trying to grab a buffer");
+    if (!priv->started)
+      goto not_started;
+
+    if (g_atomic_int_get (&priv->num_buffers) > 0)
+      return TRUE;
+
+    if (priv->is_eos)
+      goto eos;
+
+    /* nothing to return, wait */
+    GST_DEBUG_OBJECT (appsink, "waiting for a buffer");
+    priv->wait_status |= APP_WAITING;
+    if (timeout_valid) {
+      if (!g_cond_wait_until (&priv->cond, &priv->mutex, end_time))
+        goto expired;
+    } else {
+      g_cond_wait (&priv->cond, &priv->mutex);
+    }
+    priv->wait_status &= ~APP_WAITING;
+  }
+
+  /* special conditions */
+expired:
+  {
+    GST_DEBUG_OBJECT (appsink, "timeout expired, return NULL");
+    priv->wait_status &= ~APP_WAITING;
+    return FALSE;
+  }
+eos:
+  {
+    GST_DEBUG_OBJECT (appsink, "we are EOS, return NULL");
+    return FALSE;
+  }
+not_started:
+  {
+    GST_DEBUG_OBJECT (appsink, "we are stopped, return NULL");
+    return FALSE;
+  }
+}
+
+/* Pushes @data to the queue without taking the mutex. This is only done as
+ * long as the queue is below max-buffers and the caps are known, FALSE is
+ * returned otherwise and the caller has to take the locked path. */
+static gboolean
+gst_app_sink_try_push_lock_free (GstAppSink * appsink, GstMiniObject * data)
+{
+  GstAppSinkPrivate *priv = appsink->priv;
+  guint max_buffers;
+
+  if (G_UNLIKELY (g_atomic_int_get (&priv->flushing)
+          || g_atomic_pointer_get (&priv->last_caps) == NULL))
+    return FALSE;
+
+  max_buffers = g_atomic_int_get (&priv->max_buffers);
+  if (max_buffers > 0
+      && (guint) g_atomic_int_get (&priv->num_buffers) >= max_buffers)
+    return FALSE;
+
+  GST_LOG_OBJECT (appsink, "pushing render buffer/list %p lock-free", data);
+
+  gst_atomic_queue_push (priv->queue, gst_mini_object_ref (data));
+
+  /* the application only waits when the queue is empty, so it only needs
+   * to be woken up when the first buffer is queued */
+  if (g_atomic_int_add (&priv->num_buffers, 1) == 0) {
+    g_mutex_lock (&priv->mutex);
+    if ((priv->wait_status & APP_WAITING))
+      g_cond_broadcast (&priv->cond);
+    g_mutex_unlock (&priv->mutex);
+  }
+
+  return TRUE;
+}
+
 static GstFlowReturn
 gst_app_sink_render_common (GstBaseSink * psink, GstMiniObject * data,
     gboolean is_list)
@@ -908,6 +1284,17 @@ gst_app_sink_render_common (GstBaseSink * psink, GstMiniObject * data,
   gboolean emit;
   Callbacks *callbacks = NULL;
 
+  if (priv->lock_free && gst_app_sink_try_push_lock_free (appsink, data)) {
+    /* callbacks and emit-signals are also protected by the object lock, so
+     * that they can be read here without taking the mutex */
+    GST_OBJECT_LOCK (appsink);
+    emit = priv->emit_signals;
+    if (priv->callbacks)
+      callbacks = callbacks_ref (priv->callbacks);
+    GST_OBJECT_UNLOCK (appsink);
+    goto notify;
+  }
+
 restart:
   g_mutex_lock (&priv->mutex);
   if (priv->flushing)
@@ -918,15 +1305,16 @@ restart:
   if (G_UNLIKELY (!priv->last_caps &&
           gst_pad_has_current_caps (GST_BASE_SINK_PAD (psink)))) {
     priv->last_caps = gst_pad_get_current_caps (GST_BASE_SINK_PAD (psink));
-    gst_sample_set_caps (priv->sample, priv->last_caps);
+    priv->caps_cookie++;
     GST_DEBUG_OBJECT (appsink, "activating pad caps %" GST_PTR_FORMAT,
         priv->last_caps);
   }
 
   GST_DEBUG_OBJECT (appsink, "pushing render buffer/list %p on queue (%d)",
-      data, priv->num_buffers);
+      data, g_atomic_int_get (&priv->num_buffers));
 
-  while (priv->max_buffers > 0 && priv->num_buffers >= priv->max_buffers) {
+  while (priv->max_buffers > 0
+      && (guint) g_atomic_int_get (&priv->num_buffers) >= priv->max_buffers) {
     if (priv->drop) {
       GstMiniObject *old;
 
@@ -937,7 +1325,7 @@ restart:
       }
     } else {
       GST_DEBUG_OBJECT (appsink, "waiting for free space, length %d >= %d",
-          priv->num_buffers, priv->max_buffers);
+          g_atomic_int_get (&priv->num_buffers), priv->max_buffers);
 
       if (priv->unlock) {
         /* we are asked to unlock, call the wait_preroll method */
@@ -959,10 +1347,11 @@ restart:
     }
   }
   /* we need to ref the buffer/list when pushing it in the queue */
-  gst_queue_array_push_tail (priv->queue, gst_mini_object_ref (data));
-  priv->num_buffers++;
+  gst_atomic_queue_push (priv->queue, gst_mini_object_ref (data));
 
-  if ((priv->wait_status & APP_WAITING))
+  /* the application only waits for the empty to non-empty transition */
+  if (g_atomic_int_add (&priv->num_buffers, 1) == 0
+      && (priv->wait_status & APP_WAITING))
     g_cond_signal (&priv->cond);
 
   emit = priv->emit_signals;
@@ -970,6 +1359,8 @@ restart:
     callbacks = callbacks_ref (priv->callbacks);
   g_mutex_unlock (&priv->mutex);
 
+notify:
+
   if (callbacks && callbacks->callbacks.new_sample) {
     ret = callbacks->callbacks.new_sample (appsink, callbacks->user_data);
   } else {
@@ -1011,6 +1402,9 @@ gst_app_sink_render_list (GstBaseSink * sink, GstBufferList * list)
 
   appsink = GST_APP_SINK_CAST (sink);
 
+  if (gst_buffer_list_length (list) == 0)
+    return GST_FLOW_OK;
+
   if (appsink->priv->buffer_lists_supported)
     return gst_app_sink_render_common (sink, GST_MINI_OBJECT_CAST (list), TRUE);
 
@@ -1063,7 +1457,8 @@ gst_app_sink_query (GstBaseSink * bsink, GstQuery * query)
     {
       g_mutex_lock (&priv->mutex);
       GST_DEBUG_OBJECT (appsink, "waiting buffers to be consumed");
-      while (priv->num_buffers > 0 || priv->preroll_buffer) {
+      while (g_atomic_int_get (&priv->num_buffers) > 0
+          || priv->preroll_buffer) {
         if (priv->unlock) {
           /* we are asked to unlock, call the wait_preroll method */
           g_mutex_unlock (&priv->mutex);
@@ -1194,7 +1589,7 @@ gst_app_sink_is_eos (GstAppSink * appsink)
   if (!priv->started)
     goto not_started;
 
-  if (priv->is_eos && priv->num_buffers == 0) {
+  if (priv->is_eos && g_atomic_int_get (&priv->num_buffers) == 0) {
     GST_DEBUG_OBJECT (appsink, "we are EOS and the queue is empty");
     ret = TRUE;
   } else {
@@ -1232,7 +1627,9 @@ gst_app_sink_set_emit_signals (GstAppSink * appsink, gboolean emit)
   priv = appsink->priv;
 
   g_mutex_lock (&priv->mutex);
+  GST_OBJECT_LOCK (appsink);
   priv->emit_signals = emit;
+  GST_OBJECT_UNLOCK (appsink);
   g_mutex_unlock (&priv->mutex);
 }
 
@@ -1666,7 +2063,7 @@ gst_app_sink_try_pull_sample (GstAppSink * appsink, GstClockTime timeout)
   GstSample *sample = NULL;
   GstMiniObject *obj;
   gboolean timeout_valid;
-  gint64 end_time;
+  gint64 end_time = 0;
 
   g_return_val_if_fail (GST_IS_APP_SINK (appsink), NULL);
 
@@ -1681,72 +2078,136 @@ gst_app_sink_try_pull_sample (GstAppSink * appsink, GstClockTime timeout)
   g_mutex_lock (&priv->mutex);
   gst_buffer_replace (&priv->preroll_buffer, NULL);
 
-  while (TRUE) {
-    GST_DEBUG_OBJECT (appsink, "trying to grab a buffer");
-    if (!priv->started)
-      goto not_started;
+  if (gst_app_sink_wait_for_buffer (appsink, timeout_valid, end_time)) {
+    obj = dequeue_buffer (appsink);
+    sample = gst_app_sink_make_sample (appsink, obj);
+    gst_mini_object_unref (obj);
 
-    if (priv->num_buffers > 0)
-      break;
+    if ((priv->wait_status & STREAM_WAITING))
+      g_cond_signal (&priv->cond);
+  }
 
-    if (priv->is_eos)
-      goto eos;
+  g_mutex_unlock (&priv->mutex);
 
-    /* nothing to return, wait */
-    GST_DEBUG_OBJECT (appsink, "waiting for a buffer");
-    priv->wait_status |= APP_WAITING;
-    if (timeout_valid) {
-      if (!g_cond_wait_until (&priv->cond, &priv->mutex, end_time))
-        goto expired;
-    } else {
-      g_cond_wait (&priv->cond, &priv->mutex);
+  return sample;
+}
+
+/**
+ * gst_app_sink_try_pull_samples:
+ * @appsink: a #GstAppSink
+ * @samples: (out caller-allocates) (array length=n_samples) (transfer full):
+ *   array to store the pulled samples in
+ * @n_samples: the size of @samples
+ * @timeout: the maximum amount of time to wait for the first sample
+ *
+ * Pulls up to @n_samples samples at once. This function blocks like
+ * gst_app_sink_try_pull_sample() until at least one sample is available,
+ * then returns all queued samples up to @n_samples without waiting any
+ * further. This is considerably cheaper than pulling the samples one by one
+ * when many small buffers are queued.
+ *
+ * Returns: the number of samples stored in @samples, 0 when the appsink is
+ * stopped or EOS or the timeout expires. Call gst_sample_unref() on each of
+ * the samples after usage.
+ *
+ * Since: 1.20
+ */
+guint
+gst_app_sink_try_pull_samples (GstAppSink * appsink, GstSample ** samples,
+    guint n_samples, GstClockTime timeout)
+{
+  GstAppSinkPrivate *priv;
+  GstMiniObject *obj;
+  gboolean timeout_valid;
+  gint64 end_time = 0;
+  guint n = 0;
+
+  g_return_val_if_fail (GST_IS_APP_SINK (appsink), 0);
+  g_return_val_if_fail (samples != NULL || n_samples == 0, 0);
+
+  if (n_samples == 0)
+    return 0;
+
+  timeout_valid = GST_CLOCK_TIME_IS_VALID (timeout);
+
+  if (timeout_valid)
+    end_time =
+        g_get_monotonic_time () + timeout / (GST_SECOND / G_TIME_SPAN_SECOND);
+
+  priv = appsink->priv;
+
+  g_mutex_lock (&priv->mutex);
+  gst_buffer_replace (&priv->preroll_buffer, NULL);
+
+  if (gst_app_sink_wait_for_buffer (appsink, timeout_valid, end_time)) {
+    while (n < n_samples && g_atomic_int_get (&priv->num_buffers) > 0) {
+      obj = dequeue_buffer (appsink);
+      samples[n++] = gst_app_sink_make_sample (appsink, obj);
+      gst_mini_object_unref (obj);
     }
-    priv->wait_status &= ~APP_WAITING;
-  }
 
-  obj = dequeue_buffer (appsink);
-  if (GST_IS_BUFFER (obj)) {
-    GST_DEBUG_OBJECT (appsink, "we have a buffer %p", obj);
-    priv->sample = gst_sample_make_writable (priv->sample);
-    gst_sample_set_buffer_list (priv->sample, NULL);
-    gst_sample_set_buffer (priv->sample, GST_BUFFER_CAST (obj));
-    sample = gst_sample_ref (priv->sample);
-  } else {
-    GST_DEBUG_OBJECT (appsink, "we have a list %p", obj);
-    priv->sample = gst_sample_make_writable (priv->sample);
-    gst_sample_set_buffer (priv->sample, NULL);
-    gst_sample_set_buffer_list (priv->sample, GST_BUFFER_LIST_CAST (obj));
-    sample = gst_sample_ref (priv->sample);
-  }
-  gst_mini_object_unref (obj);
+    GST_DEBUG_OBJECT (appsink, "pulled %u samples", n);
 
-  if ((priv->wait_status & STREAM_WAITING))
-    g_cond_signal (&priv->cond);
+    if ((priv->wait_status & STREAM_WAITING))
+      g_cond_signal (&priv->cond);
+  }
 
   g_mutex_unlock (&priv->mutex);
 
-  return sample;
+  return n;
+}
 
-  /* special conditions */
-expired:
-  {
-    GST_DEBUG_OBJECT (appsink, "timeout expired, return NULL");
-    priv->wait_status &= ~APP_WAITING;
-    g_mutex_unlock (&priv->mutex);
-    return NULL;
-  }
-eos:
-  {
-    GST_DEBUG_OBJECT (appsink, "we are EOS, return NULL");
-    g_mutex_unlock (&priv->mutex);
-    return NULL;
-  }
-not_started:
-  {
-    GST_DEBUG_OBJECT (appsink, "we are stopped, return NULL");
-    g_mutex_unlock (&priv->mutex);
-    return NULL;
+/**
+ * gst_app_sink_try_pull_buffer:
+ * @appsink: a #GstAppSink
+ * @timeout: the maximum amount of time to wait for a buffer
+ *
+ * Like gst_app_sink_try_pull_sample() but returns the buffer only, without
+ * wrapping it in a #GstSample. This is the cheapest way to pull data when
+ * the application doesn't need the caps and segment of every buffer, or
+ * tracks them otherwise.
+ *
+ * If buffer list support is enabled, the buffers of a queued #GstBufferList
+ * are returned one after another.
+ *
+ * Returns: (transfer full) (nullable): a #GstBuffer or %NULL when the appsink
+ * is stopped or EOS or the timeout expires. Call gst_buffer_unref() after
+ * usage.
+ *
+ * Since: 1.20
+ */
+GstBuffer *
+gst_app_sink_try_pull_buffer (GstAppSink * appsink, GstClockTime timeout)
+{
+  GstAppSinkPrivate *priv;
+  GstBuffer *buffer = NULL;
+  gboolean timeout_valid;
+  gint64 end_time = 0;
+
+  g_return_val_if_fail (GST_IS_APP_SINK (appsink), NULL);
+
+  timeout_valid = GST_CLOCK_TIME_IS_VALID (timeout);
+
+  if (timeout_valid)
+    end_time =
+        g_get_monotonic_time () + timeout / (GST_SECOND / G_TIME_SPAN_SECOND);
+
+  priv = appsink->priv;
+
+  g_mutex_lock (&priv->mutex);
+  gst_buffer_replace (&priv->preroll_buffer, NULL);
+
+  if (gst_app_sink_wait_for_buffer (appsink, timeout_valid, end_time)) {
+    buffer = dequeue_single_buffer (appsink);
+    GST_DEBUG_OBJECT (appsink, "pulled buffer %p", buffer);
+
+    if ((priv->wait_status & STREAM_WAITING))
+      g_cond_signal (&priv->cond);
   }
+
+  g_mutex_unlock (&priv->mutex);
+
+  return buffer;
 }
 
 /**
@@ -1787,8 +2248,10 @@ gst_app_sink_set_callbacks (GstAppSink * appsink,
   }
 
   g_mutex_lock (&priv->mutex);
+  GST_OBJECT_LOCK (appsink);
   old_callbacks = g_steal_pointer (&priv->callbacks);
   priv->callbacks = g_steal_pointer (&new_callbacks);
+  GST_OBJECT_UNLOCK (appsink);
   g_mutex_unlock (&priv->mutex);
 
   g_clear_pointer (&old_callbacks, callbacks_unref);
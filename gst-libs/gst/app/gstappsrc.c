@@ -141,7 +141,12 @@ struct _GstAppSrcPrivate
 {
   GCond cond;
   GMutex mutex;
-  GstQueueArray *queue;
+  /* buffers, lists, caps and segment events. queue_len and queued_bytes are
+   * only modified atomically as the application pushes to the queue without
+   * taking the mutex in lock-free mode */
+  GstAtomicQueue *queue;
+  gint queue_len;
+  gboolean lock_free;
   GstAppSrcWaitStatus wait_status;
 
   GstCaps *last_caps;
@@ -161,7 +166,7 @@ struct _GstAppSrcPrivate
   gboolean flushing;
   gboolean started;
   gboolean is_eos;
-  guint64 queued_bytes;
+  gsize queued_bytes;
   guint64 offset;
   GstAppStreamType current_type;
 
@@ -206,6 +211,7 @@ enum
 #define DEFAULT_PROP_CURRENT_LEVEL_BYTES   0
 #define DEFAULT_PROP_DURATION      GST_CLOCK_TIME_NONE
 #define DEFAULT_PROP_HANDLE_SEGMENT_CHANGE FALSE
+#define DEFAULT_PROP_LOCK_FREE     FALSE
 
 enum
 {
@@ -224,6 +230,7 @@ enum
   PROP_CURRENT_LEVEL_BYTES,
   PROP_DURATION,
   PROP_HANDLE_SEGMENT_CHANGE,
+  PROP_LOCK_FREE,
   PROP_LAST
 };
 
@@ -273,6 +280,9 @@ static GstFlowReturn gst_app_src_push_sample_action (GstAppSrc * appsrc,
 
 static guint gst_app_src_signals[LAST_SIGNAL] = { 0 };
 
+/* size of a queued buffer list as it was accounted when pushing */
+static GQuark list_size_quark;
+
 #define gst_app_src_parent_class parent_class
 G_DEFINE_TYPE_WITH_CODE (GstAppSrc, gst_app_src, GST_TYPE_BASE_SRC,
     G_ADD_PRIVATE (GstAppSrc)
@@ -287,6 +297,8 @@ gst_app_src_class_init (GstAppSrcClass * klass)
 
   GST_DEBUG_CATEGORY_INIT (app_src_debug, "appsrc", 0, "appsrc element");
 
+  list_size_quark = g_quark_from_static_string ("GstAppSrcListSize");
+
   gobject_class->dispose = gst_app_src_dispose;
   gobject_class->finalize = gst_app_src_finalize;
 
@@ -467,6 +479,25 @@ gst_app_src_class_init (GstAppSrcClass * klass)
           G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
           G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAppSrc:lock-free:
+   *
+   * Queue buffers pushed by the application without taking the internal
+   * queue lock as long as the queue is below #GstAppSrc:max-bytes. The
+   * streaming thread is then only woken up when the queue goes from empty to
+   * non-empty, which reduces lock contention and wakeups when pushing at
+   * high buffer rates. Full queues, blocking, flushing, EOS and segment
+   * changes are still handled with the lock held. With several threads
+   * pushing concurrently max-bytes can be exceeded by at most one buffer per
+   * thread.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_LOCK_FREE,
+      g_param_spec_boolean ("lock-free", "Lock Free",
+          "Queue buffers without taking the queue lock when possible",
+          DEFAULT_PROP_LOCK_FREE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstAppSrc:need-data:
    * @appsrc: the appsrc element that emitted the signal
@@ -629,8 +660,9 @@ gst_app_src_init (GstAppSrc * appsrc)
 
   g_mutex_init (&priv->mutex);
   g_cond_init (&priv->cond);
-  priv->queue = gst_queue_array_new (16);
+  priv->queue = gst_atomic_queue_new (16);
   priv->wait_status = NOONE_WAITING;
+  priv->lock_free = DEFAULT_PROP_LOCK_FREE;
 
   priv->size = DEFAULT_PROP_SIZE;
   priv->duration = DEFAULT_PROP_DURATION;
@@ -647,6 +679,59 @@ gst_app_src_init (GstAppSrc * appsrc)
   gst_base_src_set_live (GST_BASE_SRC (appsrc), DEFAULT_PROP_IS_LIVE);
 }
 
+#define QUEUED_BYTES(priv) \
+    ((gsize) g_atomic_pointer_get (&(priv)->queued_bytes))
+#define QUEUE_IS_EMPTY(priv) (g_atomic_int_get (&(priv)->queue_len) <= 0)
+
+/* Called with priv->mutex, or without it from the lock-free push path.
+ * Returns TRUE if the queue was empty before */
+static gboolean
+gst_app_src_queue_push (GstAppSrc * src, gpointer obj)
+{
+  GstAppSrcPrivate *priv = src->priv;
+
+  gst_atomic_queue_push (priv->queue, obj);
+
+  /* the length is only incremented once @obj can be popped, it can
+   * temporarily drop below zero if the streaming thread popped it already */
+  return g_atomic_int_add (&priv->queue_len, 1) <= 0;
+}
+
+/* Must be called with priv->mutex */
+static GstMiniObject *
+gst_app_src_queue_pop (GstAppSrc * src)
+{
+  GstAppSrcPrivate *priv = src->priv;
+  GstMiniObject *obj;
+
+  obj = gst_atomic_queue_pop (priv->queue);
+  if (obj)
+    g_atomic_int_add (&priv->queue_len, -1);
+
+  return obj;
+}
+
+/* Returns the size of a popped queue item. Buffer lists that were queued
+ * by us carry the size they were accounted with, so that they don't have to
+ * be walked again. */
+static gsize
+gst_app_src_get_object_size (GstMiniObject * obj)
+{
+  if (GST_IS_BUFFER (obj)) {
+    return gst_buffer_get_size (GST_BUFFER_CAST (obj));
+  } else if (GST_IS_BUFFER_LIST (obj)) {
+    gsize size =
+        GPOINTER_TO_SIZE (gst_mini_object_steal_qdata (obj, list_size_quark));
+
+    if (size > 0)
+      return size;
+
+    return gst_buffer_list_calculate_size (GST_BUFFER_LIST_CAST (obj));
+  }
+
+  return 0;
+}
+
 /* Must be called with priv->mutex */
 static void
 gst_app_src_flush_queued (GstAppSrc * src, gboolean retain_last_caps)
@@ -654,22 +739,23 @@ gst_app_src_flush_queued (GstAppSrc * src, gboolean retain_last_caps)
   GstMiniObject *obj;
   GstAppSrcPrivate *priv = src->priv;
   GstCaps *requeue_caps = NULL;
+  gsize flushed_bytes = 0;
 
-  while (!gst_queue_array_is_empty (priv->queue)) {
-    obj = gst_queue_array_pop_head (priv->queue);
-    if (obj) {
-      if (GST_IS_CAPS (obj) && retain_last_caps) {
-        gst_caps_replace (&requeue_caps, GST_CAPS_CAST (obj));
-      }
-      gst_mini_object_unref (obj);
+  while ((obj = gst_app_src_queue_pop (src))) {
+    if (GST_IS_CAPS (obj) && retain_last_caps) {
+      gst_caps_replace (&requeue_caps, GST_CAPS_CAST (obj));
     }
+    flushed_bytes += gst_app_src_get_object_size (obj);
+    gst_mini_object_unref (obj);
   }
 
   if (requeue_caps) {
-    gst_queue_array_push_tail (priv->queue, requeue_caps);
+    gst_app_src_queue_push (src, requeue_caps);
   }
 
-  priv->queued_bytes = 0;
+  /* only subtract what was flushed, in lock-free mode the application might
+   * have accounted a buffer that it did not push yet */
+  g_atomic_pointer_add (&priv->queued_bytes, -(gssize) flushed_bytes);
 }
 
 static void
@@ -709,7 +795,7 @@ gst_app_src_finalize (GObject * obj)
 
   g_mutex_clear (&priv->mutex);
   g_cond_clear (&priv->cond);
-  gst_queue_array_free (priv->queue);
+  gst_atomic_queue_unref (priv->queue);
 
   g_free (priv->uri);
 
@@ -792,6 +878,9 @@ gst_app_src_set_property (GObject * object, guint prop_id,
     case PROP_HANDLE_SEGMENT_CHANGE:
       priv->handle_segment_change = g_value_get_boolean (value);
       break;
+    case PROP_LOCK_FREE:
+      priv->lock_free = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -858,6 +947,9 @@ gst_app_src_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_HANDLE_SEGMENT_CHANGE:
       g_value_set_boolean (value, priv->handle_segment_change);
       break;
+    case PROP_LOCK_FREE:
+      g_value_set_boolean (value, priv->lock_free);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1262,14 +1354,24 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
 
   while (TRUE) {
     /* return data as long as we have some */
-    if (!gst_queue_array_is_empty (priv->queue)) {
+    if (!QUEUE_IS_EMPTY (priv)) {
       guint buf_size;
-      GstMiniObject *obj = gst_queue_array_pop_head (priv->queue);
+      gsize queued;
+      GstMiniObject *obj = gst_app_src_queue_pop (appsrc);
 
       if (GST_IS_CAPS (obj)) {
         GstCaps *next_caps = GST_CAPS (obj);
+        GstMiniObject *next = gst_atomic_queue_peek (priv->queue);
         gboolean caps_changed = TRUE;
 
+        /* caps directly followed by other caps are never used */
+        if (next && GST_IS_CAPS (next)) {
+          GST_DEBUG_OBJECT (appsrc, "skipping replaced caps %" GST_PTR_FORMAT,
+              next_caps);
+          gst_caps_unref (next_caps);
+          continue;
+        }
+
         if (next_caps && priv->current_caps)
           caps_changed = !gst_caps_is_equal (next_caps, priv->current_caps);
         else
@@ -1304,7 +1406,7 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
 
         buffer_list = GST_BUFFER_LIST (obj);
 
-        buf_size = gst_buffer_list_calculate_size (buffer_list);
+        buf_size = gst_app_src_get_object_size (obj);
 
         GST_LOG_OBJECT (appsrc, "have buffer list %p of size %u, %u buffers",
             buffer_list, buf_size, gst_buffer_list_length (buffer_list));
@@ -1336,19 +1438,22 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
         g_assert_not_reached ();
       }
 
-      priv->queued_bytes -= buf_size;
+      queued = g_atomic_pointer_add (&priv->queued_bytes,
+          -(gssize) buf_size) - buf_size;
 
       /* only update the offset when in random_access mode */
       if (priv->stream_type == GST_APP_STREAM_TYPE_RANDOM_ACCESS)
         priv->offset += buf_size;
 
-      /* signal that we removed an item */
-      if ((priv->wait_status & APP_WAITING))
+      /* signal that there is free space again, the application only waits
+       * while the queue is filled */
+      if ((priv->wait_status & APP_WAITING) && (!priv->max_bytes
+              || queued < priv->max_bytes))
         g_cond_broadcast (&priv->cond);
 
       /* see if we go lower than the min-percent */
       if (priv->min_percent && priv->max_bytes) {
-        if (priv->queued_bytes * 100 / priv->max_bytes <= priv->min_percent)
+        if ((guint64) queued * 100 / priv->max_bytes <= priv->min_percent)
           /* ignore flushing state, we got a buffer and we will return it now.
            * Errors will be handled in the next round */
           gst_app_src_emit_need_data (appsrc, size);
@@ -1367,7 +1472,7 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
        * signal) we can still be empty because the pushed buffer got flushed or
        * when the application pushes the requested buffer later, we support both
        * possibilities. */
-      if (!gst_queue_array_is_empty (priv->queue))
+      if (!QUEUE_IS_EMPTY (priv))
         continue;
 
       /* no buffer yet, maybe we are EOS, if not, block for more data. */
@@ -1447,18 +1552,15 @@ gst_app_src_set_caps (GstAppSrc * appsrc, const GstCaps * caps)
 
   if (caps_changed) {
     GstCaps *new_caps;
-    gpointer t;
 
     new_caps = caps ? gst_caps_copy (caps) : NULL;
     GST_DEBUG_OBJECT (appsrc, "setting caps to %" GST_PTR_FORMAT, caps);
 
-    while ((t = gst_queue_array_peek_tail (priv->queue)) && GST_IS_CAPS (t)) {
-      gst_caps_unref (gst_queue_array_pop_tail (priv->queue));
-    }
-    gst_queue_array_push_tail (priv->queue, new_caps);
+    /* caps that are replaced before any data was pushed are skipped by the
+     * streaming thread */
     gst_caps_replace (&priv->last_caps, new_caps);
-
-    if ((priv->wait_status & STREAM_WAITING))
+    if (new_caps && gst_app_src_queue_push (appsrc, new_caps)
+        && (priv->wait_status & STREAM_WAITING))
       g_cond_broadcast (&priv->cond);
   }
 
@@ -1725,7 +1827,7 @@ gst_app_src_get_current_level_bytes (GstAppSrc * appsrc)
   priv = appsrc->priv;
 
   GST_OBJECT_LOCK (appsrc);
-  queued = priv->queued_bytes;
+  queued = QUEUED_BYTES (priv);
   GST_DEBUG_OBJECT (appsrc, "current level bytes is %" G_GUINT64_FORMAT,
       queued);
   GST_OBJECT_UNLOCK (appsrc);
@@ -1847,12 +1949,64 @@ gst_app_src_get_emit_signals (GstAppSrc * appsrc)
   return result;
 }
 
+/* Queues @buffer or @buflist without taking the mutex. This is only done as
+ * long as the queue is below max-bytes and no flushing, EOS or pending
+ * segment has to be handled, FALSE is returned otherwise and the caller has
+ * to take the locked path. */
+static gboolean
+gst_app_src_try_push_lock_free (GstAppSrc * appsrc, GstBuffer * buffer,
+    GstBufferList * buflist, gboolean steal_ref, gsize size)
+{
+  GstAppSrcPrivate *priv = appsrc->priv;
+  GstMiniObject *obj;
+  guint64 max_bytes;
+
+  if (G_UNLIKELY (g_atomic_int_get (&priv->flushing)
+          || g_atomic_int_get (&priv->is_eos)
+          || g_atomic_int_get (&priv->pending_custom_segment)))
+    return FALSE;
+
+  max_bytes = priv->max_bytes;
+  if (max_bytes && QUEUED_BYTES (priv) >= max_bytes)
+    return FALSE;
+
+  if (buflist != NULL) {
+    GST_LOG_OBJECT (appsrc, "queueing buffer list %p lock-free", buflist);
+    if (!steal_ref)
+      gst_buffer_list_ref (buflist);
+    obj = GST_MINI_OBJECT_CAST (buflist);
+  } else {
+    GST_LOG_OBJECT (appsrc, "queueing buffer %p lock-free", buffer);
+    if (!steal_ref)
+      gst_buffer_ref (buffer);
+    obj = GST_MINI_OBJECT_CAST (buffer);
+  }
+
+  /* account the size before the streaming thread can pop and subtract it */
+  g_atomic_pointer_add (&priv->queued_bytes, size);
+
+  /* the streaming thread only waits when the queue is empty, so it only
+   * needs to be woken up when the first item is queued */
+  if (gst_app_src_queue_push (appsrc, obj)) {
+    g_mutex_lock (&priv->mutex);
+    if ((priv->wait_status & STREAM_WAITING))
+      g_cond_broadcast (&priv->cond);
+    g_mutex_unlock (&priv->mutex);
+  }
+
+  return TRUE;
+}
+
+/* @size is the size of @buffer or @buflist if known by the caller, or -1.
+ * It is computed only once and a buffer list is accounted as one item */
 static GstFlowReturn
 gst_app_src_push_internal (GstAppSrc * appsrc, GstBuffer * buffer,
-    GstBufferList * buflist, gboolean steal_ref)
+    GstBufferList * buflist, gboolean steal_ref, gssize size)
 {
   gboolean first = TRUE;
+  gboolean was_empty;
   GstAppSrcPrivate *priv;
+  gsize queued;
 
   g_return_val_if_fail (GST_IS_APP_SRC (appsrc), GST_FLOW_ERROR);
 
@@ -1864,12 +2018,27 @@ gst_app_src_push_internal (GstAppSrc * appsrc, GstBuffer * buffer,
     g_return_val_if_fail (GST_IS_BUFFER_LIST (buflist), GST_FLOW_ERROR);
 
   if (buflist != NULL) {
-    if (gst_buffer_list_length (buflist) == 0)
+    if (gst_buffer_list_length (buflist) == 0) {
+      if (steal_ref)
+        gst_buffer_list_unref (buflist);
       return GST_FLOW_OK;
+    }
 
     buffer = gst_buffer_list_get (buflist, 0);
   }
 
+  if (size < 0) {
+    if (buflist != NULL)
+      size = gst_buffer_list_calculate_size (buflist);
+    else
+      size = gst_buffer_get_size (buffer);
+  }
+
+  /* remember the size of lists we own for when they are dequeued */
+  if (buflist != NULL && steal_ref)
+    gst_mini_object_set_qdata (GST_MINI_OBJECT_CAST (buflist),
+        list_size_quark, GSIZE_TO_POINTER (size), NULL);
+
   if (GST_BUFFER_DTS (buffer) == GST_CLOCK_TIME_NONE &&
       GST_BUFFER_PTS (buffer) == GST_CLOCK_TIME_NONE &&
       gst_base_src_get_do_timestamp (GST_BASE_SRC_CAST (appsrc))) {
@@ -1915,6 +2084,11 @@ gst_app_src_push_internal (GstAppSrc * appsrc, GstBuffer * buffer,
     }
   }
 
+  if (priv->lock_free
+      && gst_app_src_try_push_lock_free (appsrc, buffer, buflist, steal_ref,
+          size))
+    return GST_FLOW_OK;
+
   g_mutex_lock (&priv->mutex);
 
   while (TRUE) {
@@ -1925,10 +2099,11 @@ gst_app_src_push_internal (GstAppSrc * appsrc, GstBuffer * buffer,
     if (priv->is_eos)
       goto eos;
 
-    if (priv->max_bytes && priv->queued_bytes >= priv->max_bytes) {
+    queued = QUEUED_BYTES (priv);
+    if (priv->max_bytes && queued >= priv->max_bytes) {
       GST_DEBUG_OBJECT (appsrc,
-          "queue filled (%" G_GUINT64_FORMAT " >= %" G_GUINT64_FORMAT ")",
-          priv->queued_bytes, priv->max_bytes);
+          "queue filled (%" G_GSIZE_FORMAT " >= %" G_GUINT64_FORMAT ")",
+          queued, priv->max_bytes);
 
       if (first) {
         Callbacks *callbacks = NULL;
@@ -1970,11 +2145,12 @@ gst_app_src_push_internal (GstAppSrc * appsrc, GstBuffer * buffer,
       break;
   }
 
+  was_empty = FALSE;
   if (priv->pending_custom_segment) {
     GstEvent *event = gst_event_new_segment (&priv->last_segment);
 
     GST_DEBUG_OBJECT (appsrc, "enqueue new segment %" GST_PTR_FORMAT, event);
-    gst_queue_array_push_tail (priv->queue, event);
+    was_empty = gst_app_src_queue_push (appsrc, event);
     priv->pending_custom_segment = FALSE;
   }
 
@@ -1982,17 +2158,18 @@ gst_app_src_push_internal (GstAppSrc * appsrc, GstBuffer * buffer,
     GST_DEBUG_OBJECT (appsrc, "queueing buffer list %p", buflist);
     if (!steal_ref)
       gst_buffer_list_ref (buflist);
-    gst_queue_array_push_tail (priv->queue, buflist);
-    priv->queued_bytes += gst_buffer_list_calculate_size (buflist);
+    g_atomic_pointer_add (&priv->queued_bytes, size);
+    was_empty |= gst_app_src_queue_push (appsrc, buflist);
   } else {
     GST_DEBUG_OBJECT (appsrc, "queueing buffer %p", buffer);
     if (!steal_ref)
       gst_buffer_ref (buffer);
-    gst_queue_array_push_tail (priv->queue, buffer);
-    priv->queued_bytes += gst_buffer_get_size (buffer);
+    g_atomic_pointer_add (&priv->queued_bytes, size);
+    was_empty |= gst_app_src_queue_push (appsrc, buffer);
   }
 
-  if ((priv->wait_status & STREAM_WAITING))
+  /* the streaming thread only waits while the queue is empty */
+  if (was_empty && (priv->wait_status & STREAM_WAITING))
     g_cond_broadcast (&priv->cond);
 
   g_mutex_unlock (&priv->mutex);
@@ -2022,7 +2199,7 @@ static GstFlowReturn
 gst_app_src_push_buffer_full (GstAppSrc * appsrc, GstBuffer * buffer,
     gboolean steal_ref)
 {
-  return gst_app_src_push_internal (appsrc, buffer, NULL, steal_ref);
+  return gst_app_src_push_internal (appsrc, buffer, NULL, steal_ref, -1);
 }
 
 static GstFlowReturn
@@ -2072,7 +2249,7 @@ handle_buffer:
 
   buffer_list = gst_sample_get_buffer_list (sample);
   if (buffer_list != NULL)
-    return gst_app_src_push_internal (appsrc, NULL, buffer_list, FALSE);
+    return gst_app_src_push_internal (appsrc, NULL, buffer_list, FALSE, -1);
 
   GST_WARNING_OBJECT (appsrc, "received sample without buffer or buffer list");
   return GST_FLOW_OK;
@@ -2120,7 +2297,96 @@ gst_app_src_push_buffer (GstAppSrc * appsrc, GstBuffer * buffer)
 GstFlowReturn
 gst_app_src_push_buffer_list (GstAppSrc * appsrc, GstBufferList * buffer_list)
 {
-  return gst_app_src_push_internal (appsrc, NULL, buffer_list, TRUE);
+  return gst_app_src_push_internal (appsrc, NULL, buffer_list, TRUE, -1);
+}
+
+/**
+ * gst_app_src_push_buffer_frames:
+ * @appsrc: a #GstAppSrc
+ * @buffer: (transfer full): a #GstBuffer containing consecutive frames
+ * @offsets: (array length=n_offsets) (nullable): start offsets of the frames
+ *     in @buffer, in increasing order
+ * @n_offsets: the number of frames
+ *
+ * Splits @buffer into @n_offsets frames and adds them as one #GstBufferList
+ * to the queue of buffers and buffer lists that the appsrc element will push
+ * to its source pad. Frame i covers the bytes from @offsets[i] up to
+ * @offsets[i + 1], or up to the end of @buffer for the last frame. Bytes of
+ * @buffer before @offsets[0] are not pushed.
+ *
+ * The frames share the memory of @buffer so no data is copied, which makes
+ * this efficient for packetised producers that generate many small frames
+ * into one larger memory region, e.g. RTP packets. Only the first frame
+ * carries the timestamps, offsets and flags of @buffer, metas of @buffer are
+ * not copied to the frames. The buffer list is queued and accounted
+ * as a single item and pushed downstream as a list.
+ *
+ * This function takes ownership of @buffer.
+ *
+ * When the block property is TRUE, this function can block until free
+ * space becomes available in the queue.
+ *
+ * Returns: #GST_FLOW_OK when the frames were successfully queued.
+ * #GST_FLOW_FLUSHING when @appsrc is not PAUSED or PLAYING.
+ * #GST_FLOW_EOS when EOS occurred.
+ * #GST_FLOW_ERROR when @offsets are not increasing or are outside of @buffer.
+ *
+ * Since: 1.20
+ */
+GstFlowReturn
+gst_app_src_push_buffer_frames (GstAppSrc * appsrc, GstBuffer * buffer,
+    const gsize * offsets, guint n_offsets)
+{
+  GstBufferList *buffer_list;
+  GstBuffer *frame;
+  gsize size;
+  guint i;
+
+  g_return_val_if_fail (GST_IS_APP_SRC (appsrc), GST_FLOW_ERROR);
+  g_return_val_if_fail (GST_IS_BUFFER (buffer), GST_FLOW_ERROR);
+  g_return_val_if_fail (offsets != NULL || n_offsets == 0, GST_FLOW_ERROR);
+
+  if (n_offsets == 0) {
+    gst_buffer_unref (buffer);
+    return GST_FLOW_OK;
+  }
+
+  size = gst_buffer_get_size (buffer);
+  buffer_list = gst_buffer_list_new_sized (n_offsets);
+
+  for (i = 0; i < n_offsets; i++) {
+    gsize start = offsets[i];
+    gsize end = (i + 1 < n_offsets) ? offsets[i + 1] : size;
+
+    if (G_UNLIKELY (start > end || end > size))
+      goto invalid_offsets;
+
+    /* only the first frame carries the timestamps and flags of @buffer,
+     * metas describe all of @buffer and are not copied */
+    frame = gst_buffer_copy_region (buffer, GST_BUFFER_COPY_MEMORY, start,
+        end - start);
+    if (i == 0)
+      gst_buffer_copy_into (frame, buffer,
+          GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS, 0, -1);
+    gst_buffer_list_add (buffer_list, frame);
+  }
+  gst_buffer_unref (buffer);
+
+  GST_LOG_OBJECT (appsrc, "pushing %u frames of %" G_GSIZE_FORMAT " bytes",
+      n_offsets, size - offsets[0]);
+
+  return gst_app_src_push_internal (appsrc, NULL, buffer_list, TRUE,
+      size - offsets[0]);
+
+  /* ERRORS */
+invalid_offsets:
+  {
+    GST_WARNING_OBJECT (appsrc, "invalid frame offset %u for buffer of size %"
+        G_GSIZE_FORMAT, i, size);
+    gst_buffer_list_unref (buffer_list);
+    gst_buffer_unref (buffer);
+    return GST_FLOW_ERROR;
+  }
 }
 
 /**
@@ -2167,7 +2433,7 @@ static GstFlowReturn
 gst_app_src_push_buffer_list_action (GstAppSrc * appsrc,
     GstBufferList * buffer_list)
 {
-  return gst_app_src_push_internal (appsrc, NULL, buffer_list, FALSE);
+  return gst_app_src_push_internal (appsrc, NULL, buffer_list, FALSE, -1);
 }
 
 /* push a sample without stealing the ref. This is used for the
@@ -172,6 +172,10 @@ GstFlowReturn    gst_app_src_push_buffer             (GstAppSrc *appsrc, GstBuff
 GST_APP_API
 GstFlowReturn    gst_app_src_push_buffer_list        (GstAppSrc * appsrc, GstBufferList * buffer_list);
 
+GST_APP_API
+GstFlowReturn    gst_app_src_push_buffer_frames      (GstAppSrc * appsrc, GstBuffer * buffer,
+                                                      const gsize * offsets, guint n_offsets);
+
 GST_APP_API
 GstFlowReturn    gst_app_src_end_of_stream           (GstAppSrc *appsrc);
 
@@ -589,48 +589,13 @@ do_quantize (AudioChain * chain, gpointer user_data)
   return TRUE;
 }
 
-#define MAKE_INTERLEAVE_FUNC(type) \
-static inline void \
-interleave_##type (const type * in[], type * out[], \
-    gsize num_samples, gint channels) \
-{ \
-  gsize s; \
-  gint c; \
-  for (s = 0; s < num_samples; s++) { \
-    for (c = 0; c < channels; c++) { \
-      out[0][s * channels + c] = in[c][s]; \
-    } \
-  } \
-}
-
-#define MAKE_DEINTERLEAVE_FUNC(type) \
-static inline void \
-deinterleave_##type (const type * in[], type * out[], \
-    gsize num_samples, gint channels) \
-{ \
-  gsize s; \
-  gint c; \
-  for (s = 0; s < num_samples; s++) { \
-    for (c = 0; c < channels; c++) { \
-      out[c][s] = in[0][s * channels + c]; \
-    } \
-  } \
-}
-
-MAKE_INTERLEAVE_FUNC (gint16);
-MAKE_INTERLEAVE_FUNC (gint32);
-MAKE_INTERLEAVE_FUNC (gfloat);
-MAKE_INTERLEAVE_FUNC (gdouble);
-MAKE_DEINTERLEAVE_FUNC (gint16);
-MAKE_DEINTERLEAVE_FUNC (gint32);
-MAKE_DEINTERLEAVE_FUNC (gfloat);
-MAKE_DEINTERLEAVE_FUNC (gdouble);
-
 static gboolean
 do_change_layout (AudioChain * chain, gpointer user_data)
 {
   GstAudioConverter *convert = user_data;
-  GstAudioFormat format = convert->chlayout_format;
+  guint width =
+      GST_AUDIO_FORMAT_INFO_WIDTH (gst_audio_format_get_info
+      (convert->chlayout_format));
   GstAudioLayout out_layout = convert->chlayout_target;
   gint channels = convert->chlayout_channels;
   gsize num_samples;
@@ -642,51 +607,13 @@ do_change_layout (AudioChain * chain, gpointer user_data)
   if (out_layout == GST_AUDIO_LAYOUT_INTERLEAVED) {
     /* interleave */
     GST_LOG ("interleaving %p, %p %" G_GSIZE_FORMAT, in, out, num_samples);
-    switch (format) {
-      case GST_AUDIO_FORMAT_S16:
-        interleave_gint16 ((const gint16 **) in, (gint16 **) out,
-            num_samples, channels);
-        break;
-      case GST_AUDIO_FORMAT_S32:
-        interleave_gint32 ((const gint32 **) in, (gint32 **) out,
-            num_samples, channels);
-        break;
-      case GST_AUDIO_FORMAT_F32:
-        interleave_gfloat ((const gfloat **) in, (gfloat **) out,
-            num_samples, channels);
-        break;
-      case GST_AUDIO_FORMAT_F64:
-        interleave_gdouble ((const gdouble **) in, (gdouble **) out,
-            num_samples, channels);
-        break;
-      default:
-        g_assert_not_reached ();
-        break;
-    }
+    gst_audio_interleave_samples (width, out[0], channels, in, channels,
+        num_samples);
   } else {
     /* deinterleave */
     GST_LOG ("deinterleaving %p, %p %" G_GSIZE_FORMAT, in, out, num_samples);
-    switch (format) {
-      case GST_AUDIO_FORMAT_S16:
-        deinterleave_gint16 ((const gint16 **) in, (gint16 **) out,
-            num_samples, channels);
-        break;
-      case GST_AUDIO_FORMAT_S32:
-        deinterleave_gint32 ((const gint32 **) in, (gint32 **) out,
-            num_samples, channels);
-        break;
-      case GST_AUDIO_FORMAT_F32:
-        deinterleave_gfloat ((const gfloat **) in, (gfloat **) out,
-            num_samples, channels);
-        break;
-      case GST_AUDIO_FORMAT_F64:
-        deinterleave_gdouble ((const gdouble **) in, (gdouble **) out,
-            num_samples, channels);
-        break;
-      default:
-        g_assert_not_reached ();
-        break;
-    }
+    gst_audio_deinterleave_samples (width, out, channels, in[0], channels,
+        num_samples);
   }
 
   audio_chain_set_samples (chain, out, num_samples);
@@ -33,6 +33,14 @@
 #include "audio.h"
 #include "audio-enumtypes.h"
 
+#if defined (HAVE_EMMINTRIN_H) && defined (__SSE2__)
+#  include <emmintrin.h>
+#  define INTERLEAVE_SSE2
+#elif defined (HAVE_ARM_NEON) || defined (__aarch64__)
+#  include <arm_neon.h>
+#  define INTERLEAVE_NEON
+#endif
+
 #ifndef GST_DISABLE_GST_DEBUG
 #define GST_CAT_DEFAULT ensure_debug_category()
 static GstDebugCategory *
@@ -310,3 +318,599 @@ gst_audio_buffer_truncate (GstBuffer * buffer, gint bpf, gsize trim,
 
   return ret;
 }
+
+/* (De)interleaving is done in blocks of frames that keep the interleaved
+ * side of the block in the cache while all channels are transposed into or
+ * out of it. Writing a whole channel at a time instead touches a different
+ * cache line for every sample once there are more than a few channels.
+ * Within a block, groups of channels are transposed with SIMD where
+ * possible. */
+#define INTERLEAVE_BLOCK_BYTES 16384
+
+static inline gsize
+interleave_block_frames (gsize stride, gsize bytes)
+{
+  gsize frames = INTERLEAVE_BLOCK_BYTES / (stride * bytes);
+
+  return CLAMP (frames, 8, 1024) & ~7;
+}
+
+/* 4 channels of 16 bits, @out + f * @stride + c = @in[c][f] */
+static inline void
+interleave_group_16 (guint16 * out, gsize stride, gpointer in[], gsize offset,
+    gsize n_frames)
+{
+  const guint16 *i0 = (const guint16 *) in[0] + offset;
+  const guint16 *i1 = (const guint16 *) in[1] + offset;
+  const guint16 *i2 = (const guint16 *) in[2] + offset;
+  const guint16 *i3 = (const guint16 *) in[3] + offset;
+  gsize f = 0;
+
+#if defined (INTERLEAVE_SSE2)
+  for (; f + 8 <= n_frames; f += 8) {
+    __m128i a, b, c, d, ab0, ab1, cd0, cd1, v0, v1, v2, v3;
+    guint16 *o = out + f * stride;
+
+    a = _mm_loadu_si128 ((const __m128i *) (i0 + f));
+    b = _mm_loadu_si128 ((const __m128i *) (i1 + f));
+    c = _mm_loadu_si128 ((const __m128i *) (i2 + f));
+    d = _mm_loadu_si128 ((const __m128i *) (i3 + f));
+    ab0 = _mm_unpacklo_epi16 (a, b);
+    ab1 = _mm_unpackhi_epi16 (a, b);
+    cd0 = _mm_unpacklo_epi16 (c, d);
+    cd1 = _mm_unpackhi_epi16 (c, d);
+    v0 = _mm_unpacklo_epi32 (ab0, cd0);
+    v1 = _mm_unpackhi_epi32 (ab0, cd0);
+    v2 = _mm_unpacklo_epi32 (ab1, cd1);
+    v3 = _mm_unpackhi_epi32 (ab1, cd1);
+    _mm_storel_epi64 ((__m128i *) (o + 0 * stride), v0);
+    _mm_storel_epi64 ((__m128i *) (o + 1 * stride), _mm_unpackhi_epi64 (v0,
+            v0));
+    _mm_storel_epi64 ((__m128i *) (o + 2 * stride), v1);
+    _mm_storel_epi64 ((__m128i *) (o + 3 * stride), _mm_unpackhi_epi64 (v1,
+            v1));
+    _mm_storel_epi64 ((__m128i *) (o + 4 * stride), v2);
+    _mm_storel_epi64 ((__m128i *) (o + 5 * stride), _mm_unpackhi_epi64 (v2,
+            v2));
+    _mm_storel_epi64 ((__m128i *) (o + 6 * stride), v3);
+    _mm_storel_epi64 ((__m128i *) (o + 7 * stride), _mm_unpackhi_epi64 (v3,
+            v3));
+  }
+#elif defined (INTERLEAVE_NEON)
+  for (; f + 8 <= n_frames; f += 8) {
+    uint16x8x2_t ab, cd;
+    uint32x4x2_t lo, hi;
+    guint16 *o = out + f * stride;
+
+    ab = vzipq_u16 (vld1q_u16 (i0 + f), vld1q_u16 (i1 + f));
+    cd = vzipq_u16 (vld1q_u16 (i2 + f), vld1q_u16 (i3 + f));
+    lo = vzipq_u32 (vreinterpretq_u32_u16 (ab.val[0]),
+        vreinterpretq_u32_u16 (cd.val[0]));
+    hi = vzipq_u32 (vreinterpretq_u32_u16 (ab.val[1]),
+        vreinterpretq_u32_u16 (cd.val[1]));
+    vst1_u16 (o + 0 * stride, vget_low_u16 (vreinterpretq_u16_u32 (lo.val[0])));
+    vst1_u16 (o + 1 * stride, vget_high_u16 (vreinterpretq_u16_u32 (lo.val[0])));
+    vst1_u16 (o + 2 * stride, vget_low_u16 (vreinterpretq_u16_u32 (lo.val[1])));
+    vst1_u16 (o + 3 * stride, vget_high_u16 (vreinterpretq_u16_u32 (lo.val[1])));
+    vst1_u16 (o + 4 * stride, vget_low_u16 (vreinterpretq_u16_u32 (hi.val[0])));
+    vst1_u16 (o + 5 * stride, vget_high_u16 (vreinterpretq_u16_u32 (hi.val[0])));
+    vst1_u16 (o + 6 * stride, vget_low_u16 (vreinterpretq_u16_u32 (hi.val[1])));
+    vst1_u16 (o + 7 * stride, vget_high_u16 (vreinterpretq_u16_u32 (hi.val[1])));
+  }
+#endif
+  for (; f < n_frames; f++) {
+    guint16 *o = out + f * stride;
+
+    o[0] = i0[f];
+    o[1] = i1[f];
+    o[2] = i2[f];
+    o[3] = i3[f];
+  }
+}
+
+/* 4 channels of 16 bits, @out[c][f] = @in + f * @stride + c */
+static inline void
+deinterleave_group_16 (gpointer out[], const guint16 * in, gsize stride,
+    gsize offset, gsize n_frames)
+{
+  guint16 *o0 = (guint16 *) out[0] + offset;
+  guint16 *o1 = (guint16 *) out[1] + offset;
+  guint16 *o2 = (guint16 *) out[2] + offset;
+  guint16 *o3 = (guint16 *) out[3] + offset;
+  gsize f = 0;
+
+#if defined (INTERLEAVE_SSE2)
+  for (; f + 8 <= n_frames; f += 8) {
+    __m128i v0, v1, v2, v3, w0, w1, x0, x1, y0, y1;
+    const guint16 *i = in + f * stride;
+
+    v0 = _mm_unpacklo_epi64 (_mm_loadl_epi64 ((const __m128i *) i),
+        _mm_loadl_epi64 ((const __m128i *) (i + stride)));
+    v1 = _mm_unpacklo_epi64 (_mm_loadl_epi64 ((const __m128i *) (i +
+                2 * stride)), _mm_loadl_epi64 ((const __m128i *) (i +
+                3 * stride)));
+    v2 = _mm_unpacklo_epi64 (_mm_loadl_epi64 ((const __m128i *) (i +
+                4 * stride)), _mm_loadl_epi64 ((const __m128i *) (i +
+                5 * stride)));
+    v3 = _mm_unpacklo_epi64 (_mm_loadl_epi64 ((const __m128i *) (i +
+                6 * stride)), _mm_loadl_epi64 ((const __m128i *) (i +
+                7 * stride)));
+    /* a0 a2 b0 b2 c0 c2 d0 d2 and a1 a3 b1 b3 c1 c3 d1 d3 */
+    w0 = _mm_unpacklo_epi16 (v0, v1);
+    w1 = _mm_unpackhi_epi16 (v0, v1);
+    /* a0 a1 a2 a3 b0 b1 b2 b3 and c0 c1 c2 c3 d0 d1 d2 d3 */
+    x0 = _mm_unpacklo_epi16 (w0, w1);
+    x1 = _mm_unpackhi_epi16 (w0, w1);
+    w0 = _mm_unpacklo_epi16 (v2, v3);
+    w1 = _mm_unpackhi_epi16 (v2, v3);
+    y0 = _mm_unpacklo_epi16 (w0, w1);
+    y1 = _mm_unpackhi_epi16 (w0, w1);
+    _mm_storeu_si128 ((__m128i *) (o0 + f), _mm_unpacklo_epi64 (x0, y0));
+    _mm_storeu_si128 ((__m128i *) (o1 + f), _mm_unpackhi_epi64 (x0, y0));
+    _mm_storeu_si128 ((__m128i *) (o2 + f), _mm_unpacklo_epi64 (x1, y1));
+    _mm_storeu_si128 ((__m128i *) (o3 + f), _mm_unpackhi_epi64 (x1, y1));
+  }
+#elif defined (INTERLEAVE_NEON)
+  for (; f + 8 <= n_frames; f += 8) {
+    uint16x8_t v0, v1, v2, v3;
+    uint16x8x2_t p, q, ac, bd;
+    const guint16 *i = in + f * stride;
+
+    v0 = vcombine_u16 (vld1_u16 (i), vld1_u16 (i + stride));
+    v1 = vcombine_u16 (vld1_u16 (i + 2 * stride), vld1_u16 (i + 3 * stride));
+    v2 = vcombine_u16 (vld1_u16 (i + 4 * stride), vld1_u16 (i + 5 * stride));
+    v3 = vcombine_u16 (vld1_u16 (i + 6 * stride), vld1_u16 (i + 7 * stride));
+    /* a0 c0 a1 c1 a2 c2 a3 c3 and b0 d0 b1 d1 b2 d2 b3 d3 */
+    p = vuzpq_u16 (v0, v1);
+    q = vuzpq_u16 (v2, v3);
+    ac = vuzpq_u16 (p.val[0], q.val[0]);
+    bd = vuzpq_u16 (p.val[1], q.val[1]);
+    vst1q_u16 (o0 + f, ac.val[0]);
+    vst1q_u16 (o1 + f, bd.val[0]);
+    vst1q_u16 (o2 + f, ac.val[1]);
+    vst1q_u16 (o3 + f, bd.val[1]);
+  }
+#endif
+  for (; f < n_frames; f++) {
+    const guint16 *i = in + f * stride;
+
+    o0[f] = i[0];
+    o1[f] = i[1];
+    o2[f] = i[2];
+    o3[f] = i[3];
+  }
+}
+
+/* 4 channels of 32 bits, @out + f * @stride + c = @in[c][f] */
+static inline void
+interleave_group_32 (guint32 * out, gsize stride, gpointer in[], gsize offset,
+    gsize n_frames)
+{
+  const guint32 *i0 = (const guint32 *) in[0] + offset;
+  const guint32 *i1 = (const guint32 *) in[1] + offset;
+  const guint32 *i2 = (const guint32 *) in[2] + offset;
+  const guint32 *i3 = (const guint32 *) in[3] + offset;
+  gsize f = 0;
+
+#if defined (INTERLEAVE_SSE2)
+  for (; f + 4 <= n_frames; f += 4) {
+    __m128i a, b, c, d, ac0, ac1, bd0, bd1;
+    guint32 *o = out + f * stride;
+
+    a = _mm_loadu_si128 ((const __m128i *) (i0 + f));
+    b = _mm_loadu_si128 ((const __m128i *) (i1 + f));
+    c = _mm_loadu_si128 ((const __m128i *) (i2 + f));
+    d = _mm_loadu_si128 ((const __m128i *) (i3 + f));
+    ac0 = _mm_unpacklo_epi32 (a, c);
+    ac1 = _mm_unpackhi_epi32 (a, c);
+    bd0 = _mm_unpacklo_epi32 (b, d);
+    bd1 = _mm_unpackhi_epi32 (b, d);
+    _mm_storeu_si128 ((__m128i *) (o + 0 * stride),
+        _mm_unpacklo_epi32 (ac0, bd0));
+    _mm_storeu_si128 ((__m128i *) (o + 1 * stride),
+        _mm_unpackhi_epi32 (ac0, bd0));
+    _mm_storeu_si128 ((__m128i *) (o + 2 * stride),
+        _mm_unpacklo_epi32 (ac1, bd1));
+    _mm_storeu_si128 ((__m128i *) (o + 3 * stride),
+        _mm_unpackhi_epi32 (ac1, bd1));
+  }
+#elif defined (INTERLEAVE_NEON)
+  for (; f + 4 <= n_frames; f += 4) {
+    uint32x4x2_t ac, bd, lo, hi;
+    guint32 *o = out + f * stride;
+
+    ac = vzipq_u32 (vld1q_u32 (i0 + f), vld1q_u32 (i2 + f));
+    bd = vzipq_u32 (vld1q_u32 (i1 + f), vld1q_u32 (i3 + f));
+    lo = vzipq_u32 (ac.val[0], bd.val[0]);
+    hi = vzipq_u32 (ac.val[1], bd.val[1]);
+    vst1q_u32 (o + 0 * stride, lo.val[0]);
+    vst1q_u32 (o + 1 * stride, lo.val[1]);
+    vst1q_u32 (o + 2 * stride, hi.val[0]);
+    vst1q_u32 (o + 3 * stride, hi.val[1]);
+  }
+#endif
+  for (; f < n_frames; f++) {
+    guint32 *o = out + f * stride;
+
+    o[0] = i0[f];
+    o[1] = i1[f];
+    o[2] = i2[f];
+    o[3] = i3[f];
+  }
+}
+
+/* 4 channels of 32 bits, @out[c][f] = @in + f * @stride + c */
+static inline void
+deinterleave_group_32 (gpointer out[], const guint32 * in, gsize stride,
+    gsize offset, gsize n_frames)
+{
+  guint32 *o0 = (guint32 *) out[0] + offset;
+  guint32 *o1 = (guint32 *) out[1] + offset;
+  guint32 *o2 = (guint32 *) out[2] + offset;
+  guint32 *o3 = (guint32 *) out[3] + offset;
+  gsize f = 0;
+
+  /* a 4x4 transpose is its own inverse */
+#if defined (INTERLEAVE_SSE2)
+  for (; f + 4 <= n_frames; f += 4) {
+    __m128i a, b, c, d, ac0, ac1, bd0, bd1;
+    const guint32 *i = in + f * stride;
+
+    a = _mm_loadu_si128 ((const __m128i *) (i + 0 * stride));
+    b = _mm_loadu_si128 ((const __m128i *) (i + 1 * stride));
+    c = _mm_loadu_si128 ((const __m128i *) (i + 2 * stride));
+    d = _mm_loadu_si128 ((const __m128i *) (i + 3 * stride));
+    ac0 = _mm_unpacklo_epi32 (a, c);
+    ac1 = _mm_unpackhi_epi32 (a, c);
+    bd0 = _mm_unpacklo_epi32 (b, d);
+    bd1 = _mm_unpackhi_epi32 (b, d);
+    _mm_storeu_si128 ((__m128i *) (o0 + f), _mm_unpacklo_epi32 (ac0, bd0));
+    _mm_storeu_si128 ((__m128i *) (o1 + f), _mm_unpackhi_epi32 (ac0, bd0));
+    _mm_storeu_si128 ((__m128i *) (o2 + f), _mm_unpacklo_epi32 (ac1, bd1));
+    _mm_storeu_si128 ((__m128i *) (o3 + f), _mm_unpackhi_epi32 (ac1, bd1));
+  }
+#elif defined (INTERLEAVE_NEON)
+  for (; f + 4 <= n_frames; f += 4) {
+    uint32x4x2_t ac, bd, lo, hi;
+    const guint32 *i = in + f * stride;
+
+    ac = vzipq_u32 (vld1q_u32 (i + 0 * stride), vld1q_u32 (i + 2 * stride));
+    bd = vzipq_u32 (vld1q_u32 (i + 1 * stride), vld1q_u32 (i + 3 * stride));
+    lo = vzipq_u32 (ac.val[0], bd.val[0]);
+    hi = vzipq_u32 (ac.val[1], bd.val[1]);
+    vst1q_u32 (o0 + f, lo.val[0]);
+    vst1q_u32 (o1 + f, lo.val[1]);
+    vst1q_u32 (o2 + f, hi.val[0]);
+    vst1q_u32 (o3 + f, hi.val[1]);
+  }
+#endif
+  for (; f < n_frames; f++) {
+    const guint32 *i = in + f * stride;
+
+    o0[f] = i[0];
+    o1[f] = i[1];
+    o2[f] = i[2];
+    o3[f] = i[3];
+  }
+}
+
+/* 2 channels of 64 bits, @out + f * @stride + c = @in[c][f] */
+static inline void
+interleave_group_64 (guint64 * out, gsize stride, gpointer in[], gsize offset,
+    gsize n_frames)
+{
+  const guint64 *i0 = (const guint64 *) in[0] + offset;
+  const guint64 *i1 = (const guint64 *) in[1] + offset;
+  gsize f = 0;
+
+#if defined (INTERLEAVE_SSE2)
+  for (; f + 2 <= n_frames; f += 2) {
+    __m128i a, b;
+    guint64 *o = out + f * stride;
+
+    a = _mm_loadu_si128 ((const __m128i *) (i0 + f));
+    b = _mm_loadu_si128 ((const __m128i *) (i1 + f));
+    _mm_storeu_si128 ((__m128i *) o, _mm_unpacklo_epi64 (a, b));
+    _mm_storeu_si128 ((__m128i *) (o + stride), _mm_unpackhi_epi64 (a, b));
+  }
+#elif defined (INTERLEAVE_NEON)
+  for (; f + 2 <= n_frames; f += 2) {
+    uint64x2_t a, b;
+    guint64 *o = out + f * stride;
+
+    a = vld1q_u64 ((const uint64_t *) (i0 + f));
+    b = vld1q_u64 ((const uint64_t *) (i1 + f));
+    vst1q_u64 ((uint64_t *) o, vcombine_u64 (vget_low_u64 (a),
+            vget_low_u64 (b)));
+    vst1q_u64 ((uint64_t *) (o + stride), vcombine_u64 (vget_high_u64 (a),
+            vget_high_u64 (b)));
+  }
+#endif
+  for (; f < n_frames; f++) {
+    guint64 *o = out + f * stride;
+
+    o[0] = i0[f];
+    o[1] = i1[f];
+  }
+}
+
+/* 2 channels of 64 bits, @out[c][f] = @in + f * @stride + c */
+static inline void
+deinterleave_group_64 (gpointer out[], const guint64 * in, gsize stride,
+    gsize offset, gsize n_frames)
+{
+  guint64 *o0 = (guint64 *) out[0] + offset;
+  guint64 *o1 = (guint64 *) out[1] + offset;
+  gsize f = 0;
+
+#if defined (INTERLEAVE_SSE2)
+  for (; f + 2 <= n_frames; f += 2) {
+    __m128i a, b;
+    const guint64 *i = in + f * stride;
+
+    a = _mm_loadu_si128 ((const __m128i *) i);
+    b = _mm_loadu_si128 ((const __m128i *) (i + stride));
+    _mm_storeu_si128 ((__m128i *) (o0 + f), _mm_unpacklo_epi64 (a, b));
+    _mm_storeu_si128 ((__m128i *) (o1 + f), _mm_unpackhi_epi64 (a, b));
+  }
+#elif defined (INTERLEAVE_NEON)
+  for (; f + 2 <= n_frames; f += 2) {
+    uint64x2_t a, b;
+    const guint64 *i = in + f * stride;
+
+    a = vld1q_u64 ((const uint64_t *) i);
+    b = vld1q_u64 ((const uint64_t *) (i + stride));
+    vst1q_u64 ((uint64_t *) (o0 + f), vcombine_u64 (vget_low_u64 (a),
+            vget_low_u64 (b)));
+    vst1q_u64 ((uint64_t *) (o1 + f), vcombine_u64 (vget_high_u64 (a),
+            vget_high_u64 (b)));
+  }
+#endif
+  for (; f < n_frames; f++) {
+    const guint64 *i = in + f * stride;
+
+    o0[f] = i[0];
+    o1[f] = i[1];
+  }
+}
+
+#define MAKE_INTERLEAVE_FUNCS(type, bits, group) \
+static void \
+interleave_##bits (gpointer out, gsize stride, gpointer in[], \
+    guint channels, gsize n_frames) \
+{ \
+  gsize block = interleave_block_frames (stride, sizeof (type)); \
+  gsize f0, f, nf; \
+  guint c; \
+  \
+  for (f0 = 0; f0 < n_frames; f0 += block) { \
+    type *o = (type *) out + f0 * stride; \
+    \
+    nf = MIN (block, n_frames - f0); \
+    for (c = 0; c + group <= channels; c += group) \
+      interleave_group_##bits (o + c, stride, in + c, f0, nf); \
+    for (; c < channels; c++) { \
+      const type *i = (const type *) in[c] + f0; \
+      \
+      for (f = 0; f < nf; f++) \
+        o[f * stride + c] = i[f]; \
+    } \
+  } \
+} \
+\
+static void \
+deinterleave_##bits (gpointer out[], guint channels, gconstpointer in, \
+    gsize stride, gsize n_frames) \
+{ \
+  gsize block = interleave_block_frames (stride, sizeof (type)); \
+  gsize f0, f, nf; \
+  guint c; \
+  \
+  for (f0 = 0; f0 < n_frames; f0 += block) { \
+    const type *i = (const type *) in + f0 * stride; \
+    \
+    nf = MIN (block, n_frames - f0); \
+    for (c = 0; c + group <= channels; c += group) \
+      deinterleave_group_##bits (out + c, i + c, stride, f0, nf); \
+    for (; c < channels; c++) { \
+      type *o = (type *) out[c] + f0; \
+      \
+      for (f = 0; f < nf; f++) \
+        o[f] = i[f * stride + c]; \
+    } \
+  } \
+}
+
+MAKE_INTERLEAVE_FUNCS (guint16, 16, 4);
+MAKE_INTERLEAVE_FUNCS (guint32, 32, 4);
+MAKE_INTERLEAVE_FUNCS (guint64, 64, 2);
+
+/* 8 and 24 bits samples are only cache blocked */
+static void
+interleave_8 (gpointer out, gsize stride, gpointer in[], guint channels,
+    gsize n_frames)
+{
+  gsize block = interleave_block_frames (stride, 1);
+  gsize f0, f, nf;
+  guint c;
+
+  for (f0 = 0; f0 < n_frames; f0 += block) {
+    guint8 *o = (guint8 *) out + f0 * stride;
+
+    nf = MIN (block, n_frames - f0);
+    for (c = 0; c < channels; c++) {
+      const guint8 *i = (const guint8 *) in[c] + f0;
+
+      for (f = 0; f < nf; f++)
+        o[f * stride + c] = i[f];
+    }
+  }
+}
+
+static void
+deinterleave_8 (gpointer out[], guint channels, gconstpointer in,
+    gsize stride, gsize n_frames)
+{
+  gsize block = interleave_block_frames (stride, 1);
+  gsize f0, f, nf;
+  guint c;
+
+  for (f0 = 0; f0 < n_frames; f0 += block) {
+    const guint8 *i = (const guint8 *) in + f0 * stride;
+
+    nf = MIN (block, n_frames - f0);
+    for (c = 0; c < channels; c++) {
+      guint8 *o = (guint8 *) out[c] + f0;
+
+      for (f = 0; f < nf; f++)
+        o[f] = i[f * stride + c];
+    }
+  }
+}
+
+static void
+interleave_24 (gpointer out, gsize stride, gpointer in[], guint channels,
+    gsize n_frames)
+{
+  gsize block = interleave_block_frames (stride, 3);
+  gsize f0, f, nf;
+  guint c;
+
+  for (f0 = 0; f0 < n_frames; f0 += block) {
+    guint8 *o = (guint8 *) out + f0 * stride * 3;
+
+    nf = MIN (block, n_frames - f0);
+    for (c = 0; c < channels; c++) {
+      const guint8 *i = (const guint8 *) in[c] + f0 * 3;
+      guint8 *d = o + c * 3;
+
+      for (f = 0; f < nf; f++) {
+        memcpy (d, i, 3);
+        d += stride * 3;
+        i += 3;
+      }
+    }
+  }
+}
+
+static void
+deinterleave_24 (gpointer out[], guint channels, gconstpointer in,
+    gsize stride, gsize n_frames)
+{
+  gsize block = interleave_block_frames (stride, 3);
+  gsize f0, f, nf;
+  guint c;
+
+  for (f0 = 0; f0 < n_frames; f0 += block) {
+    const guint8 *i = (const guint8 *) in + f0 * stride * 3;
+
+    nf = MIN (block, n_frames - f0);
+    for (c = 0; c < channels; c++) {
+      const guint8 *s = i + c * 3;
+      guint8 *o = (guint8 *) out[c] + f0 * 3;
+
+      for (f = 0; f < nf; f++) {
+        memcpy (o, s, 3);
+        s += stride * 3;
+        o += 3;
+      }
+    }
+  }
+}
+
+/**
+ * gst_audio_interleave_samples:
+ * @width: the width of a sample in bits, one of 8, 16, 24, 32 or 64
+ * @out: the sample of the first channel to write in the first frame
+ * @out_channels: the number of channels in a frame of @out
+ * @in: (array length=in_channels): pointers to the non-interleaved samples
+ *   of each channel
+ * @in_channels: the number of channels in @in
+ * @n_frames: the number of frames to interleave
+ *
+ * Interleaves @n_frames samples of the @in_channels channels in @in into
+ * consecutive channels of @out. Sample f of @in[c] is written to sample
+ * f * @out_channels + c of @out, the other channels of @out are not
+ * touched.
+ *
+ * This works on blocks of frames so that it stays efficient for streams
+ * with many channels.
+ *
+ * Since: 1.20
+ */
+void
+gst_audio_interleave_samples (guint width, gpointer out, guint out_channels,
+    gpointer in[], guint in_channels, gsize n_frames)
+{
+  g_return_if_fail (out != NULL);
+  g_return_if_fail (in != NULL);
+  g_return_if_fail (in_channels <= out_channels);
+
+  switch (width) {
+    case 8:
+      interleave_8 (out, out_channels, in, in_channels, n_frames);
+      break;
+    case 16:
+      interleave_16 (out, out_channels, in, in_channels, n_frames);
+      break;
+    case 24:
+      interleave_24 (out, out_channels, in, in_channels, n_frames);
+      break;
+    case 32:
+      interleave_32 (out, out_channels, in, in_channels, n_frames);
+      break;
+    case 64:
+      interleave_64 (out, out_channels, in, in_channels, n_frames);
+      break;
+    default:
+      g_return_if_reached ();
+  }
+}
+
+/**
+ * gst_audio_deinterleave_samples:
+ * @width: the width of a sample in bits, one of 8, 16, 24, 32 or 64
+ * @out: (array length=out_channels): pointers to the non-interleaved samples
+ *   to write for each channel
+ * @out_channels: the number of channels in @out
+ * @in: the sample of the first channel to read in the first frame
+ * @in_channels: the number of channels in a frame of @in
+ * @n_frames: the number of frames to deinterleave
+ *
+ * Deinterleaves @n_frames samples of @out_channels consecutive channels of
+ * @in into @out. Sample f * @in_channels + c of @in is written to sample f
+ * of @out[c].
+ *
+ * This works on blocks of frames so that it stays efficient for streams
+ * with many channels.
+ *
+ * Since: 1.20
+ */
+void
+gst_audio_deinterleave_samples (guint width, gpointer out[],
+    guint out_channels, gconstpointer in, guint in_channels, gsize n_frames)
+{
+  g_return_if_fail (out != NULL);
+  g_return_if_fail (in != NULL);
+  g_return_if_fail (out_channels <= in_channels);
+
+  switch (width) {
+    case 8:
+      deinterleave_8 (out, out_channels, in, in_channels, n_frames);
+      break;
+    case 16:
+      deinterleave_16 (out, out_channels, in, in_channels, n_frames);
+      break;
+    case 24:
+      deinterleave_24 (out, out_channels, in, in_channels, n_frames);
+      break;
+    case 32:
+      deinterleave_32 (out, out_channels, in, in_channels, n_frames);
+      break;
+    case 64:
+      deinterleave_64 (out, out_channels, in, in_channels, n_frames);
+      break;
+    default:
+      g_return_if_reached ();
+  }
+}
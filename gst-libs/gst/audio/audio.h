@@ -101,6 +101,19 @@ GST_AUDIO_API
 GstBuffer *    gst_audio_buffer_truncate (GstBuffer *buffer,
                                           gint bpf, gsize trim, gsize samples);
 
+GST_AUDIO_API
+void           gst_audio_interleave_samples   (guint width, gpointer out,
+                                               guint out_channels,
+                                               gpointer in[], guint in_channels,
+                                               gsize n_frames);
+
+GST_AUDIO_API
+void           gst_audio_deinterleave_samples (guint width, gpointer out[],
+                                               guint out_channels,
+                                               gconstpointer in,
+                                               guint in_channels,
+                                               gsize n_frames);
+
 G_END_DECLS
 
 #include <gst/audio/gstaudioringbuffer.h>
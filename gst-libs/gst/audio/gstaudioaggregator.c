@@ -114,6 +114,9 @@ struct _GstAudioAggregatorPadPrivate
 
   /* A new unhandled segment event has been received */
   gboolean new_segment;
+
+  /* The current buffer only contains digital silence */
+  gboolean silent;
 };
 
 
@@ -391,13 +394,20 @@ struct _GstAudioAggregatorPrivate
   guint samples_per_buffer;
   guint error_per_buffer;
   guint accumulated_error;
+  /* Size of the output buffer being mixed, 0 if none was started yet */
   guint current_blocksize;
 
   /* Protected by srcpad stream clock */
   /* Output buffer starting at offset containing blocksize frames (calculated
-   * from output_buffer_duration) */
+   * from output_buffer_duration). Only allocated once some pad has non-silent
+   * data to mix in. */
   GstBuffer *current_buffer;
 
+  /* Read-only silence that output buffers are created from when no pad had
+   * anything to mix, must only be accessed from the aggregate thread */
+  GstMemory *silence_mem;
+  GstAudioFormat silence_format;
+
   /* counters to keep track of timestamps */
   /* Readable with object lock, writable with both aag lock and object lock */
 
@@ -653,6 +663,11 @@ gst_audio_aggregator_dispose (GObject * object)
 
   gst_clear_structure (&aagg->priv->selected_samples_info);
 
+  if (aagg->priv->silence_mem) {
+    gst_memory_unref (aagg->priv->silence_mem);
+    aagg->priv->silence_mem = NULL;
+  }
+
   g_mutex_clear (&aagg->priv->mutex);
 
   G_OBJECT_CLASS (gst_audio_aggregator_parent_class)->dispose (object);
@@ -1498,7 +1513,12 @@ gst_audio_aggregator_reset (GstAudioAggregator * aagg)
   gst_audio_info_init (&GST_AUDIO_AGGREGATOR_PAD (agg->srcpad)->info);
   gst_caps_replace (&aagg->current_caps, NULL);
   gst_buffer_replace (&aagg->priv->current_buffer, NULL);
+  aagg->priv->current_blocksize = 0;
   aagg->priv->accumulated_error = 0;
+  if (aagg->priv->silence_mem) {
+    gst_memory_unref (aagg->priv->silence_mem);
+    aagg->priv->silence_mem = NULL;
+  }
   GST_OBJECT_UNLOCK (aagg);
   GST_AUDIO_AGGREGATOR_UNLOCK (aagg);
 }
@@ -1534,6 +1554,7 @@ gst_audio_aggregator_flush (GstAggregator * agg)
   aagg->priv->offset = -1;
   aagg->priv->accumulated_error = 0;
   gst_buffer_replace (&aagg->priv->current_buffer, NULL);
+  aagg->priv->current_blocksize = 0;
   GST_OBJECT_UNLOCK (aagg);
   GST_AUDIO_AGGREGATOR_UNLOCK (aagg);
 
@@ -1779,18 +1800,85 @@ done:
   return TRUE;
 }
 
+/* Check if @buf only contains digital silence. This is the case if the first
+ * sample is silence and every following sample is identical to the one before
+ * it, which boils down to a memcmp() that bails out on the first sample with
+ * any signal. */
+static gboolean
+gst_audio_aggregator_buffer_is_silent (const GstAudioInfo * info,
+    GstBuffer * buf)
+{
+  const GstAudioFormatInfo *finfo = info->finfo;
+  guint width = GST_AUDIO_FORMAT_INFO_WIDTH (finfo) / 8;
+  gboolean silent = FALSE;
+  GstMapInfo map;
+
+  if (width == 0 || width > sizeof (finfo->silence))
+    return FALSE;
+
+  if (!gst_buffer_map (buf, &map, GST_MAP_READ))
+    return FALSE;
+
+  if (map.size >= width && map.size % width == 0)
+    silent = memcmp (map.data, finfo->silence, width) == 0 &&
+        memcmp (map.data, map.data + width, map.size - width) == 0;
+
+  gst_buffer_unmap (buf, &map);
+
+  return silent;
+}
+
+/* Create a GAP output buffer of silence that shares read-only memory, so
+ * that nothing needs to be allocated or written when all pads are silent.
+ * Downstream copies the memory if it wants to write to it. */
+static GstBuffer *
+gst_audio_aggregator_create_silence_buffer (GstAudioAggregator * aagg,
+    guint num_frames)
+{
+  GstAggregator *agg = GST_AGGREGATOR (aagg);
+  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
+  gsize size = num_frames * GST_AUDIO_INFO_BPF (&srcpad->info);
+  GstBuffer *outbuf;
+
+  if (aagg->priv->silence_mem == NULL ||
+      aagg->priv->silence_format != GST_AUDIO_INFO_FORMAT (&srcpad->info) ||
+      aagg->priv->silence_mem->size < size) {
+    GstMapInfo map;
+
+    if (aagg->priv->silence_mem)
+      gst_memory_unref (aagg->priv->silence_mem);
+
+    /* leave room for the odd extra frame of the next buffers */
+    aagg->priv->silence_mem = gst_allocator_alloc (NULL,
+        size + GST_AUDIO_INFO_BPF (&srcpad->info), NULL);
+    gst_memory_map (aagg->priv->silence_mem, &map, GST_MAP_WRITE);
+    gst_audio_format_fill_silence (srcpad->info.finfo, map.data, map.size);
+    gst_memory_unmap (aagg->priv->silence_mem, &map);
+    GST_MINI_OBJECT_FLAG_SET (aagg->priv->silence_mem,
+        GST_MEMORY_FLAG_READONLY);
+    aagg->priv->silence_format = GST_AUDIO_INFO_FORMAT (&srcpad->info);
+  }
+
+  outbuf = gst_buffer_new ();
+  gst_buffer_append_memory (outbuf,
+      gst_memory_share (aagg->priv->silence_mem, 0, size));
+  GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_GAP);
+
+  return outbuf;
+}
+
 /* Called with pad object lock held */
 
 static gboolean
 gst_audio_aggregator_mix_buffer (GstAudioAggregator * aagg,
-    GstAudioAggregatorPad * pad, GstBuffer * inbuf, GstBuffer * outbuf,
-    guint blocksize)
+    GstAudioAggregatorPad * pad, GstBuffer * inbuf, guint blocksize)
 {
   guint overlap;
   guint out_start;
   gboolean filled;
   guint in_offset;
   gboolean pad_changed = FALSE;
+  GstBuffer *outbuf;
 
   /* Overlap => mix */
   if (aagg->priv->offset < pad->priv->output_offset)
@@ -1802,9 +1890,9 @@ gst_audio_aggregator_mix_buffer (GstAudioAggregator * aagg,
   if (overlap > blocksize - out_start)
     overlap = blocksize - out_start;
 
-  if (GST_BUFFER_FLAG_IS_SET (inbuf, GST_BUFFER_FLAG_GAP)) {
+  if (GST_BUFFER_FLAG_IS_SET (inbuf, GST_BUFFER_FLAG_GAP) || pad->priv->silent) {
     /* skip gap buffer */
-    GST_LOG_OBJECT (pad, "skipping GAP buffer");
+    GST_LOG_OBJECT (pad, "skipping GAP or silent buffer");
     pad->priv->output_offset += pad->priv->size - pad->priv->position;
     pad->priv->position = pad->priv->size;
 
@@ -1818,6 +1906,15 @@ gst_audio_aggregator_mix_buffer (GstAudioAggregator * aagg,
   GST_OBJECT_UNLOCK (pad);
   GST_OBJECT_UNLOCK (aagg);
 
+  /* first pad with something to mix, get the output buffer */
+  if (aagg->priv->current_buffer == NULL) {
+    aagg->priv->current_buffer =
+        GST_AUDIO_AGGREGATOR_GET_CLASS (aagg)->create_output_buffer (aagg,
+        blocksize);
+    GST_BUFFER_FLAG_SET (aagg->priv->current_buffer, GST_BUFFER_FLAG_GAP);
+  }
+  outbuf = aagg->priv->current_buffer;
+
   filled = GST_AUDIO_AGGREGATOR_GET_CLASS (aagg)->aggregate_one_buffer (aagg,
       pad, inbuf, in_offset, outbuf, out_start, overlap);
 
@@ -2040,7 +2137,9 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
         aagg->priv->offset);
   }
 
-  if (aagg->priv->current_buffer == NULL) {
+  /* The output buffer itself is only created once a pad has something to
+   * mix into it */
+  if (aagg->priv->current_blocksize == 0) {
     blocksize = aagg->priv->samples_per_buffer;
 
     if (aagg->priv->error_per_buffer + aagg->priv->accumulated_error >=
@@ -2052,14 +2151,6 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
     aagg->priv->accumulated_error =
         (aagg->priv->accumulated_error +
         aagg->priv->error_per_buffer) % aagg->priv->output_buffer_duration_d;
-
-    GST_OBJECT_UNLOCK (agg);
-    aagg->priv->current_buffer =
-        GST_AUDIO_AGGREGATOR_GET_CLASS (aagg)->create_output_buffer (aagg,
-        blocksize);
-    /* Be careful, some things could have changed ? */
-    GST_OBJECT_LOCK (agg);
-    GST_BUFFER_FLAG_SET (aagg->priv->current_buffer, GST_BUFFER_FLAG_GAP);
   } else {
     blocksize = aagg->priv->current_blocksize;
   }
@@ -2076,8 +2167,6 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
       agg_segment->start + gst_util_uint64_scale (next_offset, GST_SECOND,
       rate);
 
-  outbuf = aagg->priv->current_buffer;
-
   GST_LOG_OBJECT (agg,
       "Starting to mix %u samples for offset %" G_GINT64_FORMAT
       " with timestamp %" GST_TIME_FORMAT, blocksize,
@@ -2124,6 +2213,13 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
       else
         pad->priv->buffer = gst_buffer_ref (pad->priv->input_buffer);
 
+      /* Checked once per buffer, as a buffer is usually mixed into several
+       * output buffers */
+      pad->priv->silent =
+          !GST_BUFFER_FLAG_IS_SET (pad->priv->buffer, GST_BUFFER_FLAG_GAP) &&
+          gst_audio_aggregator_buffer_is_silent (&srcpad->info,
+          pad->priv->buffer);
+
       if (!gst_audio_aggregator_fill_buffer (aagg, pad)) {
         gst_buffer_replace (&pad->priv->buffer, NULL);
         gst_buffer_replace (&pad->priv->input_buffer, NULL);
@@ -2199,7 +2295,7 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
 
       GST_LOG_OBJECT (aggpad, "Mixing buffer for current offset");
       drop_buf = !gst_audio_aggregator_mix_buffer (aagg, pad, pad->priv->buffer,
-          outbuf, blocksize);
+          blocksize);
       if (pad->priv->output_offset >= next_offset) {
         GST_LOG_OBJECT (pad,
             "Pad is at or after current offset: %" G_GUINT64_FORMAT " >= %"
@@ -2233,6 +2329,22 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
     return GST_AGGREGATOR_FLOW_NEED_DATA;
   }
 
+  /* No pad had anything to mix in, output silence without touching any
+   * memory unless the subclass wants to create output buffers itself */
+  if (aagg->priv->current_buffer == NULL) {
+    if (GST_AUDIO_AGGREGATOR_GET_CLASS (aagg)->create_output_buffer ==
+        gst_audio_aggregator_create_output_buffer) {
+      aagg->priv->current_buffer =
+          gst_audio_aggregator_create_silence_buffer (aagg, blocksize);
+    } else {
+      aagg->priv->current_buffer =
+          GST_AUDIO_AGGREGATOR_GET_CLASS (aagg)->create_output_buffer (aagg,
+          blocksize);
+      GST_BUFFER_FLAG_SET (aagg->priv->current_buffer, GST_BUFFER_FLAG_GAP);
+    }
+  }
+  outbuf = aagg->priv->current_buffer;
+
   if (is_eos) {
     gint64 max_offset = 0;
 
@@ -2249,6 +2361,7 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
     /* This means EOS or nothing mixed in at all */
     if (aagg->priv->offset == max_offset) {
       gst_buffer_replace (&aagg->priv->current_buffer, NULL);
+      aagg->priv->current_blocksize = 0;
       GST_AUDIO_AGGREGATOR_UNLOCK (aagg);
       return GST_FLOW_EOS;
     }
@@ -2293,6 +2406,7 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
 
   ret = gst_aggregator_finish_buffer (agg, outbuf);
   aagg->priv->current_buffer = NULL;
+  aagg->priv->current_blocksize = 0;
 
   GST_LOG_OBJECT (aagg, "pushed outbuf, result = %s", gst_flow_get_name (ret));
 
@@ -38,6 +38,7 @@
 
 #include <gst/audio/audio.h>
 #include "gstaudiobasesink.h"
+#include "gstaudioutilsprivate.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_audio_base_sink_debug);
 #define GST_CAT_DEFAULT gst_audio_base_sink_debug
@@ -75,6 +76,24 @@ struct _GstAudioBaseSinkPrivate
   GstAudioBaseSinkCustomSlavingCallback custom_slaving_callback;
   gpointer custom_slaving_cb_data;
   GDestroyNotify custom_slaving_cb_notify;
+
+  /* size the ringbuffer from the observed scheduling jitter */
+  gboolean low_latency;
+  /* low_latency as it was when the ringbuffer was last configured, only used
+   * from the streaming thread */
+  gboolean rb_low_latency;
+  /* ATOMIC, TRUE when nothing was committed to the ringbuffer since it was
+   * acquired or flushed, it can then be reconfigured without losing data */
+  gint rb_empty;
+  /* the ringbuffer sample offset after the last committed sample, only used
+   * from the streaming thread */
+  guint64 rb_end_sample;
+  /* monotonic time in microseconds of the previous render call, or -1 */
+  gint64 last_render_time;
+  /* duration of the previously rendered buffer */
+  GstClockTime last_render_duration;
+  /* peak of the render scheduling jitter, slowly decaying */
+  GstClockTime jitter;
 };
 
 /* BaseAudioSink signals and args */
@@ -105,6 +124,12 @@ enum
  * fix itself, or is a permanent offset */
 #define DEFAULT_DISCONT_WAIT        (1 * GST_SECOND)
 
+#define DEFAULT_LOW_LATENCY         FALSE
+
+/* in low-latency mode, the number of times we poll the ringbuffer for a free
+ * segment before blocking */
+#define LOW_LATENCY_SPIN_COUNT      64
+
 enum
 {
   PROP_0,
@@ -117,6 +142,7 @@ enum
   PROP_ALIGNMENT_THRESHOLD,
   PROP_DRIFT_TOLERANCE,
   PROP_DISCONT_WAIT,
+  PROP_LOW_LATENCY,
 
   PROP_LAST
 };
@@ -160,6 +186,8 @@ static void gst_audio_base_sink_get_times (GstBaseSink * bsink,
     GstBuffer * buffer, GstClockTime * start, GstClockTime * end);
 static gboolean gst_audio_base_sink_setcaps (GstBaseSink * bsink,
     GstCaps * caps);
+static gboolean gst_audio_base_sink_configure_ringbuffer (GstAudioBaseSink *
+    sink, GstCaps * caps);
 static GstCaps *gst_audio_base_sink_fixate (GstBaseSink * bsink,
     GstCaps * caps);
 
@@ -247,6 +275,28 @@ gst_audio_base_sink_class_init (GstAudioBaseSinkClass * klass)
           G_MAXUINT64 - 1, DEFAULT_DISCONT_WAIT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAudioBaseSink:low-latency:
+   *
+   * Size the ringbuffer adaptively for low latency. The ringbuffer starts out
+   * with only a few segments of #GstAudioBaseSink:latency-time and grows when
+   * the jitter observed between render calls would otherwise cause underruns.
+   * #GstAudioBaseSink:buffer-time is used as the upper bound. Waiting for free
+   * space in the ringbuffer also polls briefly before blocking.
+   *
+   * Growing requires the ringbuffer to be reacquired. So that no queued
+   * samples are dropped, the samples in the ringbuffer are played out first
+   * while streaming, which shows as a short gap of silence. While paused, it
+   * only grows once it is empty, for example after a flush. Changes to this
+   * property take effect when the ringbuffer is configured next.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_LOW_LATENCY,
+      g_param_spec_boolean ("low-latency", "Low Latency",
+          "Adapt the buffer size to the observed scheduling jitter",
+          DEFAULT_LOW_LATENCY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_audio_base_sink_change_state);
   gstelement_class->provide_clock =
@@ -290,6 +340,9 @@ gst_audio_base_sink_init (GstAudioBaseSink * audiobasesink)
   audiobasesink->priv->custom_slaving_callback = NULL;
   audiobasesink->priv->custom_slaving_cb_data = NULL;
   audiobasesink->priv->custom_slaving_cb_notify = NULL;
+  audiobasesink->priv->low_latency = DEFAULT_LOW_LATENCY;
+  audiobasesink->priv->last_render_time = -1;
+  audiobasesink->priv->jitter = 0;
 
   audiobasesink->provided_clock = gst_audio_clock_new ("GstAudioSinkClock",
       (GstAudioClockGetTimeFunc) gst_audio_base_sink_get_time, audiobasesink,
@@ -854,6 +907,11 @@ gst_audio_base_sink_set_property (GObject * object, guint prop_id,
     case PROP_DISCONT_WAIT:
       gst_audio_base_sink_set_discont_wait (sink, g_value_get_uint64 (value));
       break;
+    case PROP_LOW_LATENCY:
+      GST_OBJECT_LOCK (sink);
+      sink->priv->low_latency = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (sink);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -894,19 +952,36 @@ gst_audio_base_sink_get_property (GObject * object, guint prop_id,
     case PROP_DISCONT_WAIT:
       g_value_set_uint64 (value, gst_audio_base_sink_get_discont_wait (sink));
       break;
+    case PROP_LOW_LATENCY:
+      GST_OBJECT_LOCK (sink);
+      g_value_set_boolean (value, sink->priv->low_latency);
+      GST_OBJECT_UNLOCK (sink);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
   }
 }
 
+/* the buffer time in microseconds to use in low-latency mode: two segments
+ * plus enough headroom to absorb twice the worst jitter we have seen,
+ * bounded by the buffer-time property */
+static guint64
+gst_audio_base_sink_get_low_latency_buffer_time (GstAudioBaseSink * sink)
+{
+  guint64 buffer_time;
+
+  buffer_time = 2 * sink->latency_time +
+      2 * (sink->priv->jitter / GST_USECOND);
+
+  return MIN (buffer_time, sink->buffer_time);
+}
+
 static gboolean
 gst_audio_base_sink_setcaps (GstBaseSink * bsink, GstCaps * caps)
 {
   GstAudioBaseSink *sink = GST_AUDIO_BASE_SINK (bsink);
   GstAudioRingBufferSpec *spec;
-  GstClockTime now, internal_time;
-  GstClockTime crate_num, crate_denom;
 
   if (!sink->ringbuffer)
     return FALSE;
@@ -919,6 +994,22 @@ gst_audio_base_sink_setcaps (GstBaseSink * bsink, GstCaps * caps)
     return TRUE;
   }
 
+  return gst_audio_base_sink_configure_ringbuffer (sink, caps);
+}
+
+/* (re)acquire the ringbuffer for @caps */
+static gboolean
+gst_audio_base_sink_configure_ringbuffer (GstAudioBaseSink * sink,
+    GstCaps * caps)
+{
+  GstBaseSink *bsink = GST_BASE_SINK_CAST (sink);
+  GstAudioRingBufferSpec *spec;
+  GstClockTime now, internal_time;
+  GstClockTime crate_num, crate_denom;
+  gboolean low_latency;
+
+  spec = &sink->ringbuffer->spec;
+
   GST_DEBUG_OBJECT (sink, "release old ringbuffer");
 
   /* get current time, updates the last_time. When the subclass has a clock that
@@ -937,8 +1028,14 @@ gst_audio_base_sink_setcaps (GstBaseSink * bsink, GstCaps * caps)
 
   GST_DEBUG_OBJECT (sink, "parse caps");
 
-  spec->buffer_time = sink->buffer_time;
+  GST_OBJECT_LOCK (sink);
+  low_latency = sink->priv->low_latency;
+  if (low_latency)
+    spec->buffer_time = gst_audio_base_sink_get_low_latency_buffer_time (sink);
+  else
+    spec->buffer_time = sink->buffer_time;
   spec->latency_time = sink->latency_time;
+  GST_OBJECT_UNLOCK (sink);
 
   /* parse new caps */
   if (!gst_audio_ring_buffer_parse_caps (spec, caps))
@@ -950,6 +1047,12 @@ gst_audio_base_sink_setcaps (GstBaseSink * bsink, GstCaps * caps)
   if (!gst_audio_ring_buffer_acquire (sink->ringbuffer, spec))
     goto acquire_error;
 
+  sink->priv->rb_low_latency = low_latency;
+  g_atomic_int_set (&sink->priv->rb_empty, 1);
+  sink->priv->rb_end_sample = 0;
+  gst_audio_ring_buffer_set_spin_count (sink->ringbuffer,
+      low_latency ? LOW_LATENCY_SPIN_COUNT : 0);
+
   /* If we use our own clock, we need to adjust the offset since it will now
    * restart from zero */
   if (gst_audio_base_sink_is_self_provided_clock (sink))
@@ -997,6 +1100,7 @@ parse_error:
 acquire_error:
   {
     GST_DEBUG_OBJECT (sink, "could not acquire ringbuffer");
+    sink->priv->rb_low_latency = FALSE;
     return FALSE;
   }
 }
@@ -1041,6 +1145,88 @@ gst_audio_base_sink_reset_sync (GstAudioBaseSink * sink)
   sink->priv->discont_time = -1;
   sink->priv->avg_skew = -1;
   sink->priv->last_align = 0;
+  sink->priv->last_render_time = -1;
+}
+
+/* Track the deviation between the time that passed since the previous render
+ * call and the duration of the data rendered then. */
+static void
+gst_audio_base_sink_update_jitter (GstAudioBaseSink * sink, guint samples,
+    gint rate)
+{
+  GstAudioBaseSinkPrivate *priv = sink->priv;
+  GstClockTimeDiff elapsed, deviation;
+  guint64 max_buffer_time;
+  gint64 now;
+
+  now = g_get_monotonic_time ();
+
+  GST_OBJECT_LOCK (sink);
+  max_buffer_time = sink->buffer_time;
+  GST_OBJECT_UNLOCK (sink);
+
+  if (priv->last_render_time != -1 && rate > 0) {
+    elapsed = (now - priv->last_render_time) * GST_USECOND;
+    deviation = ABS (elapsed - (GstClockTimeDiff) priv->last_render_duration);
+
+    /* a stall longer than the maximum buffer size can't be absorbed anyway,
+     * don't let it blow up the latency */
+    if (deviation < max_buffer_time * GST_USECOND) {
+      if (deviation > priv->jitter)
+        priv->jitter = deviation;
+      else
+        priv->jitter -= priv->jitter >> 6;
+    }
+  }
+  priv->last_render_time = now;
+  priv->last_render_duration = rate > 0 ?
+      gst_util_uint64_scale_int (samples, GST_SECOND, rate) : 0;
+}
+
+/* When the observed jitter no longer fits in the ringbuffer, reconfigure it
+ * with a larger buffer-time. Releasing the ringbuffer drops everything that is
+ * queued in it, so when something was committed since it was acquired or
+ * flushed, we first wait for the device to play it. When that is not possible
+ * because the ringbuffer may not start yet, this is tried again with the next
+ * buffer. Returns FALSE when the ringbuffer could not be reacquired. */
+static gboolean
+gst_audio_base_sink_maybe_grow_ringbuffer (GstAudioBaseSink * sink)
+{
+  GstAudioRingBuffer *ringbuf = sink->ringbuffer;
+  GstAudioRingBufferSpec *spec = &ringbuf->spec;
+  guint64 buffer_time, max_buffer_time;
+  GstCaps *caps;
+  gboolean ret;
+
+  if (spec->caps == NULL || gst_audio_ring_buffer_is_flushing (ringbuf))
+    return TRUE;
+
+  GST_OBJECT_LOCK (sink);
+  buffer_time = gst_audio_base_sink_get_low_latency_buffer_time (sink);
+  max_buffer_time = sink->buffer_time;
+  GST_OBJECT_UNLOCK (sink);
+
+  /* only grow by at least one segment at a time */
+  if (buffer_time < spec->buffer_time + spec->latency_time ||
+      spec->buffer_time >= max_buffer_time)
+    return TRUE;
+
+  if (!g_atomic_int_get (&sink->priv->rb_empty)) {
+    GST_DEBUG_OBJECT (sink, "playing out the ringbuffer before growing it");
+    if (!__gst_audio_ring_buffer_wait_played (ringbuf,
+            sink->priv->rb_end_sample))
+      return TRUE;
+  }
+
+  GST_INFO_OBJECT (sink, "jitter %" GST_TIME_FORMAT ", growing buffer-time "
+      "from %" G_GUINT64_FORMAT " to %" G_GUINT64_FORMAT " microseconds",
+      GST_TIME_ARGS (sink->priv->jitter), spec->buffer_time, buffer_time);
+
+  caps = gst_caps_ref (spec->caps);
+  ret = gst_audio_base_sink_configure_ringbuffer (sink, caps);
+  gst_caps_unref (caps);
+
+  return ret;
 }
 
 static void
@@ -1153,12 +1339,16 @@ gst_audio_base_sink_event (GstBaseSink * bsink, GstEvent * event)
 
   switch (GST_EVENT_TYPE (event)) {
     case GST_EVENT_FLUSH_START:
-      if (sink->ringbuffer)
+      if (sink->ringbuffer) {
         gst_audio_ring_buffer_set_flushing (sink->ringbuffer, TRUE);
+        /* flushing cleared the ringbuffer */
+        g_atomic_int_set (&sink->priv->rb_empty, 1);
+      }
       break;
     case GST_EVENT_FLUSH_STOP:
       /* always resync on sample after a flush */
       gst_audio_base_sink_reset_sync (sink);
+      sink->priv->rb_end_sample = 0;
 
       gst_audio_base_sink_custom_cb_report_discont (sink,
           GST_AUDIO_BASE_SINK_DISCONT_REASON_FLUSH);
@@ -1864,6 +2054,15 @@ gst_audio_base_sink_render (GstBaseSink * bsink, GstBuffer * buf)
 
   samples = size / bpf;
 
+  if (G_UNLIKELY (sink->priv->rb_low_latency)) {
+    gst_audio_base_sink_update_jitter (sink, samples, rate);
+    if (!gst_audio_base_sink_maybe_grow_ringbuffer (sink))
+      goto grow_failed;
+  }
+  /* we are about to commit, the ringbuffer can't be reconfigured anymore
+   * until it is flushed */
+  g_atomic_int_set (&sink->priv->rb_empty, 0);
+
   time = GST_BUFFER_TIMESTAMP (buf);
 
   /* Last ditch attempt to ensure that we only play silence if
@@ -2136,6 +2335,10 @@ no_align:
   GST_DEBUG_OBJECT (sink, "rendering at %" G_GUINT64_FORMAT " %d/%d",
       sample_offset, samples, out_samples);
 
+  /* remember up to where the ringbuffer is filled, it is played out up to
+   * there before the ringbuffer grows */
+  sink->priv->rb_end_sample = MAX (sink->priv->rb_end_sample, render_stop);
+
   /* we need to accumulate over different runs for when we get interrupted */
   accum = 0;
   align_next = TRUE;
@@ -2244,6 +2447,14 @@ sync_latency_failed:
     GST_DEBUG_OBJECT (sink, "failed waiting for latency");
     goto done;
   }
+grow_failed:
+  {
+    GST_DEBUG_OBJECT (sink, "failed to grow the ringbuffer");
+    GST_ELEMENT_ERROR (sink, RESOURCE, SETTINGS, (NULL),
+        ("failed to reconfigure the ringbuffer."));
+    ret = GST_FLOW_ERROR;
+    goto done;
+  }
 }
 
 /**
@@ -2438,6 +2649,7 @@ gst_audio_base_sink_change_state (GstElement * element,
       GST_OBJECT_LOCK (sink);
       GST_DEBUG_OBJECT (sink, "ringbuffer may start now");
       sink->priv->sync_latency = TRUE;
+      sink->priv->last_render_time = -1;
       eos = GST_BASE_SINK (sink)->eos;
       GST_OBJECT_UNLOCK (sink);
 
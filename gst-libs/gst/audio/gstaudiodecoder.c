@@ -184,6 +184,11 @@ typedef struct _GstAudioDecoderContext
 
   GstAllocator *allocator;
   GstAllocationParams params;
+
+  /* output buffer pool, only used if the subclass set a maximum
+   * frame size */
+  GstBufferPool *pool;
+  guint pool_size;
 } GstAudioDecoderContext;
 
 struct _GstAudioDecoderPrivate
@@ -269,6 +274,15 @@ struct _GstAudioDecoderPrivate
   /* pending serialized sink events, will be sent from finish_frame() */
   GList *pending_events;
 
+  /* maximum output buffer size set by the subclass, kept outside of the
+   * context so that it survives resets */
+  gsize max_frame_size;
+
+  /* output buffer pool statistics, protected by the object lock */
+  guint64 pooled_buffers;
+  guint64 recycled_buffers;
+  guint64 unpooled_buffers;
+
   /* flags */
   gboolean use_default_pad_acceptcaps;
 };
@@ -544,12 +558,19 @@ gst_audio_decoder_reset (GstAudioDecoder * dec, gboolean full)
 
     if (dec->priv->ctx.allocator)
       gst_object_unref (dec->priv->ctx.allocator);
+    if (dec->priv->ctx.pool) {
+      gst_buffer_pool_set_active (dec->priv->ctx.pool, FALSE);
+      gst_object_unref (dec->priv->ctx.pool);
+    }
 
     GST_OBJECT_LOCK (dec);
     dec->priv->decode_flags_override = FALSE;
     gst_caps_replace (&dec->priv->ctx.input_caps, NULL);
     gst_caps_replace (&dec->priv->ctx.caps, NULL);
     gst_caps_replace (&dec->priv->ctx.allocation_caps, NULL);
+    dec->priv->pooled_buffers = 0;
+    dec->priv->recycled_buffers = 0;
+    dec->priv->unpooled_buffers = 0;
 
     memset (&dec->priv->ctx, 0, sizeof (dec->priv->ctx));
 
@@ -729,6 +750,28 @@ gst_audio_decoder_negotiate_default (GstAudioDecoder * dec)
   dec->priv->ctx.allocator = allocator;
   dec->priv->ctx.params = params;
 
+  if (dec->priv->ctx.pool) {
+    gst_buffer_pool_set_active (dec->priv->ctx.pool, FALSE);
+    gst_object_unref (dec->priv->ctx.pool);
+    dec->priv->ctx.pool = NULL;
+  }
+
+  if (dec->priv->max_frame_size > 0
+      && gst_query_get_n_allocation_pools (query) > 0) {
+    GstBufferPool *pool;
+    guint size;
+
+    gst_query_parse_nth_allocation_pool (query, 0, &pool, &size, NULL, NULL);
+    if (pool && size >= dec->priv->max_frame_size
+        && gst_buffer_pool_set_active (pool, TRUE)) {
+      dec->priv->ctx.pool = pool;
+      dec->priv->ctx.pool_size = size;
+    } else if (pool) {
+      GST_INFO_OBJECT (dec, "can't use output pool %" GST_PTR_FORMAT, pool);
+      gst_object_unref (pool);
+    }
+  }
+
 done:
 
   if (query)
@@ -2748,6 +2791,10 @@ gst_audio_decoder_decide_allocation_default (GstAudioDecoder * dec,
   if (allocator)
     gst_object_unref (allocator);
 
+  if (dec->priv->max_frame_size > 0)
+    __gst_audio_decide_output_pool (GST_ELEMENT_CAST (dec), query,
+        dec->priv->max_frame_size);
+
   return TRUE;
 }
 
@@ -3772,6 +3819,29 @@ gst_audio_decoder_allocate_output_buffer (GstAudioDecoder * dec, gsize size)
     }
   }
 
+  if (dec->priv->ctx.pool && size <= dec->priv->ctx.pool_size) {
+    gboolean recycled;
+
+    buffer =
+        __gst_audio_acquire_pooled_buffer (dec->priv->ctx.pool, size,
+        &recycled);
+    if (buffer) {
+      GST_OBJECT_LOCK (dec);
+      dec->priv->pooled_buffers++;
+      if (recycled)
+        dec->priv->recycled_buffers++;
+      GST_OBJECT_UNLOCK (dec);
+      GST_AUDIO_DECODER_STREAM_UNLOCK (dec);
+
+      return buffer;
+    }
+    GST_LOG_OBJECT (dec, "output pool is empty, allocating outside of it");
+  }
+
+  GST_OBJECT_LOCK (dec);
+  dec->priv->unpooled_buffers++;
+  GST_OBJECT_UNLOCK (dec);
+
   buffer =
       gst_buffer_new_allocate (dec->priv->ctx.allocator, size,
       &dec->priv->ctx.params);
@@ -3817,6 +3887,97 @@ gst_audio_decoder_get_allocator (GstAudioDecoder * dec,
     *params = dec->priv->ctx.params;
 }
 
+/**
+ * gst_audio_decoder_set_max_frame_size:
+ * @dec: a #GstAudioDecoder
+ * @size: maximum size of an output buffer in bytes, or 0
+ *
+ * Sets the maximum size of the buffers the subclass allocates with
+ * gst_audio_decoder_allocate_output_buffer(). If non-zero, the base class
+ * negotiates a #GstBufferPool with buffers of this size and recycles the
+ * output buffers through it instead of allocating new memory for every
+ * frame. Larger buffers, and buffers requested while all buffers of the
+ * pool are still in use downstream, are allocated separately.
+ *
+ * This should be called before the output format is negotiated, e.g. from
+ * #GstAudioDecoderClass.set_format().
+ *
+ * Since: 1.20
+ */
+void
+gst_audio_decoder_set_max_frame_size (GstAudioDecoder * dec, gsize size)
+{
+  g_return_if_fail (GST_IS_AUDIO_DECODER (dec));
+
+  GST_AUDIO_DECODER_STREAM_LOCK (dec);
+  if (dec->priv->max_frame_size != size) {
+    GST_DEBUG_OBJECT (dec, "max frame size %" G_GSIZE_FORMAT, size);
+    dec->priv->max_frame_size = size;
+    /* pick up the new size with the next allocation query */
+    gst_pad_mark_reconfigure (dec->srcpad);
+  }
+  GST_AUDIO_DECODER_STREAM_UNLOCK (dec);
+}
+
+/**
+ * gst_audio_decoder_get_max_frame_size:
+ * @dec: a #GstAudioDecoder
+ *
+ * Returns: the maximum output buffer size set with
+ * gst_audio_decoder_set_max_frame_size().
+ *
+ * Since: 1.20
+ */
+gsize
+gst_audio_decoder_get_max_frame_size (GstAudioDecoder * dec)
+{
+  gsize size;
+
+  g_return_val_if_fail (GST_IS_AUDIO_DECODER (dec), 0);
+
+  GST_AUDIO_DECODER_STREAM_LOCK (dec);
+  size = dec->priv->max_frame_size;
+  GST_AUDIO_DECODER_STREAM_UNLOCK (dec);
+
+  return size;
+}
+
+/**
+ * gst_audio_decoder_get_pool_stats:
+ * @dec: a #GstAudioDecoder
+ *
+ * Returns statistics about the output buffers allocated with
+ * gst_audio_decoder_allocate_output_buffer() since @dec was started.
+ * The structure contains the following #guint64 fields:
+ *
+ * * "pooled": number of buffers taken from the output #GstBufferPool
+ * * "recycled": number of those buffers that were reused by the pool
+ *   instead of newly allocated
+ * * "unpooled": number of buffers allocated outside of the pool
+ *
+ * The pool hit rate is recycled / (pooled + unpooled).
+ *
+ * Returns: (transfer full): a #GstStructure with the statistics
+ *
+ * Since: 1.20
+ */
+GstStructure *
+gst_audio_decoder_get_pool_stats (GstAudioDecoder * dec)
+{
+  GstStructure *s;
+
+  g_return_val_if_fail (GST_IS_AUDIO_DECODER (dec), NULL);
+
+  GST_OBJECT_LOCK (dec);
+  s = gst_structure_new ("application/x-gst-audio-decoder-pool-stats",
+      "pooled", G_TYPE_UINT64, dec->priv->pooled_buffers,
+      "recycled", G_TYPE_UINT64, dec->priv->recycled_buffers,
+      "unpooled", G_TYPE_UINT64, dec->priv->unpooled_buffers, NULL);
+  GST_OBJECT_UNLOCK (dec);
+
+  return s;
+}
+
 /**
  * gst_audio_decoder_set_use_default_pad_acceptcaps:
  * @decoder: a #GstAudioDecoder
@@ -434,6 +434,16 @@ void              gst_audio_decoder_get_allocator (GstAudioDecoder * dec,
                                                    GstAllocator ** allocator,
                                                    GstAllocationParams * params);
 
+GST_AUDIO_API
+void              gst_audio_decoder_set_max_frame_size (GstAudioDecoder * dec,
+                                                       gsize size);
+
+GST_AUDIO_API
+gsize             gst_audio_decoder_get_max_frame_size (GstAudioDecoder * dec);
+
+GST_AUDIO_API
+GstStructure *    gst_audio_decoder_get_pool_stats (GstAudioDecoder * dec);
+
 GST_AUDIO_API
 void              gst_audio_decoder_merge_tags (GstAudioDecoder * dec,
                                                 const GstTagList * tags, GstTagMergeMode mode);
@@ -177,6 +177,11 @@ typedef struct _GstAudioEncoderContext
 
   GstAllocator *allocator;
   GstAllocationParams params;
+
+  /* output buffer pool, only used if the subclass set a maximum
+   * frame size */
+  GstBufferPool *pool;
+  guint pool_size;
 } GstAudioEncoderContext;
 
 struct _GstAudioEncoderPrivate
@@ -239,6 +244,15 @@ struct _GstAudioEncoderPrivate
 
   /* pending serialized sink events, will be sent from finish_frame() */
   GList *pending_events;
+
+  /* maximum output buffer size set by the subclass, kept outside of the
+   * context so that it survives resets */
+  gsize max_frame_size;
+
+  /* output buffer pool statistics, protected by the object lock */
+  guint64 pooled_buffers;
+  guint64 recycled_buffers;
+  guint64 unpooled_buffers;
 };
 
 
@@ -478,12 +492,19 @@ gst_audio_encoder_reset (GstAudioEncoder * enc, gboolean full)
 
     if (enc->priv->ctx.allocator)
       gst_object_unref (enc->priv->ctx.allocator);
+    if (enc->priv->ctx.pool) {
+      gst_buffer_pool_set_active (enc->priv->ctx.pool, FALSE);
+      gst_object_unref (enc->priv->ctx.pool);
+    }
     enc->priv->ctx.allocator = NULL;
 
     GST_OBJECT_LOCK (enc);
     gst_caps_replace (&enc->priv->ctx.input_caps, NULL);
     gst_caps_replace (&enc->priv->ctx.caps, NULL);
     gst_caps_replace (&enc->priv->ctx.allocation_caps, NULL);
+    enc->priv->pooled_buffers = 0;
+    enc->priv->recycled_buffers = 0;
+    enc->priv->unpooled_buffers = 0;
 
     memset (&enc->priv->ctx, 0, sizeof (enc->priv->ctx));
     gst_audio_info_init (&enc->priv->ctx.info);
@@ -1878,6 +1899,10 @@ gst_audio_encoder_decide_allocation_default (GstAudioEncoder * enc,
   if (allocator)
     gst_object_unref (allocator);
 
+  if (enc->priv->max_frame_size > 0)
+    __gst_audio_decide_output_pool (GST_ELEMENT_CAST (enc), query,
+        enc->priv->max_frame_size);
+
   return TRUE;
 }
 
@@ -2790,6 +2815,28 @@ gst_audio_encoder_negotiate_default (GstAudioEncoder * enc)
   enc->priv->ctx.allocator = allocator;
   enc->priv->ctx.params = params;
 
+  if (enc->priv->ctx.pool) {
+    gst_buffer_pool_set_active (enc->priv->ctx.pool, FALSE);
+    gst_object_unref (enc->priv->ctx.pool);
+    enc->priv->ctx.pool = NULL;
+  }
+
+  if (enc->priv->max_frame_size > 0
+      && gst_query_get_n_allocation_pools (query) > 0) {
+    GstBufferPool *pool;
+    guint size;
+
+    gst_query_parse_nth_allocation_pool (query, 0, &pool, &size, NULL, NULL);
+    if (pool && size >= enc->priv->max_frame_size
+        && gst_buffer_pool_set_active (pool, TRUE)) {
+      enc->priv->ctx.pool = pool;
+      enc->priv->ctx.pool_size = size;
+    } else if (pool) {
+      GST_INFO_OBJECT (enc, "can't use output pool %" GST_PTR_FORMAT, pool);
+      gst_object_unref (pool);
+    }
+  }
+
 done:
   if (query)
     gst_query_unref (query);
@@ -2926,6 +2973,29 @@ gst_audio_encoder_allocate_output_buffer (GstAudioEncoder * enc, gsize size)
     }
   }
 
+  if (enc->priv->ctx.pool && size <= enc->priv->ctx.pool_size) {
+    gboolean recycled;
+
+    buffer =
+        __gst_audio_acquire_pooled_buffer (enc->priv->ctx.pool, size,
+        &recycled);
+    if (buffer) {
+      GST_OBJECT_LOCK (enc);
+      enc->priv->pooled_buffers++;
+      if (recycled)
+        enc->priv->recycled_buffers++;
+      GST_OBJECT_UNLOCK (enc);
+      GST_AUDIO_ENCODER_STREAM_UNLOCK (enc);
+
+      return buffer;
+    }
+    GST_LOG_OBJECT (enc, "output pool is empty, allocating outside of it");
+  }
+
+  GST_OBJECT_LOCK (enc);
+  enc->priv->unpooled_buffers++;
+  GST_OBJECT_UNLOCK (enc);
+
   buffer =
       gst_buffer_new_allocate (enc->priv->ctx.allocator, size,
       &enc->priv->ctx.params);
@@ -2971,3 +3041,94 @@ gst_audio_encoder_get_allocator (GstAudioEncoder * enc,
   if (params)
     *params = enc->priv->ctx.params;
 }
+
+/**
+ * gst_audio_encoder_set_max_frame_size:
+ * @enc: a #GstAudioEncoder
+ * @size: maximum size of an output buffer in bytes, or 0
+ *
+ * Sets the maximum size of the buffers the subclass allocates with
+ * gst_audio_encoder_allocate_output_buffer(). If non-zero, the base class
+ * negotiates a #GstBufferPool with buffers of this size and recycles the
+ * output buffers through it instead of allocating new memory for every
+ * frame. Larger buffers, and buffers requested while all buffers of the
+ * pool are still in use downstream, are allocated separately.
+ *
+ * This should be called before the output format is negotiated, e.g. from
+ * #GstAudioEncoderClass.set_format().
+ *
+ * Since: 1.20
+ */
+void
+gst_audio_encoder_set_max_frame_size (GstAudioEncoder * enc, gsize size)
+{
+  g_return_if_fail (GST_IS_AUDIO_ENCODER (enc));
+
+  GST_AUDIO_ENCODER_STREAM_LOCK (enc);
+  if (enc->priv->max_frame_size != size) {
+    GST_DEBUG_OBJECT (enc, "max frame size %" G_GSIZE_FORMAT, size);
+    enc->priv->max_frame_size = size;
+    /* pick up the new size with the next allocation query */
+    gst_pad_mark_reconfigure (enc->srcpad);
+  }
+  GST_AUDIO_ENCODER_STREAM_UNLOCK (enc);
+}
+
+/**
+ * gst_audio_encoder_get_max_frame_size:
+ * @enc: a #GstAudioEncoder
+ *
+ * Returns: the maximum output buffer size set with
+ * gst_audio_encoder_set_max_frame_size().
+ *
+ * Since: 1.20
+ */
+gsize
+gst_audio_encoder_get_max_frame_size (GstAudioEncoder * enc)
+{
+  gsize size;
+
+  g_return_val_if_fail (GST_IS_AUDIO_ENCODER (enc), 0);
+
+  GST_AUDIO_ENCODER_STREAM_LOCK (enc);
+  size = enc->priv->max_frame_size;
+  GST_AUDIO_ENCODER_STREAM_UNLOCK (enc);
+
+  return size;
+}
+
+/**
+ * gst_audio_encoder_get_pool_stats:
+ * @enc: a #GstAudioEncoder
+ *
+ * Returns statistics about the output buffers allocated with
+ * gst_audio_encoder_allocate_output_buffer() since @enc was started.
+ * The structure contains the following #guint64 fields:
+ *
+ * * "pooled": number of buffers taken from the output #GstBufferPool
+ * * "recycled": number of those buffers that were reused by the pool
+ *   instead of newly allocated
+ * * "unpooled": number of buffers allocated outside of the pool
+ *
+ * The pool hit rate is recycled / (pooled + unpooled).
+ *
+ * Returns: (transfer full): a #GstStructure with the statistics
+ *
+ * Since: 1.20
+ */
+GstStructure *
+gst_audio_encoder_get_pool_stats (GstAudioEncoder * enc)
+{
+  GstStructure *s;
+
+  g_return_val_if_fail (GST_IS_AUDIO_ENCODER (enc), NULL);
+
+  GST_OBJECT_LOCK (enc);
+  s = gst_structure_new ("application/x-gst-audio-encoder-pool-stats",
+      "pooled", G_TYPE_UINT64, enc->priv->pooled_buffers,
+      "recycled", G_TYPE_UINT64, enc->priv->recycled_buffers,
+      "unpooled", G_TYPE_UINT64, enc->priv->unpooled_buffers, NULL);
+  GST_OBJECT_UNLOCK (enc);
+
+  return s;
+}
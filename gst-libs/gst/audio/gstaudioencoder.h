@@ -367,6 +367,16 @@ void            gst_audio_encoder_get_allocator (GstAudioEncoder * enc,
                                                  GstAllocator ** allocator,
                                                  GstAllocationParams * params);
 
+GST_AUDIO_API
+void              gst_audio_encoder_set_max_frame_size (GstAudioEncoder * enc,
+                                                       gsize size);
+
+GST_AUDIO_API
+gsize             gst_audio_encoder_get_max_frame_size (GstAudioEncoder * enc);
+
+GST_AUDIO_API
+GstStructure *    gst_audio_encoder_get_pool_stats (GstAudioEncoder * enc);
+
 GST_AUDIO_API
 void            gst_audio_encoder_merge_tags (GstAudioEncoder * enc,
                                               const GstTagList * tags, GstTagMergeMode mode);
@@ -41,6 +41,7 @@
 
 #include <gst/audio/audio.h>
 #include "gstaudioringbuffer.h"
+#include "gstaudioutilsprivate.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_audio_ring_buffer_debug);
 #define GST_CAT_DEFAULT gst_audio_ring_buffer_debug
@@ -53,10 +54,19 @@ static void default_clear_all (GstAudioRingBuffer * buf);
 static guint default_commit (GstAudioRingBuffer * buf, guint64 * sample,
     guint8 * data, gint in_samples, gint out_samples, gint * accum);
 
+typedef struct
+{
+  /* ATOMIC */
+  gint spin_count;
+} GstAudioRingBufferPrivate;
+
 /* ringbuffer abstract base class */
-G_DEFINE_ABSTRACT_TYPE (GstAudioRingBuffer, gst_audio_ring_buffer,
+G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (GstAudioRingBuffer, gst_audio_ring_buffer,
     GST_TYPE_OBJECT);
 
+#define GET_PRIV(buf) \
+    ((GstAudioRingBufferPrivate *) gst_audio_ring_buffer_get_instance_private (buf))
+
 static void
 gst_audio_ring_buffer_class_init (GstAudioRingBufferClass * klass)
 {
@@ -88,6 +98,7 @@ gst_audio_ring_buffer_init (GstAudioRingBuffer * ringbuffer)
   ringbuffer->flushing = TRUE;
   ringbuffer->segbase = 0;
   ringbuffer->segdone = 0;
+  GET_PRIV (ringbuffer)->spin_count = 0;
 }
 
 static void
@@ -1335,11 +1346,14 @@ gst_audio_ring_buffer_clear_all (GstAudioRingBuffer * buf)
 }
 
 
+/* @segments is the value of segdone the caller last looked at. When the device
+ * thread advanced past it we can return right away, we only block on the
+ * condition when the segment counter really did not move. */
 static gboolean
-wait_segment (GstAudioRingBuffer * buf)
+wait_segment (GstAudioRingBuffer * buf, gint segments)
 {
-  gint segments;
   gboolean wait = TRUE;
+  gint spin;
 
   /* buffer must be started now or we deadlock since nobody is reading */
   if (G_UNLIKELY (g_atomic_int_get (&buf->state) !=
@@ -1356,6 +1370,18 @@ wait_segment (GstAudioRingBuffer * buf)
      * don't need to wait anymore */
     if (G_LIKELY (g_atomic_int_get (&buf->segdone) != segments))
       wait = FALSE;
+  } else {
+    /* in low-latency mode, poll the segment counter for a little while before
+     * going to sleep, the lock and wakeup round-trip is often longer than
+     * the time it takes the device to consume a small segment */
+    spin = g_atomic_int_get (&GET_PRIV (buf)->spin_count);
+    while (spin-- > 0) {
+      if (g_atomic_int_get (&buf->segdone) != segments)
+        return TRUE;
+      if (G_UNLIKELY (buf->flushing))
+        break;
+      g_thread_yield ();
+    }
   }
 
   /* take lock first, then update our waiting flag */
@@ -1369,8 +1395,16 @@ wait_segment (GstAudioRingBuffer * buf)
 
   if (G_LIKELY (wait)) {
     if (g_atomic_int_compare_and_exchange (&buf->waiting, 0, 1)) {
-      GST_DEBUG_OBJECT (buf, "waiting..");
-      GST_AUDIO_RING_BUFFER_WAIT (buf);
+      /* gst_audio_ring_buffer_advance() increments segdone before it looks at
+       * the waiting flag, so if segdone did not move after we raised the flag
+       * we are guaranteed to be signalled. If it did move, we would otherwise
+       * sleep for a whole segment for nothing. */
+      if (g_atomic_int_get (&buf->segdone) != segments) {
+        g_atomic_int_compare_and_exchange (&buf->waiting, 1, 0);
+      } else {
+        GST_DEBUG_OBJECT (buf, "waiting..");
+        GST_AUDIO_RING_BUFFER_WAIT (buf);
+      }
 
       if (G_UNLIKELY (buf->flushing))
         goto flushing;
@@ -1406,6 +1440,38 @@ no_start:
   }
 }
 
+/*
+ * Block until the device played all samples before @sample, which counts
+ * from the segment base like the sample offsets passed to
+ * gst_audio_ring_buffer_commit(). The ringbuffer is started when it may
+ * start. After segtotal segments everything that was committed before has
+ * been played, so this never waits longer than that.
+ *
+ * Returns FALSE when the ringbuffer could not be started or was stopped or
+ * flushed while waiting.
+ */
+gboolean
+__gst_audio_ring_buffer_wait_played (GstAudioRingBuffer * buf, guint64 sample)
+{
+  gint segdone, segments, sps;
+
+  sps = buf->samples_per_seg;
+  if (G_UNLIKELY (sps <= 0))
+    return FALSE;
+
+  for (segments = 0; segments <= buf->spec.segtotal; segments++) {
+    segdone = g_atomic_int_get (&buf->segdone);
+    if ((guint64) MAX (segdone - buf->segbase, 0) * sps >= sample)
+      break;
+
+    if (!wait_segment (buf, segdone))
+      return FALSE;
+  }
+  GST_DEBUG_OBJECT (buf, "played up to sample %" G_GUINT64_FORMAT, sample);
+
+  return TRUE;
+}
+
 
 
 #define REORDER_SAMPLE(d, s, l)                 \
@@ -1518,7 +1584,7 @@ static guint
 default_commit (GstAudioRingBuffer * buf, guint64 * sample,
     guint8 * data, gint in_samples, gint out_samples, gint * accum)
 {
-  gint segdone;
+  gint segdone, segments;
   gint segsize, segtotal, channels, bps, bpf, sps;
   guint8 *dest, *data_end;
   gint writeseg, sampleoff;
@@ -1573,7 +1639,8 @@ default_commit (GstAudioRingBuffer * buf, guint64 * sample,
       gint diff;
 
       /* get the currently processed segment */
-      segdone = g_atomic_int_get (&buf->segdone) - buf->segbase;
+      segments = g_atomic_int_get (&buf->segdone);
+      segdone = segments - buf->segbase;
 
       /* see how far away it is from the write segment */
       diff = writeseg - segdone;
@@ -1597,7 +1664,7 @@ default_commit (GstAudioRingBuffer * buf, guint64 * sample,
       }
 
       /* else we need to wait for the segment to become writable. */
-      if (!wait_segment (buf))
+      if (!wait_segment (buf, segments))
         goto not_started;
     }
 
@@ -1752,7 +1819,7 @@ guint
 gst_audio_ring_buffer_read (GstAudioRingBuffer * buf, guint64 sample,
     guint8 * data, guint len, GstClockTime * timestamp)
 {
-  gint segdone;
+  gint segdone, segments;
   gint segsize, segtotal, channels, bps, bpf, sps, readseg = 0;
   guint8 *dest;
   guint to_read;
@@ -1786,7 +1853,8 @@ gst_audio_ring_buffer_read (GstAudioRingBuffer * buf, guint64 sample,
       gint diff;
 
       /* get the currently processed segment */
-      segdone = g_atomic_int_get (&buf->segdone) - buf->segbase;
+      segments = g_atomic_int_get (&buf->segdone);
+      segdone = segments - buf->segbase;
 
       /* see how far away it is from the read segment, normally segdone (where
        * the hardware is writing) is bigger than readseg (where software is
@@ -1813,7 +1881,7 @@ gst_audio_ring_buffer_read (GstAudioRingBuffer * buf, guint64 sample,
         break;
 
       /* else we need to wait for the segment to become readable. */
-      if (!wait_segment (buf))
+      if (!wait_segment (buf, segments))
         goto not_started;
     }
 
@@ -2001,6 +2069,51 @@ gst_audio_ring_buffer_may_start (GstAudioRingBuffer * buf, gboolean allowed)
   g_atomic_int_set (&buf->may_start, allowed);
 }
 
+/**
+ * gst_audio_ring_buffer_set_spin_count:
+ * @buf: the #GstAudioRingBuffer
+ * @spin_count: the number of times to poll the segment counter
+ *
+ * Configure how many times gst_audio_ring_buffer_commit() and
+ * gst_audio_ring_buffer_read() poll for the device to advance before they
+ * block on the ringbuffer lock and condition variable. Polling avoids the
+ * wakeup latency when segments are very small, at the expense of some CPU.
+ * A value of 0, the default, always blocks right away.
+ *
+ * MT safe.
+ *
+ * Since: 1.20
+ */
+void
+gst_audio_ring_buffer_set_spin_count (GstAudioRingBuffer * buf,
+    guint spin_count)
+{
+  g_return_if_fail (GST_IS_AUDIO_RING_BUFFER (buf));
+
+  GST_LOG_OBJECT (buf, "spin count: %u", spin_count);
+  g_atomic_int_set (&GET_PRIV (buf)->spin_count, MIN (spin_count, G_MAXINT));
+}
+
+/**
+ * gst_audio_ring_buffer_get_spin_count:
+ * @buf: the #GstAudioRingBuffer
+ *
+ * Get the spin count configured with gst_audio_ring_buffer_set_spin_count().
+ *
+ * Returns: the number of times the segment counter is polled before blocking.
+ *
+ * MT safe.
+ *
+ * Since: 1.20
+ */
+guint
+gst_audio_ring_buffer_get_spin_count (GstAudioRingBuffer * buf)
+{
+  g_return_val_if_fail (GST_IS_AUDIO_RING_BUFFER (buf), 0);
+
+  return g_atomic_int_get (&GET_PRIV (buf)->spin_count);
+}
+
 /* GST_AUDIO_CHANNEL_POSITION_NONE is used for position-less
  * mutually exclusive channels. In this case we should not attempt
  * to do any reordering.
@@ -407,6 +407,12 @@ void            gst_audio_ring_buffer_advance         (GstAudioRingBuffer *buf,
 GST_AUDIO_API
 void            gst_audio_ring_buffer_may_start       (GstAudioRingBuffer *buf, gboolean allowed);
 
+GST_AUDIO_API
+void            gst_audio_ring_buffer_set_spin_count  (GstAudioRingBuffer *buf, guint spin_count);
+
+GST_AUDIO_API
+guint           gst_audio_ring_buffer_get_spin_count  (GstAudioRingBuffer *buf);
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstAudioRingBuffer, gst_object_unref)
 
 G_END_DECLS
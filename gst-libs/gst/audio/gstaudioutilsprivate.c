@@ -217,6 +217,135 @@ exit:
   return res;
 }
 
+/*
+ * Helper function to add a #GstBufferPool for output buffers of up to
+ * @max_frame_size bytes to the allocation @query, using the first
+ * allocator in the @query. A pool proposed by downstream is used if it
+ * accepts our configuration, otherwise a new pool is created.
+ *
+ * Returns: %TRUE if a pool was configured in @query.
+ */
+gboolean
+__gst_audio_decide_output_pool (GstElement * element, GstQuery * query,
+    gsize max_frame_size)
+{
+  GstBufferPool *pool = NULL;
+  GstAllocator *allocator = NULL;
+  GstAllocationParams params;
+  GstStructure *config;
+  GstCaps *caps = NULL;
+  guint size, min, max;
+  gboolean update_pool;
+
+  gst_query_parse_allocation (query, &caps, NULL);
+
+  if (gst_query_get_n_allocation_params (query) > 0)
+    gst_query_parse_nth_allocation_param (query, 0, &allocator, &params);
+  else
+    gst_allocation_params_init (&params);
+
+  if (gst_query_get_n_allocation_pools (query) > 0) {
+    gst_query_parse_nth_allocation_pool (query, 0, &pool, &size, &min, &max);
+    size = MAX (size, max_frame_size);
+    update_pool = TRUE;
+  } else {
+    size = max_frame_size;
+    min = max = 0;
+    update_pool = FALSE;
+  }
+
+  if (pool == NULL) {
+    GST_DEBUG_OBJECT (element, "no pool, making new pool");
+    pool = gst_buffer_pool_new ();
+  }
+
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, caps, size, min, max);
+  gst_buffer_pool_config_set_allocator (config, allocator, &params);
+
+  if (!gst_buffer_pool_set_config (pool, config)) {
+    /* downstream pool doesn't like our config, use a plain one instead */
+    GST_DEBUG_OBJECT (element, "unsupported pool, making new pool");
+    gst_object_unref (pool);
+    pool = gst_buffer_pool_new ();
+    config = gst_buffer_pool_get_config (pool);
+    gst_buffer_pool_config_set_params (config, caps, size, min, max);
+    gst_buffer_pool_config_set_allocator (config, allocator, &params);
+
+    if (!gst_buffer_pool_set_config (pool, config)) {
+      GST_WARNING_OBJECT (element, "failed to configure output pool");
+      gst_object_unref (pool);
+      if (allocator)
+        gst_object_unref (allocator);
+      return FALSE;
+    }
+  }
+
+  GST_DEBUG_OBJECT (element, "using output pool %" GST_PTR_FORMAT
+      " with buffers of %u bytes", pool, size);
+
+  if (update_pool)
+    gst_query_set_nth_allocation_pool (query, 0, pool, size, min, max);
+  else
+    gst_query_add_allocation_pool (query, pool, size, min, max);
+
+  gst_object_unref (pool);
+  if (allocator)
+    gst_object_unref (allocator);
+
+  return TRUE;
+}
+
+static GQuark
+__gst_audio_pooled_buffer_quark (void)
+{
+  static gsize quark = 0;
+
+  if (g_once_init_enter (&quark)) {
+    gsize q = g_quark_from_static_string ("GstAudioPooledBuffer");
+
+    g_once_init_leave (&quark, q);
+  }
+
+  return (GQuark) quark;
+}
+
+/*
+ * Helper function to take a buffer of @size bytes from @pool. Buffers are
+ * marked the first time they come out of @pool, which allows to tell if
+ * @pool had to allocate a new buffer or recycled one and is reported in
+ * @recycled.
+ *
+ * This never blocks: downstream may hold on to all buffers of a pool with
+ * a maximum number of buffers, so %NULL is returned when @pool is empty and
+ * the caller is expected to allocate a buffer outside of it.
+ */
+GstBuffer *
+__gst_audio_acquire_pooled_buffer (GstBufferPool * pool, gsize size,
+    gboolean * recycled)
+{
+  GQuark quark = __gst_audio_pooled_buffer_quark ();
+  GstBufferPoolAcquireParams params = { 0, };
+  GstBuffer *buffer = NULL;
+
+  params.flags = GST_BUFFER_POOL_ACQUIRE_FLAG_DONTWAIT;
+  if (gst_buffer_pool_acquire_buffer (pool, &buffer, &params) != GST_FLOW_OK)
+    return NULL;
+
+  if (gst_mini_object_get_qdata (GST_MINI_OBJECT_CAST (buffer), quark)) {
+    *recycled = TRUE;
+  } else {
+    gst_mini_object_set_qdata (GST_MINI_OBJECT_CAST (buffer), quark,
+        GINT_TO_POINTER (1), NULL);
+    *recycled = FALSE;
+  }
+
+  /* the pool resets the size when the buffer comes back */
+  gst_buffer_set_size (buffer, size);
+
+  return buffer;
+}
+
 #ifdef G_OS_WIN32
 /* *INDENT-OFF* */
 static struct
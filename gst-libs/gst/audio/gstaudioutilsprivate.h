@@ -42,9 +42,22 @@ gboolean __gst_audio_encoded_audio_convert (GstAudioInfo * fmt, gint64 bytes,
                                             gint64 src_value, GstFormat * dest_format,
                                             gint64 * dest_value);
 
+G_GNUC_INTERNAL
+gboolean __gst_audio_decide_output_pool (GstElement * element, GstQuery * query,
+                                         gsize max_frame_size);
+
+G_GNUC_INTERNAL
+GstBuffer *__gst_audio_acquire_pooled_buffer (GstBufferPool * pool, gsize size,
+                                              gboolean * recycled);
+
 G_GNUC_INTERNAL
 gboolean __gst_audio_set_thread_priority   (gpointer * handle);
 
+/* Ringbuffer utility functions */
+G_GNUC_INTERNAL
+gboolean __gst_audio_ring_buffer_wait_played (GstAudioRingBuffer * buf,
+                                              guint64 sample);
+
 G_GNUC_INTERNAL
 gboolean __gst_audio_restore_thread_priority (gpointer handle);
 
@@ -54,6 +54,14 @@
  * to apply a window function to it. For this gst_fft_f32_window() can comfortably
  * be used.
  *
+ * Several channels or frames of the same length can be transformed with a
+ * single call to gst_fft_f32_fft_batch(), which also applies the window
+ * while reading the samples.
+ *
+ * Lengths that are a power of two use a radix-4 FFT working on separate
+ * real and imaginary arrays, which the compiler can vectorize. All other
+ * lengths use a mixed radix FFT.
+ *
  * Be aware, that you can't simply run gst_fft_f32_inverse_fft() on the
  * resulting frequency data of gst_fft_f32_fft() to get the original data back.
  * The relation between them is iFFT (FFT (x)) = x * nfft where nfft is the
@@ -67,8 +75,26 @@ struct _GstFFTF32
   void *cfg;
   gboolean inverse;
   gint len;
+
+  /* power of two lengths: half of len, the complex FFT stage twiddles, the
+   * real FFT twiddles and two split complex work buffers, otherwise 0 */
+  gint half_len;
+  gfloat *twiddles;
+  gfloat *rtwiddles;
+  gfloat *work;
+
+  /* gst_fft_f32_fft_batch() */
+  GstFFTWindow window;
+  gfloat *window_coeffs;
+  gfloat *scratch;
 };
 
+#define FFT_TYPE gfloat
+#define FFT_COMPLEX GstFFTF32Complex
+#define FFT_SELF GstFFTF32
+#define FFT_FUNC(name) gst_fft_f32_##name
+#include "gstfftpow2.h"
+
 /**
  * gst_fft_f32_new: (skip)
  * @len: Length of the FFT in the time domain
@@ -92,17 +118,34 @@ gst_fft_f32_new (gint len, gboolean inverse)
   g_return_val_if_fail (len > 0, NULL);
   g_return_val_if_fail (len % 2 == 0, NULL);
 
-  kiss_fftr_f32_alloc (len, (inverse) ? 1 : 0, NULL, &subsize);
-  memneeded = ALIGN_STRUCT (sizeof (GstFFTF32)) + subsize;
+  if (gst_fft_f32_use_pow2 (len)) {
+    gint m = len / 2;
 
-  self = (GstFFTF32 *) g_malloc0 (memneeded);
+    memneeded = ALIGN_STRUCT (sizeof (GstFFTF32)) +
+        POW2_N_VALUES (m) * sizeof (gfloat);
+    self = (GstFFTF32 *) g_malloc0 (memneeded);
 
-  self->cfg = (((guint8 *) self) + ALIGN_STRUCT (sizeof (GstFFTF32)));
-  self->cfg = kiss_fftr_f32_alloc (len, (inverse) ? 1 : 0, self->cfg, &subsize);
-  g_assert (self->cfg);
+    self->half_len = m;
+    self->twiddles =
+        (gfloat *) (((guint8 *) self) + ALIGN_STRUCT (sizeof (GstFFTF32)));
+    self->rtwiddles = self->twiddles + 2 * m;
+    self->work = self->rtwiddles + 2 * m;
+    gst_fft_f32_pow2_init (self);
+  } else {
+    kiss_fftr_f32_alloc (len, (inverse) ? 1 : 0, NULL, &subsize);
+    memneeded = ALIGN_STRUCT (sizeof (GstFFTF32)) + subsize;
+
+    self = (GstFFTF32 *) g_malloc0 (memneeded);
+
+    self->cfg = (((guint8 *) self) + ALIGN_STRUCT (sizeof (GstFFTF32)));
+    self->cfg =
+        kiss_fftr_f32_alloc (len, (inverse) ? 1 : 0, self->cfg, &subsize);
+    g_assert (self->cfg);
+  }
 
   self->inverse = inverse;
   self->len = len;
+  self->window = GST_FFT_WINDOW_RECTANGULAR;
 
   return self;
 }
@@ -131,7 +174,10 @@ gst_fft_f32_fft (GstFFTF32 * self, const gfloat * timedata,
   g_return_if_fail (timedata);
   g_return_if_fail (freqdata);
 
-  kiss_fftr_f32 (self->cfg, timedata, (kiss_fft_f32_cpx *) freqdata);
+  if (self->half_len)
+    gst_fft_f32_pow2_fft (self, timedata, 1, NULL, freqdata);
+  else
+    kiss_fftr_f32 (self->cfg, timedata, (kiss_fft_f32_cpx *) freqdata);
 }
 
 /**
@@ -157,7 +203,10 @@ gst_fft_f32_inverse_fft (GstFFTF32 * self, const GstFFTF32Complex * freqdata,
   g_return_if_fail (timedata);
   g_return_if_fail (freqdata);
 
-  kiss_fftri_f32 (self->cfg, (kiss_fft_f32_cpx *) freqdata, timedata);
+  if (self->half_len)
+    gst_fft_f32_pow2_inverse_fft (self, freqdata, timedata);
+  else
+    kiss_fftri_f32 (self->cfg, (kiss_fft_f32_cpx *) freqdata, timedata);
 }
 
 /**
@@ -170,6 +219,8 @@ gst_fft_f32_inverse_fft (GstFFTF32 * self, const GstFFTF32Complex * freqdata,
 void
 gst_fft_f32_free (GstFFTF32 * self)
 {
+  g_free (self->window_coeffs);
+  g_free (self->scratch);
   g_free (self);
 }
 
@@ -218,3 +269,80 @@ gst_fft_f32_window (GstFFTF32 * self, gfloat * timedata, GstFFTWindow window)
       break;
   }
 }
+
+/**
+ * gst_fft_f32_fft_batch:
+ * @self: #GstFFTF32 instance for this call
+ * @timedata: Buffer of the samples in the time domain
+ * @sample_stride: Distance between two samples of a frame in @timedata
+ * @frame_stride: Distance between the first samples of two frames in
+ *     @timedata
+ * @n_frames: Number of frames to transform
+ * @window: Window function to apply to each frame
+ * @freqdata: Target buffer for the samples in the frequency domain
+ *
+ * This applies @window to @n_frames frames of @timedata and performs the
+ * FFT on each of them, putting the results one after the other in
+ * @freqdata. @timedata itself is not modified.
+ *
+ * Each frame has as many samples as specified with the @len parameter while
+ * allocating the #GstFFTF32 instance with gst_fft_f32_new(). For the channels
+ * of interleaved audio @sample_stride is the number of channels and
+ * @frame_stride is 1. For consecutive frames overlapping by 50%
+ * @sample_stride is 1 and @frame_stride is @len / 2.
+ *
+ * @freqdata must be large enough to hold @n_frames * (@len/2 + 1)
+ * #GstFFTF32Complex frequency domain samples.
+ *
+ * Since: 1.20
+ */
+void
+gst_fft_f32_fft_batch (GstFFTF32 * self, const gfloat * timedata,
+    gint sample_stride, gint frame_stride, gint n_frames, GstFFTWindow window,
+    GstFFTF32Complex * freqdata)
+{
+  const gfloat *coeffs = NULL;
+  gint f, i, len;
+
+  g_return_if_fail (self);
+  g_return_if_fail (!self->inverse);
+  g_return_if_fail (timedata);
+  g_return_if_fail (freqdata);
+  g_return_if_fail (sample_stride > 0);
+  g_return_if_fail (frame_stride >= 0);
+  g_return_if_fail (n_frames >= 0);
+
+  len = self->len;
+
+  if (window != GST_FFT_WINDOW_RECTANGULAR) {
+    if (self->window_coeffs == NULL || self->window != window) {
+      if (self->window_coeffs == NULL)
+        self->window_coeffs = g_new (gfloat, len);
+      for (i = 0; i < len; i++)
+        self->window_coeffs[i] = 1.0;
+      gst_fft_f32_window (self, self->window_coeffs, window);
+      self->window = window;
+    }
+    coeffs = self->window_coeffs;
+  }
+
+  if (self->half_len == 0 && self->scratch == NULL)
+    self->scratch = g_new (gfloat, len);
+
+  for (f = 0; f < n_frames; f++) {
+    const gfloat *frame = timedata + (gssize) f * frame_stride;
+    GstFFTF32Complex *out = freqdata + (gsize) f * (len / 2 + 1);
+
+    if (self->half_len) {
+      gst_fft_f32_pow2_fft (self, frame, sample_stride, coeffs, out);
+    } else {
+      for (i = 0; i < len; i++)
+        self->scratch[i] = frame[i * sample_stride];
+      if (coeffs) {
+        for (i = 0; i < len; i++)
+          self->scratch[i] *= coeffs[i];
+      }
+      kiss_fftr_f32 (self->cfg, self->scratch, (kiss_fft_f32_cpx *) out);
+    }
+  }
+}
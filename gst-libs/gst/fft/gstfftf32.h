@@ -66,6 +66,12 @@ void          gst_fft_f32_inverse_fft   (GstFFTF32 *self, const GstFFTF32Complex
 GST_FFT_API
 void          gst_fft_f32_window        (GstFFTF32 *self, gfloat *timedata, GstFFTWindow window);
 
+GST_FFT_API
+void          gst_fft_f32_fft_batch     (GstFFTF32 *self, const gfloat *timedata,
+                                         gint sample_stride, gint frame_stride,
+                                         gint n_frames, GstFFTWindow window,
+                                         GstFFTF32Complex *freqdata);
+
 G_END_DECLS
 
 #endif /* __GST_FFT_F32_H__ */
@@ -66,6 +66,12 @@ void            gst_fft_f64_inverse_fft (GstFFTF64 *self, const GstFFTF64Complex
 GST_FFT_API
 void            gst_fft_f64_window      (GstFFTF64 *self, gdouble *timedata, GstFFTWindow window);
 
+GST_FFT_API
+void            gst_fft_f64_fft_batch   (GstFFTF64 *self, const gdouble *timedata,
+                                         gint sample_stride, gint frame_stride,
+                                         gint n_frames, GstFFTWindow window,
+                                         GstFFTF64Complex *freqdata);
+
 G_END_DECLS
 
 #endif /* __GST_FFT_F64_H__ */
@@ -0,0 +1,271 @@
+/* GStreamer
+ * Copyright (C) <2007> Sebastian Dröge <slomo@circular-chaos.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Radix-4 Stockham FFT for power of two lengths, shared by the float and
+ * double implementations. Before including this file define
+ *
+ *  FFT_TYPE:       the sample type, gfloat or gdouble
+ *  FFT_COMPLEX:    the complex type of the frequency domain samples
+ *  FFT_SELF:       the instance type, with the half_len, twiddles,
+ *                  rtwiddles and work fields
+ *  FFT_FUNC(name): the name of the function @name for this type
+ */
+
+#ifndef FFT_TYPE
+#error "FFT_TYPE must be defined before including gstfftpow2.h"
+#endif
+
+#ifndef restrict
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+/* restrict should be available */
+#elif defined(__GNUC__) && __GNUC__ >= 4
+#define restrict __restrict__
+#elif defined(_MSC_VER) &&  _MSC_VER >= 1500
+#define restrict __restrict
+#else
+#define restrict                /* no op */
+#endif
+#endif
+
+/* Number of values needed for the tables and work buffers of a power of two
+ * FFT with @half_len complex points: at most 2 * @half_len for the stage
+ * twiddles, 2 * @half_len for the real FFT twiddles and 4 * @half_len for
+ * the work buffers */
+#define POW2_N_VALUES(half_len) (8 * (half_len))
+
+static gboolean
+FFT_FUNC (use_pow2) (gint len)
+{
+  return len >= 8 && (len & (len - 1)) == 0;
+}
+
+static void
+FFT_FUNC (pow2_init) (FFT_SELF * self)
+{
+  gint m = self->half_len;
+  FFT_TYPE *tw = self->twiddles;
+  gint n, p, k;
+
+  /* per radix-4 stage of length n, the twiddles w^p, w^2p and w^3p with
+   * w = exp(-2 pi i / n), stored as 6 arrays of n / 4 values */
+  for (n = m; n >= 4; n /= 4) {
+    gint n1 = n / 4;
+
+    for (p = 0; p < n1; p++) {
+      gdouble theta = -2.0 * G_PI * p / n;
+
+      tw[p] = cos (theta);
+      tw[n1 + p] = sin (theta);
+      tw[2 * n1 + p] = cos (2.0 * theta);
+      tw[3 * n1 + p] = sin (2.0 * theta);
+      tw[4 * n1 + p] = cos (3.0 * theta);
+      tw[5 * n1 + p] = sin (3.0 * theta);
+    }
+    tw += 6 * n1;
+  }
+
+  /* exp(-2 pi i k / len) to split the half length complex FFT into the
+   * spectrum of the real signal */
+  for (k = 0; k < m; k++) {
+    gdouble theta = -G_PI * k / m;
+
+    self->rtwiddles[k] = cos (theta);
+    self->rtwiddles[m + k] = sin (theta);
+  }
+}
+
+/* Radix-4 butterfly of the inputs at i, i + is, i + 2 * is and i + 3 * is
+ * to the outputs at o, o + os, o + 2 * os and o + 3 * os, multiplied with
+ * the twiddles of p */
+#define RADIX4_BUTTERFLY(i, is, o, os, p) G_STMT_START {                \
+  FFT_TYPE apcr = xr[i] + xr[i + 2 * is], apci = xi[i] + xi[i + 2 * is]; \
+  FFT_TYPE amcr = xr[i] - xr[i + 2 * is], amci = xi[i] - xi[i + 2 * is]; \
+  FFT_TYPE bpdr = xr[i + is] + xr[i + 3 * is];                          \
+  FFT_TYPE bpdi = xi[i + is] + xi[i + 3 * is];                          \
+  /* i * (b - d) */                                                     \
+  FFT_TYPE jbmdr = xi[i + 3 * is] - xi[i + is];                         \
+  FFT_TYPE jbmdi = xr[i + is] - xr[i + 3 * is];                         \
+  FFT_TYPE tr, ti;                                                      \
+                                                                        \
+  yr[o] = apcr + bpdr;                                                  \
+  yi[o] = apci + bpdi;                                                  \
+  tr = amcr - jbmdr;                                                    \
+  ti = amci - jbmdi;                                                    \
+  yr[o + os] = tr * tw[p] - ti * tw[n1 + p];                            \
+  yi[o + os] = tr * tw[n1 + p] + ti * tw[p];                            \
+  tr = apcr - bpdr;                                                     \
+  ti = apci - bpdi;                                                     \
+  yr[o + 2 * os] = tr * tw[2 * n1 + p] - ti * tw[3 * n1 + p];           \
+  yi[o + 2 * os] = tr * tw[3 * n1 + p] + ti * tw[2 * n1 + p];           \
+  tr = amcr + jbmdr;                                                    \
+  ti = amci + jbmdi;                                                    \
+  yr[o + 3 * os] = tr * tw[4 * n1 + p] - ti * tw[5 * n1 + p];           \
+  yi[o + 3 * os] = tr * tw[5 * n1 + p] + ti * tw[4 * n1 + p];           \
+} G_STMT_END
+
+/* First radix-4 stage, consecutive butterflies read consecutive samples */
+static void
+FFT_FUNC (radix4_first) (gint n1, const FFT_TYPE * restrict xr,
+    const FFT_TYPE * restrict xi, FFT_TYPE * restrict yr,
+    FFT_TYPE * restrict yi, const FFT_TYPE * restrict tw)
+{
+  gint p;
+
+  for (p = 0; p < n1; p++)
+    RADIX4_BUTTERFLY (p, n1, 4 * p, 1, p);
+}
+
+/* Following radix-4 stages on @s interleaved transforms, the inner loop
+ * runs over consecutive samples with the same twiddles */
+static void
+FFT_FUNC (radix4_stage) (gint n1, gint s, const FFT_TYPE * restrict xr,
+    const FFT_TYPE * restrict xi, FFT_TYPE * restrict yr,
+    FFT_TYPE * restrict yi, const FFT_TYPE * restrict tw)
+{
+  gint p, q;
+
+  for (p = 0; p < n1; p++) {
+    for (q = 0; q < s; q++)
+      RADIX4_BUTTERFLY (q + s * p, s * n1, q + 4 * s * p, s, p);
+  }
+}
+
+/* Stockham autosort FFT of length half_len on the split complex data in the
+ * first work buffer, alternating between both work buffers. Returns the
+ * buffer holding the result in @re and @im. */
+static void
+FFT_FUNC (pow2_transform) (FFT_SELF * self, FFT_TYPE ** re, FFT_TYPE ** im)
+{
+  gint m = self->half_len;
+  const FFT_TYPE *tw = self->twiddles;
+  FFT_TYPE *xr = self->work, *xi = self->work + m;
+  FFT_TYPE *yr = self->work + 2 * m, *yi = self->work + 3 * m;
+  FFT_TYPE *t;
+  gint n, s, q;
+
+  for (n = m, s = 1; n >= 4; n /= 4, s *= 4) {
+    gint n1 = n / 4;
+
+    if (s == 1)
+      FFT_FUNC (radix4_first) (n1, xr, xi, yr, yi, tw);
+    else
+      FFT_FUNC (radix4_stage) (n1, s, xr, xi, yr, yi, tw);
+
+    tw += 6 * n1;
+    t = xr, xr = yr, yr = t;
+    t = xi, xi = yi, yi = t;
+  }
+
+  /* final radix-2 stage for odd powers of two */
+  if (n == 2) {
+    for (q = 0; q < s; q++) {
+      yr[q] = xr[q] + xr[q + s];
+      yi[q] = xi[q] + xi[q + s];
+      yr[q + s] = xr[q] - xr[q + s];
+      yi[q + s] = xi[q] - xi[q + s];
+    }
+    xr = yr;
+    xi = yi;
+  }
+
+  *re = xr;
+  *im = xi;
+}
+
+/* Real FFT of the len samples at @timedata, @stride samples apart,
+ * optionally multiplied with @window, through a complex FFT of the even
+ * and odd samples */
+static void
+FFT_FUNC (pow2_fft) (FFT_SELF * self, const FFT_TYPE * timedata, gint stride,
+    const FFT_TYPE * window, FFT_COMPLEX * freqdata)
+{
+  gint m = self->half_len;
+  FFT_TYPE *re = self->work, *im = self->work + m;
+  const FFT_TYPE *wr = self->rtwiddles, *wi = self->rtwiddles + m;
+  gint k;
+
+  if (window) {
+    for (k = 0; k < m; k++) {
+      re[k] = timedata[2 * k * stride] * window[2 * k];
+      im[k] = timedata[(2 * k + 1) * stride] * window[2 * k + 1];
+    }
+  } else if (stride == 1) {
+    for (k = 0; k < m; k++) {
+      re[k] = timedata[2 * k];
+      im[k] = timedata[2 * k + 1];
+    }
+  } else {
+    for (k = 0; k < m; k++) {
+      re[k] = timedata[2 * k * stride];
+      im[k] = timedata[(2 * k + 1) * stride];
+    }
+  }
+
+  FFT_FUNC (pow2_transform) (self, &re, &im);
+
+  freqdata[0].r = re[0] + im[0];
+  freqdata[0].i = 0.0;
+  freqdata[m].r = re[0] - im[0];
+  freqdata[m].i = 0.0;
+
+  for (k = 1; k < m; k++) {
+    /* spectra of the even and odd samples from Z[k] and conj (Z[m - k]) */
+    FFT_TYPE er = (FFT_TYPE) 0.5 * (re[k] + re[m - k]);
+    FFT_TYPE ei = (FFT_TYPE) 0.5 * (im[k] - im[m - k]);
+    FFT_TYPE odr = (FFT_TYPE) 0.5 * (im[k] + im[m - k]);
+    FFT_TYPE odi = (FFT_TYPE) 0.5 * (re[m - k] - re[k]);
+
+    freqdata[k].r = er + odr * wr[k] - odi * wi[k];
+    freqdata[k].i = ei + odr * wi[k] + odi * wr[k];
+  }
+}
+
+static void
+FFT_FUNC (pow2_inverse_fft) (FFT_SELF * self,
+    const FFT_COMPLEX * freqdata, FFT_TYPE * timedata)
+{
+  gint m = self->half_len;
+  FFT_TYPE *re = self->work, *im = self->work + m;
+  const FFT_TYPE *wr = self->rtwiddles, *wi = self->rtwiddles + m;
+  gint k;
+
+  /* combine the spectra of the even and odd samples into Z[k] and
+   * conjugate it, so that the forward FFT calculates the inverse */
+  for (k = 0; k < m; k++) {
+    FFT_TYPE xr = freqdata[k].r, xi = freqdata[k].i;
+    FFT_TYPE yr = freqdata[m - k].r, yi = -freqdata[m - k].i;
+    FFT_TYPE er = xr + yr, ei = xi + yi;
+    FFT_TYPE dr = xr - yr, di = xi - yi;
+    /* (x - conj (y)) * conj (w) */
+    FFT_TYPE odr = dr * wr[k] + di * wi[k];
+    FFT_TYPE odi = di * wr[k] - dr * wi[k];
+
+    re[k] = er - odi;
+    im[k] = -(ei + odr);
+  }
+
+  FFT_FUNC (pow2_transform) (self, &re, &im);
+
+  for (k = 0; k < m; k++) {
+    timedata[2 * k] = re[k];
+    timedata[2 * k + 1] = -im[k];
+  }
+}
+
+#undef RADIX4_BUTTERFLY
@@ -126,6 +126,8 @@ struct _GstAudioVisualizerPrivate
   /* QoS stuff *//* with LOCK */
   gdouble proportion;
   GstClockTime earliest_time;
+  /* fraction of a frame we may render while downstream can't keep up */
+  gdouble render_credit;
 
   guint dropped;                /* frames dropped / not dropped */
   guint processed;
@@ -138,37 +140,66 @@ struct _GstAudioVisualizerPrivate
 
 /* shading functions */
 
-/* we're only supporting GST_VIDEO_FORMAT_xRGB right now) */
-#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+/* we're only supporting GST_VIDEO_FORMAT_xRGB right now)
+ *
+ * Shading subtracts the shade amount from the colour components of a pixel
+ * with saturation and clears the padding byte. Loaded as a native endian
+ * 32 bit word, an xRGB pixel has its padding in the top byte and r, g and b
+ * in the same bit positions as the 0x00RRGGBB shade amount on both big and
+ * little endian machines, so we can process whole pixels with a SWAR
+ * saturating byte subtraction, two pixels per 64 bit word. */
+#define SHADE_HI_BITS G_GUINT64_CONSTANT (0x8080808080808080)
+#define SHADE_PIX_MASK G_GUINT64_CONSTANT (0x00ffffff00ffffff)
+
+static inline guint64
+shade_sub_sat (guint64 s, guint64 k)
+{
+  guint64 diff, borrow;
 
-#define SHADE(_d, _s, _i, _r, _g, _b)                     \
-G_STMT_START {                                            \
-    _d[_i * 4 + 0] = (_s[_i * 4 + 0] > _b) ? _s[_i * 4 + 0] - _b : 0; \
-    _d[_i * 4 + 1] = (_s[_i * 4 + 1] > _g) ? _s[_i * 4 + 1] - _g : 0; \
-    _d[_i * 4 + 2] = (_s[_i * 4 + 2] > _r) ? _s[_i * 4 + 2] - _r : 0; \
-    _d[_i * 4 + 3] = 0;                                       \
-} G_STMT_END
+  /* per byte s - k, without carrying the borrow into the next byte */
+  diff = ((s | SHADE_HI_BITS) - (k & ~SHADE_HI_BITS)) ^
+      ((s ^ ~k) & SHADE_HI_BITS);
+  /* the top bit of each byte is set if that byte underflowed */
+  borrow = ((~s & k) | ((~s | k) & diff)) & SHADE_HI_BITS;
 
-#else /* G_BYTE_ORDER == G_LITTLE_ENDIAN */
+  return diff & ~((borrow >> 7) * 0xff);
+}
 
-#define SHADE(_d, _s, _i, _r, _g, _b)                     \
-G_STMT_START {                                            \
-    _d[_i * 4 + 0] = 0;                                       \
-    _d[_i * 4 + 1] = (_s[_i * 4 + 1] > _r) ? _s[_i * 4 + 1] - _r : 0; \
-    _d[_i * 4 + 2] = (_s[_i * 4 + 2] > _g) ? _s[_i * 4 + 2] - _g : 0; \
-    _d[_i * 4 + 3] = (_s[_i * 4 + 3] > _b) ? _s[_i * 4 + 3] - _b : 0; \
-} G_STMT_END
+static void
+shade_line (guint8 * d, const guint8 * s, gint width, guint64 k)
+{
+  guint64 p;
+  guint32 p32;
+  gint i;
+
+  /* rows can start unaligned for the vertical shaders, which move by a byte,
+   * memcpy compiles to a plain load/store where that is allowed */
+  for (i = 0; i + 1 < width; i += 2) {
+    memcpy (&p, s + i * 4, 8);
+    p = shade_sub_sat (p, k) & SHADE_PIX_MASK;
+    memcpy (d + i * 4, &p, 8);
+  }
+  if (i < width) {
+    memcpy (&p32, s + i * 4, 4);
+    p32 = (guint32) (shade_sub_sat (p32, k) & SHADE_PIX_MASK);
+    memcpy (d + i * 4, &p32, 4);
+  }
+}
 
-#endif
+static inline guint64
+shade_amount_word (GstAudioVisualizer * scope)
+{
+  guint64 k = scope->priv->shade_amount & 0x00ffffff;
+
+  return k | (k << 32);
+}
 
 static void
 shader_fade (GstAudioVisualizer * scope, const GstVideoFrame * sframe,
     GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
+  guint j;
+  guint64 k = shade_amount_word (scope);
   guint8 *s, *d;
   gint ss, ds, width, height;
 
@@ -180,10 +211,14 @@ shader_fade (GstAudioVisualizer * scope, const GstVideoFrame * sframe,
   width = GST_VIDEO_FRAME_WIDTH (sframe);
   height = GST_VIDEO_FRAME_HEIGHT (sframe);
 
+  if (ss == ds && ss == width * 4) {
+    /* no padding between the rows, shade everything in one go */
+    shade_line (d, s, width * height, k);
+    return;
+  }
+
   for (j = 0; j < height; j++) {
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    shade_line (d, s, width, k);
     s += ss;
     d += ds;
   }
@@ -193,10 +228,8 @@ static void
 shader_fade_and_move_up (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
+  guint j;
+  guint64 k = shade_amount_word (scope);
   guint8 *s, *d;
   gint ss, ds, width, height;
 
@@ -210,9 +243,7 @@ shader_fade_and_move_up (GstAudioVisualizer * scope,
 
   for (j = 1; j < height; j++) {
     s += ss;
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    shade_line (d, s, width, k);
     d += ds;
   }
 }
@@ -221,10 +252,8 @@ static void
 shader_fade_and_move_down (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
+  guint j;
+  guint64 k = shade_amount_word (scope);
   guint8 *s, *d;
   gint ss, ds, width, height;
 
@@ -238,9 +267,7 @@ shader_fade_and_move_down (GstAudioVisualizer * scope,
 
   for (j = 1; j < height; j++) {
     d += ds;
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    shade_line (d, s, width, k);
     s += ss;
   }
 }
@@ -249,10 +276,8 @@ static void
 shader_fade_and_move_left (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
+  guint j;
+  guint64 k = shade_amount_word (scope);
   guint8 *s, *d;
   gint ss, ds, width, height;
 
@@ -269,9 +294,7 @@ shader_fade_and_move_left (GstAudioVisualizer * scope,
 
   /* move to the left */
   for (j = 0; j < height; j++) {
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    shade_line (d, s, width, k);
     d += ds;
     s += ss;
   }
@@ -281,10 +304,8 @@ static void
 shader_fade_and_move_right (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
+  guint j;
+  guint64 k = shade_amount_word (scope);
   guint8 *s, *d;
   gint ss, ds, width, height;
 
@@ -301,9 +322,7 @@ shader_fade_and_move_right (GstAudioVisualizer * scope,
 
   /* move to the right */
   for (j = 0; j < height; j++) {
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    shade_line (d, s, width, k);
     d += ds;
     s += ss;
   }
@@ -313,10 +332,8 @@ static void
 shader_fade_and_move_horiz_out (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
+  guint j;
+  guint64 k = shade_amount_word (scope);
   guint8 *s, *d;
   gint ss, ds, width, height;
 
@@ -331,17 +348,13 @@ shader_fade_and_move_horiz_out (GstAudioVisualizer * scope,
   /* move upper half up */
   for (j = 0; j < height / 2; j++) {
     s += ss;
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    shade_line (d, s, width, k);
     d += ds;
   }
   /* move lower half down */
   for (j = 0; j < height / 2; j++) {
     d += ds;
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    shade_line (d, s, width, k);
     s += ss;
   }
 }
@@ -350,10 +363,8 @@ static void
 shader_fade_and_move_horiz_in (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
+  guint j;
+  guint64 k = shade_amount_word (scope);
   guint8 *s, *d;
   gint ss, ds, width, height;
 
@@ -368,17 +379,13 @@ shader_fade_and_move_horiz_in (GstAudioVisualizer * scope,
   /* move upper half down */
   for (j = 0; j < height / 2; j++) {
     d += ds;
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    shade_line (d, s, width, k);
     s += ss;
   }
   /* move lower half up */
   for (j = 0; j < height / 2; j++) {
     s += ss;
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    shade_line (d, s, width, k);
     d += ds;
   }
 }
@@ -387,12 +394,10 @@ static void
 shader_fade_and_move_vert_out (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
+  guint j;
+  guint64 k = shade_amount_word (scope);
   guint8 *s, *s1, *d, *d1;
-  gint ss, ds, width, height;
+  gint ss, ds, width, height, half;
 
   s = GST_VIDEO_FRAME_PLANE_DATA (sframe, 0);
   ss = GST_VIDEO_FRAME_PLANE_STRIDE (sframe, 0);
@@ -401,18 +406,15 @@ shader_fade_and_move_vert_out (GstAudioVisualizer * scope,
 
   width = GST_VIDEO_FRAME_WIDTH (sframe);
   height = GST_VIDEO_FRAME_HEIGHT (sframe);
+  half = width / 2;
 
   for (j = 0; j < height; j++) {
     /* move left half to the left */
     s1 = s + 1;
-    for (i = 0; i < width / 2; i++) {
-      SHADE (d, s1, i, r, g, b);
-    }
+    shade_line (d, s1, half, k);
     /* move right half to the right */
     d1 = d + 1;
-    for (; i < width - 1; i++) {
-      SHADE (d1, s, i, r, g, b);
-    }
+    shade_line (d1 + half * 4, s + half * 4, width - 1 - half, k);
     s += ss;
     d += ds;
   }
@@ -422,12 +424,10 @@ static void
 shader_fade_and_move_vert_in (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
+  guint j;
+  guint64 k = shade_amount_word (scope);
   guint8 *s, *s1, *d, *d1;
-  gint ss, ds, width, height;
+  gint ss, ds, width, height, half;
 
   s = GST_VIDEO_FRAME_PLANE_DATA (sframe, 0);
   ss = GST_VIDEO_FRAME_PLANE_STRIDE (sframe, 0);
@@ -436,18 +436,15 @@ shader_fade_and_move_vert_in (GstAudioVisualizer * scope,
 
   width = GST_VIDEO_FRAME_WIDTH (sframe);
   height = GST_VIDEO_FRAME_HEIGHT (sframe);
+  half = width / 2;
 
   for (j = 0; j < height; j++) {
     /* move left half to the right */
     d1 = d + 1;
-    for (i = 0; i < width / 2; i++) {
-      SHADE (d1, s, i, r, g, b);
-    }
+    shade_line (d1, s, half, k);
     /* move right half to the left */
     s1 = s + 1;
-    for (; i < width - 1; i++) {
-      SHADE (d, s1, i, r, g, b);
-    }
+    shade_line (d + half * 4, s1 + half * 4, width - 1 - half, k);
     s += ss;
     d += ds;
   }
@@ -690,6 +687,7 @@ gst_audio_visualizer_reset (GstAudioVisualizer * scope)
   GST_OBJECT_LOCK (scope);
   scope->priv->proportion = 1.0;
   scope->priv->earliest_time = -1;
+  scope->priv->render_credit = 0.0;
   scope->priv->dropped = 0;
   scope->priv->processed = 0;
   GST_OBJECT_UNLOCK (scope);
@@ -1039,6 +1037,26 @@ activate_failed:
   }
 }
 
+/* with config_lock */
+static void
+gst_audio_visualizer_post_qos (GstAudioVisualizer * scope, GstClockTime ts,
+    GstClockTime qostime, GstClockTimeDiff jitter, gdouble proportion,
+    GstClockTime duration)
+{
+  GstClockTime stream_time;
+  GstMessage *qos_msg;
+
+  ++scope->priv->dropped;
+  stream_time = gst_segment_to_stream_time (&scope->priv->segment,
+      GST_FORMAT_TIME, ts);
+  qos_msg = gst_message_new_qos (GST_OBJECT (scope), FALSE, qostime,
+      stream_time, ts, duration);
+  gst_message_set_qos_values (qos_msg, jitter, proportion, 1000000);
+  gst_message_set_qos_stats (qos_msg, GST_FORMAT_BUFFERS,
+      scope->priv->processed, scope->priv->dropped);
+  gst_element_post_message (GST_ELEMENT (scope), qos_msg);
+}
+
 static GstFlowReturn
 gst_audio_visualizer_chain (GstPad * pad, GstObject * parent,
     GstBuffer * buffer)
@@ -1049,7 +1067,6 @@ gst_audio_visualizer_chain (GstPad * pad, GstObject * parent,
   GstBuffer *inbuf;
   guint64 dist, ts;
   guint avail, sbpf;
-  gpointer adata;
   gint bpf, rate;
 
   scope = GST_AUDIO_VISUALIZER (parent);
@@ -1093,7 +1110,7 @@ gst_audio_visualizer_chain (GstPad * pad, GstObject * parent,
   avail = gst_adapter_available (scope->priv->adapter);
   GST_LOG_OBJECT (scope, "avail: %u, bpf: %u", avail, sbpf);
   while (avail >= sbpf) {
-    GstBuffer *outbuf;
+    GstBuffer *outbuf, *audio;
     GstVideoFrame outframe;
 
     /* get timestamp of the current adapter content */
@@ -1119,26 +1136,33 @@ gst_audio_visualizer_chain (GstPad * pad, GstObject * parent,
       GST_OBJECT_UNLOCK (scope);
 
       if (GST_CLOCK_TIME_IS_VALID (earliest_time) && qostime <= earliest_time) {
-        GstClockTime stream_time, jitter;
-        GstMessage *qos_msg;
-
         GST_DEBUG_OBJECT (scope,
             "QoS: skip ts: %" GST_TIME_FORMAT ", earliest: %" GST_TIME_FORMAT,
             GST_TIME_ARGS (qostime), GST_TIME_ARGS (earliest_time));
 
-        ++scope->priv->dropped;
-        stream_time = gst_segment_to_stream_time (&scope->priv->segment,
-            GST_FORMAT_TIME, ts);
-        jitter = GST_CLOCK_DIFF (qostime, earliest_time);
-        qos_msg = gst_message_new_qos (GST_OBJECT (scope), FALSE, qostime,
-            stream_time, ts, GST_BUFFER_DURATION (buffer));
-        gst_message_set_qos_values (qos_msg, jitter, proportion, 1000000);
-        gst_message_set_qos_stats (qos_msg, GST_FORMAT_BUFFERS,
-            scope->priv->processed, scope->priv->dropped);
-        gst_element_post_message (GST_ELEMENT (scope), qos_msg);
-
+        gst_audio_visualizer_post_qos (scope, ts, qostime,
+            GST_CLOCK_DIFF (qostime, earliest_time), proportion,
+            GST_BUFFER_DURATION (buffer));
         goto skip;
       }
+
+      /* downstream reports that it can't keep up with our framerate, only
+       * render every proportion'th frame until it has caught up. The audio
+       * of the skipped frames is still consumed. */
+      if (proportion > 1.0) {
+        scope->priv->render_credit += 1.0 / proportion;
+        if (scope->priv->render_credit < 1.0) {
+          GST_LOG_OBJECT (scope, "QoS: throttle ts: %" GST_TIME_FORMAT
+              ", proportion: %lf", GST_TIME_ARGS (qostime), proportion);
+
+          gst_audio_visualizer_post_qos (scope, ts, qostime, 0, proportion,
+              GST_BUFFER_DURATION (buffer));
+          goto skip;
+        }
+        scope->priv->render_credit -= 1.0;
+      } else {
+        scope->priv->render_credit = 0.0;
+      }
     }
 
     ++scope->priv->processed;
@@ -1161,8 +1185,18 @@ gst_audio_visualizer_chain (GstPad * pad, GstObject * parent,
     GST_BUFFER_DURATION (outbuf) = scope->priv->frame_duration;
 
     /* this can fail as the data size we need could have changed */
-    if (!(adata = (gpointer) gst_adapter_map (scope->priv->adapter, sbpf)))
+    if (sbpf > avail) {
+      gst_buffer_unref (outbuf);
       break;
+    }
+
+    /* share the audio memory instead of mapping the adapter, which would
+     * copy all data that spans input buffers into its own scratch area
+     * again for every (possibly overlapping) frame */
+    audio = gst_adapter_get_buffer_fast (scope->priv->adapter, sbpf);
+    gst_buffer_remove_all_memory (inbuf);
+    gst_buffer_copy_into (inbuf, audio, GST_BUFFER_COPY_MEMORY, 0, -1);
+    gst_buffer_unref (audio);
 
     gst_video_frame_map (&outframe, &scope->vinfo, outbuf, GST_MAP_READWRITE);
 
@@ -1177,14 +1211,11 @@ gst_audio_visualizer_chain (GstPad * pad, GstObject * parent,
       }
     }
 
-    gst_buffer_replace_all_memory (inbuf,
-        gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY, adata, sbpf, 0,
-            sbpf, NULL, NULL));
-
     /* call class->render() vmethod */
     if (klass->render) {
       if (!klass->render (scope, inbuf, &outframe)) {
         ret = GST_FLOW_ERROR;
+        gst_buffer_remove_all_memory (inbuf);
         gst_video_frame_unmap (&outframe);
         goto beach;
       } else {
@@ -1196,6 +1227,7 @@ gst_audio_visualizer_chain (GstPad * pad, GstObject * parent,
         }
       }
     }
+    gst_buffer_remove_all_memory (inbuf);
     gst_video_frame_unmap (&outframe);
 
     g_mutex_unlock (&scope->priv->config_lock);
@@ -1210,11 +1242,9 @@ gst_audio_visualizer_chain (GstPad * pad, GstObject * parent,
     /* we want to take less or more, depending on spf : req_spf */
     if (avail - sbpf >= sbpf) {
       gst_adapter_flush (scope->priv->adapter, sbpf);
-      gst_adapter_unmap (scope->priv->adapter);
     } else if (avail >= sbpf) {
       /* just flush a bit and stop */
       gst_adapter_flush (scope->priv->adapter, (avail - sbpf));
-      gst_adapter_unmap (scope->priv->adapter);
       break;
     }
     avail = gst_adapter_available (scope->priv->adapter);
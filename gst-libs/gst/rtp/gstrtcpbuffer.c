@@ -3582,3 +3582,870 @@ gst_rtcp_packet_xr_get_voip_jitter_buffer_params (GstRTCPPacket * packet,
 
   return TRUE;
 }
+
+/**
+ * gst_rtcp_packet_iter_init:
+ * @iter: a #GstRTCPPacketIter
+ * @data: (array length=size): the compound RTCP packet
+ * @size: the size of @data
+ * @reduced_size: %TRUE to accept reduced size RTCP as specified in RFC 5506
+ *
+ * Prepare @iter to walk the packets of the compound RTCP packet in @data.
+ * Unlike gst_rtcp_buffer_map(), this needs no #GstBuffer and performs no
+ * allocation; @data must stay valid while @iter and the views it returns
+ * are in use.
+ *
+ * Since: 1.20
+ */
+void
+gst_rtcp_packet_iter_init (GstRTCPPacketIter * iter, const guint8 * data,
+    gsize size, gboolean reduced_size)
+{
+  g_return_if_fail (iter != NULL);
+  g_return_if_fail (data != NULL || size == 0);
+
+  iter->data = data;
+  iter->size = size;
+  iter->offset = 0;
+  iter->valid_mask =
+      reduced_size ? GST_RTCP_REDUCED_SIZE_VALID_MASK : GST_RTCP_VALID_MASK;
+  iter->error = FALSE;
+}
+
+/**
+ * gst_rtcp_packet_iter_next:
+ * @iter: a #GstRTCPPacketIter
+ * @view: (out caller-allocates): a #GstRTCPPacketView to fill
+ *
+ * Validate the next packet of the compound packet and fill @view with it.
+ * The checks are the same as those of gst_rtcp_buffer_validate_data(), but
+ * they are done one packet at a time while walking, so the data is only
+ * traversed once.
+ *
+ * When this function returns %FALSE, gst_rtcp_packet_iter_is_valid() tells
+ * whether the end of the compound packet was reached or whether it was
+ * invalid. Packets returned before an error was detected have been
+ * validated individually.
+ *
+ * Returns: %TRUE if @view was filled with the next packet.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtcp_packet_iter_next (GstRTCPPacketIter * iter, GstRTCPPacketView * view)
+{
+  const guint8 *data;
+  gsize left, len;
+  guint8 pad_bytes;
+
+  g_return_val_if_fail (iter != NULL, FALSE);
+  g_return_val_if_fail (view != NULL, FALSE);
+
+  if (G_UNLIKELY (iter->error))
+    return FALSE;
+
+  left = iter->size - iter->offset;
+  if (left == 0 && iter->offset > 0)
+    return FALSE;
+
+  /* we need 4 bytes for the type and length */
+  if (G_UNLIKELY (left < 4))
+    goto wrong_length;
+
+  data = iter->data + iter->offset;
+
+  if (iter->offset == 0) {
+    /* first packet must be RR or SR and version must be 2 */
+    if (G_UNLIKELY ((GST_READ_UINT16_BE (data) & iter->valid_mask) !=
+            GST_RTCP_VALID_VALUE))
+      goto wrong_mask;
+  } else if (G_UNLIKELY ((data[0] & 0xc0) != (GST_RTCP_VERSION << 6))) {
+    goto wrong_version;
+  }
+
+  len = ((gsize) GST_READ_UINT16_BE (data + 2) + 1) << 2;
+  if (G_UNLIKELY (len > left))
+    goto wrong_length;
+
+  pad_bytes = 0;
+  if (data[0] & 0x20) {
+    /* padding only allowed on the last packet, the last byte contains the
+     * number of padded bytes including itself. must be a multiple of 4, but
+     * cannot be 0. */
+    if (G_UNLIKELY (len != left))
+      goto wrong_length;
+    pad_bytes = data[len - 1];
+    if (G_UNLIKELY (pad_bytes == 0 || (pad_bytes & 0x3)))
+      goto wrong_padding;
+  }
+
+  view->type = data[1];
+  view->count = data[0] & 0x1f;
+  view->padding = pad_bytes != 0;
+  view->data = data;
+  view->size = len;
+  view->body = data + 4;
+  view->body_size = len - 4 > pad_bytes ? len - 4 - pad_bytes : 0;
+
+  iter->offset += len;
+
+  return TRUE;
+
+  /* ERRORS */
+wrong_length:
+  {
+    GST_DEBUG ("len check failed at offset %" G_GSIZE_FORMAT, iter->offset);
+    iter->error = TRUE;
+    return FALSE;
+  }
+wrong_mask:
+  {
+    GST_DEBUG ("mask check failed");
+    iter->error = TRUE;
+    return FALSE;
+  }
+wrong_version:
+  {
+    GST_DEBUG ("wrong version at offset %" G_GSIZE_FORMAT, iter->offset);
+    iter->error = TRUE;
+    return FALSE;
+  }
+wrong_padding:
+  {
+    GST_DEBUG ("padding check failed");
+    iter->error = TRUE;
+    return FALSE;
+  }
+}
+
+/**
+ * gst_rtcp_packet_iter_is_valid:
+ * @iter: a #GstRTCPPacketIter
+ *
+ * Check if no validation error was found so far. After
+ * gst_rtcp_packet_iter_next() returned %FALSE, this tells whether the
+ * complete compound packet was valid.
+ *
+ * Returns: %TRUE if @iter did not encounter invalid data.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtcp_packet_iter_is_valid (const GstRTCPPacketIter * iter)
+{
+  g_return_val_if_fail (iter != NULL, FALSE);
+
+  return !iter->error;
+}
+
+/**
+ * gst_rtcp_packet_view_get_ssrc:
+ * @view: a #GstRTCPPacketView
+ *
+ * Get the first SSRC of the packet body. This is the sender SSRC for SR, RR,
+ * feedback, XR and APP packets, the first SSRC of a BYE packet and the SSRC
+ * of the first chunk of a SDES packet.
+ *
+ * Returns: the SSRC or 0 when the packet body is too short.
+ *
+ * Since: 1.20
+ */
+guint32
+gst_rtcp_packet_view_get_ssrc (const GstRTCPPacketView * view)
+{
+  g_return_val_if_fail (view != NULL, 0);
+
+  if (view->body_size < 4)
+    return 0;
+
+  return GST_READ_UINT32_BE (view->body);
+}
+
+/**
+ * gst_rtcp_packet_view_get_sender_info:
+ * @view: a #GstRTCPPacketView of type #GST_RTCP_TYPE_SR
+ * @ssrc: (out) (optional): result SSRC
+ * @ntptime: (out) (optional): result NTP time
+ * @rtptime: (out) (optional): result RTP time
+ * @packet_count: (out) (optional): result packet count
+ * @octet_count: (out) (optional): result octet count
+ *
+ * Parse the SR sender info of @view, see
+ * gst_rtcp_packet_sr_get_sender_info().
+ *
+ * Returns: %TRUE if the sender info could be read.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtcp_packet_view_get_sender_info (const GstRTCPPacketView * view,
+    guint32 * ssrc, guint64 * ntptime, guint32 * rtptime,
+    guint32 * packet_count, guint32 * octet_count)
+{
+  const guint8 *data;
+
+  g_return_val_if_fail (view != NULL, FALSE);
+  g_return_val_if_fail (view->type == GST_RTCP_TYPE_SR, FALSE);
+
+  if (view->body_size < 24)
+    return FALSE;
+
+  data = view->body;
+  if (ssrc)
+    *ssrc = GST_READ_UINT32_BE (data);
+  if (ntptime)
+    *ntptime = GST_READ_UINT64_BE (data + 4);
+  if (rtptime)
+    *rtptime = GST_READ_UINT32_BE (data + 12);
+  if (packet_count)
+    *packet_count = GST_READ_UINT32_BE (data + 16);
+  if (octet_count)
+    *octet_count = GST_READ_UINT32_BE (data + 20);
+
+  return TRUE;
+}
+
+/**
+ * gst_rtcp_packet_view_get_rb:
+ * @view: a #GstRTCPPacketView of type #GST_RTCP_TYPE_SR or #GST_RTCP_TYPE_RR
+ * @nth: the nth report block in @view
+ * @ssrc: (out) (optional): result for data source being reported
+ * @fractionlost: (out) (optional): result for fraction lost since last SR/RR
+ * @packetslost: (out) (optional): result for the cumulative number of packets lost
+ * @exthighestseq: (out) (optional): result for the extended last sequence number received
+ * @jitter: (out) (optional): result for the interarrival jitter
+ * @lsr: (out) (optional): result for the last SR packet from this source
+ * @dlsr: (out) (optional): result for the delay since last SR packet
+ *
+ * Parse the values of the @nth report block of @view, see
+ * gst_rtcp_packet_get_rb().
+ *
+ * Returns: %TRUE if the report block could be read.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtcp_packet_view_get_rb (const GstRTCPPacketView * view, guint nth,
+    guint32 * ssrc, guint8 * fractionlost, gint32 * packetslost,
+    guint32 * exthighestseq, guint32 * jitter, guint32 * lsr, guint32 * dlsr)
+{
+  const guint8 *data;
+  gsize offset;
+  guint32 tmp;
+
+  g_return_val_if_fail (view != NULL, FALSE);
+  g_return_val_if_fail (view->type == GST_RTCP_TYPE_RR ||
+      view->type == GST_RTCP_TYPE_SR, FALSE);
+
+  if (nth >= view->count)
+    return FALSE;
+
+  /* skip the ssrc and the sender info */
+  offset = view->type == GST_RTCP_TYPE_RR ? 4 : 24;
+  offset += nth * 24;
+  if (offset + 24 > view->body_size)
+    return FALSE;
+
+  data = view->body + offset;
+  if (ssrc)
+    *ssrc = GST_READ_UINT32_BE (data);
+  tmp = GST_READ_UINT32_BE (data + 4);
+  if (fractionlost)
+    *fractionlost = (tmp >> 24);
+  if (packetslost) {
+    /* sign extend */
+    if (tmp & 0x00800000)
+      tmp |= 0xff000000;
+    else
+      tmp &= 0x00ffffff;
+    *packetslost = (gint32) tmp;
+  }
+  if (exthighestseq)
+    *exthighestseq = GST_READ_UINT32_BE (data + 8);
+  if (jitter)
+    *jitter = GST_READ_UINT32_BE (data + 12);
+  if (lsr)
+    *lsr = GST_READ_UINT32_BE (data + 16);
+  if (dlsr)
+    *dlsr = GST_READ_UINT32_BE (data + 20);
+
+  return TRUE;
+}
+
+/**
+ * gst_rtcp_packet_view_get_fb:
+ * @view: a #GstRTCPPacketView of type #GST_RTCP_TYPE_RTPFB or #GST_RTCP_TYPE_PSFB
+ * @sender_ssrc: (out) (optional): result sender SSRC
+ * @media_ssrc: (out) (optional): result media SSRC
+ * @fci: (out) (optional) (transfer none): result feedback control information
+ * @fci_length: (out) (optional): result length of @fci in 32-bit words
+ *
+ * Parse the common fields of the feedback packet @view. The feedback message
+ * type is available in the count field of @view.
+ *
+ * Returns: %TRUE if the feedback packet could be read.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtcp_packet_view_get_fb (const GstRTCPPacketView * view,
+    guint32 * sender_ssrc, guint32 * media_ssrc, const guint8 ** fci,
+    guint16 * fci_length)
+{
+  g_return_val_if_fail (view != NULL, FALSE);
+  g_return_val_if_fail (view->type == GST_RTCP_TYPE_RTPFB ||
+      view->type == GST_RTCP_TYPE_PSFB, FALSE);
+
+  if (view->body_size < 8)
+    return FALSE;
+
+  if (sender_ssrc)
+    *sender_ssrc = GST_READ_UINT32_BE (view->body);
+  if (media_ssrc)
+    *media_ssrc = GST_READ_UINT32_BE (view->body + 4);
+  if (fci)
+    *fci = view->body + 8;
+  if (fci_length)
+    *fci_length = (view->body_size - 8) >> 2;
+
+  return TRUE;
+}
+
+/**
+ * gst_rtcp_packet_view_sdes_next_chunk:
+ * @view: a #GstRTCPPacketView of type #GST_RTCP_TYPE_SDES
+ * @offset: (inout): the chunk cursor, initialize to 0
+ * @ssrc: (out) (optional): result SSRC of the chunk
+ * @items: (out) (optional) (transfer none): result item list of the chunk
+ * @items_size: (out) (optional): result size of @items in bytes
+ *
+ * Get the chunk at @offset in @view and move @offset to the next chunk. The
+ * items of the chunk, without the terminating null octet, can be walked
+ * with gst_rtcp_sdes_items_next().
+ *
+ * Returns: %TRUE if a chunk was found at @offset.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtcp_packet_view_sdes_next_chunk (const GstRTCPPacketView * view,
+    guint * offset, guint32 * ssrc, const guint8 ** items, guint * items_size)
+{
+  const guint8 *body;
+  gsize start, end;
+
+  g_return_val_if_fail (view != NULL, FALSE);
+  g_return_val_if_fail (view->type == GST_RTCP_TYPE_SDES, FALSE);
+  g_return_val_if_fail (offset != NULL, FALSE);
+
+  body = view->body;
+  start = *offset;
+  if (start + 4 > view->body_size)
+    return FALSE;
+
+  /* find the null octet that ends the item list */
+  end = start + 4;
+  while (end < view->body_size && body[end] != GST_RTCP_SDES_END) {
+    if (end + 2 > view->body_size)
+      return FALSE;
+    end += 2 + body[end + 1];
+  }
+  if (end >= view->body_size)
+    return FALSE;
+
+  if (ssrc)
+    *ssrc = GST_READ_UINT32_BE (body + start);
+  if (items)
+    *items = body + start + 4;
+  if (items_size)
+    *items_size = end - start - 4;
+
+  /* the next chunk starts at the next 32-bit boundary */
+  *offset = GST_ROUND_UP_4 (end + 1);
+
+  return TRUE;
+}
+
+/**
+ * gst_rtcp_sdes_items_next:
+ * @items: (array length=items_size): an item list from
+ *     gst_rtcp_packet_view_sdes_next_chunk()
+ * @items_size: the size of @items
+ * @offset: (inout): the item cursor, initialize to 0
+ * @type: (out) (optional): result type of the item
+ * @len: (out) (optional): result length of the item data
+ * @data: (out) (optional) (transfer none): result item data
+ *
+ * Get the SDES item at @offset in @items and move @offset to the next item.
+ *
+ * Returns: %TRUE if an item was found at @offset.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtcp_sdes_items_next (const guint8 * items, guint items_size,
+    guint * offset, GstRTCPSDESType * type, guint8 * len, const guint8 ** data)
+{
+  guint off;
+  guint8 item_len;
+
+  g_return_val_if_fail (items != NULL || items_size == 0, FALSE);
+  g_return_val_if_fail (offset != NULL, FALSE);
+
+  off = *offset;
+  if (off + 2 > items_size)
+    return FALSE;
+
+  item_len = items[off + 1];
+  if (off + 2 + item_len > items_size)
+    return FALSE;
+
+  if (type)
+    *type = items[off];
+  if (len)
+    *len = item_len;
+  if (data)
+    *data = items + off + 2;
+
+  *offset = off + 2 + item_len;
+
+  return TRUE;
+}
+
+/**
+ * gst_rtcp_packet_view_xr_next_block:
+ * @view: a #GstRTCPPacketView of type #GST_RTCP_TYPE_XR
+ * @offset: (inout): the block cursor, initialize to 0
+ * @type: (out) (optional): result block type
+ * @type_specific: (out) (optional): result type specific byte of the block
+ * @data: (out) (optional) (transfer none): result block contents after the
+ *     block header
+ * @length: (out) (optional): result length of @data in 32-bit words
+ *
+ * Get the report block at @offset in the extended report @view and move
+ * @offset to the next block.
+ *
+ * Returns: %TRUE if a report block was found at @offset.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtcp_packet_view_xr_next_block (const GstRTCPPacketView * view,
+    guint * offset, GstRTCPXRType * type, guint8 * type_specific,
+    const guint8 ** data, guint16 * length)
+{
+  const guint8 *block;
+  gsize off;
+  guint16 block_len;
+
+  g_return_val_if_fail (view != NULL, FALSE);
+  g_return_val_if_fail (view->type == GST_RTCP_TYPE_XR, FALSE);
+  g_return_val_if_fail (offset != NULL, FALSE);
+
+  /* skip the ssrc of the sender */
+  off = MAX (*offset, 4);
+  if (off + 4 > view->body_size)
+    return FALSE;
+
+  block = view->body + off;
+  block_len = GST_READ_UINT16_BE (block + 2);
+  if (off + 4 + ((gsize) block_len << 2) > view->body_size)
+    return FALSE;
+
+  if (type)
+    *type = block[0];
+  if (type_specific)
+    *type_specific = block[1];
+  if (data)
+    *data = block + 4;
+  if (length)
+    *length = block_len;
+
+  *offset = off + 4 + ((gsize) block_len << 2);
+
+  return TRUE;
+}
+
+/**
+ * gst_rtcp_builder_init:
+ * @builder: a #GstRTCPBuilder
+ * @data: (array length=size): memory to write the compound packet to
+ * @size: the size of @data
+ *
+ * Prepare @builder to append RTCP packets to @data. The builder keeps track
+ * of the write offset and the currently open packet, so adding a packet
+ * never needs to look at the packets that were written before it.
+ *
+ * Since: 1.20
+ */
+void
+gst_rtcp_builder_init (GstRTCPBuilder * builder, guint8 * data, gsize size)
+{
+  g_return_if_fail (builder != NULL);
+  g_return_if_fail (data != NULL || size == 0);
+
+  builder->data = data;
+  builder->size = size;
+  builder->offset = 0;
+  builder->packet = 0;
+  builder->type = GST_RTCP_TYPE_INVALID;
+  builder->count = 0;
+  builder->chunk = 0;
+  builder->chunk_ssrc = 0;
+  builder->chunk_open = FALSE;
+}
+
+static void
+rtcp_builder_close_chunk (GstRTCPBuilder * builder)
+{
+  /* terminate the item list with at least one null octet and pad to the next
+   * 32-bit boundary, the space for this was checked when adding the items */
+  do {
+    builder->data[builder->offset++] = GST_RTCP_SDES_END;
+  } while (builder->offset & 0x3);
+
+  builder->chunk_open = FALSE;
+}
+
+static void
+rtcp_builder_close_packet (GstRTCPBuilder * builder)
+{
+  guint16 len;
+
+  if (builder->type == GST_RTCP_TYPE_INVALID)
+    return;
+
+  if (builder->chunk_open)
+    rtcp_builder_close_chunk (builder);
+
+  /* length is stored in multiples of 32 bit words minus the length of the
+   * header */
+  len = ((builder->offset - builder->packet) >> 2) - 1;
+  GST_WRITE_UINT16_BE (builder->data + builder->packet + 2, len);
+
+  builder->type = GST_RTCP_TYPE_INVALID;
+}
+
+static guint8 *
+rtcp_builder_open_packet (GstRTCPBuilder * builder, GstRTCPType type,
+    guint8 count, gsize len)
+{
+  guint8 *data;
+
+  rtcp_builder_close_packet (builder);
+
+  if (builder->size - builder->offset < 4 + len)
+    return NULL;
+
+  data = builder->data + builder->offset;
+  data[0] = (GST_RTCP_VERSION << 6) | count;
+  data[1] = type;
+  data[2] = 0;
+  data[3] = 0;
+
+  builder->packet = builder->offset;
+  builder->offset += 4 + len;
+  builder->type = type;
+  builder->count = count;
+
+  return data + 4;
+}
+
+/**
+ * gst_rtcp_builder_add_sr:
+ * @builder: a #GstRTCPBuilder
+ * @ssrc: the SSRC
+ * @ntptime: the NTP time
+ * @rtptime: the RTP time
+ * @packet_count: the packet count
+ * @octet_count: the octet count
+ *
+ * Close the open packet and start a new SR packet. Report blocks can be
+ * added to it with gst_rtcp_builder_add_rb().
+ *
+ * Returns: %TRUE if the packet was added, %FALSE if there was not enough
+ * space.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtcp_builder_add_sr (GstRTCPBuilder * builder, guint32 ssrc,
+    guint64 ntptime, guint32 rtptime, guint32 packet_count,
+    guint32 octet_count)
+{
+  guint8 *data;
+
+  g_return_val_if_fail (builder != NULL, FALSE);
+
+  data = rtcp_builder_open_packet (builder, GST_RTCP_TYPE_SR, 0, 24);
+  if (data == NULL)
+    return FALSE;
+
+  GST_WRITE_UINT32_BE (data, ssrc);
+  GST_WRITE_UINT64_BE (data + 4, ntptime);
+  GST_WRITE_UINT32_BE (data + 12, rtptime);
+  GST_WRITE_UINT32_BE (data + 16, packet_count);
+  GST_WRITE_UINT32_BE (data + 20, octet_count);
+
+  return TRUE;
+}
+
+/**
+ * gst_rtcp_builder_add_rr:
+ * @builder: a #GstRTCPBuilder
+ * @ssrc: the SSRC of the packet sender
+ *
+ * Close the open packet and start a new RR packet. Report blocks can be
+ * added to it with gst_rtcp_builder_add_rb().
+ *
+ * Returns: %TRUE if the packet was added, %FALSE if there was not enough
+ * space.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtcp_builder_add_rr (GstRTCPBuilder * builder, guint32 ssrc)
+{
+  guint8 *data;
+
+  g_return_val_if_fail (builder != NULL, FALSE);
+
+  data = rtcp_builder_open_packet (builder, GST_RTCP_TYPE_RR, 0, 4);
+  if (data == NULL)
+    return FALSE;
+
+  GST_WRITE_UINT32_BE (data, ssrc);
+
+  return TRUE;
+}
+
+/**
+ * gst_rtcp_builder_add_rb:
+ * @builder: a #GstRTCPBuilder with an open SR or RR packet
+ * @ssrc: data source being reported
+ * @fractionlost: fraction lost since last SR/RR
+ * @packetslost: the cumulative number of packets lost
+ * @exthighestseq: the extended last sequence number received
+ * @jitter: the interarrival jitter
+ * @lsr: the last SR packet from this source
+ * @dlsr: the delay since last SR packet
+ *
+ * Append a report block to the SR or RR packet that was last started on
+ * @builder.
+ *
+ * Returns: %TRUE if the report block was added, %FALSE if the packet already
+ * holds #GST_RTCP_MAX_RB_COUNT blocks or there was not enough space.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtcp_builder_add_rb (GstRTCPBuilder * builder, guint32 ssrc,
+    guint8 fractionlost, gint32 packetslost, guint32 exthighestseq,
+    guint32 jitter, guint32 lsr, guint32 dlsr)
+{
+  guint8 *data;
+
+  g_return_val_if_fail (builder != NULL, FALSE);
+  g_return_val_if_fail (builder->type == GST_RTCP_TYPE_RR ||
+      builder->type == GST_RTCP_TYPE_SR, FALSE);
+
+  if (builder->count >= GST_RTCP_MAX_RB_COUNT)
+    return FALSE;
+
+  if (builder->size - builder->offset < 24)
+    return FALSE;
+
+  builder->count++;
+  builder->data[builder->packet] = (GST_RTCP_VERSION << 6) | builder->count;
+
+  data = builder->data + builder->offset;
+  GST_WRITE_UINT32_BE (data, ssrc);
+  GST_WRITE_UINT32_BE (data + 4,
+      ((guint32) fractionlost << 24) | (packetslost & 0xffffff));
+  GST_WRITE_UINT32_BE (data + 8, exthighestseq);
+  GST_WRITE_UINT32_BE (data + 12, jitter);
+  GST_WRITE_UINT32_BE (data + 16, lsr);
+  GST_WRITE_UINT32_BE (data + 20, dlsr);
+
+  builder->offset += 24;
+
+  return TRUE;
+}
+
+/**
+ * gst_rtcp_builder_add_sdes_item:
+ * @builder: a #GstRTCPBuilder
+ * @ssrc: the SSRC the item describes
+ * @type: the #GstRTCPSDESType of the item
+ * @data: (array length=len): the item data
+ * @len: the length of @data
+ *
+ * Append an SDES item. When the open packet is not an SDES packet, a new one
+ * is started. Consecutive items with the same @ssrc go into the same chunk,
+ * a different @ssrc closes the chunk and opens a new one.
+ *
+ * Returns: %TRUE if the item was added, %FALSE if the packet already holds
+ * #GST_RTCP_MAX_SDES_ITEM_COUNT chunks or there was not enough space.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtcp_builder_add_sdes_item (GstRTCPBuilder * builder, guint32 ssrc,
+    GstRTCPSDESType type, const guint8 * data, guint8 len)
+{
+  gboolean new_packet, new_chunk;
+  gsize end;
+  guint8 *item;
+
+  g_return_val_if_fail (builder != NULL, FALSE);
+  g_return_val_if_fail (type != GST_RTCP_SDES_END, FALSE);
+  g_return_val_if_fail (data != NULL || len == 0, FALSE);
+
+  new_packet = builder->type != GST_RTCP_TYPE_SDES;
+  new_chunk = new_packet || !builder->chunk_open || builder->chunk_ssrc != ssrc;
+
+  /* check the space for everything we write, including the terminating null
+   * octet and padding of the chunk, before writing anything */
+  end = builder->offset;
+  if (new_packet) {
+    end += 4;
+  } else if (new_chunk) {
+    if (builder->count >= GST_RTCP_MAX_SDES_ITEM_COUNT)
+      return FALSE;
+    if (builder->chunk_open)
+      end = GST_ROUND_UP_4 (end + 1);
+  }
+  if (new_chunk)
+    end += 4;
+  end = GST_ROUND_UP_4 (end + 2 + len + 1);
+  if (end > builder->size)
+    return FALSE;
+
+  if (new_packet)
+    rtcp_builder_open_packet (builder, GST_RTCP_TYPE_SDES, 0, 0);
+  else if (new_chunk && builder->chunk_open)
+    rtcp_builder_close_chunk (builder);
+
+  if (new_chunk) {
+    builder->count++;
+    builder->data[builder->packet] = (GST_RTCP_VERSION << 6) | builder->count;
+    builder->chunk = builder->offset;
+    builder->chunk_ssrc = ssrc;
+    builder->chunk_open = TRUE;
+    GST_WRITE_UINT32_BE (builder->data + builder->offset, ssrc);
+    builder->offset += 4;
+  }
+
+  item = builder->data + builder->offset;
+  item[0] = type;
+  item[1] = len;
+  if (len)
+    memcpy (item + 2, data, len);
+  builder->offset += 2 + len;
+
+  return TRUE;
+}
+
+/**
+ * gst_rtcp_builder_add_fb:
+ * @builder: a #GstRTCPBuilder
+ * @type: #GST_RTCP_TYPE_RTPFB or #GST_RTCP_TYPE_PSFB
+ * @fbtype: the #GstRTCPFBType
+ * @sender_ssrc: the sender SSRC
+ * @media_ssrc: the media SSRC
+ * @fci: (array) (nullable): the feedback control information
+ * @fci_length: the length of @fci in 32-bit words
+ *
+ * Close the open packet and append a feedback packet. When @fci is %NULL,
+ * @fci_length words of zeroes are written.
+ *
+ * Returns: %TRUE if the packet was added, %FALSE if there was not enough
+ * space.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtcp_builder_add_fb (GstRTCPBuilder * builder, GstRTCPType type,
+    GstRTCPFBType fbtype, guint32 sender_ssrc, guint32 media_ssrc,
+    const guint8 * fci, guint16 fci_length)
+{
+  guint8 *data;
+  gsize fci_size;
+
+  g_return_val_if_fail (builder != NULL, FALSE);
+  g_return_val_if_fail (type == GST_RTCP_TYPE_RTPFB ||
+      type == GST_RTCP_TYPE_PSFB, FALSE);
+  g_return_val_if_fail (fbtype <= 0x1f, FALSE);
+
+  fci_size = (gsize) fci_length << 2;
+  data = rtcp_builder_open_packet (builder, type, fbtype, 8 + fci_size);
+  if (data == NULL)
+    return FALSE;
+
+  GST_WRITE_UINT32_BE (data, sender_ssrc);
+  GST_WRITE_UINT32_BE (data + 4, media_ssrc);
+  if (fci)
+    memcpy (data + 8, fci, fci_size);
+  else
+    memset (data + 8, 0, fci_size);
+
+  return TRUE;
+}
+
+/**
+ * gst_rtcp_builder_add_packet:
+ * @builder: a #GstRTCPBuilder
+ * @type: the #GstRTCPType of the packet
+ * @count: the count field of the packet
+ * @length: the length of the packet body in 32-bit words
+ *
+ * Close the open packet and append a packet of @type with a zeroed body of
+ * @length words that the caller fills in. This can be used for packet types
+ * without a dedicated builder function, such as BYE, APP or XR.
+ *
+ * Returns: (transfer none) (nullable): the body of the new packet, or %NULL
+ * if there was not enough space.
+ *
+ * Since: 1.20
+ */
+guint8 *
+gst_rtcp_builder_add_packet (GstRTCPBuilder * builder, GstRTCPType type,
+    guint8 count, guint16 length)
+{
+  guint8 *data;
+  gsize size;
+
+  g_return_val_if_fail (builder != NULL, NULL);
+  g_return_val_if_fail (type != GST_RTCP_TYPE_INVALID, NULL);
+  g_return_val_if_fail (count <= 0x1f, NULL);
+
+  size = (gsize) length << 2;
+  data = rtcp_builder_open_packet (builder, type, count, size);
+  if (data == NULL)
+    return NULL;
+
+  memset (data, 0, size);
+
+  return data;
+}
+
+/**
+ * gst_rtcp_builder_finish:
+ * @builder: a #GstRTCPBuilder
+ *
+ * Close the open packet of @builder and return the size of the compound
+ * packet written so far. More packets can be appended afterwards.
+ *
+ * Returns: the number of bytes written to the data of @builder.
+ *
+ * Since: 1.20
+ */
+gsize
+gst_rtcp_builder_finish (GstRTCPBuilder * builder)
+{
+  g_return_val_if_fail (builder != NULL, 0);
+
+  rtcp_builder_close_packet (builder);
+
+  return builder->offset;
+}
@@ -609,6 +609,161 @@ gboolean        gst_rtcp_packet_xr_get_voip_jitter_buffer_params        (GstRTCP
                                                                          guint16 * jb_maximum,
                                                                          guint16 * jb_abs_max);
 
+/* zero-copy compound parsing and building */
+
+/**
+ * GstRTCPPacketView:
+ * @type: the type of the packet
+ * @count: the count field of the packet (RC, SC or FMT)
+ * @padding: %TRUE if the packet has padding
+ * @data: the first byte of the packet header
+ * @size: size of the packet in bytes, including header and padding
+ * @body: the first byte after the 4 byte packet header
+ * @body_size: size of @body in bytes, excluding padding
+ *
+ * A read-only view on one packet of a compound RTCP packet, as returned by
+ * gst_rtcp_packet_iter_next(). All pointers point into the memory that was
+ * passed to gst_rtcp_packet_iter_init().
+ *
+ * Since: 1.20
+ */
+typedef struct {
+  GstRTCPType    type;
+  guint8         count;
+  gboolean       padding;
+  const guint8  *data;
+  gsize          size;
+  const guint8  *body;
+  gsize          body_size;
+
+  /*< private >*/
+  gpointer _gst_reserved[GST_PADDING];
+} GstRTCPPacketView;
+
+/**
+ * GstRTCPPacketIter:
+ *
+ * Iterator over the packets of a compound RTCP packet in a raw byte span.
+ * The structure is public to allow stack allocations.
+ *
+ * Since: 1.20
+ */
+typedef struct {
+  /*< private >*/
+  const guint8  *data;
+  gsize          size;
+  gsize          offset;
+  guint16        valid_mask;
+  gboolean       error;
+
+  gpointer _gst_reserved[GST_PADDING];
+} GstRTCPPacketIter;
+
+/**
+ * GstRTCPBuilder:
+ * @data: the memory the compound packet is written to
+ * @size: the size of @data
+ *
+ * Append-only writer for compound RTCP packets. The structure is public to
+ * allow stack allocations.
+ *
+ * Since: 1.20
+ */
+typedef struct {
+  guint8        *data;
+  gsize          size;
+
+  /*< private >*/
+  gsize          offset;       /* write offset */
+  gsize          packet;       /* offset of the open packet header */
+  GstRTCPType    type;         /* type of the open packet, INVALID when none */
+  guint8         count;        /* count field of the open packet */
+  gsize          chunk;        /* offset of the open SDES chunk */
+  guint32        chunk_ssrc;   /* ssrc of the open SDES chunk */
+  gboolean       chunk_open;
+
+  gpointer _gst_reserved[GST_PADDING];
+} GstRTCPBuilder;
+
+GST_RTP_API
+void            gst_rtcp_packet_iter_init             (GstRTCPPacketIter *iter, const guint8 *data,
+                                                       gsize size, gboolean reduced_size);
+
+GST_RTP_API
+gboolean        gst_rtcp_packet_iter_next             (GstRTCPPacketIter *iter, GstRTCPPacketView *view);
+
+GST_RTP_API
+gboolean        gst_rtcp_packet_iter_is_valid         (const GstRTCPPacketIter *iter);
+
+GST_RTP_API
+guint32         gst_rtcp_packet_view_get_ssrc         (const GstRTCPPacketView *view);
+
+GST_RTP_API
+gboolean        gst_rtcp_packet_view_get_sender_info  (const GstRTCPPacketView *view, guint32 *ssrc,
+                                                       guint64 *ntptime, guint32 *rtptime,
+                                                       guint32 *packet_count, guint32 *octet_count);
+
+GST_RTP_API
+gboolean        gst_rtcp_packet_view_get_rb           (const GstRTCPPacketView *view, guint nth, guint32 *ssrc,
+                                                       guint8 *fractionlost, gint32 *packetslost,
+                                                       guint32 *exthighestseq, guint32 *jitter,
+                                                       guint32 *lsr, guint32 *dlsr);
+
+GST_RTP_API
+gboolean        gst_rtcp_packet_view_get_fb           (const GstRTCPPacketView *view, guint32 *sender_ssrc,
+                                                       guint32 *media_ssrc, const guint8 **fci,
+                                                       guint16 *fci_length);
+
+GST_RTP_API
+gboolean        gst_rtcp_packet_view_sdes_next_chunk  (const GstRTCPPacketView *view, guint *offset,
+                                                       guint32 *ssrc, const guint8 **items,
+                                                       guint *items_size);
+
+GST_RTP_API
+gboolean        gst_rtcp_sdes_items_next              (const guint8 *items, guint items_size,
+                                                       guint *offset, GstRTCPSDESType *type,
+                                                       guint8 *len, const guint8 **data);
+
+GST_RTP_API
+gboolean        gst_rtcp_packet_view_xr_next_block    (const GstRTCPPacketView *view, guint *offset,
+                                                       GstRTCPXRType *type, guint8 *type_specific,
+                                                       const guint8 **data, guint16 *length);
+
+GST_RTP_API
+void            gst_rtcp_builder_init                 (GstRTCPBuilder *builder, guint8 *data, gsize size);
+
+GST_RTP_API
+gboolean        gst_rtcp_builder_add_sr               (GstRTCPBuilder *builder, guint32 ssrc,
+                                                       guint64 ntptime, guint32 rtptime,
+                                                       guint32 packet_count, guint32 octet_count);
+
+GST_RTP_API
+gboolean        gst_rtcp_builder_add_rr               (GstRTCPBuilder *builder, guint32 ssrc);
+
+GST_RTP_API
+gboolean        gst_rtcp_builder_add_rb               (GstRTCPBuilder *builder, guint32 ssrc,
+                                                       guint8 fractionlost, gint32 packetslost,
+                                                       guint32 exthighestseq, guint32 jitter,
+                                                       guint32 lsr, guint32 dlsr);
+
+GST_RTP_API
+gboolean        gst_rtcp_builder_add_sdes_item        (GstRTCPBuilder *builder, guint32 ssrc,
+                                                       GstRTCPSDESType type, const guint8 *data,
+                                                       guint8 len);
+
+GST_RTP_API
+gboolean        gst_rtcp_builder_add_fb               (GstRTCPBuilder *builder, GstRTCPType type,
+                                                       GstRTCPFBType fbtype, guint32 sender_ssrc,
+                                                       guint32 media_ssrc, const guint8 *fci,
+                                                       guint16 fci_length);
+
+GST_RTP_API
+guint8 *        gst_rtcp_builder_add_packet           (GstRTCPBuilder *builder, GstRTCPType type,
+                                                       guint8 count, guint16 length);
+
+GST_RTP_API
+gsize           gst_rtcp_builder_finish               (GstRTCPBuilder *builder);
+
 G_END_DECLS
 
 #endif /* __GST_RTCPBUFFER_H__ */
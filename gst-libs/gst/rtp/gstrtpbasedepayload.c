@@ -65,6 +65,13 @@ struct _GstRTPBaseDepayloadPrivate
   GstBuffer *input_buffer;
 
   GstFlowReturn process_flow_ret;
+
+  /* reused for mapping input buffer lists */
+  GstRTPBufferList rtplist;
+
+  /* output of one input list is pushed as a single list */
+  gboolean aggregate_output;
+  GstBufferList *pending_list;
 };
 
 /* Filter signals and args */
@@ -281,6 +288,10 @@ gst_rtp_base_depayload_init (GstRTPBaseDepayload * filter,
 static void
 gst_rtp_base_depayload_finalize (GObject * object)
 {
+  GstRTPBaseDepayload *filter = GST_RTP_BASE_DEPAYLOAD_CAST (object);
+
+  gst_rtp_buffer_list_clear (&filter->priv->rtplist);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -379,54 +390,38 @@ caps_not_changed:
   }
 }
 
-/* takes ownership of the input buffer */
-static GstFlowReturn
-gst_rtp_base_depayload_handle_buffer (GstRTPBaseDepayload * filter,
-    GstRTPBaseDepayloadClass * bclass, GstBuffer * in)
+/* Checks the seqnum of the mapped packet against the expected one and
+ * prepares the segment event if needed. Returns %FALSE when the packet is a
+ * duplicate that must be dropped. @discont is set when the packet is not the
+ * continuation of the previous one. */
+static gboolean
+gst_rtp_base_depayload_check_packet (GstRTPBaseDepayload * filter,
+    GstRTPBuffer * rtp, gboolean * discont)
 {
-  GstBuffer *(*process_rtp_packet_func) (GstRTPBaseDepayload * base,
-      GstRTPBuffer * rtp_buffer);
-  GstBuffer *(*process_func) (GstRTPBaseDepayload * base, GstBuffer * in);
   GstRTPBaseDepayloadPrivate *priv;
-  GstBuffer *out_buf;
   guint32 ssrc;
   guint16 seqnum;
   guint32 rtptime;
-  gboolean discont, buf_discont;
+  gboolean buf_discont;
   gint gap;
-  GstRTPBuffer rtp = { NULL };
 
   priv = filter->priv;
-  priv->process_flow_ret = GST_FLOW_OK;
-
-  process_func = bclass->process;
-  process_rtp_packet_func = bclass->process_rtp_packet;
 
-  /* we must have a setcaps first */
-  if (G_UNLIKELY (!priv->negotiated))
-    goto not_negotiated;
-
-  if (G_UNLIKELY (!gst_rtp_buffer_map (in, GST_MAP_READ, &rtp)))
-    goto invalid_buffer;
+  buf_discont = GST_BUFFER_IS_DISCONT (rtp->buffer);
 
-  buf_discont = GST_BUFFER_IS_DISCONT (in);
-
-  priv->pts = GST_BUFFER_PTS (in);
-  priv->dts = GST_BUFFER_DTS (in);
-  priv->duration = GST_BUFFER_DURATION (in);
-
-  ssrc = gst_rtp_buffer_get_ssrc (&rtp);
-  seqnum = gst_rtp_buffer_get_seq (&rtp);
-  rtptime = gst_rtp_buffer_get_timestamp (&rtp);
+  ssrc = gst_rtp_buffer_get_ssrc (rtp);
+  seqnum = gst_rtp_buffer_get_seq (rtp);
+  rtptime = gst_rtp_buffer_get_timestamp (rtp);
 
   priv->last_seqnum = seqnum;
   priv->last_rtptime = rtptime;
 
-  discont = buf_discont;
+  *discont = buf_discont;
 
   GST_LOG_OBJECT (filter, "discont %d, seqnum %u, rtptime %u, pts %"
       GST_TIME_FORMAT ", dts %" GST_TIME_FORMAT, buf_discont, seqnum, rtptime,
-      GST_TIME_ARGS (priv->pts), GST_TIME_ARGS (priv->dts));
+      GST_TIME_ARGS (GST_BUFFER_PTS (rtp->buffer)),
+      GST_TIME_ARGS (GST_BUFFER_DTS (rtp->buffer)));
 
   /* Check seqnum. This is a very simple check that makes sure that the seqnums
    * are strictly increasing, dropping anything that is out of the ordinary. We
@@ -436,7 +431,7 @@ gst_rtp_base_depayload_handle_buffer (GstRTPBaseDepayload * filter,
       GST_LOG_OBJECT (filter,
           "New ssrc %u (current ssrc %u), sender restarted",
           ssrc, priv->last_ssrc);
-      discont = TRUE;
+      *discont = TRUE;
     } else {
       gap = gst_rtp_buffer_compare_seqnum (seqnum, priv->next_seqnum);
 
@@ -448,7 +443,7 @@ gst_rtp_base_depayload_handle_buffer (GstRTPBaseDepayload * filter,
           /* seqnum > next_seqnum, we are missing some packets, this is always a
            * DISCONT. */
           GST_LOG_OBJECT (filter, "%d missing packets", gap);
-          discont = TRUE;
+          *discont = TRUE;
         } else {
           /* seqnum < next_seqnum, we have seen this packet before, have a
            * reordered packet or the sender could be restarted. If the packet
@@ -459,11 +454,11 @@ gst_rtp_base_depayload_handle_buffer (GstRTPBaseDepayload * filter,
             GST_WARNING_OBJECT (filter, "got old packet %u, expected %u, "
                 "gap %d <= max_reorder (%d), dropping!",
                 seqnum, priv->next_seqnum, gap, priv->max_reorder);
-            goto dropping;
+            return FALSE;
           }
           GST_WARNING_OBJECT (filter, "got old packet %u, expected %u, "
               "marking discont", seqnum, priv->next_seqnum);
-          discont = TRUE;
+          *discont = TRUE;
         }
       }
     }
@@ -471,41 +466,70 @@ gst_rtp_base_depayload_handle_buffer (GstRTPBaseDepayload * filter,
   priv->next_seqnum = (seqnum + 1) & 0xffff;
   priv->last_ssrc = ssrc;
 
-  if (G_UNLIKELY (discont)) {
+  if (G_UNLIKELY (*discont))
     priv->discont = TRUE;
-    if (!buf_discont) {
-      gpointer old_inbuf = in;
-
-      /* we detected a seqnum discont but the buffer was not flagged with a discont,
-       * set the discont flag so that the subclass can throw away old data. */
-      GST_LOG_OBJECT (filter, "mark DISCONT on input buffer");
-      in = gst_buffer_make_writable (in);
-      GST_BUFFER_FLAG_SET (in, GST_BUFFER_FLAG_DISCONT);
-      /* depayloaders will check flag on rtpbuffer->buffer, so if the input
-       * buffer was not writable already we need to remap to make our
-       * newly-flagged buffer current on the rtpbuffer */
-      if (in != old_inbuf) {
-        gst_rtp_buffer_unmap (&rtp);
-        if (G_UNLIKELY (!gst_rtp_buffer_map (in, GST_MAP_READ, &rtp)))
-          goto invalid_buffer;
-      }
-    }
-  }
 
   /* prepare segment event if needed */
   if (filter->need_newsegment) {
     priv->segment_event = create_segment_event (filter, rtptime,
-        GST_BUFFER_PTS (in));
+        GST_BUFFER_PTS (rtp->buffer));
     filter->need_newsegment = FALSE;
   }
 
+  return TRUE;
+}
+
+/* takes ownership of the input buffer and of the mapping in @rtp, which
+ * is unmapped when this function returns */
+static GstFlowReturn
+gst_rtp_base_depayload_handle_packet (GstRTPBaseDepayload * filter,
+    GstRTPBaseDepayloadClass * bclass, GstBuffer * in, GstRTPBuffer * rtp)
+{
+  GstBuffer *(*process_rtp_packet_func) (GstRTPBaseDepayload * base,
+      GstRTPBuffer * rtp_buffer);
+  GstBuffer *(*process_func) (GstRTPBaseDepayload * base, GstBuffer * in);
+  GstRTPBaseDepayloadPrivate *priv;
+  GstBuffer *out_buf;
+  gboolean discont;
+
+  priv = filter->priv;
+  priv->process_flow_ret = GST_FLOW_OK;
+
+  process_func = bclass->process;
+  process_rtp_packet_func = bclass->process_rtp_packet;
+
+  priv->pts = GST_BUFFER_PTS (in);
+  priv->dts = GST_BUFFER_DTS (in);
+  priv->duration = GST_BUFFER_DURATION (in);
+
+  if (!gst_rtp_base_depayload_check_packet (filter, rtp, &discont))
+    goto dropping;
+
+  if (G_UNLIKELY (discont && !GST_BUFFER_IS_DISCONT (in))) {
+    gpointer old_inbuf = in;
+
+    /* we detected a seqnum discont but the buffer was not flagged with a discont,
+     * set the discont flag so that the subclass can throw away old data. */
+    GST_LOG_OBJECT (filter, "mark DISCONT on input buffer");
+    in = gst_buffer_make_writable (in);
+    GST_BUFFER_FLAG_SET (in, GST_BUFFER_FLAG_DISCONT);
+    /* depayloaders will check flag on rtpbuffer->buffer, so if the input
+     * buffer was not writable already we need to remap to make our
+     * newly-flagged buffer current on the rtpbuffer */
+    if (in != old_inbuf) {
+      gst_rtp_buffer_unmap (rtp);
+      if (G_UNLIKELY (!gst_rtp_buffer_map (in, GST_MAP_READ, rtp)))
+        goto invalid_buffer;
+    }
+  }
+
   priv->input_buffer = in;
 
   if (process_rtp_packet_func != NULL) {
-    out_buf = process_rtp_packet_func (filter, &rtp);
-    gst_rtp_buffer_unmap (&rtp);
+    out_buf = process_rtp_packet_func (filter, rtp);
+    gst_rtp_buffer_unmap (rtp);
   } else if (process_func != NULL) {
-    gst_rtp_buffer_unmap (&rtp);
+    gst_rtp_buffer_unmap (rtp);
     out_buf = process_func (filter, in);
   } else {
     goto no_process;
@@ -524,6 +548,48 @@ gst_rtp_base_depayload_handle_buffer (GstRTPBaseDepayload * filter,
 
   return priv->process_flow_ret;
 
+  /* ERRORS */
+invalid_buffer:
+  {
+    /* this is not fatal but should be filtered earlier */
+    GST_ELEMENT_WARNING (filter, STREAM, DECODE, (NULL),
+        ("Received invalid RTP payload, dropping"));
+    gst_buffer_unref (in);
+    return GST_FLOW_OK;
+  }
+dropping:
+  {
+    gst_rtp_buffer_unmap (rtp);
+    gst_buffer_unref (in);
+    return GST_FLOW_OK;
+  }
+no_process:
+  {
+    gst_rtp_buffer_unmap (rtp);
+    /* this is not fatal but should be filtered earlier */
+    GST_ELEMENT_ERROR (filter, STREAM, NOT_IMPLEMENTED, (NULL),
+        ("The subclass does not have a process or process_rtp_packet method"));
+    gst_buffer_unref (in);
+    return GST_FLOW_ERROR;
+  }
+}
+
+/* takes ownership of the input buffer */
+static GstFlowReturn
+gst_rtp_base_depayload_handle_buffer (GstRTPBaseDepayload * filter,
+    GstRTPBaseDepayloadClass * bclass, GstBuffer * in)
+{
+  GstRTPBuffer rtp = { NULL };
+
+  /* we must have a setcaps first */
+  if (G_UNLIKELY (!filter->priv->negotiated))
+    goto not_negotiated;
+
+  if (G_UNLIKELY (!gst_rtp_buffer_map (in, GST_MAP_READ, &rtp)))
+    goto invalid_buffer;
+
+  return gst_rtp_base_depayload_handle_packet (filter, bclass, in, &rtp);
+
   /* ERRORS */
 not_negotiated:
   {
@@ -547,21 +613,6 @@ invalid_buffer:
     gst_buffer_unref (in);
     return GST_FLOW_OK;
   }
-dropping:
-  {
-    gst_rtp_buffer_unmap (&rtp);
-    gst_buffer_unref (in);
-    return GST_FLOW_OK;
-  }
-no_process:
-  {
-    gst_rtp_buffer_unmap (&rtp);
-    /* this is not fatal but should be filtered earlier */
-    GST_ELEMENT_ERROR (filter, STREAM, NOT_IMPLEMENTED, (NULL),
-        ("The subclass does not have a process or process_rtp_packet method"));
-    gst_buffer_unref (in);
-    return GST_FLOW_ERROR;
-  }
 }
 
 static GstFlowReturn
@@ -580,17 +631,83 @@ gst_rtp_base_depayload_chain (GstPad * pad, GstObject * parent, GstBuffer * in)
   return flow_ret;
 }
 
+/* Runs the seqnum checks on all packets of the mapped @rtplist, then hands the
+ * whole list to the process_list vfunc. Duplicates and invalid packets are
+ * left unmapped. */
+static GstFlowReturn
+gst_rtp_base_depayload_handle_list (GstRTPBaseDepayload * filter,
+    GstRTPBaseDepayloadClass * bclass, GstRTPBufferList * rtplist)
+{
+  GstRTPBaseDepayloadPrivate *priv = filter->priv;
+  GstFlowReturn ret;
+  gboolean first = TRUE;
+  guint i;
+
+  for (i = 0; i < rtplist->n_packets; i++) {
+    GstRTPBuffer *rtp = &rtplist->packets[i];
+    gboolean discont;
+
+    if (G_UNLIKELY (rtp->buffer == NULL)) {
+      /* this is not fatal but should be filtered earlier */
+      GST_ELEMENT_WARNING (filter, STREAM, DECODE, (NULL),
+          ("Received invalid RTP payload, dropping"));
+      continue;
+    }
+
+    if (!gst_rtp_base_depayload_check_packet (filter, rtp, &discont)) {
+      gst_rtp_buffer_unmap (rtp);
+      continue;
+    }
+
+    if (G_UNLIKELY (discont && !GST_BUFFER_IS_DISCONT (rtp->buffer))) {
+      GstBuffer *buffer;
+
+      GST_LOG_OBJECT (filter, "mark DISCONT on input buffer %u", i);
+      gst_rtp_buffer_unmap (rtp);
+      buffer = gst_buffer_list_get_writable (rtplist->list, i);
+      GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DISCONT);
+      if (G_UNLIKELY (!gst_rtp_buffer_map (buffer, GST_MAP_READ, rtp))) {
+        rtp->buffer = NULL;
+        continue;
+      }
+    }
+
+    /* output without timestamps gets the ones of the first packet */
+    if (first) {
+      priv->pts = GST_BUFFER_PTS (rtp->buffer);
+      priv->dts = GST_BUFFER_DTS (rtp->buffer);
+      priv->duration = GST_BUFFER_DURATION (rtp->buffer);
+      priv->input_buffer = rtp->buffer;
+      first = FALSE;
+    }
+  }
+
+  if (first)
+    return GST_FLOW_OK;
+
+  priv->process_flow_ret = GST_FLOW_OK;
+  ret = bclass->process_list (filter, rtplist);
+  if (ret == GST_FLOW_OK)
+    ret = priv->process_flow_ret;
+  priv->input_buffer = NULL;
+
+  return ret;
+}
+
 static GstFlowReturn
 gst_rtp_base_depayload_chain_list (GstPad * pad, GstObject * parent,
     GstBufferList * list)
 {
   GstRTPBaseDepayloadClass *bclass;
   GstRTPBaseDepayload *basedepay;
+  GstRTPBaseDepayloadPrivate *priv;
+  GstRTPBufferList *rtplist;
   GstFlowReturn flow_ret;
   GstBuffer *buffer;
   guint i, len;
 
   basedepay = GST_RTP_BASE_DEPAYLOAD_CAST (parent);
+  priv = basedepay->priv;
 
   bclass = GST_RTP_BASE_DEPAYLOAD_GET_CLASS (basedepay);
 
@@ -602,21 +719,71 @@ gst_rtp_base_depayload_chain_list (GstPad * pad, GstObject * parent,
   if (len == 0)
     goto done;
 
+  /* without caps, let handle_buffer post the error for the first buffer */
+  if (G_UNLIKELY (!priv->negotiated)) {
+    buffer = gst_buffer_ref (gst_buffer_list_get (list, 0));
+    flow_ret = gst_rtp_base_depayload_handle_buffer (basedepay, bclass, buffer);
+    goto done;
+  }
+
+  /* collect everything pushed for this list into a single output list */
+  if (priv->aggregate_output)
+    priv->pending_list = gst_buffer_list_new_sized (len);
+
+  /* map and validate all headers of the list in one pass, each packet is then
+   * handed over with its mapping already in place */
+  rtplist = &priv->rtplist;
+
+  if (bclass->process_list != NULL) {
+    /* DISCONT may need to be marked on the packets */
+    list = gst_buffer_list_make_writable (list);
+    gst_rtp_buffer_list_map (list, GST_MAP_READ, rtplist);
+    flow_ret = gst_rtp_base_depayload_handle_list (basedepay, bclass, rtplist);
+    gst_rtp_buffer_list_unmap (rtplist);
+    goto flush;
+  }
+
+  gst_rtp_buffer_list_map (list, GST_MAP_READ, rtplist);
+
   for (i = 0; i < len; i++) {
+    GstRTPBuffer *rtp = &rtplist->packets[i];
+
     buffer = gst_buffer_list_get (list, i);
 
-    /* handle_buffer takes ownership of input buffer */
+    if (G_UNLIKELY (rtp->buffer == NULL)) {
+      /* this is not fatal but should be filtered earlier */
+      GST_ELEMENT_WARNING (basedepay, STREAM, DECODE, (NULL),
+          ("Received invalid RTP payload, dropping"));
+      continue;
+    }
+
+    /* handle_packet takes ownership of input buffer */
     /* FIXME: add a way to steal buffers from list as we will unref it anyway */
     gst_buffer_ref (buffer);
 
     /* Should we fix up any missing timestamps for list buffers here
      * (e.g. set to first or previous timestamp in list) or just assume
      * the's a jitterbuffer that will have done that for us? */
-    flow_ret = gst_rtp_base_depayload_handle_buffer (basedepay, bclass, buffer);
+    flow_ret =
+        gst_rtp_base_depayload_handle_packet (basedepay, bclass, buffer, rtp);
     if (flow_ret != GST_FLOW_OK)
       break;
   }
 
+  gst_rtp_buffer_list_unmap (rtplist);
+
+flush:
+  if (priv->pending_list) {
+    GstBufferList *out_list = priv->pending_list;
+
+    priv->pending_list = NULL;
+    if (flow_ret == GST_FLOW_OK && gst_buffer_list_length (out_list) > 0) {
+      flow_ret = gst_pad_push_list (basedepay->srcpad, out_list);
+    } else {
+      gst_buffer_list_unref (out_list);
+    }
+  }
+
 done:
 
   gst_buffer_list_unref (list);
@@ -902,6 +1069,10 @@ gst_rtp_base_depayload_prepare_push (GstRTPBaseDepayload * filter,
  * Push @out_buf to the peer of @filter. This function takes ownership of
  * @out_buf.
  *
+ * While an input buffer list is processed with aggregated output enabled,
+ * @out_buf is queued and pushed with the rest of the output of that list, see
+ * gst_rtp_base_depayload_set_aggregate_output_enabled().
+ *
  * This function will by default apply the last incoming timestamp on
  * the outgoing buffer when it didn't have a timestamp already.
  *
@@ -914,10 +1085,12 @@ gst_rtp_base_depayload_push (GstRTPBaseDepayload * filter, GstBuffer * out_buf)
 
   res = gst_rtp_base_depayload_prepare_push (filter, FALSE, &out_buf);
 
-  if (G_LIKELY (res == GST_FLOW_OK))
-    res = gst_pad_push (filter->srcpad, out_buf);
-  else
+  if (G_UNLIKELY (res != GST_FLOW_OK))
     gst_buffer_unref (out_buf);
+  else if (filter->priv->pending_list)
+    gst_buffer_list_add (filter->priv->pending_list, out_buf);
+  else
+    res = gst_pad_push (filter->srcpad, out_buf);
 
   if (res != GST_FLOW_OK)
     filter->priv->process_flow_ret = res;
@@ -933,6 +1106,10 @@ gst_rtp_base_depayload_push (GstRTPBaseDepayload * filter, GstBuffer * out_buf)
  * Push @out_list to the peer of @filter. This function takes ownership of
  * @out_list.
  *
+ * While an input buffer list is processed with aggregated output enabled,
+ * the buffers of @out_list are queued and pushed with the rest of the output
+ * of that list, see gst_rtp_base_depayload_set_aggregate_output_enabled().
+ *
  * Returns: a #GstFlowReturn.
  */
 GstFlowReturn
@@ -943,10 +1120,18 @@ gst_rtp_base_depayload_push_list (GstRTPBaseDepayload * filter,
 
   res = gst_rtp_base_depayload_prepare_push (filter, TRUE, &out_list);
 
-  if (G_LIKELY (res == GST_FLOW_OK))
-    res = gst_pad_push_list (filter->srcpad, out_list);
-  else
+  if (G_UNLIKELY (res != GST_FLOW_OK)) {
     gst_buffer_list_unref (out_list);
+  } else if (filter->priv->pending_list) {
+    guint i, len = gst_buffer_list_length (out_list);
+
+    for (i = 0; i < len; i++)
+      gst_buffer_list_add (filter->priv->pending_list,
+          gst_buffer_ref (gst_buffer_list_get (out_list, i)));
+    gst_buffer_list_unref (out_list);
+  } else {
+    res = gst_pad_push_list (filter->srcpad, out_list);
+  }
 
   if (res != GST_FLOW_OK)
     filter->priv->process_flow_ret = res;
@@ -1165,3 +1350,43 @@ gst_rtp_base_depayload_is_source_info_enabled (GstRTPBaseDepayload * depayload)
 {
   return depayload->priv->source_info;
 }
+
+/**
+ * gst_rtp_base_depayload_set_aggregate_output_enabled:
+ * @depayload: a #GstRTPBaseDepayload
+ * @enable: whether to aggregate the output of input buffer lists
+ *
+ * Enable or disable aggregating the output of input buffer lists. When
+ * enabled, everything pushed with gst_rtp_base_depayload_push() or
+ * gst_rtp_base_depayload_push_list() while an input list is processed is
+ * collected and pushed downstream as a single #GstBufferList once the whole
+ * input list was handled.
+ *
+ * Subclasses that push serialized events from their processing functions
+ * must not enable this, as the events would overtake the queued buffers.
+ *
+ * Since: 1.20
+ **/
+void
+gst_rtp_base_depayload_set_aggregate_output_enabled (GstRTPBaseDepayload *
+    depayload, gboolean enable)
+{
+  depayload->priv->aggregate_output = enable;
+}
+
+/**
+ * gst_rtp_base_depayload_is_aggregate_output_enabled:
+ * @depayload: a #GstRTPBaseDepayload
+ *
+ * Queries whether the output of input buffer lists is aggregated.
+ *
+ * Returns: %TRUE if the output of input buffer lists is pushed as one list
+ *
+ * Since: 1.20
+ **/
+gboolean
+gst_rtp_base_depayload_is_aggregate_output_enabled (GstRTPBaseDepayload *
+    depayload)
+{
+  return depayload->priv->aggregate_output;
+}
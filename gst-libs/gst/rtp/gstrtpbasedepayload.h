@@ -82,6 +82,15 @@ struct _GstRTPBaseDepayload
  * timestamp, the timestamp of the input buffer will be applied to the result
  * buffer and the output buffer will be pushed out. If this function returns
  * %NULL, nothing is pushed out. Since: 1.6.
+ * @process_list: Process all packets of an incoming buffer list at once. The
+ * packets have been mapped (with GST_MAP_READ) by the base class, which also
+ * ran its sequence number checks on them: duplicates and invalid packets are
+ * unmapped and have a %NULL buffer in the #GstRTPBufferList, packets following
+ * a gap are flagged with %GST_BUFFER_FLAG_DISCONT. Output is pushed with
+ * gst_rtp_base_depayload_push() or gst_rtp_base_depayload_push_list(), output
+ * without timestamps gets the ones of the first packet. Subclasses
+ * implementing this must still implement @process or @process_rtp_packet
+ * for buffers not received in a list. Since: 1.20.
  *
  * Base class for RTP depayloaders.
  */
@@ -107,8 +116,10 @@ struct _GstRTPBaseDepayloadClass
 
   GstBuffer * (*process_rtp_packet) (GstRTPBaseDepayload *base, GstRTPBuffer * rtp_buffer);
 
+  GstFlowReturn (*process_list) (GstRTPBaseDepayload *base, GstRTPBufferList * rtplist);
+
   /*< private >*/
-  gpointer _gst_reserved[GST_PADDING - 1];
+  gpointer _gst_reserved[GST_PADDING - 2];
 };
 
 GST_RTP_API
@@ -127,6 +138,13 @@ GST_RTP_API
 void            gst_rtp_base_depayload_set_source_info_enabled (GstRTPBaseDepayload * depayload,
                                                                 gboolean enable);
 
+GST_RTP_API
+gboolean        gst_rtp_base_depayload_is_aggregate_output_enabled  (GstRTPBaseDepayload * depayload);
+
+GST_RTP_API
+void            gst_rtp_base_depayload_set_aggregate_output_enabled (GstRTPBaseDepayload * depayload,
+                                                                     gboolean enable);
+
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstRTPBaseDepayload, gst_object_unref)
 
@@ -69,8 +69,82 @@ struct _GstRTPBasePayloadPrivate
 
   GstCaps *subclass_srccaps;
   GstCaps *sinkcaps;
+
+  /* reused for mapping output buffer lists */
+  GstRTPBufferList rtplist;
+
+  /* header-only output buffers */
+  GstBufferPool *header_pool;
+  guint64 header_pool_hits;
+  guint64 header_pool_misses;
 };
 
+/* Pool of buffers holding a single memory large enough for an RTP header with
+ * the maximum number of CSRCs. Memory appended by subclasses (payload,
+ * header extensions) is removed when a buffer returns to the pool so that
+ * both the buffer and its header memory get reused. */
+typedef struct
+{
+  GstBufferPool parent;
+
+  guint64 n_allocated;
+} GstRTPHeaderPool;
+
+typedef struct
+{
+  GstBufferPoolClass parent_class;
+} GstRTPHeaderPoolClass;
+
+/* room for 15 CSRCs and a small reserved header extension */
+#define RTP_HEADER_POOL_SIZE (GST_RTP_HEADER_LEN + 15 * sizeof (guint32) + \
+    4 + 4 * sizeof (guint32))
+
+static GType gst_rtp_header_pool_get_type (void);
+G_DEFINE_TYPE (GstRTPHeaderPool, gst_rtp_header_pool, GST_TYPE_BUFFER_POOL);
+
+static GstFlowReturn
+gst_rtp_header_pool_alloc_buffer (GstBufferPool * pool, GstBuffer ** buffer,
+    GstBufferPoolAcquireParams * params)
+{
+  GstFlowReturn ret;
+
+  ret = GST_BUFFER_POOL_CLASS (gst_rtp_header_pool_parent_class)->alloc_buffer
+      (pool, buffer, params);
+  if (ret == GST_FLOW_OK)
+    ((GstRTPHeaderPool *) pool)->n_allocated++;
+
+  return ret;
+}
+
+static void
+gst_rtp_header_pool_reset_buffer (GstBufferPool * pool, GstBuffer * buffer)
+{
+  /* keep only the header memory, the default release checks that it is
+   * still writable and large enough */
+  if (gst_buffer_n_memory (buffer) > 0) {
+    if (gst_buffer_n_memory (buffer) > 1)
+      gst_buffer_remove_memory_range (buffer, 1, -1);
+    GST_BUFFER_FLAG_UNSET (buffer, GST_BUFFER_FLAG_TAG_MEMORY);
+  }
+
+  GST_BUFFER_POOL_CLASS (gst_rtp_header_pool_parent_class)->reset_buffer
+      (pool, buffer);
+}
+
+static void
+gst_rtp_header_pool_class_init (GstRTPHeaderPoolClass * klass)
+{
+  GstBufferPoolClass *pool_class = (GstBufferPoolClass *) klass;
+
+  pool_class->alloc_buffer = gst_rtp_header_pool_alloc_buffer;
+  pool_class->reset_buffer = gst_rtp_header_pool_reset_buffer;
+}
+
+static void
+gst_rtp_header_pool_init (GstRTPHeaderPool * pool)
+{
+}
+
 /* RTPBasePayload signals and args */
 enum
 {
@@ -315,6 +389,11 @@ gst_rtp_base_payload_class_init (GstRTPBasePayloadClass * klass)
    *   * `pt` :#G_TYPE_UINT, The Payload type in use, same as #GstRTPBasePayload:pt
    *   * `seqnum-offset` :#G_TYPE_UINT, The current offset added to the seqnum
    *   * `timestamp-offset` :#G_TYPE_UINT, The current offset added to the timestamp
+   *   * `header-pool-hits` :#G_TYPE_UINT64, Output buffers from
+   *     gst_rtp_base_payload_allocate_output_buffer() that were recycled from
+   *     the header pool (Since: 1.20)
+   *   * `header-pool-misses` :#G_TYPE_UINT64, Output buffers the header pool
+   *     had to allocate (Since: 1.20)
    **/
   g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_STATS,
       g_param_spec_boxed ("stats", "Statistics", "Various statistics",
@@ -479,6 +558,11 @@ gst_rtp_base_payload_finalize (GObject * object)
 
   gst_caps_replace (&rtpbasepayload->priv->subclass_srccaps, NULL);
   gst_caps_replace (&rtpbasepayload->priv->sinkcaps, NULL);
+  gst_rtp_buffer_list_clear (&rtpbasepayload->priv->rtplist);
+  if (rtpbasepayload->priv->header_pool) {
+    gst_buffer_pool_set_active (rtpbasepayload->priv->header_pool, FALSE);
+    gst_object_unref (rtpbasepayload->priv->header_pool);
+  }
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -1243,22 +1327,6 @@ typedef struct
   guint8 twcc_ext_id;
 } HeaderData;
 
-static gboolean
-find_timestamp (GstBuffer ** buffer, guint idx, gpointer user_data)
-{
-  HeaderData *data = user_data;
-  data->dts = GST_BUFFER_DTS (*buffer);
-  data->pts = GST_BUFFER_PTS (*buffer);
-  data->offset = GST_BUFFER_OFFSET (*buffer);
-
-  /* stop when we find a timestamp. We take whatever offset is associated with
-   * the timestamp (if any) to do perfect timestamps when we need to. */
-  if (data->pts != -1)
-    return FALSE;
-  else
-    return TRUE;
-}
-
 static void
 _set_twcc_seq (GstRTPBuffer * rtp, guint16 seq, guint8 ext_id)
 {
@@ -1344,10 +1412,25 @@ gst_rtp_base_payload_prepare_push (GstRTPBasePayload * payload,
 
   /* find the first buffer with a timestamp */
   if (is_list) {
+    GstBufferList *list = GST_BUFFER_LIST_CAST (obj);
+    guint i, len;
+
     data.dts = -1;
     data.pts = -1;
     data.offset = GST_BUFFER_OFFSET_NONE;
-    gst_buffer_list_foreach (GST_BUFFER_LIST_CAST (obj), find_timestamp, &data);
+
+    /* stop when we find a timestamp. We take whatever offset is associated
+     * with the timestamp (if any) to do perfect timestamps when we need to. */
+    len = gst_buffer_list_length (list);
+    for (i = 0; i < len; i++) {
+      GstBuffer *buf = gst_buffer_list_get (list, i);
+
+      data.dts = GST_BUFFER_DTS (buf);
+      data.pts = GST_BUFFER_PTS (buf);
+      data.offset = GST_BUFFER_OFFSET (buf);
+      if (data.pts != -1)
+        break;
+    }
   } else {
     data.dts = GST_BUFFER_DTS (GST_BUFFER_CAST (obj));
     data.pts = GST_BUFFER_PTS (GST_BUFFER_CAST (obj));
@@ -1421,8 +1504,27 @@ gst_rtp_base_payload_prepare_push (GstRTPBasePayload * payload,
   /* set ssrc, payload type, seq number, caps and rtptime */
   /* remove unwanted meta */
   if (is_list) {
-    gst_buffer_list_foreach (GST_BUFFER_LIST_CAST (obj), set_headers, &data);
-    gst_buffer_list_foreach (GST_BUFFER_LIST_CAST (obj), filter_meta, NULL);
+    GstBufferList *list = GST_BUFFER_LIST_CAST (obj);
+    GstRTPBufferList *rtplist = &priv->rtplist;
+    guint i;
+
+    /* map all packets once and rewrite their fixed headers in one go */
+    if (!gst_rtp_buffer_list_map (list, GST_MAP_WRITE, rtplist))
+      GST_ERROR_OBJECT (payload, "failed to map some buffers of list %p", list);
+
+    data.seqnum = gst_rtp_buffer_list_set_headers (rtplist, data.ssrc,
+        data.pt, data.seqnum, data.rtptime);
+
+    for (i = 0; i < rtplist->n_packets; i++) {
+      GstRTPBuffer *rtp = &rtplist->packets[i];
+      GstBuffer *buf = gst_buffer_list_get (list, i);
+
+      if (enable_experimental_twcc && rtp->buffer != NULL)
+        _set_twcc_seq (rtp, gst_rtp_buffer_get_seq (rtp), data.twcc_ext_id);
+      filter_meta (&buf, i, NULL);
+    }
+    gst_rtp_buffer_list_unmap (rtplist);
+
     /* sequence number has increased more if this was a buffer list */
     payload->seqnum = data.seqnum - 1;
   } else {
@@ -1476,6 +1578,9 @@ gst_rtp_base_payload_push_list (GstRTPBasePayload * payload,
 {
   GstFlowReturn res;
 
+  /* the RTP headers are rewritten in place */
+  list = gst_buffer_list_make_writable (list);
+
   res = gst_rtp_base_payload_prepare_push (payload, list, TRUE);
 
   if (G_LIKELY (res == GST_FLOW_OK)) {
@@ -1525,6 +1630,86 @@ gst_rtp_base_payload_push (GstRTPBasePayload * payload, GstBuffer * buffer)
   return res;
 }
 
+/* Get a buffer with only an RTP header from the header pool. Returns %NULL
+ * when no pool could be set up. */
+static GstBuffer *
+gst_rtp_base_payload_acquire_header (GstRTPBasePayload * payload,
+    guint8 csrc_count)
+{
+  GstRTPBasePayloadPrivate *priv = payload->priv;
+  GstBuffer *buffer = NULL;
+  GstMapInfo map;
+  guint64 n_allocated;
+  guint header_len;
+
+  if (G_UNLIKELY (priv->header_pool == NULL)) {
+    GstBufferPool *pool;
+    GstStructure *config;
+
+    pool = g_object_new (gst_rtp_header_pool_get_type (), NULL);
+    gst_object_ref_sink (pool);
+
+    config = gst_buffer_pool_get_config (pool);
+    gst_buffer_pool_config_set_params (config, NULL, RTP_HEADER_POOL_SIZE, 0,
+        0);
+    if (!gst_buffer_pool_set_config (pool, config) ||
+        !gst_buffer_pool_set_active (pool, TRUE)) {
+      GST_WARNING_OBJECT (payload, "failed to activate header pool");
+      gst_object_unref (pool);
+      return NULL;
+    }
+    priv->header_pool = pool;
+  }
+
+  n_allocated = ((GstRTPHeaderPool *) priv->header_pool)->n_allocated;
+  if (gst_buffer_pool_acquire_buffer (priv->header_pool, &buffer,
+          NULL) != GST_FLOW_OK)
+    return NULL;
+
+  if (((GstRTPHeaderPool *) priv->header_pool)->n_allocated == n_allocated)
+    priv->header_pool_hits++;
+  else
+    priv->header_pool_misses++;
+
+  /* same header as gst_rtp_buffer_allocate_data() */
+  header_len = gst_rtp_buffer_calc_header_len (csrc_count);
+  gst_buffer_set_size (buffer, header_len);
+  gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+  memset (map.data, 0, header_len);
+  map.data[0] = (GST_RTP_VERSION << 6) | csrc_count;
+  gst_buffer_unmap (buffer, &map);
+
+  /* reserve the extension for the TWCC seqnum set in prepare_push so that
+   * it gets written in place */
+  if (enable_experimental_twcc && priv->twcc_ext_id > 0
+      && priv->twcc_ext_id < 15) {
+    GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+
+    if (gst_rtp_buffer_map (buffer, GST_MAP_WRITE, &rtp)) {
+      gst_rtp_buffer_reserve_extension_data (&rtp, 0xBEDE, 1);
+      gst_rtp_buffer_unmap (&rtp);
+    }
+  }
+
+  return buffer;
+}
+
+static GstBuffer *
+gst_rtp_base_payload_new_output_buffer (GstRTPBasePayload * payload,
+    guint payload_len, guint8 pad_len, guint8 csrc_count)
+{
+  GstBuffer *buffer = NULL;
+
+  /* payloaders that append their payload memory only need a header */
+  if (payload_len == 0 && pad_len == 0)
+    buffer = gst_rtp_base_payload_acquire_header (payload, csrc_count);
+
+  if (buffer == NULL)
+    buffer = gst_rtp_buffer_new_allocate (payload_len, pad_len, csrc_count);
+
+  return buffer;
+}
+
 /**
  * gst_rtp_base_payload_allocate_output_buffer:
  * @payload: a #GstRTPBasePayload
@@ -1537,6 +1722,10 @@ gst_rtp_base_payload_push (GstRTPBasePayload * payload, GstBuffer * buffer)
  * @pad_len. If @payload has #GstRTPBasePayload:source-info %TRUE additional
  * CSRCs may be allocated and filled with RTP source information.
  *
+ * When both @payload_len and @pad_len are 0 the buffer only holds the RTP
+ * header and is recycled from an internal pool once released. The payload
+ * should then be added as separate memory, e.g. with gst_buffer_append().
+ *
  * Returns: A newly allocated buffer that can hold an RTP packet with given
  * parameters.
  *
@@ -1558,8 +1747,8 @@ gst_rtp_base_payload_allocate_output_buffer (GstRTPBasePayload * payload,
       total_csrc_count = csrc_count + meta->csrc_count +
           (meta->ssrc_valid ? 1 : 0);
       total_csrc_count = MIN (total_csrc_count, 15);
-      buffer = gst_rtp_buffer_new_allocate (payload_len, pad_len,
-          total_csrc_count);
+      buffer = gst_rtp_base_payload_new_output_buffer (payload, payload_len,
+          pad_len, total_csrc_count);
 
       gst_rtp_buffer_map (buffer, GST_MAP_READWRITE, &rtp);
 
@@ -1576,7 +1765,8 @@ gst_rtp_base_payload_allocate_output_buffer (GstRTPBasePayload * payload,
   }
 
   if (buffer == NULL)
-    buffer = gst_rtp_buffer_new_allocate (payload_len, pad_len, csrc_count);
+    buffer = gst_rtp_base_payload_new_output_buffer (payload, payload_len,
+        pad_len, csrc_count);
 
   return buffer;
 }
@@ -1597,7 +1787,9 @@ gst_rtp_base_payload_create_stats (GstRTPBasePayload * rtpbasepayload)
       "ssrc", G_TYPE_UINT, rtpbasepayload->current_ssrc,
       "pt", G_TYPE_UINT, rtpbasepayload->pt,
       "seqnum-offset", G_TYPE_UINT, (guint) rtpbasepayload->seqnum_base,
-      "timestamp-offset", G_TYPE_UINT, (guint) rtpbasepayload->ts_base, NULL);
+      "timestamp-offset", G_TYPE_UINT, (guint) rtpbasepayload->ts_base,
+      "header-pool-hits", G_TYPE_UINT64, priv->header_pool_hits,
+      "header-pool-misses", G_TYPE_UINT64, priv->header_pool_misses, NULL);
 
   return s;
 }
@@ -1785,6 +1977,8 @@ gst_rtp_base_payload_change_state (GstElement * element,
       priv->running_time = DEFAULT_RUNNING_TIME;
       g_atomic_int_set (&rtpbasepayload->priv->notified_first_timestamp, 1);
       priv->base_offset = GST_BUFFER_OFFSET_NONE;
+      priv->header_pool_hits = 0;
+      priv->header_pool_misses = 0;
       priv->negotiated = FALSE;
       gst_caps_replace (&rtpbasepayload->priv->subclass_srccaps, NULL);
       gst_caps_replace (&rtpbasepayload->priv->sinkcaps, NULL);
@@ -1801,6 +1995,11 @@ gst_rtp_base_payload_change_state (GstElement * element,
       break;
     case GST_STATE_CHANGE_PAUSED_TO_READY:
       gst_event_replace (&rtpbasepayload->priv->pending_segment, NULL);
+      if (priv->header_pool) {
+        gst_buffer_pool_set_active (priv->header_pool, FALSE);
+        gst_object_unref (priv->header_pool);
+        priv->header_pool = NULL;
+      }
       break;
     default:
       break;
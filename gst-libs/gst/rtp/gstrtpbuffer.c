@@ -515,6 +515,157 @@ gst_rtp_buffer_unmap (GstRTPBuffer * rtp)
 }
 
 
+/**
+ * gst_rtp_buffer_list_map:
+ * @list: a #GstBufferList
+ * @flags: #GstMapFlags
+ * @rtplist: a #GstRTPBufferList
+ *
+ * Map all packets of @list into @rtplist in one pass. Each packet is mapped
+ * and validated like with gst_rtp_buffer_map(); packets that fail are left
+ * unmapped in @rtplist with a %NULL buffer so that the caller can skip them.
+ *
+ * When @flags contains %GST_MAP_WRITE, @list must be writable and the
+ * packets are made writable in place before mapping them.
+ *
+ * Returns: %TRUE if all packets of @list could be mapped.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtp_buffer_list_map (GstBufferList * list, GstMapFlags flags,
+    GstRTPBufferList * rtplist)
+{
+  gboolean res = TRUE;
+  guint i, len;
+
+  g_return_val_if_fail (GST_IS_BUFFER_LIST (list), FALSE);
+  g_return_val_if_fail (rtplist != NULL, FALSE);
+  g_return_val_if_fail (rtplist->list == NULL, FALSE);
+  g_return_val_if_fail ((flags & GST_MAP_WRITE) == 0
+      || gst_buffer_list_is_writable (list), FALSE);
+
+  len = gst_buffer_list_length (list);
+  if (rtplist->n_allocated < len) {
+    g_free (rtplist->packets);
+    rtplist->packets = g_new (GstRTPBuffer, len);
+    rtplist->n_allocated = len;
+  }
+  rtplist->list = list;
+  rtplist->n_packets = len;
+
+  for (i = 0; i < len; i++) {
+    GstRTPBuffer *rtp = &rtplist->packets[i];
+    GstBuffer *buffer;
+
+    memset (rtp, 0, sizeof (GstRTPBuffer));
+
+    if (flags & GST_MAP_WRITE)
+      buffer = gst_buffer_list_get_writable (list, i);
+    else
+      buffer = gst_buffer_list_get (list, i);
+
+    if (G_UNLIKELY (!gst_rtp_buffer_map (buffer, flags, rtp))) {
+      GST_DEBUG ("packet %u of list %p is not a valid RTP packet", i, list);
+      rtp->buffer = NULL;
+      res = FALSE;
+    }
+  }
+
+  return res;
+}
+
+/**
+ * gst_rtp_buffer_list_unmap:
+ * @rtplist: a #GstRTPBufferList
+ *
+ * Unmap all packets of @rtplist previously mapped with
+ * gst_rtp_buffer_list_map(). Packets that were already unmapped with
+ * gst_rtp_buffer_unmap() are skipped. The packet array is kept for the next
+ * gst_rtp_buffer_list_map() call.
+ *
+ * Since: 1.20
+ */
+void
+gst_rtp_buffer_list_unmap (GstRTPBufferList * rtplist)
+{
+  guint i;
+
+  g_return_if_fail (rtplist != NULL);
+  g_return_if_fail (rtplist->list != NULL);
+
+  for (i = 0; i < rtplist->n_packets; i++) {
+    if (rtplist->packets[i].buffer != NULL)
+      gst_rtp_buffer_unmap (&rtplist->packets[i]);
+  }
+  rtplist->list = NULL;
+  rtplist->n_packets = 0;
+}
+
+/**
+ * gst_rtp_buffer_list_clear:
+ * @rtplist: a #GstRTPBufferList
+ *
+ * Free the packet array of @rtplist. @rtplist must not be mapped.
+ *
+ * Since: 1.20
+ */
+void
+gst_rtp_buffer_list_clear (GstRTPBufferList * rtplist)
+{
+  g_return_if_fail (rtplist != NULL);
+  g_return_if_fail (rtplist->list == NULL);
+
+  g_free (rtplist->packets);
+  rtplist->packets = NULL;
+  rtplist->n_allocated = 0;
+}
+
+/**
+ * gst_rtp_buffer_list_set_headers:
+ * @rtplist: a #GstRTPBufferList mapped with %GST_MAP_WRITE
+ * @ssrc: the SSRC to set
+ * @payload_type: the payload type to set
+ * @seqnum: the sequence number of the first packet
+ * @rtptime: the RTP timestamp to set
+ *
+ * Set the SSRC, payload type and RTP timestamp of all valid packets in
+ * @rtplist and give them consecutive sequence numbers starting at @seqnum.
+ * The fixed headers are written directly, without going through the
+ * per-packet setters.
+ *
+ * Returns: the sequence number following the one of the last packet.
+ *
+ * Since: 1.20
+ */
+guint16
+gst_rtp_buffer_list_set_headers (GstRTPBufferList * rtplist, guint32 ssrc,
+    guint8 payload_type, guint16 seqnum, guint32 rtptime)
+{
+  guint i;
+
+  g_return_val_if_fail (rtplist != NULL, seqnum);
+  g_return_val_if_fail (rtplist->list != NULL, seqnum);
+  g_return_val_if_fail (payload_type < 0x80, seqnum);
+
+  for (i = 0; i < rtplist->n_packets; i++) {
+    GstRTPBuffer *rtp = &rtplist->packets[i];
+    guint8 *data;
+
+    if (G_UNLIKELY (rtp->buffer == NULL))
+      continue;
+
+    data = rtp->data[0];
+    data[1] = (data[1] & 0x80) | payload_type;
+    GST_WRITE_UINT16_BE (data + 2, seqnum);
+    GST_WRITE_UINT32_BE (data + 4, rtptime);
+    GST_WRITE_UINT32_BE (data + 8, ssrc);
+    seqnum++;
+  }
+
+  return seqnum;
+}
+
 /**
  * gst_rtp_buffer_set_packet_len:
  * @rtp: the RTP packet
@@ -843,8 +994,6 @@ gst_rtp_buffer_set_extension_data (GstRTPBuffer * rtp, guint16 bits,
   guint8 *data;
   GstMemory *mem = NULL;
 
-  ensure_buffers (rtp);
-
   /* this is the size of the extension data we need */
   min_size = 4 + length * sizeof (guint32);
 
@@ -852,6 +1001,10 @@ gst_rtp_buffer_set_extension_data (GstRTPBuffer * rtp, guint16 bits,
   if (rtp->data[1] == NULL || min_size > rtp->size[1]) {
     GstMapInfo map;
 
+    /* the extension gets its own memory, the existing extension data is
+     * large enough otherwise and is written in place */
+    ensure_buffers (rtp);
+
     /* we don't have (enough) extension data, make some */
     mem = gst_allocator_alloc (NULL, min_size, NULL);
 
@@ -1617,18 +1770,20 @@ gst_rtp_buffer_add_extension_onebyte_header (GstRTPBuffer * rtp, guint8 id,
 }
 
 
-static guint
-get_twobytes_header_end_offset (const guint8 * pdata, guint wordlen)
+static gboolean
+get_twobytes_header_end_offset (const guint8 * pdata, guint wordlen,
+    guint * offset)
 {
-  guint offset = 0;
   guint bytelen = wordlen * 4;
   guint paddingcount = 0;
 
-  while (offset + 2 < bytelen) {
+  *offset = 0;
+
+  while (*offset + 2 < bytelen) {
     guint8 read_id, read_len;
 
-    read_id = GST_READ_UINT8 (pdata + offset);
-    offset += 1;
+    read_id = GST_READ_UINT8 (pdata + *offset);
+    *offset += 1;
 
     /* ID 0 means its padding, skip */
     if (read_id == 0) {
@@ -1638,17 +1793,19 @@ get_twobytes_header_end_offset (const guint8 * pdata, guint wordlen)
 
     paddingcount = 0;
 
-    read_len = GST_READ_UINT8 (pdata + offset);
-    offset += 1;
+    read_len = GST_READ_UINT8 (pdata + *offset);
+    *offset += 1;
 
     /* Ignore extension headers where the size does not fit */
-    if (offset + read_len > bytelen)
-      return 0;
+    if (*offset + read_len > bytelen)
+      return FALSE;
 
-    offset += read_len;
+    *offset += read_len;
   }
 
-  return offset - paddingcount;
+  *offset -= paddingcount;
+
+  return TRUE;
 }
 
 /**
@@ -1676,10 +1833,10 @@ gst_rtp_buffer_add_extension_twobytes_header (GstRTPBuffer * rtp,
 {
   guint16 bits;
   guint8 *pdata = 0;
-  guint wordlen;
+  guint wordlen = 0;
+  guint wordlen_new;
   gboolean has_bit;
-  gulong offset = 0;
-  guint extlen;
+  guint extlen, offset = 0;
 
   g_return_val_if_fail ((appbits & 0xF0) == 0, FALSE);
   g_return_val_if_fail (size < 256, FALSE);
@@ -1692,18 +1849,19 @@ gst_rtp_buffer_add_extension_twobytes_header (GstRTPBuffer * rtp,
     if (bits != ((0x100 << 4) | (appbits & 0x0f)))
       return FALSE;
 
-    offset = get_twobytes_header_end_offset (pdata, wordlen);
-    if (offset == 0)
+    if (!get_twobytes_header_end_offset (pdata, wordlen, &offset))
       return FALSE;
   }
 
   /* the required size of the new extension data */
   extlen = offset + size + 2;
-  /* calculate amount of words */
-  wordlen = extlen / 4 + ((extlen % 4) ? 1 : 0);
+  /* calculate amount of words, never shrink reserved space */
+  wordlen_new = extlen / 4 + ((extlen % 4) ? 1 : 0);
+  if (has_bit)
+    wordlen_new = MAX (wordlen_new, wordlen);
 
   gst_rtp_buffer_set_extension_data (rtp, (0x100 << 4) | (appbits & 0x0F),
-      wordlen);
+      wordlen_new);
   gst_rtp_buffer_get_extension_data (rtp, &bits, (gpointer) & pdata, &wordlen);
 
   pdata += offset;
@@ -1716,3 +1874,214 @@ gst_rtp_buffer_add_extension_twobytes_header (GstRTPBuffer * rtp,
 
   return TRUE;
 }
+
+/**
+ * gst_rtp_buffer_reserve_extension_data:
+ * @rtp: the RTP packet, mapped with %GST_MAP_WRITE
+ * @bits: the bits specific for the extension
+ * @wordlen: the number of 32-bit words to reserve
+ *
+ * Add an extension of @wordlen 32-bit words to an RTP packet that does not
+ * have one yet, filled with RFC 5285 padding. Header extensions added later
+ * with gst_rtp_buffer_add_extension_onebyte_header() or
+ * gst_rtp_buffer_add_extension_twobytes_header() are written into the
+ * reserved space without reallocating as long as they fit.
+ *
+ * When the first memory of the packet only holds the RTP header and has
+ * enough room left, it is grown in place. This is the case for packets whose
+ * header was allocated separately from the payload with enough spare size.
+ * @rtp is remapped then, pointers previously retrieved from it are no longer
+ * valid. @rtp stays mapped when this fails.
+ *
+ * Returns: %TRUE if the space was reserved.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtp_buffer_reserve_extension_data (GstRTPBuffer * rtp, guint16 bits,
+    guint16 wordlen)
+{
+  GstBuffer *buffer;
+  GstMemory *mem;
+  GstMapFlags flags;
+  gsize offset, maxsize;
+  guint header_len, extlen;
+  guint8 *data;
+
+  g_return_val_if_fail (rtp != NULL, FALSE);
+  g_return_val_if_fail (rtp->buffer != NULL, FALSE);
+  g_return_val_if_fail (gst_buffer_is_writable (rtp->buffer), FALSE);
+
+  if (rtp->data[1] != NULL)
+    return FALSE;
+
+  header_len = gst_rtp_buffer_get_header_len (rtp);
+  extlen = 4 + wordlen * sizeof (guint32);
+
+  buffer = rtp->buffer;
+  mem = gst_buffer_peek_memory (buffer, 0);
+  gst_memory_get_sizes (mem, &offset, &maxsize);
+
+  if (rtp->map[0].size == header_len && maxsize - offset >= header_len + extlen
+      && gst_memory_is_writable (mem)) {
+    GstMapInfo map;
+
+    /* grow the header memory, the extension follows the header directly */
+    flags = rtp->map[0].flags;
+    gst_rtp_buffer_unmap (rtp);
+    gst_memory_resize (mem, 0, header_len + extlen);
+
+    if (!gst_memory_map (mem, &map, GST_MAP_WRITE))
+      goto map_failed;
+    data = map.data + header_len;
+    GST_WRITE_UINT16_BE (data, bits);
+    GST_WRITE_UINT16_BE (data + 2, wordlen);
+    memset (data + 4, 0, extlen - 4);
+    GST_RTP_HEADER_EXTENSION (map.data) = TRUE;
+    gst_memory_unmap (mem, &map);
+
+    /* remap so that the extension and payload pointers are updated */
+    if (!gst_rtp_buffer_map (buffer, flags, rtp)) {
+      if (gst_memory_map (mem, &map, GST_MAP_WRITE)) {
+        GST_RTP_HEADER_EXTENSION (map.data) = FALSE;
+        gst_memory_unmap (mem, &map);
+      }
+      goto map_failed;
+    }
+  } else {
+    gst_rtp_buffer_set_extension_data (rtp, bits, wordlen);
+    memset ((guint8 *) rtp->data[1] + 4, 0, extlen - 4);
+  }
+
+  return TRUE;
+
+  /* ERRORS */
+map_failed:
+  {
+    /* restore the original packet, which could be mapped before */
+    GST_ERROR ("failed to map the packet with the reserved extension");
+    gst_memory_resize (mem, 0, header_len);
+    if (!gst_rtp_buffer_map (buffer, flags, rtp))
+      GST_ERROR ("failed to remap the original packet");
+    return FALSE;
+  }
+}
+
+/**
+ * gst_rtp_buffer_index_extensions:
+ * @rtp: the RTP packet
+ * @index: (out caller-allocates): a #GstRTPExtensionIndex
+ *
+ * Parse the RFC 5285 header extensions of @rtp in a single pass and store
+ * where each ID is found in @index. The extensions can then be looked up in
+ * constant time with gst_rtp_buffer_get_indexed_extension(). Only the first
+ * extension with a given ID is indexed.
+ *
+ * @index stays valid as long as the extension data of @rtp is not modified
+ * other than by writing to data returned by
+ * gst_rtp_buffer_get_indexed_extension().
+ *
+ * Returns: %TRUE if @rtp has RFC 5285 header extensions. @index is empty
+ * otherwise.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtp_buffer_index_extensions (GstRTPBuffer * rtp,
+    GstRTPExtensionIndex * index)
+{
+  guint16 bits;
+  guint8 *pdata;
+  guint wordlen, bytelen, offset;
+  gboolean twobytes;
+
+  g_return_val_if_fail (rtp != NULL, FALSE);
+  g_return_val_if_fail (index != NULL, FALSE);
+
+  memset (index, 0, sizeof (GstRTPExtensionIndex));
+
+  if (!gst_rtp_buffer_get_extension_data (rtp, &bits, (gpointer) & pdata,
+          &wordlen))
+    return FALSE;
+
+  if (bits == 0xBEDE)
+    twobytes = FALSE;
+  else if (bits >> 4 == 0x100)
+    twobytes = TRUE;
+  else
+    return FALSE;
+
+  /* offsets are stored in 16 bits, larger blocks are only partially indexed */
+  bytelen = MIN (wordlen * 4, G_MAXUINT16);
+  offset = 0;
+
+  while (offset + (twobytes ? 2 : 1) < bytelen) {
+    guint8 read_id, read_len;
+
+    if (twobytes) {
+      read_id = pdata[offset++];
+      if (read_id == 0)
+        continue;
+      read_len = pdata[offset++];
+    } else {
+      read_id = pdata[offset] >> 4;
+      read_len = (pdata[offset] & 0x0F) + 1;
+      offset++;
+      if (read_id == 0)
+        continue;
+      /* ID 15 is special and means we should stop parsing */
+      if (read_id == 15)
+        break;
+    }
+
+    /* Ignore extension headers where the size does not fit */
+    if (offset + read_len > bytelen)
+      break;
+
+    if (index->offset[read_id] == 0) {
+      index->offset[read_id] = offset + 1;
+      index->size[read_id] = read_len;
+    }
+    offset += read_len;
+  }
+
+  index->bits = bits;
+
+  return TRUE;
+}
+
+/**
+ * gst_rtp_buffer_get_indexed_extension:
+ * @rtp: the RTP packet
+ * @index: a #GstRTPExtensionIndex of @rtp
+ * @id: The ID of the header extension
+ * @data: (out) (array length=size) (element-type guint8) (transfer none):
+ *   location for data
+ * @size: (out): the size of the data in bytes
+ *
+ * Look up the header extension with @id in @index, built for @rtp with
+ * gst_rtp_buffer_index_extensions(). When @rtp is mapped with
+ * %GST_MAP_WRITE, @data can be rewritten in place.
+ *
+ * Returns: %TRUE if @rtp has a header extension with @id.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtp_buffer_get_indexed_extension (GstRTPBuffer * rtp,
+    const GstRTPExtensionIndex * index, guint8 id, gpointer * data,
+    guint * size)
+{
+  g_return_val_if_fail (rtp != NULL, FALSE);
+  g_return_val_if_fail (index != NULL, FALSE);
+
+  if (index->offset[id] == 0 || rtp->data[1] == NULL)
+    return FALSE;
+
+  if (data)
+    *data = (guint8 *) rtp->data[1] + 4 + index->offset[id] - 1;
+  if (size)
+    *size = index->size[id];
+
+  return TRUE;
+}
@@ -62,6 +62,57 @@ struct _GstRTPBuffer
 #define GST_RTP_BUFFER_INIT { NULL, 0, { NULL, NULL, NULL, NULL}, { 0, 0, 0, 0 }, \
   { GST_MAP_INFO_INIT, GST_MAP_INFO_INIT, GST_MAP_INFO_INIT, GST_MAP_INFO_INIT} }
 
+/**
+ * GstRTPBufferList:
+ * @list: the mapped #GstBufferList
+ * @n_packets: the number of packets in @list
+ * @packets: (array length=n_packets): one #GstRTPBuffer for each packet in
+ *     @list. Packets that are not valid RTP have a %NULL buffer.
+ *
+ * Data structure that maps all packets of a #GstBufferList at once. The
+ * packet array is kept between gst_rtp_buffer_list_map() calls so that the
+ * same structure can be reused for many lists without allocating. Release it
+ * with gst_rtp_buffer_list_clear().
+ *
+ * Since: 1.20
+ */
+typedef struct {
+  GstBufferList *list;
+  guint          n_packets;
+  GstRTPBuffer  *packets;
+
+  /*< private >*/
+  guint          n_allocated;
+  gpointer       _gst_reserved[GST_PADDING];
+} GstRTPBufferList;
+
+/**
+ * GST_RTP_BUFFER_LIST_INIT:
+ *
+ * Initializer for a #GstRTPBufferList.
+ *
+ * Since: 1.20
+ */
+#define GST_RTP_BUFFER_LIST_INIT { NULL, 0, NULL, 0, { NULL, } }
+
+/**
+ * GstRTPExtensionIndex:
+ *
+ * Index of the RFC 5285 header extensions of an RTP packet, built with
+ * gst_rtp_buffer_index_extensions(). The size of the structure is public to
+ * allow stack allocations.
+ *
+ * Since: 1.20
+ */
+typedef struct {
+  /*< private >*/
+  guint16        bits;
+  guint16        offset[256];
+  guint8         size[256];
+
+  gpointer       _gst_reserved[GST_PADDING];
+} GstRTPExtensionIndex;
+
 /* creating buffers */
 
 GST_RTP_API
@@ -95,6 +146,21 @@ gboolean        gst_rtp_buffer_map                   (GstBuffer *buffer, GstMapF
 GST_RTP_API
 void            gst_rtp_buffer_unmap                 (GstRTPBuffer *rtp);
 
+GST_RTP_API
+gboolean        gst_rtp_buffer_list_map              (GstBufferList *list, GstMapFlags flags,
+                                                      GstRTPBufferList *rtplist);
+
+GST_RTP_API
+void            gst_rtp_buffer_list_unmap            (GstRTPBufferList *rtplist);
+
+GST_RTP_API
+void            gst_rtp_buffer_list_clear            (GstRTPBufferList *rtplist);
+
+GST_RTP_API
+guint16         gst_rtp_buffer_list_set_headers      (GstRTPBufferList *rtplist, guint32 ssrc,
+                                                      guint8 payload_type, guint16 seqnum,
+                                                      guint32 rtptime);
+
 GST_RTP_API
 void            gst_rtp_buffer_set_packet_len        (GstRTPBuffer *rtp, guint len);
 
@@ -236,6 +302,22 @@ gboolean gst_rtp_buffer_get_extension_onebyte_header_from_bytes (GBytes * bytes,
                                                                  gpointer * data,
                                                                  guint * size);
 
+GST_RTP_API
+gboolean       gst_rtp_buffer_reserve_extension_data        (GstRTPBuffer *rtp,
+                                                             guint16 bits,
+                                                             guint16 wordlen);
+
+GST_RTP_API
+gboolean       gst_rtp_buffer_index_extensions              (GstRTPBuffer *rtp,
+                                                             GstRTPExtensionIndex *index);
+
+GST_RTP_API
+gboolean       gst_rtp_buffer_get_indexed_extension         (GstRTPBuffer *rtp,
+                                                             const GstRTPExtensionIndex *index,
+                                                             guint8 id,
+                                                             gpointer * data,
+                                                             guint * size);
+
 /**
  * GstRTPBufferFlags:
  * @GST_RTP_BUFFER_FLAG_RETRANSMISSION: The #GstBuffer was once wrapped
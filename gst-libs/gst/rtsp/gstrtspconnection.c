@@ -117,6 +117,9 @@ typedef struct
 
   /* ID of the message for notification */
   guint id;
+
+  /* monotonic time when the message was queued in a watch */
+  gint64 queued_time;
 } GstRTSPSerializedMessage;
 
 static void
@@ -213,6 +216,10 @@ struct _GstRTSPConnection
 
   gchar *proxy_host;
   guint proxy_port;
+
+  /* memory for interleaved data received without a message */
+  GstAllocator *data_allocator;
+  GstAllocationParams data_params;
 };
 
 enum
@@ -243,6 +250,12 @@ typedef struct
   guint line;
   guint8 *body_data;
   guint body_len;
+
+  /* interleaved data read directly into memory from the data allocator */
+  guint8 channel;
+  GstMemory *data_mem;
+  GstMapInfo data_map;
+  GstBuffer *data_buffer;
 } GstRTSPBuilder;
 
 /* function prototypes */
@@ -253,6 +266,12 @@ static void
 build_reset (GstRTSPBuilder * builder)
 {
   g_free (builder->body_data);
+  if (builder->data_mem) {
+    gst_memory_unmap (builder->data_mem, &builder->data_map);
+    gst_memory_unref (builder->data_mem);
+  }
+  if (builder->data_buffer)
+    gst_buffer_unref (builder->data_buffer);
   memset (builder, 0, sizeof (GstRTSPBuilder));
 }
 
@@ -374,6 +393,7 @@ gst_rtsp_connection_create (const GstRTSPUrl * url, GstRTSPConnection ** conn)
   newconn->version = 0;
 
   newconn->content_length_limit = G_MAXUINT;
+  gst_allocation_params_init (&newconn->data_params);
 
   *conn = newconn;
 
@@ -2348,10 +2368,14 @@ invalid_format:
  *  GST_RTSP_EEOF: when the read socket is closed
  *  GST_RTSP_EINTR: when more data is needed.
  *  GST_RTSP_..: some other error occurred.
+ *
+ * With @direct_data, interleaved data is read straight into memory from the
+ * data allocator of @conn and returned in builder->data_buffer, @message is
+ * left untouched in that case.
  */
 static GstRTSPResult
 build_next (GstRTSPBuilder * builder, GstRTSPMessage * message,
-    GstRTSPConnection * conn, gboolean block)
+    GstRTSPConnection * conn, gboolean block, gboolean direct_data)
 {
   GstRTSPResult res;
 
@@ -2394,17 +2418,54 @@ build_next (GstRTSPBuilder * builder, GstRTSPMessage * message,
         if (res != GST_RTSP_OK)
           goto done;
 
+        builder->body_len = (builder->buffer[2] << 8) | builder->buffer[3];
+        builder->offset = 0;
+        builder->state = STATE_DATA_BODY;
+
+        if (direct_data) {
+          builder->channel = builder->buffer[1];
+          builder->data_mem = gst_allocator_alloc (conn->data_allocator,
+              builder->body_len, &conn->data_params);
+          if (G_UNLIKELY (builder->data_mem == NULL)) {
+            res = GST_RTSP_ENOMEM;
+            goto done;
+          }
+          if (G_UNLIKELY (!gst_memory_map (builder->data_mem,
+                      &builder->data_map, GST_MAP_WRITE))) {
+            gst_memory_unref (builder->data_mem);
+            builder->data_mem = NULL;
+            res = GST_RTSP_ENOMEM;
+            goto done;
+          }
+          break;
+        }
+
         gst_rtsp_message_init_data (message, builder->buffer[1]);
 
-        builder->body_len = (builder->buffer[2] << 8) | builder->buffer[3];
         builder->body_data = g_malloc (builder->body_len + 1);
         builder->body_data[builder->body_len] = '\0';
-        builder->offset = 0;
-        builder->state = STATE_DATA_BODY;
         break;
       }
       case STATE_DATA_BODY:
       {
+        if (builder->data_mem) {
+          /* read the payload in place, without an intermediate copy */
+          res = read_bytes (conn, builder->data_map.data, &builder->offset,
+              builder->body_len, block);
+          if (res != GST_RTSP_OK)
+            goto done;
+
+          gst_memory_unmap (builder->data_mem, &builder->data_map);
+          builder->data_buffer = gst_buffer_new ();
+          gst_buffer_append_memory (builder->data_buffer, builder->data_mem);
+          builder->data_mem = NULL;
+          builder->body_len = 0;
+
+          builder->state = STATE_END;
+          res = GST_RTSP_OK;
+          goto done;
+        }
+
         res =
             read_bytes (conn, builder->body_data, &builder->offset,
             builder->body_len, block);
@@ -2666,45 +2727,36 @@ no_message:
   }
 }
 
-/**
- * gst_rtsp_connection_receive_usec:
- * @conn: a #GstRTSPConnection
- * @message: the message to read
- * @timeout: a timeout value or 0
- *
- * Attempt to read into @message from the connected @conn, blocking up to
- * the specified @timeout. @timeout can be 0, in which case this function
- * might block forever.
- *
- * This function can be cancelled with gst_rtsp_connection_flush().
- *
- * Returns: #GST_RTSP_OK on success.
- *
- * Since: 1.18
- */
-GstRTSPResult
-gst_rtsp_connection_receive_usec (GstRTSPConnection * conn,
-    GstRTSPMessage * message, gint64 timeout)
+static GstRTSPResult
+gst_rtsp_connection_receive_internal (GstRTSPConnection * conn,
+    GstRTSPMessage * message, guint8 * channel, GstBuffer ** buffer,
+    gint64 timeout)
 {
   GstRTSPResult res;
   GstRTSPBuilder builder;
   GstClockTime to;
 
-  g_return_val_if_fail (conn != NULL, GST_RTSP_EINVAL);
-  g_return_val_if_fail (message != NULL, GST_RTSP_EINVAL);
-  g_return_val_if_fail (conn->read_socket != NULL, GST_RTSP_EINVAL);
-
   /* configure timeout if any */
   to = timeout * 1000;
 
   g_socket_set_timeout (conn->read_socket, (to + GST_SECOND - 1) / GST_SECOND);
   memset (&builder, 0, sizeof (GstRTSPBuilder));
-  res = build_next (&builder, message, conn, TRUE);
+  res = build_next (&builder, message, conn, TRUE, buffer != NULL);
   g_socket_set_timeout (conn->read_socket, 0);
 
   if (G_UNLIKELY (res != GST_RTSP_OK))
     goto read_error;
 
+  if (builder.data_buffer) {
+    /* interleaved data, no message was built */
+    *channel = builder.channel;
+    *buffer = builder.data_buffer;
+    builder.data_buffer = NULL;
+    build_reset (&builder);
+
+    return GST_RTSP_OK;
+  }
+
   if (!conn->manual_http) {
     if (message->type == GST_RTSP_MESSAGE_HTTP_REQUEST) {
       if (conn->tstate == TUNNEL_STATE_NONE &&
@@ -2753,6 +2805,74 @@ cleanup:
   }
 }
 
+/**
+ * gst_rtsp_connection_receive_usec:
+ * @conn: a #GstRTSPConnection
+ * @message: the message to read
+ * @timeout: a timeout value or 0
+ *
+ * Attempt to read into @message from the connected @conn, blocking up to
+ * the specified @timeout. @timeout can be 0, in which case this function
+ * might block forever.
+ *
+ * This function can be cancelled with gst_rtsp_connection_flush().
+ *
+ * Returns: #GST_RTSP_OK on success.
+ *
+ * Since: 1.18
+ */
+GstRTSPResult
+gst_rtsp_connection_receive_usec (GstRTSPConnection * conn,
+    GstRTSPMessage * message, gint64 timeout)
+{
+  g_return_val_if_fail (conn != NULL, GST_RTSP_EINVAL);
+  g_return_val_if_fail (message != NULL, GST_RTSP_EINVAL);
+  g_return_val_if_fail (conn->read_socket != NULL, GST_RTSP_EINVAL);
+
+  return gst_rtsp_connection_receive_internal (conn, message, NULL, NULL,
+      timeout);
+}
+
+/**
+ * gst_rtsp_connection_receive_data_usec:
+ * @conn: a #GstRTSPConnection
+ * @message: the message to read
+ * @channel: (out): location for the channel of interleaved data
+ * @buffer: (out) (transfer full): location for interleaved data
+ * @timeout: a timeout value or 0
+ *
+ * Like gst_rtsp_connection_receive_usec(), but when interleaved data is
+ * received, it is read directly into memory from the allocator configured
+ * with gst_rtsp_connection_set_data_allocator() and returned in @buffer and
+ * @channel without building a #GstRTSPMessage. This avoids copying the data
+ * and allocating a message for every interleaved packet.
+ *
+ * When another message is received, @buffer is set to %NULL and @message
+ * is filled as with gst_rtsp_connection_receive_usec().
+ *
+ * This function can be cancelled with gst_rtsp_connection_flush().
+ *
+ * Returns: #GST_RTSP_OK on success.
+ *
+ * Since: 1.20
+ */
+GstRTSPResult
+gst_rtsp_connection_receive_data_usec (GstRTSPConnection * conn,
+    GstRTSPMessage * message, guint8 * channel, GstBuffer ** buffer,
+    gint64 timeout)
+{
+  g_return_val_if_fail (conn != NULL, GST_RTSP_EINVAL);
+  g_return_val_if_fail (message != NULL, GST_RTSP_EINVAL);
+  g_return_val_if_fail (channel != NULL, GST_RTSP_EINVAL);
+  g_return_val_if_fail (buffer != NULL, GST_RTSP_EINVAL);
+  g_return_val_if_fail (conn->read_socket != NULL, GST_RTSP_EINVAL);
+
+  *buffer = NULL;
+
+  return gst_rtsp_connection_receive_internal (conn, message, channel, buffer,
+      timeout);
+}
+
 /**
  * gst_rtsp_connection_close:
  * @conn: a #GstRTSPConnection
@@ -2845,6 +2965,8 @@ gst_rtsp_connection_free (GstRTSPConnection * conn)
   g_timer_destroy (conn->timer);
   gst_rtsp_url_free (conn->url);
   g_free (conn->proxy_host);
+  if (conn->data_allocator)
+    gst_object_unref (conn->data_allocator);
   g_free (conn);
 
   return res;
@@ -3285,6 +3407,40 @@ gst_rtsp_connection_set_content_length_limit (GstRTSPConnection * conn,
   conn->content_length_limit = limit;
 }
 
+/**
+ * gst_rtsp_connection_set_data_allocator:
+ * @conn: a #GstRTSPConnection
+ * @allocator: (transfer none) (nullable): a #GstAllocator or %NULL
+ * @params: (transfer none) (nullable): #GstAllocationParams or %NULL
+ *
+ * Configure the allocator and parameters used for the memory that
+ * interleaved data is read into by gst_rtsp_connection_receive_data_usec()
+ * and by watches with a #GstRTSPWatchFuncs.data_received callback. A pooling
+ * allocator lets the memory be recycled once the buffers are released.
+ *
+ * When @allocator is %NULL, the default allocator is used.
+ *
+ * Since: 1.20
+ */
+void
+gst_rtsp_connection_set_data_allocator (GstRTSPConnection * conn,
+    GstAllocator * allocator, const GstAllocationParams * params)
+{
+  g_return_if_fail (conn != NULL);
+  g_return_if_fail (allocator == NULL || GST_IS_ALLOCATOR (allocator));
+
+  if (allocator)
+    gst_object_ref (allocator);
+  if (conn->data_allocator)
+    gst_object_unref (conn->data_allocator);
+  conn->data_allocator = allocator;
+
+  if (params)
+    conn->data_params = *params;
+  else
+    gst_allocation_params_init (&conn->data_params);
+}
+
 /**
  * gst_rtsp_connection_get_url:
  * @conn: a #GstRTSPConnection
@@ -3596,6 +3752,13 @@ struct _GstRTSPWatch
   GCond queue_not_full;
   gboolean flushing;
 
+  /* backlog statistics, protected by mutex */
+  guint64 stats_writes;
+  guint64 stats_bytes_written;
+  guint64 stats_messages_written;
+  GstClockTime stats_latency_total;
+  GstClockTime stats_latency_max;
+
   GstRTSPWatchFuncs funcs;
 
   gpointer user_data;
@@ -3605,6 +3768,107 @@ struct _GstRTSPWatch
 #define IS_BACKLOG_FULL(w) (((w)->max_bytes != 0 && (w)->messages_bytes >= (w)->max_bytes) || \
       ((w)->max_messages != 0 && (w)->messages_count >= (w)->max_messages))
 
+/* maximum number of vectors coalesced into one write of the backlog */
+#define WATCH_WRITE_MAX_VECTORS 256
+
+/* called with the watch mutex when a queued message was completely written */
+static void
+watch_message_written (GstRTSPWatch * watch, GstRTSPSerializedMessage * msg,
+    gint64 now)
+{
+  GstClockTime latency;
+
+  latency = MAX (now - msg->queued_time, 0) * GST_USECOND;
+
+  watch->stats_messages_written++;
+  watch->stats_latency_total += latency;
+  if (latency > watch->stats_latency_max)
+    watch->stats_latency_max = latency;
+}
+
+/* writes the first @n_batch queued messages with a single writev. The
+ * vectors and memory maps only live for the duration of this call so that
+ * the dispatch loop does not grow the stack with every batch. Called with
+ * the watch mutex */
+static GstRTSPResult
+watch_write_batch (GstRTSPWatch * watch, guint n_batch, guint n_vectors,
+    guint n_memories, gsize * bytes_to_write, gsize * bytes_written)
+{
+  GstRTSPResult res;
+  GOutputVector *vectors;
+  GstMapInfo *map_infos;
+  GstRTSPSerializedMessage *msg;
+  gint i, j, n_mmap;
+
+  vectors = g_newa (GOutputVector, n_vectors);
+  map_infos = n_memories ? g_newa (GstMapInfo, n_memories) : NULL;
+
+  for (i = 0, j = 0, n_mmap = 0, *bytes_to_write = 0; i < n_batch; i++) {
+    msg = gst_queue_array_peek_nth_struct (watch->messages, i);
+
+    if (msg->data_offset < msg->data_size) {
+      vectors[j].buffer = (msg->data_is_data_header ?
+          msg->data_header : msg->data) + msg->data_offset;
+      vectors[j].size = msg->data_size - msg->data_offset;
+      *bytes_to_write += vectors[j].size;
+      j++;
+    }
+
+    if (msg->body_data) {
+      if (msg->body_offset < msg->body_data_size) {
+        vectors[j].buffer = msg->body_data + msg->body_offset;
+        vectors[j].size = msg->body_data_size - msg->body_offset;
+        *bytes_to_write += vectors[j].size;
+        j++;
+      }
+    } else if (msg->body_buffer) {
+      guint m, n;
+      guint offset = 0;
+      n = gst_buffer_n_memory (msg->body_buffer);
+      for (m = 0; m < n; m++) {
+        GstMemory *mem = gst_buffer_peek_memory (msg->body_buffer, m);
+        guint off;
+
+        /* Skip all memories we already wrote */
+        if (offset + mem->size <= msg->body_offset) {
+          offset += mem->size;
+          continue;
+        }
+
+        if (offset < msg->body_offset)
+          off = msg->body_offset - offset;
+        else
+          off = 0;
+
+        offset += mem->size;
+
+        g_assert (off < mem->size);
+
+        gst_memory_map (mem, &map_infos[n_mmap], GST_MAP_READ);
+        vectors[j].buffer = map_infos[n_mmap].data + off;
+        vectors[j].size = map_infos[n_mmap].size - off;
+        *bytes_to_write += vectors[j].size;
+
+        n_mmap++;
+        j++;
+      }
+    }
+  }
+
+  res =
+      writev_bytes (watch->conn->output_stream, vectors, n_vectors,
+      bytes_written, FALSE, watch->conn->cancellable);
+  g_assert (*bytes_written == *bytes_to_write || res != GST_RTSP_OK);
+
+  /* unmap all memories here, this way the caller doesn't have to skip
+   * the memories that were already written before */
+  for (i = 0; i < n_mmap; i++) {
+    gst_memory_unmap (map_infos[i].memory, &map_infos[i]);
+  }
+
+  return res;
+}
+
 static gboolean
 gst_rtsp_source_prepare (GSource * source, gint * timeout)
 {
@@ -3691,7 +3955,8 @@ gst_rtsp_source_dispatch_read (GPollableInputStream * stream,
   if (G_POLLABLE_INPUT_STREAM (conn->input_stream) != stream)
     goto eof;
 
-  res = build_next (&watch->builder, &watch->message, conn, FALSE);
+  res = build_next (&watch->builder, &watch->message, conn, FALSE,
+      watch->funcs.data_received != NULL);
   if (res == GST_RTSP_EINTR)
     goto done;
   else if (G_UNLIKELY (res == GST_RTSP_EEOF)) {
@@ -3736,6 +4001,15 @@ gst_rtsp_source_dispatch_read (GPollableInputStream * stream,
     } else
       goto eof;
   } else if (G_LIKELY (res == GST_RTSP_OK)) {
+    if (watch->builder.data_buffer) {
+      /* interleaved data, read without building a message */
+      res = watch->funcs.data_received (watch, watch->builder.channel,
+          watch->builder.data_buffer, watch->user_data);
+      build_reset (&watch->builder);
+      if (G_UNLIKELY (res != GST_RTSP_OK))
+        goto read_error;
+      goto done;
+    }
     if (!conn->manual_http &&
         watch->message.type == GST_RTSP_MESSAGE_HTTP_REQUEST) {
       if (conn->tstate == TUNNEL_STATE_NONE &&
@@ -3847,6 +4121,8 @@ gst_rtsp_source_dispatch_write (GPollableOutputStream * stream,
 {
   GstRTSPResult res = GST_RTSP_ERROR;
   GstRTSPConnection *conn = watch->conn;
+  /* ids of the messages written by one batch, 0 terminated */
+  guint ids[WATCH_WRITE_MAX_VECTORS + 1];
 
   /* if this connection was already closed, stop now */
   if (G_POLLABLE_OUTPUT_STREAM (conn->output_stream) != stream ||
@@ -3856,12 +4132,10 @@ gst_rtsp_source_dispatch_write (GPollableOutputStream * stream,
   g_mutex_lock (&watch->mutex);
   do {
     guint n_messages = gst_queue_array_get_length (watch->messages);
-    GOutputVector *vectors;
-    GstMapInfo *map_infos;
-    guint *ids;
-    gsize bytes_to_write, bytes_written;
-    guint n_vectors, n_memories, n_ids, drop_messages;
-    gint i, j, l, n_mmap;
+    gsize bytes_to_write, bytes_written, batch_bytes;
+    guint n_vectors, n_memories, n_ids, n_batch, drop_messages;
+    gint i, l;
+    gint64 now;
     GstRTSPSerializedMessage *msg;
 
     /* if this connection was already closed, stop now */
@@ -3898,16 +4172,25 @@ gst_rtsp_source_dispatch_write (GPollableOutputStream * stream,
       break;
     }
 
-    for (i = 0, n_vectors = 0, n_memories = 0, n_ids = 0; i < n_messages; i++) {
+    /* coalesce the queued messages into one write, bounded by the number of
+     * messages and vectors and by the max-bytes backlog. The first message
+     * is always written completely */
+    n_vectors = n_memories = n_ids = n_batch = 0;
+    batch_bytes = 0;
+    for (i = 0; i < n_messages; i++) {
+      guint msg_vectors = 0, msg_memories = 0;
+      gsize msg_bytes = 0;
+
       msg = gst_queue_array_peek_nth_struct (watch->messages, i);
-      if (msg->id != 0)
-        n_ids++;
 
-      if (msg->data_offset < msg->data_size)
-        n_vectors++;
+      if (msg->data_offset < msg->data_size) {
+        msg_vectors++;
+        msg_bytes += msg->data_size - msg->data_offset;
+      }
 
       if (msg->body_data && msg->body_offset < msg->body_data_size) {
-        n_vectors++;
+        msg_vectors++;
+        msg_bytes += msg->body_data_size - msg->body_offset;
       } else if (msg->body_buffer) {
         guint m, n;
         guint offset = 0;
@@ -3923,92 +4206,46 @@ gst_rtsp_source_dispatch_write (GPollableOutputStream * stream,
           }
           offset += mem->size;
 
-          n_memories++;
-          n_vectors++;
+          msg_memories++;
+          msg_vectors++;
         }
+        msg_bytes += gst_buffer_get_size (msg->body_buffer) - msg->body_offset;
       }
-    }
-
-    vectors = g_newa (GOutputVector, n_vectors);
-    map_infos = n_memories ? g_newa (GstMapInfo, n_memories) : NULL;
-    ids = n_ids ? g_newa (guint, n_ids + 1) : NULL;
-    if (ids)
-      memset (ids, 0, sizeof (guint) * (n_ids + 1));
-
-    for (i = 0, j = 0, n_mmap = 0, l = 0, bytes_to_write = 0; i < n_messages;
-        i++) {
-      msg = gst_queue_array_peek_nth_struct (watch->messages, i);
-
-      if (msg->data_offset < msg->data_size) {
-        vectors[j].buffer = (msg->data_is_data_header ?
-            msg->data_header : msg->data) + msg->data_offset;
-        vectors[j].size = msg->data_size - msg->data_offset;
-        bytes_to_write += vectors[j].size;
-        j++;
-      }
-
-      if (msg->body_data) {
-        if (msg->body_offset < msg->body_data_size) {
-          vectors[j].buffer = msg->body_data + msg->body_offset;
-          vectors[j].size = msg->body_data_size - msg->body_offset;
-          bytes_to_write += vectors[j].size;
-          j++;
-        }
-      } else if (msg->body_buffer) {
-        guint m, n;
-        guint offset = 0;
-        n = gst_buffer_n_memory (msg->body_buffer);
-        for (m = 0; m < n; m++) {
-          GstMemory *mem = gst_buffer_peek_memory (msg->body_buffer, m);
-          guint off;
-
-          /* Skip all memories we already wrote */
-          if (offset + mem->size <= msg->body_offset) {
-            offset += mem->size;
-            continue;
-          }
-
-          if (offset < msg->body_offset)
-            off = msg->body_offset - offset;
-          else
-            off = 0;
-
-          offset += mem->size;
 
-          g_assert (off < mem->size);
-
-          gst_memory_map (mem, &map_infos[n_mmap], GST_MAP_READ);
-          vectors[j].buffer = map_infos[n_mmap].data + off;
-          vectors[j].size = map_infos[n_mmap].size - off;
-          bytes_to_write += vectors[j].size;
+      if (n_batch > 0 && (n_batch == WATCH_WRITE_MAX_VECTORS ||
+              n_vectors + msg_vectors > WATCH_WRITE_MAX_VECTORS ||
+              (watch->max_bytes != 0
+                  && batch_bytes + msg_bytes > watch->max_bytes)))
+        break;
 
-          n_mmap++;
-          j++;
-        }
-      }
+      if (msg->id != 0)
+        n_ids++;
+      n_vectors += msg_vectors;
+      n_memories += msg_memories;
+      batch_bytes += msg_bytes;
+      n_batch++;
     }
 
-    res =
-        writev_bytes (watch->conn->output_stream, vectors, n_vectors,
-        &bytes_written, FALSE, watch->conn->cancellable);
-    g_assert (bytes_written == bytes_to_write || res != GST_RTSP_OK);
+    res = watch_write_batch (watch, n_batch, n_vectors, n_memories,
+        &bytes_to_write, &bytes_written);
+    memset (ids, 0, sizeof (guint) * (n_ids + 1));
+    l = 0;
 
-    /* First unmap all memories here, this simplifies the code below
-     * as we don't have to skip all memories that were already written
-     * before */
-    for (i = 0; i < n_mmap; i++) {
-      gst_memory_unmap (map_infos[i].memory, &map_infos[i]);
-    }
+    now = g_get_monotonic_time ();
+    watch->stats_writes++;
+    watch->stats_bytes_written += bytes_written;
 
     if (bytes_written == bytes_to_write) {
-      /* fast path, just unmap all memories, free memory, drop all messages and notify them */
-      l = 0;
-      while ((msg = gst_queue_array_pop_head_struct (watch->messages))) {
+      /* fast path, free memory, drop all messages of the batch and notify
+       * them */
+      for (i = 0; i < n_batch; i++) {
+        msg = gst_queue_array_pop_head_struct (watch->messages);
         if (msg->id) {
           ids[l] = msg->id;
           l++;
         }
 
+        watch_message_written (watch, msg, now);
         gst_rtsp_serialized_message_clear (msg);
       }
 
@@ -4016,7 +4253,7 @@ gst_rtsp_source_dispatch_write (GPollableOutputStream * stream,
       watch->messages_bytes -= bytes_written;
     } else if (bytes_written > 0) {
       /* not done, let's skip all messages that were sent already and free them */
-      for (i = 0, drop_messages = 0; i < n_messages; i++) {
+      for (i = 0, drop_messages = 0; i < n_batch; i++) {
         msg = gst_queue_array_peek_nth_struct (watch->messages, i);
 
         if (bytes_written >= msg->data_size - msg->data_offset) {
@@ -4048,6 +4285,7 @@ gst_rtsp_source_dispatch_write (GPollableOutputStream * stream,
               l++;
             }
 
+            watch_message_written (watch, msg, now);
             gst_rtsp_serialized_message_clear (msg);
           } else {
             msg->body_offset += bytes_written;
@@ -4077,16 +4315,13 @@ gst_rtsp_source_dispatch_write (GPollableOutputStream * stream,
     g_mutex_unlock (&watch->mutex);
 
     /* notify all messages that were successfully written */
-    if (ids) {
-      while (*ids) {
-        /* only decrease the counter for messages that have an id. Only
-         * the last message of a messages chunk is counted */
-        watch->messages_count--;
-
-        if (watch->funcs.message_sent)
-          watch->funcs.message_sent (watch, *ids, watch->user_data);
-        ids++;
-      }
+    for (i = 0; ids[i]; i++) {
+      /* only decrease the counter for messages that have an id. Only
+       * the last message of a messages chunk is counted */
+      watch->messages_count--;
+
+      if (watch->funcs.message_sent)
+        watch->funcs.message_sent (watch, ids[i], watch->user_data);
     }
 
     if (res == GST_RTSP_EINTR) {
@@ -4362,12 +4597,60 @@ gst_rtsp_watch_get_send_backlog (GstRTSPWatch * watch,
   g_mutex_unlock (&watch->mutex);
 }
 
+/**
+ * gst_rtsp_watch_get_backlog_stats:
+ * @watch: a #GstRTSPWatch
+ *
+ * Get statistics about the send backlog of @watch. The returned structure
+ * contains the following fields:
+ *
+ * * "bytes-in-flight" (#guint64): bytes queued and not written yet
+ * * "messages-in-flight" (#guint): messages queued and not written yet
+ * * "writes" (#guint64): number of writes done to flush the backlog. Queued
+ *   messages are coalesced, so this is usually lower than
+ *   "messages-written".
+ * * "bytes-written" (#guint64): bytes written from the backlog
+ * * "messages-written" (#guint64): messages completely written from the
+ *   backlog
+ * * "latency-mean" (#guint64): mean time in nanoseconds messages spent in
+ *   the backlog
+ * * "latency-max" (#guint64): maximum time in nanoseconds a message spent
+ *   in the backlog
+ *
+ * Returns: (transfer full): a #GstStructure with the statistics
+ *
+ * Since: 1.20
+ */
+GstStructure *
+gst_rtsp_watch_get_backlog_stats (GstRTSPWatch * watch)
+{
+  GstStructure *s;
+
+  g_return_val_if_fail (watch != NULL, NULL);
+
+  g_mutex_lock (&watch->mutex);
+  s = gst_structure_new ("application/x-rtsp-watch-stats",
+      "bytes-in-flight", G_TYPE_UINT64, (guint64) watch->messages_bytes,
+      "messages-in-flight", G_TYPE_UINT,
+      watch->messages ? gst_queue_array_get_length (watch->messages) : 0,
+      "writes", G_TYPE_UINT64, watch->stats_writes,
+      "bytes-written", G_TYPE_UINT64, watch->stats_bytes_written,
+      "messages-written", G_TYPE_UINT64, watch->stats_messages_written,
+      "latency-mean", G_TYPE_UINT64, watch->stats_messages_written ?
+      watch->stats_latency_total / watch->stats_messages_written : 0,
+      "latency-max", G_TYPE_UINT64, watch->stats_latency_max, NULL);
+  g_mutex_unlock (&watch->mutex);
+
+  return s;
+}
+
 static GstRTSPResult
 gst_rtsp_watch_write_serialized_messages (GstRTSPWatch * watch,
     GstRTSPSerializedMessage * messages, guint n_messages, guint * id)
 {
   GstRTSPResult res;
   GMainContext *context = NULL;
+  gint64 now;
   gint i;
 
   g_return_val_if_fail (watch != NULL, GST_RTSP_EINVAL);
@@ -4501,11 +4784,13 @@ gst_rtsp_watch_write_serialized_messages (GstRTSPWatch * watch,
   if (IS_BACKLOG_FULL (watch))
     goto too_much_backlog;
 
+  now = g_get_monotonic_time ();
   for (i = 0; i < n_messages; i++) {
     GstRTSPSerializedMessage local_message;
 
     /* make a record with the data and id for sending async */
     local_message = messages[i];
+    local_message.queued_time = now;
 
     /* copy the body data or take an additional reference to the body buffer
      * we don't own them here */
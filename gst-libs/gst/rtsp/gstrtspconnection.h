@@ -144,6 +144,11 @@ GST_RTSP_API
 GstRTSPResult      gst_rtsp_connection_receive_usec    (GstRTSPConnection *conn, GstRTSPMessage *message,
                                                        gint64 timeout);
 
+GST_RTSP_API
+GstRTSPResult      gst_rtsp_connection_receive_data_usec (GstRTSPConnection *conn, GstRTSPMessage *message,
+                                                         guint8 *channel, GstBuffer **buffer,
+                                                         gint64 timeout);
+
 /* status management */
 
 GST_RTSP_API
@@ -194,6 +199,12 @@ GST_RTSP_API
 void               gst_rtsp_connection_set_content_length_limit (GstRTSPConnection *conn,
                                                                  guint limit);
 
+/* interleaved data memory */
+GST_RTSP_API
+void               gst_rtsp_connection_set_data_allocator (GstRTSPConnection *conn,
+                                                           GstAllocator *allocator,
+                                                           const GstAllocationParams *params);
+
 /* accessors */
 
 GST_RTSP_API
@@ -262,6 +273,13 @@ typedef struct _GstRTSPWatch GstRTSPWatch;
  * @tunnel_http_response: callback when an HTTP response to the GET request
  *   is about to be sent for a tunneled connection. The response can be
  *   modified in the callback. Since: 1.4.
+ * @data_received: callback when interleaved data was received. When set,
+ *   interleaved data is read directly into a #GstBuffer from the allocator
+ *   configured with gst_rtsp_connection_set_data_allocator() and
+ *   @message_received is not called for it. The buffer is only valid during
+ *   the callback unless a reference is taken. When it returns anything
+ *   other than #GST_RTSP_OK, the result is reported with @error_full or
+ *   @error and the connection is closed. Since: 1.20.
  *
  * Callback functions from a #GstRTSPWatch.
  */
@@ -283,9 +301,11 @@ typedef struct {
                                              GstRTSPMessage *request,
                                              GstRTSPMessage *response,
                                              gpointer user_data);
+  GstRTSPResult     (*data_received)    (GstRTSPWatch *watch, guint8 channel,
+                                         GstBuffer *buffer, gpointer user_data);
 
   /*< private >*/
-  gpointer _gst_reserved[GST_PADDING-1];
+  gpointer _gst_reserved[GST_PADDING-2];
 } GstRTSPWatchFuncs;
 
 GST_RTSP_API
@@ -312,6 +332,9 @@ GST_RTSP_API
 void               gst_rtsp_watch_get_send_backlog  (GstRTSPWatch *watch,
                                                      gsize *bytes, guint *messages);
 
+GST_RTSP_API
+GstStructure *     gst_rtsp_watch_get_backlog_stats (GstRTSPWatch *watch);
+
 GST_RTSP_API
 GstRTSPResult      gst_rtsp_watch_write_data         (GstRTSPWatch *watch,
                                                       const guint8 *data,
@@ -59,13 +59,211 @@
 #include <gst/gstutils.h>
 #include "gstrtspmessage.h"
 
+typedef enum
+{
+  KEY_VALUE_VALUE_IN_ARENA = (1 << 0),
+  KEY_VALUE_KEY_IN_ARENA = (1 << 1)
+} RTSPKeyValueFlags;
+
 typedef struct _RTSPKeyValue
 {
   GstRTSPHeaderField field;
   gchar *value;
   gchar *custom_key;            /* custom header string (field is INVALID then) */
+  RTSPKeyValueFlags flags;      /* strings owned by the header store */
 } RTSPKeyValue;
 
+/* header fields with a direct index to their first occurrence */
+enum
+{
+  HEADER_INDEX_CSEQ,
+  HEADER_INDEX_SESSION,
+  HEADER_INDEX_TRANSPORT,
+  HEADER_INDEX_CONTENT_LENGTH,
+  HEADER_INDEX_LAST
+};
+
+/* size of the arena chunk allocated together with the header store, enough
+ * for the headers of typical requests and responses */
+#define HEADER_ARENA_CHUNK_SIZE 1024
+
+typedef struct _RTSPArenaChunk RTSPArenaChunk;
+
+struct _RTSPArenaChunk
+{
+  RTSPArenaChunk *next;
+  gsize size;
+  gsize used;
+  /* followed by size bytes of string data */
+};
+
+#define ARENA_CHUNK_DATA(c) ((gchar *) ((c) + 1))
+
+/* per message storage for header strings, they are only freed all at once
+ * when the message is unset. The first chunk is allocated with the store.
+ * Once a header was removed, new strings are allocated separately so that
+ * removing and adding headers repeatedly doesn't grow the arena without
+ * bounds. */
+typedef struct
+{
+  gint first[HEADER_INDEX_LAST];        /* position in hdr_fields or -1 */
+  gboolean removed;             /* a header was removed from the message */
+  RTSPArenaChunk *chunks;
+  RTSPArenaChunk chunk;
+} RTSPHeaderStore;
+
+static gint
+header_index (GstRTSPHeaderField field)
+{
+  switch (field) {
+    case GST_RTSP_HDR_CSEQ:
+      return HEADER_INDEX_CSEQ;
+    case GST_RTSP_HDR_SESSION:
+      return HEADER_INDEX_SESSION;
+    case GST_RTSP_HDR_TRANSPORT:
+      return HEADER_INDEX_TRANSPORT;
+    case GST_RTSP_HDR_CONTENT_LENGTH:
+      return HEADER_INDEX_CONTENT_LENGTH;
+    default:
+      return -1;
+  }
+}
+
+static RTSPHeaderStore *
+header_store_get (GstRTSPMessage * msg)
+{
+  RTSPHeaderStore *store = msg->hdr_store;
+  gint i;
+
+  if (G_LIKELY (store != NULL))
+    return store;
+
+  store = g_malloc (sizeof (RTSPHeaderStore) + HEADER_ARENA_CHUNK_SIZE);
+  for (i = 0; i < HEADER_INDEX_LAST; i++)
+    store->first[i] = -1;
+  store->removed = FALSE;
+  store->chunk.next = NULL;
+  store->chunk.size = HEADER_ARENA_CHUNK_SIZE;
+  store->chunk.used = 0;
+  store->chunks = &store->chunk;
+  msg->hdr_store = store;
+
+  return store;
+}
+
+static void
+header_store_free (GstRTSPMessage * msg)
+{
+  RTSPHeaderStore *store = msg->hdr_store;
+  RTSPArenaChunk *chunk, *next;
+
+  if (store == NULL)
+    return;
+
+  for (chunk = store->chunks; chunk != &store->chunk; chunk = next) {
+    next = chunk->next;
+    g_free (chunk);
+  }
+  g_free (store);
+  msg->hdr_store = NULL;
+}
+
+/* copies @str into the arena and sets @flag in @flags, or makes a separate
+ * copy after a header was removed */
+static gchar *
+header_store_strdup (GstRTSPMessage * msg, const gchar * str,
+    RTSPKeyValueFlags * flags, RTSPKeyValueFlags flag)
+{
+  RTSPHeaderStore *store = header_store_get (msg);
+  RTSPArenaChunk *chunk = store->chunks;
+  gsize len;
+  gchar *dest;
+
+  if (G_UNLIKELY (store->removed))
+    return g_strdup (str);
+
+  *flags |= flag;
+
+  len = strlen (str) + 1;
+  if (chunk->size - chunk->used < len) {
+    gsize size = MAX (len, HEADER_ARENA_CHUNK_SIZE);
+
+    chunk = g_malloc (sizeof (RTSPArenaChunk) + size);
+    chunk->next = store->chunks;
+    chunk->size = size;
+    chunk->used = 0;
+    store->chunks = chunk;
+  }
+
+  dest = ARENA_CHUNK_DATA (chunk) + chunk->used;
+  memcpy (dest, str, len);
+  chunk->used += len;
+
+  return dest;
+}
+
+/* recalculate the index after headers were removed */
+static void
+header_store_reindex (GstRTSPMessage * msg)
+{
+  RTSPHeaderStore *store = msg->hdr_store;
+  guint i;
+  gint idx;
+
+  if (store == NULL)
+    return;
+
+  /* the arena space of the removed strings is not reused */
+  store->removed = TRUE;
+
+  for (idx = 0; idx < HEADER_INDEX_LAST; idx++)
+    store->first[idx] = -1;
+
+  for (i = 0; i < msg->hdr_fields->len; i++) {
+    RTSPKeyValue *kv = &g_array_index (msg->hdr_fields, RTSPKeyValue, i);
+
+    idx = header_index (kv->field);
+    if (idx >= 0 && store->first[idx] < 0)
+      store->first[idx] = i;
+  }
+}
+
+/* position to start looking for @field, -1 if it is not in @msg */
+static gint
+header_store_lookup (const GstRTSPMessage * msg, GstRTSPHeaderField field)
+{
+  RTSPHeaderStore *store = msg->hdr_store;
+  gint idx;
+
+  idx = header_index (field);
+  if (idx < 0 || store == NULL)
+    return 0;
+
+  return store->first[idx];
+}
+
+static void
+key_value_clear (RTSPKeyValue * kv)
+{
+  if (!(kv->flags & KEY_VALUE_VALUE_IN_ARENA))
+    g_free (kv->value);
+  if (!(kv->flags & KEY_VALUE_KEY_IN_ARENA))
+    g_free (kv->custom_key);
+}
+
+static void
+key_value_add (GstRTSPMessage * msg, const RTSPKeyValue * kv)
+{
+  RTSPHeaderStore *store = header_store_get (msg);
+  gint idx;
+
+  idx = header_index (kv->field);
+  if (idx >= 0 && store->first[idx] < 0)
+    store->first[idx] = msg->hdr_fields->len;
+
+  g_array_append_vals (msg->hdr_fields, kv, 1);
+}
+
 static void
 key_value_foreach (GArray * array, GFunc func, gpointer user_data)
 {
@@ -79,17 +277,24 @@ key_value_foreach (GArray * array, GFunc func, gpointer user_data)
 }
 
 static void
-key_value_append (const RTSPKeyValue * kv, GArray * array)
+key_value_append (const RTSPKeyValue * kv, GstRTSPMessage * msg)
 {
   RTSPKeyValue kvcopy;
   g_return_if_fail (kv != NULL);
-  g_return_if_fail (array != NULL);
+  g_return_if_fail (msg != NULL);
 
   kvcopy.field = kv->field;
-  kvcopy.value = g_strdup (kv->value);
-  kvcopy.custom_key = g_strdup (kv->custom_key);
+  kvcopy.flags = 0;
+  kvcopy.value = header_store_strdup (msg, kv->value, &kvcopy.flags,
+      KEY_VALUE_VALUE_IN_ARENA);
+  if (kv->custom_key) {
+    kvcopy.custom_key = header_store_strdup (msg, kv->custom_key,
+        &kvcopy.flags, KEY_VALUE_KEY_IN_ARENA);
+  } else {
+    kvcopy.custom_key = NULL;
+  }
 
-  g_array_append_val (array, kvcopy);
+  key_value_add (msg, &kvcopy);
 }
 
 static GstRTSPMessage *
@@ -501,11 +706,11 @@ gst_rtsp_message_unset (GstRTSPMessage * msg)
     for (i = 0; i < msg->hdr_fields->len; i++) {
       RTSPKeyValue *keyval = &g_array_index (msg->hdr_fields, RTSPKeyValue, i);
 
-      g_free (keyval->value);
-      g_free (keyval->custom_key);
+      key_value_clear (keyval);
     }
     g_array_free (msg->hdr_fields, TRUE);
   }
+  header_store_free (msg);
   g_free (msg->body);
   gst_buffer_replace (&msg->body_buffer, NULL);
 
@@ -586,7 +791,7 @@ gst_rtsp_message_copy (const GstRTSPMessage * msg, GstRTSPMessage ** copy)
       return GST_RTSP_EINVAL;
   }
 
-  key_value_foreach (msg->hdr_fields, (GFunc) key_value_append, cp->hdr_fields);
+  key_value_foreach (msg->hdr_fields, (GFunc) key_value_append, cp);
   if (msg->body)
     gst_rtsp_message_set_body (cp, msg->body, msg->body_size);
   else
@@ -619,8 +824,9 @@ gst_rtsp_message_take_header (GstRTSPMessage * msg, GstRTSPHeaderField field,
   key_value.field = field;
   key_value.value = value;
   key_value.custom_key = NULL;
+  key_value.flags = 0;
 
-  g_array_append_val (msg->hdr_fields, key_value);
+  key_value_add (msg, &key_value);
 
   return GST_RTSP_OK;
 }
@@ -640,7 +846,23 @@ GstRTSPResult
 gst_rtsp_message_add_header (GstRTSPMessage * msg, GstRTSPHeaderField field,
     const gchar * value)
 {
-  return gst_rtsp_message_take_header (msg, field, g_strdup (value));
+  RTSPKeyValue key_value;
+
+  g_return_val_if_fail (msg != NULL, GST_RTSP_EINVAL);
+  g_return_val_if_fail (value != NULL, GST_RTSP_EINVAL);
+
+  /* the copy is made in the header store of the message, it is freed
+   * together with the other headers. After a removal it is a separate copy
+   * that is freed with the header */
+  key_value.field = field;
+  key_value.flags = 0;
+  key_value.value = header_store_strdup (msg, value, &key_value.flags,
+      KEY_VALUE_VALUE_IN_ARENA);
+  key_value.custom_key = NULL;
+
+  key_value_add (msg, &key_value);
+
+  return GST_RTSP_OK;
 }
 
 /**
@@ -668,7 +890,7 @@ gst_rtsp_message_remove_header (GstRTSPMessage * msg, GstRTSPHeaderField field,
     RTSPKeyValue *key_value = &g_array_index (msg->hdr_fields, RTSPKeyValue, i);
 
     if (key_value->field == field && (indx == -1 || cnt++ == indx)) {
-      g_free (key_value->value);
+      key_value_clear (key_value);
       g_array_remove_index (msg->hdr_fields, i);
       res = GST_RTSP_OK;
       if (indx != -1)
@@ -677,6 +899,9 @@ gst_rtsp_message_remove_header (GstRTSPMessage * msg, GstRTSPHeaderField field,
       i++;
     }
   }
+  if (res == GST_RTSP_OK)
+    header_store_reindex (msg);
+
   return res;
 }
 
@@ -697,6 +922,7 @@ GstRTSPResult
 gst_rtsp_message_get_header (const GstRTSPMessage * msg,
     GstRTSPHeaderField field, gchar ** value, gint indx)
 {
+  gint start;
   guint i;
   gint cnt = 0;
 
@@ -706,7 +932,12 @@ gst_rtsp_message_get_header (const GstRTSPMessage * msg,
   if (msg->hdr_fields == NULL)
     return GST_RTSP_ENOTIMPL;
 
-  for (i = 0; i < msg->hdr_fields->len; i++) {
+  /* common fields are indexed, start at their first occurrence */
+  start = header_store_lookup (msg, field);
+  if (start < 0)
+    return GST_RTSP_ENOTIMPL;
+
+  for (i = start; i < msg->hdr_fields->len; i++) {
     RTSPKeyValue *key_value = &g_array_index (msg->hdr_fields, RTSPKeyValue, i);
 
     if (key_value->field == field && cnt++ == indx) {
@@ -737,6 +968,7 @@ gst_rtsp_message_add_header_by_name (GstRTSPMessage * msg,
     const gchar * header, const gchar * value)
 {
   GstRTSPHeaderField field;
+  RTSPKeyValue key_value;
 
   g_return_val_if_fail (msg != NULL, GST_RTSP_EINVAL);
   g_return_val_if_fail (header != NULL, GST_RTSP_EINVAL);
@@ -744,9 +976,18 @@ gst_rtsp_message_add_header_by_name (GstRTSPMessage * msg,
 
   field = gst_rtsp_find_header_field (header);
   if (field != GST_RTSP_HDR_INVALID)
-    return gst_rtsp_message_take_header (msg, field, g_strdup (value));
+    return gst_rtsp_message_add_header (msg, field, value);
+
+  key_value.field = GST_RTSP_HDR_INVALID;
+  key_value.flags = 0;
+  key_value.value = header_store_strdup (msg, value, &key_value.flags,
+      KEY_VALUE_VALUE_IN_ARENA);
+  key_value.custom_key = header_store_strdup (msg, header, &key_value.flags,
+      KEY_VALUE_KEY_IN_ARENA);
+
+  key_value_add (msg, &key_value);
 
-  return gst_rtsp_message_take_header_by_name (msg, header, g_strdup (value));
+  return GST_RTSP_OK;
 }
 
 /**
@@ -774,9 +1015,11 @@ gst_rtsp_message_take_header_by_name (GstRTSPMessage * msg,
 
   key_value.field = GST_RTSP_HDR_INVALID;
   key_value.value = value;
-  key_value.custom_key = g_strdup (header);
+  key_value.flags = 0;
+  key_value.custom_key = header_store_strdup (msg, header, &key_value.flags,
+      KEY_VALUE_KEY_IN_ARENA);
 
-  g_array_append_val (msg->hdr_fields, key_value);
+  key_value_add (msg, &key_value);
 
   return GST_RTSP_OK;
 }
@@ -787,6 +1030,7 @@ gst_rtsp_message_find_header_by_name (GstRTSPMessage * msg,
     const gchar * header, gint index)
 {
   GstRTSPHeaderField field;
+  gint start;
   gint cnt = 0;
   guint i;
 
@@ -795,7 +1039,11 @@ gst_rtsp_message_find_header_by_name (GstRTSPMessage * msg,
     return -1;
 
   field = gst_rtsp_find_header_field (header);
-  for (i = 0; i < msg->hdr_fields->len; i++) {
+  start = header_store_lookup (msg, field);
+  if (start < 0)
+    return -1;
+
+  for (i = start; i < msg->hdr_fields->len; i++) {
     RTSPKeyValue *key_val;
 
     key_val = &g_array_index (msg->hdr_fields, RTSPKeyValue, i);
@@ -845,9 +1093,9 @@ gst_rtsp_message_remove_header_by_name (GstRTSPMessage * msg,
       break;
 
     kv = &g_array_index (msg->hdr_fields, RTSPKeyValue, pos);
-    g_free (kv->value);
-    g_free (kv->custom_key);
+    key_value_clear (kv);
     g_array_remove_index (msg->hdr_fields, pos);
+    header_store_reindex (msg);
     res = GST_RTSP_OK;
   } while (index < 0);
 
@@ -921,7 +1169,10 @@ gst_rtsp_message_append_headers (const GstRTSPMessage * msg, GString * str)
     else
       keystr = gst_rtsp_header_as_text (key_value->field);
 
-    g_string_append_printf (str, "%s: %s\r\n", keystr, key_value->value);
+    g_string_append (str, keystr);
+    g_string_append_len (str, ": ", 2);
+    g_string_append (str, key_value->value);
+    g_string_append_len (str, "\r\n", 2);
   }
   return GST_RTSP_OK;
 }
@@ -105,7 +105,8 @@ struct _GstRTSPMessage
   guint          body_size;
 
   GstBuffer     *body_buffer;
-  gpointer _gst_reserved[GST_PADDING-1];
+  gpointer       hdr_store;
+  gpointer _gst_reserved[GST_PADDING-2];
 };
 
 GST_RTSP_API
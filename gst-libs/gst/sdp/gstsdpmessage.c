@@ -482,6 +482,126 @@ gst_sdp_address_is_multicast (const gchar * nettype, const gchar * addrtype,
   return ret;
 }
 
+/* upper bound of the length of a %u */
+#define SDP_UINT_LEN 10
+/* "x=" and "\r\n" */
+#define SDP_LINE_LEN 4
+#define SDP_STRLEN(str) ((str) ? strlen (str) : 0)
+
+static gsize
+sdp_connection_text_size (const GstSDPConnection * conn)
+{
+  return SDP_STRLEN (conn->nettype) + SDP_STRLEN (conn->addrtype) +
+      SDP_STRLEN (conn->address) + 2 + 2 * (1 + SDP_UINT_LEN) + SDP_LINE_LEN;
+}
+
+static gsize
+sdp_bandwidths_text_size (GArray * bandwidths)
+{
+  gsize size = 0;
+  guint i;
+
+  for (i = 0; i < bandwidths->len; i++) {
+    const GstSDPBandwidth *bw = &g_array_index (bandwidths, GstSDPBandwidth, i);
+
+    size += SDP_STRLEN (bw->bwtype) + 1 + SDP_UINT_LEN + SDP_LINE_LEN;
+  }
+  return size;
+}
+
+static gsize
+sdp_key_text_size (const GstSDPKey * key)
+{
+  return SDP_STRLEN (key->type) + 1 + SDP_STRLEN (key->data) + SDP_LINE_LEN;
+}
+
+static gsize
+sdp_attributes_text_size (GArray * attributes)
+{
+  gsize size = 0;
+  guint i;
+
+  for (i = 0; i < attributes->len; i++) {
+    const GstSDPAttribute *attr =
+        &g_array_index (attributes, GstSDPAttribute, i);
+
+    size += SDP_STRLEN (attr->key) + 1 + SDP_STRLEN (attr->value) +
+        SDP_LINE_LEN;
+  }
+  return size;
+}
+
+/* an upper bound of the length of the text of @media, so that the string
+ * it is serialized into never has to grow */
+static gsize
+sdp_media_text_size (const GstSDPMedia * media)
+{
+  gsize size;
+  guint i;
+
+  size = SDP_STRLEN (media->media) + 2 * (1 + SDP_UINT_LEN) + 1 +
+      SDP_STRLEN (media->proto) + SDP_LINE_LEN;
+  for (i = 0; i < media->fmts->len; i++)
+    size += 1 + strlen (g_array_index (media->fmts, gchar *, i));
+  size += SDP_STRLEN (media->information) + SDP_LINE_LEN;
+  for (i = 0; i < media->connections->len; i++)
+    size += sdp_connection_text_size (&g_array_index (media->connections,
+            GstSDPConnection, i));
+  size += sdp_bandwidths_text_size (media->bandwidths);
+  size += sdp_key_text_size (&media->key);
+  size += sdp_attributes_text_size (media->attributes);
+
+  return size;
+}
+
+static gsize
+sdp_message_text_size (const GstSDPMessage * msg)
+{
+  gsize size;
+  guint i, j;
+
+  size = SDP_STRLEN (msg->version) + SDP_LINE_LEN;
+  size += SDP_STRLEN (msg->origin.username) + SDP_STRLEN (msg->origin.sess_id)
+      + SDP_STRLEN (msg->origin.sess_version) +
+      SDP_STRLEN (msg->origin.nettype) + SDP_STRLEN (msg->origin.addrtype) +
+      SDP_STRLEN (msg->origin.addr) + 6 + SDP_LINE_LEN;
+  size += SDP_STRLEN (msg->session_name) + SDP_LINE_LEN;
+  size += SDP_STRLEN (msg->information) + SDP_LINE_LEN;
+  size += SDP_STRLEN (msg->uri) + SDP_LINE_LEN;
+  for (i = 0; i < msg->emails->len; i++)
+    size += strlen (g_array_index (msg->emails, gchar *, i)) + SDP_LINE_LEN;
+  for (i = 0; i < msg->phones->len; i++)
+    size += strlen (g_array_index (msg->phones, gchar *, i)) + SDP_LINE_LEN;
+  size += sdp_connection_text_size (&msg->connection);
+  size += sdp_bandwidths_text_size (msg->bandwidths);
+  /* "t=0 0" when there are no times */
+  size += 3 + SDP_LINE_LEN;
+  for (i = 0; i < msg->times->len; i++) {
+    const GstSDPTime *t = &g_array_index (msg->times, GstSDPTime, i);
+
+    size += SDP_STRLEN (t->start) + 1 + SDP_STRLEN (t->stop) + SDP_LINE_LEN;
+    if (t->repeat != NULL) {
+      size += SDP_LINE_LEN;
+      for (j = 0; j < t->repeat->len; j++)
+        size += 1 + strlen (g_array_index (t->repeat, gchar *, j));
+    }
+  }
+  size += SDP_LINE_LEN;
+  for (i = 0; i < msg->zones->len; i++) {
+    const GstSDPZone *zone = &g_array_index (msg->zones, GstSDPZone, i);
+
+    size += SDP_STRLEN (zone->time) + SDP_STRLEN (zone->typed_time) + 2;
+  }
+  size += sdp_key_text_size (&msg->key);
+  size += sdp_attributes_text_size (msg->attributes);
+  for (i = 0; i < msg->medias->len; i++)
+    size += sdp_media_text_size (&g_array_index (msg->medias, GstSDPMedia, i));
+
+  return size;
+}
+
+static void sdp_media_append_text (const GstSDPMedia * media, GString * lines);
+
 /**
  * gst_sdp_message_as_text:
  * @msg: a #GstSDPMessage
@@ -499,7 +619,7 @@ gst_sdp_message_as_text (const GstSDPMessage * msg)
 
   g_return_val_if_fail (msg != NULL, NULL);
 
-  lines = g_string_new ("");
+  lines = g_string_sized_new (sdp_message_text_size (msg));
 
   if (msg->version)
     g_string_append_printf (lines, "v=%s\r\n", msg->version);
@@ -600,14 +720,8 @@ gst_sdp_message_as_text (const GstSDPMessage * msg)
     }
   }
 
-  for (i = 0; i < gst_sdp_message_medias_len (msg); i++) {
-    const GstSDPMedia *media = gst_sdp_message_get_media (msg, i);
-    gchar *sdp_media_str;
-
-    sdp_media_str = gst_sdp_media_as_text (media);
-    g_string_append_printf (lines, "%s", sdp_media_str);
-    g_free (sdp_media_str);
-  }
+  for (i = 0; i < gst_sdp_message_medias_len (msg); i++)
+    sdp_media_append_text (gst_sdp_message_get_media (msg, i), lines);
 
   return g_string_free (lines, FALSE);
 }
@@ -1971,11 +2085,19 @@ gchar *
 gst_sdp_media_as_text (const GstSDPMedia * media)
 {
   GString *lines;
-  guint i;
 
   g_return_val_if_fail (media != NULL, NULL);
 
-  lines = g_string_new ("");
+  lines = g_string_sized_new (sdp_media_text_size (media));
+  sdp_media_append_text (media, lines);
+
+  return g_string_free (lines, FALSE);
+}
+
+static void
+sdp_media_append_text (const GstSDPMedia * media, GString * lines)
+{
+  guint i;
 
   if (media->media)
     g_string_append_printf (lines, "m=%s", media->media);
@@ -2036,8 +2158,6 @@ gst_sdp_media_as_text (const GstSDPMedia * media)
       g_string_append_printf (lines, "\r\n");
     }
   }
-
-  return g_string_free (lines, FALSE);
 }
 
 /**
@@ -3213,6 +3333,404 @@ out:
   return GST_SDP_OK;
 }
 
+typedef struct
+{
+  guint32 offset;               /* start of the value in the text */
+  guint32 len;                  /* length of the value */
+  guint32 key_len;              /* a= lines: length of the key */
+  guint32 next;                 /* a= lines: index + 1 of the next line with
+                                 * the same key, 0 if none */
+  gchar type;
+} SDPLazyLine;
+
+typedef struct
+{
+  guint first;
+  guint n_lines;
+  /* open addressing table with the index + 1 of the first line of each
+   * attribute key, 0 for empty slots */
+  guint32 *attr_index;
+  guint attr_mask;
+} SDPLazySection;
+
+struct _GstSDPLazyMessage
+{
+  GBytes *text;
+  const gchar *data;
+  GArray *lines;
+  /* the session, followed by the medias */
+  GArray *sections;
+  /* attribute values materialized as strings, per line */
+  gchar **values;
+};
+
+static guint
+sdp_lazy_key_hash (const gchar * key, gsize len)
+{
+  guint hash = 2166136261U;
+
+  while (len--) {
+    hash ^= (guchar) * key++;
+    hash *= 16777619U;
+  }
+  return hash;
+}
+
+/* returns the slot of @key in the attribute index of @section, which is
+ * either empty or has the first line with @key */
+static guint32 *
+sdp_lazy_find_slot (const GstSDPLazyMessage * msg,
+    const SDPLazySection * section, const gchar * key, gsize len)
+{
+  guint i;
+
+  if (section->attr_index == NULL)
+    return NULL;
+
+  i = sdp_lazy_key_hash (key, len) & section->attr_mask;
+  while (section->attr_index[i] != 0) {
+    const SDPLazyLine *line = &g_array_index (msg->lines, SDPLazyLine,
+        section->attr_index[i] - 1);
+
+    if (line->key_len == len && memcmp (msg->data + line->offset, key,
+            len) == 0)
+      break;
+    i = (i + 1) & section->attr_mask;
+  }
+  return &section->attr_index[i];
+}
+
+static void
+sdp_lazy_index_section (GstSDPLazyMessage * msg, SDPLazySection * section)
+{
+  guint i, n_attrs = 0, size = 8;
+
+  for (i = 0; i < section->n_lines; i++) {
+    if (g_array_index (msg->lines, SDPLazyLine, section->first + i).type ==
+        'a')
+      n_attrs++;
+  }
+  if (n_attrs == 0)
+    return;
+
+  /* keep the table at most half full */
+  while (size < n_attrs * 2)
+    size <<= 1;
+  section->attr_index = g_new0 (guint32, size);
+  section->attr_mask = size - 1;
+
+  /* walk backwards so that prepending to the chains keeps them in order */
+  for (i = section->n_lines; i > 0; i--) {
+    guint idx = section->first + i - 1;
+    SDPLazyLine *line = &g_array_index (msg->lines, SDPLazyLine, idx);
+    guint32 *slot;
+
+    if (line->type != 'a')
+      continue;
+
+    slot = sdp_lazy_find_slot (msg, section, msg->data + line->offset,
+        line->key_len);
+    line->next = *slot;
+    *slot = idx + 1;
+  }
+}
+
+/**
+ * gst_sdp_lazy_message_new_from_bytes:
+ * @text: the SDP text
+ * @msg: (out) (transfer full): pointer to new #GstSDPLazyMessage
+ *
+ * Parse @text into a new #GstSDPLazyMessage. The text is scanned once and
+ * only the position of the lines is recorded; a reference to @text is kept
+ * and nothing is copied until a value is requested with
+ * gst_sdp_lazy_message_get_attribute_val(). The attributes of the session
+ * and of each media are indexed by key.
+ *
+ * Lines are split the same way as gst_sdp_message_parse_buffer() does.
+ *
+ * Returns: a #GstSDPResult.
+ *
+ * Since: 1.20
+ */
+GstSDPResult
+gst_sdp_lazy_message_new_from_bytes (GBytes * text, GstSDPLazyMessage ** msg)
+{
+  GstSDPLazyMessage *lazy;
+  SDPLazySection section = { 0, };
+  SDPLazyLine line = { 0, };
+  const gchar *data, *end, *p, *s, *colon;
+  gsize size;
+  guint i;
+
+  g_return_val_if_fail (text != NULL, GST_SDP_EINVAL);
+  g_return_val_if_fail (msg != NULL, GST_SDP_EINVAL);
+
+  data = g_bytes_get_data (text, &size);
+  if (size > G_MAXUINT32)
+    return GST_SDP_EINVAL;
+
+  lazy = g_new0 (GstSDPLazyMessage, 1);
+  lazy->text = g_bytes_ref (text);
+  lazy->data = data;
+  /* guess the number of lines from the size */
+  lazy->lines = g_array_sized_new (FALSE, FALSE, sizeof (SDPLazyLine),
+      size / 32 + 1);
+  lazy->sections = g_array_new (FALSE, FALSE, sizeof (SDPLazySection));
+
+  p = data;
+  end = data + size;
+  while (p < end) {
+    while (p < end && g_ascii_isspace (*p))
+      p++;
+    if (p >= end || *p == '\0')
+      break;
+
+    line.type = *p++;
+    if (p < end && *p == '=') {
+      s = ++p;
+      while (p < end && *p != '\n' && *p != '\r' && *p != '\0')
+        p++;
+
+      if (line.type == 'm') {
+        section.n_lines = lazy->lines->len - section.first;
+        g_array_append_val (lazy->sections, section);
+        section.first = lazy->lines->len;
+      }
+
+      line.offset = s - data;
+      line.len = p - s;
+      line.key_len = line.len;
+      if (line.type == 'a' && (colon = memchr (s, ':', line.len)))
+        line.key_len = colon - s;
+      g_array_append_val (lazy->lines, line);
+    }
+
+    while (p < end && *p != '\n' && *p != '\0')
+      p++;
+    if (p < end && *p == '\n')
+      p++;
+  }
+  section.n_lines = lazy->lines->len - section.first;
+  g_array_append_val (lazy->sections, section);
+
+  for (i = 0; i < lazy->sections->len; i++)
+    sdp_lazy_index_section (lazy, &g_array_index (lazy->sections,
+            SDPLazySection, i));
+
+  *msg = lazy;
+
+  return GST_SDP_OK;
+}
+
+/**
+ * gst_sdp_lazy_message_free:
+ * @msg: a #GstSDPLazyMessage
+ *
+ * Free @msg, the strings returned from it and its reference to the text.
+ *
+ * Since: 1.20
+ */
+void
+gst_sdp_lazy_message_free (GstSDPLazyMessage * msg)
+{
+  guint i;
+
+  g_return_if_fail (msg != NULL);
+
+  for (i = 0; i < msg->sections->len; i++)
+    g_free (g_array_index (msg->sections, SDPLazySection, i).attr_index);
+  if (msg->values) {
+    for (i = 0; i < msg->lines->len; i++)
+      g_free (msg->values[i]);
+    g_free (msg->values);
+  }
+  g_array_free (msg->sections, TRUE);
+  g_array_free (msg->lines, TRUE);
+  g_bytes_unref (msg->text);
+  g_free (msg);
+}
+
+/**
+ * gst_sdp_lazy_message_medias_len:
+ * @msg: a #GstSDPLazyMessage
+ *
+ * Get the number of media descriptions in @msg.
+ *
+ * Returns: the number of media descriptions.
+ *
+ * Since: 1.20
+ */
+guint
+gst_sdp_lazy_message_medias_len (const GstSDPLazyMessage * msg)
+{
+  g_return_val_if_fail (msg != NULL, 0);
+
+  return msg->sections->len - 1;
+}
+
+static const SDPLazySection *
+sdp_lazy_get_section (const GstSDPLazyMessage * msg, gint media)
+{
+  if (media < -1 || media + 1 >= (gint) msg->sections->len)
+    return NULL;
+
+  return &g_array_index (msg->sections, SDPLazySection, media + 1);
+}
+
+/**
+ * gst_sdp_lazy_message_peek_line:
+ * @msg: a #GstSDPLazyMessage
+ * @media: the media index, or -1 for the session
+ * @type: the line type, for example 'c' or 'm'
+ * @nth: the nth line of @type to get
+ * @len: (out): the length of the value
+ *
+ * Get the value of the @nth line of @type of @media without copying it. The
+ * value is everything after the '=' and is not nul-terminated. The 'm' line
+ * of a media is its first line.
+ *
+ * Returns: (nullable) (transfer none): a pointer into the text of @msg or
+ * %NULL when there is no such line.
+ *
+ * Since: 1.20
+ */
+const gchar *
+gst_sdp_lazy_message_peek_line (const GstSDPLazyMessage * msg, gint media,
+    gchar type, guint nth, gsize * len)
+{
+  const SDPLazySection *section;
+  guint i;
+
+  g_return_val_if_fail (msg != NULL, NULL);
+  g_return_val_if_fail (len != NULL, NULL);
+
+  if (!(section = sdp_lazy_get_section (msg, media)))
+    return NULL;
+
+  for (i = 0; i < section->n_lines; i++) {
+    const SDPLazyLine *line = &g_array_index (msg->lines, SDPLazyLine,
+        section->first + i);
+
+    if (line->type == type && nth-- == 0) {
+      *len = line->len;
+      return msg->data + line->offset;
+    }
+  }
+  return NULL;
+}
+
+static gint
+sdp_lazy_find_attribute (const GstSDPLazyMessage * msg, gint media,
+    const gchar * key, guint nth)
+{
+  const SDPLazySection *section;
+  guint32 *slot;
+  guint32 idx;
+
+  if (!(section = sdp_lazy_get_section (msg, media)))
+    return -1;
+  if (!(slot = sdp_lazy_find_slot (msg, section, key, strlen (key))))
+    return -1;
+
+  idx = *slot;
+  while (idx != 0 && nth-- > 0)
+    idx = g_array_index (msg->lines, SDPLazyLine, idx - 1).next;
+
+  return (gint) idx - 1;
+}
+
+static void
+sdp_lazy_attribute_value (const GstSDPLazyMessage * msg, guint idx,
+    const gchar ** value, gsize * len)
+{
+  const SDPLazyLine *line = &g_array_index (msg->lines, SDPLazyLine, idx);
+
+  if (line->key_len < line->len) {
+    *value = msg->data + line->offset + line->key_len + 1;
+    *len = line->len - line->key_len - 1;
+  } else {
+    *value = msg->data + line->offset + line->len;
+    *len = 0;
+  }
+}
+
+/**
+ * gst_sdp_lazy_message_peek_attribute:
+ * @msg: a #GstSDPLazyMessage
+ * @media: the media index, or -1 for the session
+ * @key: the key
+ * @nth: the nth attribute with @key
+ * @value: (out) (transfer none): the value
+ * @len: (out): the length of @value
+ *
+ * Look up the @nth attribute with @key of @media without copying its value.
+ * @value is not nul-terminated and has a length of 0 for attributes without
+ * a value.
+ *
+ * Returns: %TRUE when the attribute was found.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_sdp_lazy_message_peek_attribute (const GstSDPLazyMessage * msg,
+    gint media, const gchar * key, guint nth, const gchar ** value,
+    gsize * len)
+{
+  gint idx;
+
+  g_return_val_if_fail (msg != NULL, FALSE);
+  g_return_val_if_fail (key != NULL, FALSE);
+  g_return_val_if_fail (value != NULL, FALSE);
+  g_return_val_if_fail (len != NULL, FALSE);
+
+  if ((idx = sdp_lazy_find_attribute (msg, media, key, nth)) < 0)
+    return FALSE;
+
+  sdp_lazy_attribute_value (msg, idx, value, len);
+
+  return TRUE;
+}
+
+/**
+ * gst_sdp_lazy_message_get_attribute_val:
+ * @msg: a #GstSDPLazyMessage
+ * @media: the media index, or -1 for the session
+ * @key: the key
+ * @nth: the nth attribute with @key
+ *
+ * Get the value of the @nth attribute with @key of @media as a string. The
+ * string is created the first time it is requested and stays valid until
+ * @msg is freed.
+ *
+ * Returns: (nullable): the value of the attribute or %NULL when there is no
+ * such attribute.
+ *
+ * Since: 1.20
+ */
+const gchar *
+gst_sdp_lazy_message_get_attribute_val (GstSDPLazyMessage * msg, gint media,
+    const gchar * key, guint nth)
+{
+  const gchar *value;
+  gsize len;
+  gint idx;
+
+  g_return_val_if_fail (msg != NULL, NULL);
+  g_return_val_if_fail (key != NULL, NULL);
+
+  if ((idx = sdp_lazy_find_attribute (msg, media, key, nth)) < 0)
+    return NULL;
+
+  if (msg->values == NULL)
+    msg->values = g_new0 (gchar *, msg->lines->len);
+
+  if (msg->values[idx] == NULL) {
+    sdp_lazy_attribute_value (msg, idx, &value, &len);
+    msg->values[idx] = g_strndup (value, len);
+  }
+  return msg->values[idx];
+}
+
 static void
 print_media (GstSDPMedia * media)
 {
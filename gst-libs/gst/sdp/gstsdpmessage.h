@@ -755,7 +755,40 @@ GstSDPResult            gst_sdp_message_attributes_to_caps  (const GstSDPMessage
 GST_SDP_API
 GstSDPResult            gst_sdp_media_attributes_to_caps    (const GstSDPMedia *media, GstCaps *caps);
 
+/**
+ * GstSDPLazyMessage:
+ *
+ * An opaque SDP message that keeps a reference to its source text and only
+ * records where the lines are. See gst_sdp_lazy_message_new_from_bytes().
+ *
+ * Since: 1.20
+ */
+typedef struct _GstSDPLazyMessage GstSDPLazyMessage;
+
+GST_SDP_API
+GstSDPResult            gst_sdp_lazy_message_new_from_bytes (GBytes *text, GstSDPLazyMessage **msg);
+
+GST_SDP_API
+void                    gst_sdp_lazy_message_free           (GstSDPLazyMessage *msg);
+
+GST_SDP_API
+guint                   gst_sdp_lazy_message_medias_len     (const GstSDPLazyMessage *msg);
+
+GST_SDP_API
+const gchar *           gst_sdp_lazy_message_peek_line      (const GstSDPLazyMessage *msg, gint media,
+                                                             gchar type, guint nth, gsize *len);
+
+GST_SDP_API
+gboolean                gst_sdp_lazy_message_peek_attribute (const GstSDPLazyMessage *msg, gint media,
+                                                             const gchar *key, guint nth,
+                                                             const gchar **value, gsize *len);
+
+GST_SDP_API
+const gchar *           gst_sdp_lazy_message_get_attribute_val (GstSDPLazyMessage *msg, gint media,
+                                                                const gchar *key, guint nth);
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstSDPMessage, gst_sdp_message_free)
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstSDPLazyMessage, gst_sdp_lazy_message_free)
 
 G_END_DECLS
 
@@ -23,6 +23,12 @@
 #include "gst/video/gstvideometa.h"
 #include "gst/video/gstvideopool.h"
 
+#ifdef HAVE_MMAP
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#endif
+
 
 GST_DEBUG_CATEGORY_STATIC (gst_video_pool_debug);
 #define GST_CAT_DEFAULT gst_video_pool_debug
@@ -38,6 +44,13 @@ GST_DEBUG_CATEGORY_STATIC (gst_video_pool_debug);
  * Allows configuration of video-specific requirements such as
  * stride alignments or pixel padding, and can also be configured
  * to automatically add #GstVideoMeta to the buffers.
+ *
+ * With #GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES large frames are backed by
+ * huge pages, which reduces the TLB misses of elements processing the whole
+ * frame. Explicit huge pages (MAP_HUGETLB) are used when the system has
+ * some reserved, transparent huge pages otherwise. The frames are faulted
+ * in when they are allocated, which happens when the pool is activated for
+ * the minimum amount of buffers.
  */
 
 /**
@@ -95,6 +108,9 @@ gst_buffer_pool_config_get_video_alignment (GstStructure * config,
 }
 
 /* bufferpool */
+#define DEFAULT_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+#define CACHE_LINE_ALIGN 63
+
 struct _GstVideoBufferPoolPrivate
 {
   GstVideoInfo info;
@@ -103,10 +119,48 @@ struct _GstVideoBufferPoolPrivate
   gboolean need_alignment;
   GstAllocator *allocator;
   GstAllocationParams params;
+
+  gboolean huge_pages;
+  gsize huge_page_size;
+  gint hugetlb_failed;
 };
 
 static void gst_video_buffer_pool_finalize (GObject * object);
 
+#ifdef HAVE_MMAP
+/* Returns the size of the huge pages backing PMD mappings, which both
+ * transparent huge pages and our MAP_HUGETLB mappings use */
+static gsize
+video_buffer_pool_get_huge_page_size (void)
+{
+  static gsize huge_page_size = 0;
+
+  if (g_once_init_enter (&huge_page_size)) {
+    gchar *contents = NULL, *line;
+    guint64 size = 0;
+
+    if (g_file_get_contents ("/sys/kernel/mm/transparent_hugepage/"
+            "hpage_pmd_size", &contents, NULL, NULL)) {
+      size = g_ascii_strtoull (contents, NULL, 10);
+    } else if (g_file_get_contents ("/proc/meminfo", &contents, NULL, NULL)
+        && (line = strstr (contents, "Hugepagesize:"))) {
+      size = g_ascii_strtoull (line + strlen ("Hugepagesize:"), NULL, 10);
+      size *= 1024;
+    }
+    g_free (contents);
+
+    /* must be a power of two for the alignment calculations */
+    if (size == 0 || (size & (size - 1)) || size > G_MAXSIZE / 4)
+      size = DEFAULT_HUGE_PAGE_SIZE;
+
+    GST_DEBUG ("huge page size %" G_GUINT64_FORMAT, size);
+    g_once_init_leave (&huge_page_size, size);
+  }
+
+  return huge_page_size;
+}
+#endif
+
 #define gst_video_buffer_pool_parent_class parent_class
 G_DEFINE_TYPE_WITH_PRIVATE (GstVideoBufferPool, gst_video_buffer_pool,
     GST_TYPE_BUFFER_POOL);
@@ -115,7 +169,8 @@ static const gchar **
 video_buffer_pool_get_options (GstBufferPool * pool)
 {
   static const gchar *options[] = { GST_BUFFER_POOL_OPTION_VIDEO_META,
-    GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT, NULL
+    GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT,
+    GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES, NULL
   };
   return options;
 }
@@ -169,16 +224,42 @@ video_buffer_pool_set_config (GstBufferPool * pool, GstStructure * config)
   priv->need_alignment = gst_buffer_pool_config_has_option (config,
       GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT);
 
-  if (priv->need_alignment && priv->add_videometa) {
+  /* huge pages only make sense for our own system memory and for frames
+   * that fill most of a huge page */
+  priv->huge_pages = FALSE;
+#ifdef HAVE_MMAP
+  if (gst_buffer_pool_config_has_option (config,
+          GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES)) {
+    priv->huge_page_size = video_buffer_pool_get_huge_page_size ();
+
+    if (allocator && g_strcmp0 (allocator->mem_type, GST_ALLOCATOR_SYSMEM))
+      GST_INFO_OBJECT (pool, "not using huge pages with allocator %"
+          GST_PTR_FORMAT, allocator);
+    else if (info.size < priv->huge_page_size / 2)
+      GST_INFO_OBJECT (pool, "not using huge pages for frames of %"
+          G_GSIZE_FORMAT " bytes", info.size);
+    else
+      priv->huge_pages = TRUE;
+  }
+#endif
+
+  if ((priv->need_alignment || priv->huge_pages) && priv->add_videometa) {
     guint max_align, n;
 
-    gst_buffer_pool_config_get_video_alignment (config, &priv->video_align);
+    if (priv->need_alignment)
+      gst_buffer_pool_config_get_video_alignment (config, &priv->video_align);
+    else
+      gst_video_alignment_reset (&priv->video_align);
 
     /* ensure GstAllocationParams alignment is compatible with video alignment */
     max_align = priv->params.align;
     for (n = 0; n < GST_VIDEO_MAX_PLANES; ++n)
       max_align |= priv->video_align.stride_align[n];
 
+    /* start all lines and planes on a cache line */
+    if (priv->huge_pages)
+      max_align |= CACHE_LINE_ALIGN;
+
     for (n = 0; n < GST_VIDEO_MAX_PLANES; ++n)
       priv->video_align.stride_align[n] = max_align;
 
@@ -235,6 +316,128 @@ failed_to_align:
   }
 }
 
+#ifdef HAVE_MMAP
+typedef struct
+{
+  gpointer data;
+  gsize size;
+} HugePageRegion;
+
+static void
+huge_page_region_free (HugePageRegion * region)
+{
+  munmap (region->data, region->size);
+  g_slice_free (HugePageRegion, region);
+}
+
+/* Maps @size bytes, a multiple of the huge page size, of anonymous memory
+ * starting on a huge page boundary */
+static guint8 *
+video_buffer_pool_map_huge_pages (GstVideoBufferPool * vpool, gsize size)
+{
+  GstVideoBufferPoolPrivate *priv = vpool->priv;
+  gsize huge_page_size = priv->huge_page_size;
+  guint8 *data, *aligned;
+  gsize head;
+
+#ifdef MAP_HUGETLB
+  if (!g_atomic_int_get (&priv->hugetlb_failed)) {
+    gint flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+
+#ifdef MAP_HUGE_SHIFT
+    /* ask for the PMD size explicitly, the default hugetlb size can be
+     * configured to something else */
+    flags |= g_bit_nth_lsf (huge_page_size, -1) << MAP_HUGE_SHIFT;
+#endif
+
+    data = mmap (NULL, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (data != MAP_FAILED)
+      return data;
+
+    GST_INFO_OBJECT (vpool, "no hugetlb pages (%s), using transparent huge "
+        "pages", g_strerror (errno));
+    g_atomic_int_set (&priv->hugetlb_failed, TRUE);
+  }
+#endif
+
+  /* map an extra huge page so that the mapping can be aligned */
+  data = mmap (NULL, size + huge_page_size, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (data == MAP_FAILED) {
+    GST_WARNING_OBJECT (vpool, "mmap failed: %s", g_strerror (errno));
+    return NULL;
+  }
+
+  aligned = (guint8 *) (((guintptr) data + huge_page_size - 1) &
+      ~((guintptr) huge_page_size - 1));
+  head = aligned - data;
+  if (head)
+    munmap (data, head);
+  munmap (aligned + size, huge_page_size - head);
+
+#ifdef MADV_HUGEPAGE
+  if (madvise (aligned, size, MADV_HUGEPAGE) < 0)
+    GST_DEBUG_OBJECT (vpool, "no transparent huge pages: %s",
+        g_strerror (errno));
+#endif
+
+  return aligned;
+}
+
+/* Faults in all pages of @data so that the first frame doesn't take the
+ * page faults */
+static void
+video_buffer_pool_prefault (guint8 * data, gsize size)
+{
+  gsize i;
+
+#ifdef MADV_POPULATE_WRITE
+  if (madvise (data, size, MADV_POPULATE_WRITE) == 0)
+    return;
+#endif
+
+  for (i = 0; i < size; i += 4096)
+    data[i] = 0;
+}
+
+static GstBuffer *
+video_buffer_pool_alloc_huge_pages (GstVideoBufferPool * vpool)
+{
+  GstVideoBufferPoolPrivate *priv = vpool->priv;
+  gsize align = priv->params.align;
+  gsize offset, size;
+  HugePageRegion *region;
+  GstBuffer *buffer;
+  GstMemory *mem;
+  guint8 *data;
+
+  /* the mapping is huge page aligned, keep the frame start aligned too */
+  offset = (priv->params.prefix + align) & ~align;
+  size = offset + priv->info.size + priv->params.padding;
+  size = (size + priv->huge_page_size - 1) &
+      ~((gsize) priv->huge_page_size - 1);
+
+  data = video_buffer_pool_map_huge_pages (vpool, size);
+  if (data == NULL)
+    return NULL;
+
+  video_buffer_pool_prefault (data, size);
+
+  region = g_slice_new (HugePageRegion);
+  region->data = data;
+  region->size = size;
+
+  /* anonymous memory is zero filled */
+  mem = gst_memory_new_wrapped (priv->params.flags, data, size, offset,
+      priv->info.size, region, (GDestroyNotify) huge_page_region_free);
+
+  buffer = gst_buffer_new ();
+  gst_buffer_append_memory (buffer, mem);
+
+  return buffer;
+}
+#endif
+
 static GstFlowReturn
 video_buffer_pool_alloc (GstBufferPool * pool, GstBuffer ** buffer,
     GstBufferPoolAcquireParams * params)
@@ -247,8 +450,14 @@ video_buffer_pool_alloc (GstBufferPool * pool, GstBuffer ** buffer,
 
   GST_DEBUG_OBJECT (pool, "alloc %" G_GSIZE_FORMAT, info->size);
 
-  *buffer =
-      gst_buffer_new_allocate (priv->allocator, info->size, &priv->params);
+  *buffer = NULL;
+#ifdef HAVE_MMAP
+  if (priv->huge_pages)
+    *buffer = video_buffer_pool_alloc_huge_pages (vpool);
+#endif
+  if (*buffer == NULL)
+    *buffer =
+        gst_buffer_new_allocate (priv->allocator, info->size, &priv->params);
   if (*buffer == NULL)
     goto no_memory;
 
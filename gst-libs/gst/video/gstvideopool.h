@@ -45,6 +45,21 @@ G_BEGIN_DECLS
  */
 #define GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT "GstBufferPoolOptionVideoAlignment"
 
+/**
+ * GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES:
+ *
+ * A bufferpool option to back the video frames with huge pages. The memory
+ * of frames of at least half a huge page is faulted in when it is allocated
+ * and, when #GST_BUFFER_POOL_OPTION_VIDEO_META is also enabled, the strides
+ * and plane offsets are aligned to cache lines.
+ *
+ * The option is ignored when the pool is configured with an allocator
+ * other than the system memory allocator.
+ *
+ * Since: 1.20
+ */
+#define GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES "GstBufferPoolOptionVideoHugePages"
+
 /* setting a bufferpool config */
 
 GST_VIDEO_API
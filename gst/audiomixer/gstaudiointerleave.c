@@ -347,61 +347,118 @@ gst_audio_interleave_get_channel_mask (GstAudioInterleave * self)
 }
 
 
-#define MAKE_FUNC(type) \
-static void interleave_##type (guint##type *out, guint##type *in, \
-    guint stride, guint nframes) \
-{ \
-  gint i; \
-  \
-  for (i = 0; i < nframes; i++) { \
-    *out = in[i]; \
-    out += stride; \
-  } \
-}
+typedef struct
+{
+  GstBuffer *inbuf;
+  gsize in_offset;              /* in bytes */
+  guint out_offset;             /* in frames */
+  guint num_frames;
+  gint channel;
+  GstMapInfo inmap;
+} GstAudioInterleavePending;
+
+static gint
+compare_pending (gconstpointer a, gconstpointer b)
+{
+  const GstAudioInterleavePending *pa = a, *pb = b;
+
+  if (pa->out_offset != pb->out_offset)
+    return pa->out_offset < pb->out_offset ? -1 : 1;
+  if (pa->num_frames != pb->num_frames)
+    return pa->num_frames < pb->num_frames ? -1 : 1;
 
-MAKE_FUNC (8);
-MAKE_FUNC (16);
-MAKE_FUNC (32);
-MAKE_FUNC (64);
+  return pa->channel - pb->channel;
+}
 
+/* with object lock */
 static void
-interleave_24 (guint8 * out, guint8 * in, guint stride, guint nframes)
+gst_audio_interleave_clear_pending (GstAudioInterleave * self)
 {
-  gint i;
+  guint i;
+
+  for (i = 0; i < self->pending->len; i++) {
+    GstAudioInterleavePending *p =
+        &g_array_index (self->pending, GstAudioInterleavePending, i);
 
-  for (i = 0; i < nframes; i++) {
-    memcpy (out, in, 3);
-    out += stride * 3;
-    in += 3;
+    gst_buffer_unref (p->inbuf);
   }
+  g_array_set_size (self->pending, 0);
+  self->pending_outbuf = NULL;
 }
 
+/* Interleave all channels collected for @outbuf. Channels that are
+ * consecutive in the output and cover the same frames are interleaved
+ * together, which writes each output frame once instead of once per
+ * channel. */
 static void
-gst_audio_interleave_set_process_function (GstAudioInterleave * self,
-    GstAudioInfo * info)
+gst_audio_interleave_flush_pending (GstAudioInterleave * self,
+    GstBuffer * outbuf)
 {
-  switch (GST_AUDIO_INFO_WIDTH (info)) {
-    case 8:
-      self->func = (GstInterleaveFunc) interleave_8;
-      break;
-    case 16:
-      self->func = (GstInterleaveFunc) interleave_16;
-      break;
-    case 24:
-      self->func = (GstInterleaveFunc) interleave_24;
-      break;
-    case 32:
-      self->func = (GstInterleaveFunc) interleave_32;
-      break;
-    case 64:
-      self->func = (GstInterleaveFunc) interleave_64;
-      break;
-    default:
-      g_assert_not_reached ();
-      break;
+  GstAudioAggregatorPad *srcpad =
+      GST_AUDIO_AGGREGATOR_PAD (GST_AGGREGATOR_SRC_PAD (self));
+  GstAudioInterleavePending *pending;
+  GstMapInfo outmap;
+  gint width, out_bpf, out_channels;
+  guint i, j, n_pending, max_frames;
+  gpointer *in;
+
+  GST_OBJECT_LOCK (self);
+  if (self->pending->len == 0 || self->pending_outbuf != outbuf) {
+    gst_audio_interleave_clear_pending (self);
+    GST_OBJECT_UNLOCK (self);
+    return;
   }
-}
 
+  width = GST_AUDIO_INFO_WIDTH (&srcpad->info);
+  out_bpf = GST_AUDIO_INFO_BPF (&srcpad->info);
+  out_channels = GST_AUDIO_INFO_CHANNELS (&srcpad->info);
+
+  n_pending = self->pending->len;
+  pending = (GstAudioInterleavePending *) self->pending->data;
+  g_array_sort (self->pending, compare_pending);
+  in = g_newa (gpointer, n_pending);
+
+  for (i = 0; i < n_pending; i++)
+    gst_buffer_map (pending[i].inbuf, &pending[i].inmap, GST_MAP_READ);
+  gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
+
+  /* the last output buffer can be shorter than what was aggregated into it */
+  max_frames = outmap.size / out_bpf;
+
+  for (i = 0; i < n_pending; i = j) {
+    guint num_frames = pending[i].num_frames;
+
+    in[0] = pending[i].inmap.data + pending[i].in_offset;
+    for (j = i + 1; j < n_pending; j++) {
+      if (pending[j].out_offset != pending[i].out_offset ||
+          pending[j].num_frames != num_frames ||
+          pending[j].channel != pending[i].channel + (j - i))
+        break;
+      in[j - i] = pending[j].inmap.data + pending[j].in_offset;
+    }
+
+    if (pending[i].out_offset >= max_frames)
+      continue;
+    num_frames = MIN (num_frames, max_frames - pending[i].out_offset);
+
+    GST_LOG_OBJECT (self, "interleaving %u frames of channels %d-%d/%d at "
+        "offset %u", num_frames, pending[i].channel,
+        pending[i].channel + (j - i) - 1, out_channels,
+        pending[i].out_offset * out_bpf);
+
+    gst_audio_interleave_samples (width,
+        outmap.data + pending[i].out_offset * out_bpf +
+        pending[i].channel * (width / 8), out_channels, in, j - i,
+        num_frames);
+  }
+
+  gst_buffer_unmap (outbuf, &outmap);
+  for (i = 0; i < n_pending; i++)
+    gst_buffer_unmap (pending[i].inbuf, &pending[i].inmap);
+
+  gst_audio_interleave_clear_pending (self);
+  GST_OBJECT_UNLOCK (self);
+}
 
 /* the first caps we receive on any of the sinkpads will define the caps for all
  * the other sinkpads because we can only mix streams with the same caps.
@@ -535,16 +592,39 @@ static gboolean
 gst_audio_interleave_negotiated_src_caps (GstAggregator * agg, GstCaps * caps)
 {
   GstAudioInterleave *self = GST_AUDIO_INTERLEAVE (agg);
-  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
 
   if (!GST_AGGREGATOR_CLASS (parent_class)->negotiated_src_caps (agg, caps))
     return FALSE;
 
-  gst_audio_interleave_set_process_function (self, &srcpad->info);
+  GST_OBJECT_LOCK (self);
+  gst_audio_interleave_clear_pending (self);
+  GST_OBJECT_UNLOCK (self);
 
   return TRUE;
 }
 
+static GstFlowReturn
+gst_audio_interleave_finish_buffer (GstAggregator * agg, GstBuffer * buffer)
+{
+  GstAudioInterleave *self = GST_AUDIO_INTERLEAVE (agg);
+
+  gst_audio_interleave_flush_pending (self, buffer);
+
+  return GST_AGGREGATOR_CLASS (parent_class)->finish_buffer (agg, buffer);
+}
+
+static GstFlowReturn
+gst_audio_interleave_flush (GstAggregator * agg)
+{
+  GstAudioInterleave *self = GST_AUDIO_INTERLEAVE (agg);
+
+  GST_OBJECT_LOCK (self);
+  gst_audio_interleave_clear_pending (self);
+  GST_OBJECT_UNLOCK (self);
+
+  return GST_AGGREGATOR_CLASS (parent_class)->flush (agg);
+}
+
 static void
 gst_audio_interleave_class_init (GstAudioInterleaveClass * klass)
 {
@@ -578,6 +658,8 @@ gst_audio_interleave_class_init (GstAudioInterleaveClass * klass)
   agg_class->stop = gst_audio_interleave_stop;
   agg_class->update_src_caps = gst_audio_interleave_update_src_caps;
   agg_class->negotiated_src_caps = gst_audio_interleave_negotiated_src_caps;
+  agg_class->finish_buffer = gst_audio_interleave_finish_buffer;
+  agg_class->flush = gst_audio_interleave_flush;
 
   aagg_class->aggregate_one_buffer = gst_audio_interleave_aggregate_one_buffer;
 
@@ -630,6 +712,8 @@ gst_audio_interleave_init (GstAudioInterleave * self)
   self->input_channel_positions = g_value_array_new (0);
   self->channel_positions_from_input = TRUE;
   self->channel_positions = self->input_channel_positions;
+  self->pending = g_array_new (FALSE, FALSE,
+      sizeof (GstAudioInterleavePending));
 }
 
 static void
@@ -648,6 +732,9 @@ gst_audio_interleave_finalize (GObject * object)
     self->input_channel_positions = NULL;
   }
 
+  gst_audio_interleave_clear_pending (self);
+  g_array_free (self->pending, TRUE);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -714,6 +801,10 @@ gst_audio_interleave_stop (GstAggregator * agg)
 
   gst_caps_replace (&self->sinkcaps, NULL);
 
+  GST_OBJECT_LOCK (self);
+  gst_audio_interleave_clear_pending (self);
+  GST_OBJECT_UNLOCK (self);
+
   return TRUE;
 }
 
@@ -816,42 +907,32 @@ gst_audio_interleave_aggregate_one_buffer (GstAudioAggregator * aagg,
 {
   GstAudioInterleave *self = GST_AUDIO_INTERLEAVE (aagg);
   GstAudioInterleavePad *pad = GST_AUDIO_INTERLEAVE_PAD (aaggpad);
-  GstMapInfo inmap;
-  GstMapInfo outmap;
-  gint out_width, in_bpf, out_bpf, out_channels, channel;
-  guint8 *outdata;
-  GstAggregator *agg = GST_AGGREGATOR (aagg);
-  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
+  GstAudioInterleavePending pending = { NULL, };
 
   GST_OBJECT_LOCK (aagg);
   GST_OBJECT_LOCK (aaggpad);
 
-  out_width = GST_AUDIO_INFO_WIDTH (&srcpad->info) / 8;
-  in_bpf = GST_AUDIO_INFO_BPF (&aaggpad->info);
-  out_bpf = GST_AUDIO_INFO_BPF (&srcpad->info);
-  out_channels = GST_AUDIO_INFO_CHANNELS (&srcpad->info);
-
-  gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
-  gst_buffer_map (inbuf, &inmap, GST_MAP_READ);
-  GST_LOG_OBJECT (pad, "interleaves %u frames on channel %d/%d at offset %u"
-      " from offset %u", num_frames, pad->channel, out_channels,
-      out_offset * out_bpf, in_offset * in_bpf);
-
   if (self->channels > 64) {
-    channel = pad->channel;
+    pending.channel = pad->channel;
   } else {
-    channel = self->default_channels_ordering_map[pad->channel];
+    pending.channel = self->default_channels_ordering_map[pad->channel];
   }
 
-  outdata = outmap.data + (out_offset * out_bpf) + (out_width * channel);
-
-
-  self->func (outdata, inmap.data + (in_offset * in_bpf), out_channels,
-      num_frames);
-
-
-  gst_buffer_unmap (inbuf, &inmap);
-  gst_buffer_unmap (outbuf, &outmap);
+  GST_LOG_OBJECT (pad, "queueing %u frames on channel %d at offset %u"
+      " from offset %u", num_frames, pending.channel, out_offset, in_offset);
+
+  /* an output buffer that was never finished, e.g. because of a flush */
+  if (self->pending_outbuf != outbuf)
+    gst_audio_interleave_clear_pending (self);
+  self->pending_outbuf = outbuf;
+
+  /* the actual interleaving happens in finish_buffer once all channels of
+   * the output buffer are known */
+  pending.inbuf = gst_buffer_ref (inbuf);
+  pending.in_offset = in_offset * GST_AUDIO_INFO_BPF (&aaggpad->info);
+  pending.out_offset = out_offset;
+  pending.num_frames = num_frames;
+  g_array_append_val (self->pending, pending);
 
   GST_OBJECT_UNLOCK (aaggpad);
   GST_OBJECT_UNLOCK (aagg);
@@ -86,6 +86,42 @@ GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
 #define VOLUME_UNITY_INT32           134217728  /* internal int for unity 2^(32-5) */
 #define VOLUME_UNITY_INT32_BIT_SHIFT 27
 
+/* One input buffer range to be added to the output buffer. The volume is
+ * snapshotted from the pad when the job is created. */
+typedef struct
+{
+  GstBuffer *inbuf;
+  guint in_offset;
+  guint out_offset;
+  guint num_frames;
+
+  gdouble volume;
+  gint volume_i32;
+  gint volume_i16;
+  gint volume_i8;
+} GstAudioMixerJob;
+
+typedef struct _GstAudioMixerThread
+{
+  GstAudioMixer *mixer;
+  guint index;
+  /* number of threads the jobs are split between */
+  guint stride;
+
+  /* where this thread accumulates its partial sum, the output buffer for the
+   * first thread and a scratch area of the same size for the others */
+  guint8 *dest;
+  guint8 *scratch;
+  gsize scratch_size;
+
+  /* range of frames touched in @dest */
+  guint start;
+  guint end;
+} GstAudioMixerThread;
+
+/* Don't bother splitting the work for less pads than this per thread */
+#define MIN_JOBS_PER_THREAD 4
+
 enum
 {
   PROP_PAD_0,
@@ -166,9 +202,12 @@ gst_audiomixer_pad_init (GstAudioMixerPad * pad)
   pad->mute = DEFAULT_PAD_MUTE;
 }
 
+#define DEFAULT_N_THREADS 1
+
 enum
 {
-  PROP_0
+  PROP_0,
+  PROP_N_THREADS
 };
 
 /* These are the formats we can mix natively */
@@ -216,14 +255,89 @@ static gboolean
 gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
     GstAudioAggregatorPad * aaggpad, GstBuffer * inbuf, guint in_offset,
     GstBuffer * outbuf, guint out_offset, guint num_samples);
+static GstFlowReturn gst_audiomixer_aggregate (GstAggregator * agg,
+    gboolean timeout);
+static GstFlowReturn gst_audiomixer_finish_buffer (GstAggregator * agg,
+    GstBuffer * buffer);
+static gboolean gst_audiomixer_stop (GstAggregator * agg);
+static void gst_audiomixer_free_threads (GstAudioMixer * audiomixer);
+
+static void
+gst_audiomixer_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (object);
+
+  switch (prop_id) {
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (audiomixer);
+      audiomixer->n_threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (audiomixer);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_audiomixer_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (object);
+
+  switch (prop_id) {
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (audiomixer);
+      g_value_set_uint (value, audiomixer->n_threads);
+      GST_OBJECT_UNLOCK (audiomixer);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_audiomixer_finalize (GObject * object)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (object);
+
+  gst_audiomixer_free_threads (audiomixer);
+  g_array_unref (audiomixer->jobs);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
 
 
 static void
 gst_audiomixer_class_init (GstAudioMixerClass * klass)
 {
+  GObjectClass *gobject_class = (GObjectClass *) klass;
   GstElementClass *gstelement_class = (GstElementClass *) klass;
+  GstAggregatorClass *agg_class = (GstAggregatorClass *) klass;
   GstAudioAggregatorClass *aagg_class = (GstAudioAggregatorClass *) klass;
 
+  gobject_class->set_property = gst_audiomixer_set_property;
+  gobject_class->get_property = gst_audiomixer_get_property;
+  gobject_class->finalize = gst_audiomixer_finalize;
+
+  /**
+   * GstAudioMixer:n-threads:
+   *
+   * Maximum number of threads used to mix the input pads. With more than one
+   * thread, each thread adds a subset of the pads into its own partial mix
+   * and the partial mixes are summed up at the end. This only pays off with
+   * many input pads, a thread is only used for every 4 pads. 0 uses as many
+   * threads as there are processors.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Maximum number of threads to use", 0, G_MAXUINT,
+          DEFAULT_N_THREADS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
       &gst_audiomixer_src_template, GST_TYPE_AUDIO_AGGREGATOR_CONVERT_PAD);
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
@@ -237,6 +351,10 @@ gst_audiomixer_class_init (GstAudioMixerClass * klass)
   gstelement_class->release_pad =
       GST_DEBUG_FUNCPTR (gst_audiomixer_release_pad);
 
+  agg_class->aggregate = GST_DEBUG_FUNCPTR (gst_audiomixer_aggregate);
+  agg_class->finish_buffer = GST_DEBUG_FUNCPTR (gst_audiomixer_finish_buffer);
+  agg_class->stop = GST_DEBUG_FUNCPTR (gst_audiomixer_stop);
+
   aagg_class->aggregate_one_buffer = gst_audiomixer_aggregate_one_buffer;
 
   gst_type_mark_as_plugin_api (GST_TYPE_AUDIO_MIXER_PAD, 0);
@@ -245,6 +363,9 @@ gst_audiomixer_class_init (GstAudioMixerClass * klass)
 static void
 gst_audiomixer_init (GstAudioMixer * audiomixer)
 {
+  audiomixer->n_threads = DEFAULT_N_THREADS;
+  audiomixer->active_threads = 1;
+  audiomixer->jobs = g_array_new (FALSE, FALSE, sizeof (GstAudioMixerJob));
 }
 
 static GstPad *
@@ -288,13 +409,308 @@ gst_audiomixer_release_pad (GstElement * element, GstPad * pad)
 }
 
 
+static void
+gst_audiomixer_add_samples (GstAudioFormat format, guint8 * out,
+    const guint8 * in, gint n)
+{
+  switch (format) {
+    case GST_AUDIO_FORMAT_U8:
+      audiomixer_orc_add_u8 ((gpointer) out, (gpointer) in, n);
+      break;
+    case GST_AUDIO_FORMAT_S8:
+      audiomixer_orc_add_s8 ((gpointer) out, (gpointer) in, n);
+      break;
+    case GST_AUDIO_FORMAT_U16:
+      audiomixer_orc_add_u16 ((gpointer) out, (gpointer) in, n);
+      break;
+    case GST_AUDIO_FORMAT_S16:
+      audiomixer_orc_add_s16 ((gpointer) out, (gpointer) in, n);
+      break;
+    case GST_AUDIO_FORMAT_U32:
+      audiomixer_orc_add_u32 ((gpointer) out, (gpointer) in, n);
+      break;
+    case GST_AUDIO_FORMAT_S32:
+      audiomixer_orc_add_s32 ((gpointer) out, (gpointer) in, n);
+      break;
+    case GST_AUDIO_FORMAT_F32:
+      audiomixer_orc_add_f32 ((gpointer) out, (gpointer) in, n);
+      break;
+    case GST_AUDIO_FORMAT_F64:
+      audiomixer_orc_add_f64 ((gpointer) out, (gpointer) in, n);
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+}
+
+static void
+gst_audiomixer_add_volume_samples (GstAudioFormat format, guint8 * out,
+    const guint8 * in, const GstAudioMixerJob * job, gint n)
+{
+  switch (format) {
+    case GST_AUDIO_FORMAT_U8:
+      audiomixer_orc_add_volume_u8 ((gpointer) out, (gpointer) in,
+          job->volume_i8, n);
+      break;
+    case GST_AUDIO_FORMAT_S8:
+      audiomixer_orc_add_volume_s8 ((gpointer) out, (gpointer) in,
+          job->volume_i8, n);
+      break;
+    case GST_AUDIO_FORMAT_U16:
+      audiomixer_orc_add_volume_u16 ((gpointer) out, (gpointer) in,
+          job->volume_i16, n);
+      break;
+    case GST_AUDIO_FORMAT_S16:
+      audiomixer_orc_add_volume_s16 ((gpointer) out, (gpointer) in,
+          job->volume_i16, n);
+      break;
+    case GST_AUDIO_FORMAT_U32:
+      audiomixer_orc_add_volume_u32 ((gpointer) out, (gpointer) in,
+          job->volume_i32, n);
+      break;
+    case GST_AUDIO_FORMAT_S32:
+      audiomixer_orc_add_volume_s32 ((gpointer) out, (gpointer) in,
+          job->volume_i32, n);
+      break;
+    case GST_AUDIO_FORMAT_F32:
+      audiomixer_orc_add_volume_f32 ((gpointer) out, (gpointer) in,
+          job->volume, n);
+      break;
+    case GST_AUDIO_FORMAT_F64:
+      audiomixer_orc_add_volume_f64 ((gpointer) out, (gpointer) in,
+          job->volume, n);
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+}
+
+/* Add the input of @job to @dest, which points to the start of the output */
+static void
+gst_audiomixer_mix_job (const GstAudioInfo * info,
+    const GstAudioMixerJob * job, guint8 * dest)
+{
+  GstMapInfo inmap;
+  gint bpf = GST_AUDIO_INFO_BPF (info);
+  gint n = job->num_frames * GST_AUDIO_INFO_CHANNELS (info);
+  guint8 *out;
+  const guint8 *in;
+
+  gst_buffer_map (job->inbuf, &inmap, GST_MAP_READ);
+
+  out = dest + job->out_offset * bpf;
+  in = inmap.data + job->in_offset * bpf;
+
+  if (job->volume == 1.0)
+    gst_audiomixer_add_samples (GST_AUDIO_INFO_FORMAT (info), out, in, n);
+  else
+    gst_audiomixer_add_volume_samples (GST_AUDIO_INFO_FORMAT (info), out, in,
+        job, n);
+
+  gst_buffer_unmap (job->inbuf, &inmap);
+}
+
+static void
+gst_audiomixer_mix_thread_func (gpointer user_data)
+{
+  GstAudioMixerThread *thread = user_data;
+  GstAudioMixer *audiomixer = thread->mixer;
+  GstAggregator *agg = GST_AGGREGATOR (audiomixer);
+  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
+  guint i;
+
+  thread->start = G_MAXUINT;
+  thread->end = 0;
+
+  for (i = thread->index; i < audiomixer->jobs->len;
+      i += thread->stride) {
+    GstAudioMixerJob *job =
+        &g_array_index (audiomixer->jobs, GstAudioMixerJob, i);
+
+    gst_audiomixer_mix_job (&srcpad->info, job, thread->dest);
+
+    thread->start = MIN (thread->start, job->out_offset);
+    thread->end = MAX (thread->end, job->out_offset + job->num_frames);
+  }
+}
+
+static void
+gst_audiomixer_clear_jobs (GstAudioMixer * audiomixer)
+{
+  guint i;
+
+  for (i = 0; i < audiomixer->jobs->len; i++)
+    gst_buffer_unref (g_array_index (audiomixer->jobs, GstAudioMixerJob,
+            i).inbuf);
+  g_array_set_size (audiomixer->jobs, 0);
+}
+
+static void
+gst_audiomixer_free_threads (GstAudioMixer * audiomixer)
+{
+  guint i;
+
+  if (audiomixer->task_pool) {
+    gst_task_pool_cleanup (audiomixer->task_pool);
+    gst_object_unref (audiomixer->task_pool);
+    audiomixer->task_pool = NULL;
+    audiomixer->task_pool_size = 0;
+  }
+
+  for (i = 0; i < audiomixer->n_allocated_threads; i++)
+    g_free (audiomixer->threads[i].scratch);
+  g_free (audiomixer->threads);
+  audiomixer->threads = NULL;
+  audiomixer->n_allocated_threads = 0;
+}
+
+static void
+gst_audiomixer_ensure_threads (GstAudioMixer * audiomixer, guint n_threads)
+{
+  guint i;
+
+  if (audiomixer->n_allocated_threads < n_threads) {
+    audiomixer->threads = g_renew (GstAudioMixerThread, audiomixer->threads,
+        n_threads);
+    for (i = audiomixer->n_allocated_threads; i < n_threads; i++) {
+      audiomixer->threads[i].mixer = audiomixer;
+      audiomixer->threads[i].index = i;
+      audiomixer->threads[i].scratch = NULL;
+      audiomixer->threads[i].scratch_size = 0;
+    }
+    audiomixer->n_allocated_threads = n_threads;
+  }
+
+  /* the first thread runs on the aggregator thread itself */
+  if (audiomixer->task_pool_size < n_threads - 1) {
+    if (audiomixer->task_pool) {
+      gst_task_pool_cleanup (audiomixer->task_pool);
+      gst_object_unref (audiomixer->task_pool);
+    }
+    audiomixer->task_pool = gst_shared_task_pool_new ();
+    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL
+        (audiomixer->task_pool), n_threads - 1);
+    gst_task_pool_prepare (audiomixer->task_pool, NULL);
+    audiomixer->task_pool_size = n_threads - 1;
+  }
+}
+
+/* Mix all pending jobs into @outbuf. Each thread sums a subset of the pads
+ * into its own area, the partial sums are then added to the output. */
+static void
+gst_audiomixer_run_jobs (GstAudioMixer * audiomixer, GstBuffer * outbuf)
+{
+  GstAggregator *agg = GST_AGGREGATOR (audiomixer);
+  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
+  GstAudioFormat format = GST_AUDIO_INFO_FORMAT (&srcpad->info);
+  gint bpf = GST_AUDIO_INFO_BPF (&srcpad->info);
+  gint channels = GST_AUDIO_INFO_CHANNELS (&srcpad->info);
+  guint n_threads, i;
+  GstMapInfo outmap;
+  GQueue tasks = G_QUEUE_INIT;
+
+  if (audiomixer->jobs->len == 0)
+    return;
+
+  gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
+
+  n_threads = MIN (audiomixer->active_threads,
+      audiomixer->jobs->len / MIN_JOBS_PER_THREAD);
+
+  if (n_threads <= 1) {
+    for (i = 0; i < audiomixer->jobs->len; i++)
+      gst_audiomixer_mix_job (&srcpad->info,
+          &g_array_index (audiomixer->jobs, GstAudioMixerJob, i), outmap.data);
+    goto done;
+  }
+
+  GST_LOG_OBJECT (audiomixer, "mixing %u pads with %u threads",
+      audiomixer->jobs->len, n_threads);
+
+  gst_audiomixer_ensure_threads (audiomixer, n_threads);
+
+  audiomixer->threads[0].dest = outmap.data;
+  audiomixer->threads[0].stride = n_threads;
+  for (i = 1; i < n_threads; i++) {
+    GstAudioMixerThread *thread = &audiomixer->threads[i];
+
+    thread->stride = n_threads;
+
+    if (thread->scratch_size < outmap.size) {
+      g_free (thread->scratch);
+      thread->scratch = g_malloc (outmap.size);
+      thread->scratch_size = outmap.size;
+    }
+    gst_audio_format_fill_silence (srcpad->info.finfo, thread->scratch,
+        outmap.size);
+    thread->dest = thread->scratch;
+
+    g_queue_push_tail (&tasks, gst_task_pool_push (audiomixer->task_pool,
+            gst_audiomixer_mix_thread_func, thread, NULL));
+  }
+
+  gst_audiomixer_mix_thread_func (&audiomixer->threads[0]);
+
+  while (!g_queue_is_empty (&tasks)) {
+    gpointer task = g_queue_pop_head (&tasks);
+
+    if (task)
+      gst_task_pool_join (audiomixer->task_pool, task);
+  }
+
+  /* reduce the partial sums into the output */
+  for (i = 1; i < n_threads; i++) {
+    GstAudioMixerThread *thread = &audiomixer->threads[i];
+
+    if (thread->start >= thread->end)
+      continue;
+
+    gst_audiomixer_add_samples (format, outmap.data + thread->start * bpf,
+        thread->dest + thread->start * bpf,
+        (thread->end - thread->start) * channels);
+  }
+
+done:
+  gst_buffer_unmap (outbuf, &outmap);
+  gst_audiomixer_clear_jobs (audiomixer);
+}
+
+static void
+gst_audiomixer_pending_outbuf_finalized (gpointer user_data,
+    GstMiniObject * where_the_object_was)
+{
+  GstAudioMixer *audiomixer = user_data;
+
+  audiomixer->pending_outbuf = NULL;
+}
+
+/* Mix the deferred jobs into the output buffer they were queued for, unless
+ * the base class has discarded that buffer in the meantime */
+static void
+gst_audiomixer_flush_jobs (GstAudioMixer * audiomixer)
+{
+  GstBuffer *outbuf = audiomixer->pending_outbuf;
+
+  if (outbuf) {
+    gst_mini_object_weak_unref (GST_MINI_OBJECT_CAST (outbuf),
+        gst_audiomixer_pending_outbuf_finalized, audiomixer);
+    audiomixer->pending_outbuf = NULL;
+    gst_audiomixer_run_jobs (audiomixer, outbuf);
+  }
+
+  gst_audiomixer_clear_jobs (audiomixer);
+}
+
 static gboolean
 gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
     GstAudioAggregatorPad * aaggpad, GstBuffer * inbuf, guint in_offset,
     GstBuffer * outbuf, guint out_offset, guint num_frames)
 {
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (aagg);
   GstAudioMixerPad *pad = GST_AUDIO_MIXER_PAD (aaggpad);
-  GstMapInfo inmap;
+  GstAudioMixerJob job;
   GstMapInfo outmap;
   gint bpf;
   GstAggregator *agg = GST_AGGREGATOR (aagg);
@@ -312,107 +728,34 @@ gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
 
   bpf = GST_AUDIO_INFO_BPF (&srcpad->info);
 
-  gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
-  gst_buffer_map (inbuf, &inmap, GST_MAP_READ);
+  job.inbuf = inbuf;
+  job.in_offset = in_offset;
+  job.out_offset = out_offset;
+  job.num_frames = num_frames;
+  job.volume = pad->volume;
+  job.volume_i32 = pad->volume_i32;
+  job.volume_i16 = pad->volume_i16;
+  job.volume_i8 = pad->volume_i8;
+
   GST_LOG_OBJECT (pad, "mixing %u bytes at offset %u from offset %u",
       num_frames * bpf, out_offset * bpf, in_offset * bpf);
 
-  /* further buffers, need to add them */
-  if (pad->volume == 1.0) {
-    switch (srcpad->info.finfo->format) {
-      case GST_AUDIO_FORMAT_U8:
-        audiomixer_orc_add_u8 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
-        break;
-      case GST_AUDIO_FORMAT_S8:
-        audiomixer_orc_add_s8 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
-        break;
-      case GST_AUDIO_FORMAT_U16:
-        audiomixer_orc_add_u16 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
-        break;
-      case GST_AUDIO_FORMAT_S16:
-        audiomixer_orc_add_s16 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
-        break;
-      case GST_AUDIO_FORMAT_U32:
-        audiomixer_orc_add_u32 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
-        break;
-      case GST_AUDIO_FORMAT_S32:
-        audiomixer_orc_add_s32 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
-        break;
-      case GST_AUDIO_FORMAT_F32:
-        audiomixer_orc_add_f32 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
-        break;
-      case GST_AUDIO_FORMAT_F64:
-        audiomixer_orc_add_f64 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
-        break;
-      default:
-        g_assert_not_reached ();
-        break;
+  if (audiomixer->active_threads > 1) {
+    /* mixed together with the other pads before the output buffer is
+     * pushed or the aggregate function returns */
+    if (audiomixer->pending_outbuf != outbuf) {
+      gst_audiomixer_flush_jobs (audiomixer);
+      audiomixer->pending_outbuf = outbuf;
+      gst_mini_object_weak_ref (GST_MINI_OBJECT_CAST (outbuf),
+          gst_audiomixer_pending_outbuf_finalized, audiomixer);
     }
+    job.inbuf = gst_buffer_ref (inbuf);
+    g_array_append_val (audiomixer->jobs, job);
   } else {
-    switch (srcpad->info.finfo->format) {
-      case GST_AUDIO_FORMAT_U8:
-        audiomixer_orc_add_volume_u8 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i8, num_frames * srcpad->info.channels);
-        break;
-      case GST_AUDIO_FORMAT_S8:
-        audiomixer_orc_add_volume_s8 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i8, num_frames * srcpad->info.channels);
-        break;
-      case GST_AUDIO_FORMAT_U16:
-        audiomixer_orc_add_volume_u16 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i16, num_frames * srcpad->info.channels);
-        break;
-      case GST_AUDIO_FORMAT_S16:
-        audiomixer_orc_add_volume_s16 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i16, num_frames * srcpad->info.channels);
-        break;
-      case GST_AUDIO_FORMAT_U32:
-        audiomixer_orc_add_volume_u32 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i32, num_frames * srcpad->info.channels);
-        break;
-      case GST_AUDIO_FORMAT_S32:
-        audiomixer_orc_add_volume_s32 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i32, num_frames * srcpad->info.channels);
-        break;
-      case GST_AUDIO_FORMAT_F32:
-        audiomixer_orc_add_volume_f32 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume, num_frames * srcpad->info.channels);
-        break;
-      case GST_AUDIO_FORMAT_F64:
-        audiomixer_orc_add_volume_f64 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume, num_frames * srcpad->info.channels);
-        break;
-      default:
-        g_assert_not_reached ();
-        break;
-    }
+    gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
+    gst_audiomixer_mix_job (&srcpad->info, &job, outmap.data);
+    gst_buffer_unmap (outbuf, &outmap);
   }
-  gst_buffer_unmap (inbuf, &inmap);
-  gst_buffer_unmap (outbuf, &outmap);
 
   GST_OBJECT_UNLOCK (aaggpad);
   GST_OBJECT_UNLOCK (aagg);
@@ -420,6 +763,49 @@ gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
   return TRUE;
 }
 
+static GstFlowReturn
+gst_audiomixer_aggregate (GstAggregator * agg, gboolean timeout)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (agg);
+  GstFlowReturn ret;
+  guint n_threads;
+
+  GST_OBJECT_LOCK (audiomixer);
+  n_threads = audiomixer->n_threads;
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+  audiomixer->active_threads = n_threads;
+
+  ret = GST_AGGREGATOR_CLASS (parent_class)->aggregate (agg, timeout);
+
+  /* The output buffer is not complete yet and stays around in the base class,
+   * mix what we have so far into it */
+  gst_audiomixer_flush_jobs (audiomixer);
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_audiomixer_finish_buffer (GstAggregator * agg, GstBuffer * buffer)
+{
+  gst_audiomixer_flush_jobs (GST_AUDIO_MIXER (agg));
+
+  return GST_AGGREGATOR_CLASS (parent_class)->finish_buffer (agg, buffer);
+}
+
+static gboolean
+gst_audiomixer_stop (GstAggregator * agg)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (agg);
+
+  gst_audiomixer_flush_jobs (audiomixer);
+  gst_audiomixer_free_threads (audiomixer);
+
+  return GST_AGGREGATOR_CLASS (parent_class)->stop (agg);
+}
+
 
 /* GstChildProxy implementation */
 static GObject *
@@ -41,6 +41,20 @@ G_DECLARE_FINAL_TYPE (GstAudioMixer, gst_audiomixer, GST, AUDIO_MIXER,
  */
 struct _GstAudioMixer {
   GstAudioAggregator element;
+
+  /*< private >*/
+  /* with object lock */
+  guint n_threads;
+
+  /* number of threads mixing the current output buffer, with more than one
+   * thread mixing is deferred and @jobs are split between the threads */
+  guint active_threads;
+  GArray *jobs;
+  GstBuffer *pending_outbuf;
+  GstTaskPool *task_pool;
+  guint task_pool_size;
+  struct _GstAudioMixerThread *threads;
+  guint n_allocated_threads;
 };
 
 #define GST_TYPE_AUDIO_MIXER_PAD (gst_audiomixer_pad_get_type())
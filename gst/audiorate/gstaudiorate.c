@@ -268,6 +268,49 @@ gst_audio_rate_init (GstAudioRate * audiorate)
   audiorate->tolerance = DEFAULT_TOLERANCE;
 }
 
+/* Create a GAP buffer of silence that shares read-only memory, so that
+ * nothing needs to be allocated or written for every gap. Downstream
+ * copies the memory if it wants to write to it. */
+static GstBuffer *
+gst_audio_rate_create_silence_buffer (GstAudioRate * audiorate,
+    guint64 samples)
+{
+  gint bpf = GST_AUDIO_INFO_BPF (&audiorate->info);
+  gsize size = samples * bpf;
+  GstBuffer *buf;
+
+  if (audiorate->silence_mem == NULL ||
+      audiorate->silence_format != GST_AUDIO_INFO_FORMAT (&audiorate->info) ||
+      audiorate->silence_mem->size < size) {
+    guint64 alloc_samples;
+    GstMapInfo map;
+
+    if (audiorate->silence_mem)
+      gst_memory_unref (audiorate->silence_mem);
+
+    /* round up to a power of two so that growing gaps don't reallocate
+     * every time, gaps are never filled with more than one second */
+    alloc_samples = G_GUINT64_CONSTANT (1) << g_bit_storage (samples - 1);
+    alloc_samples = MAX (samples, MIN (alloc_samples,
+            GST_AUDIO_INFO_RATE (&audiorate->info)));
+
+    audiorate->silence_mem =
+        gst_allocator_alloc (NULL, alloc_samples * bpf, NULL);
+    gst_memory_map (audiorate->silence_mem, &map, GST_MAP_WRITE);
+    gst_audio_format_fill_silence (audiorate->info.finfo, map.data, map.size);
+    gst_memory_unmap (audiorate->silence_mem, &map);
+    GST_MINI_OBJECT_FLAG_SET (audiorate->silence_mem,
+        GST_MEMORY_FLAG_READONLY);
+    audiorate->silence_format = GST_AUDIO_INFO_FORMAT (&audiorate->info);
+  }
+
+  buf = gst_buffer_new ();
+  gst_buffer_append_memory (buf,
+      gst_memory_share (audiorate->silence_mem, 0, size));
+
+  return buf;
+}
+
 static void
 gst_audio_rate_fill_to_time (GstAudioRate * audiorate, GstClockTime time)
 {
@@ -541,7 +584,6 @@ gst_audio_rate_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   /* do we need to insert samples */
   if (in_offset > audiorate->next_offset) {
     GstBuffer *fill;
-    gint fillsize;
     guint64 fillsamples;
 
     /* We don't want to allocate a single unreasonably huge buffer - it might
@@ -551,17 +593,10 @@ gst_audio_rate_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
 
     while (fillsamples > 0) {
       guint64 cursamples = MIN (fillsamples, rate);
-      GstMapInfo fillmap;
 
       fillsamples -= cursamples;
-      fillsize = cursamples * bpf;
-
-      fill = gst_buffer_new_and_alloc (fillsize);
 
-      gst_buffer_map (fill, &fillmap, GST_MAP_WRITE);
-      gst_audio_format_fill_silence (audiorate->info.finfo, fillmap.data,
-          fillmap.size);
-      gst_buffer_unmap (fill, &fillmap);
+      fill = gst_audio_rate_create_silence_buffer (audiorate, cursamples);
 
       if (audiorate->info.layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED) {
         gst_buffer_add_audio_meta (fill, &audiorate->info, cursamples, NULL);
@@ -760,6 +795,7 @@ static GstStateChangeReturn
 gst_audio_rate_change_state (GstElement * element, GstStateChange transition)
 {
   GstAudioRate *audiorate = GST_AUDIO_RATE (element);
+  GstStateChangeReturn ret;
 
   switch (transition) {
     case GST_STATE_CHANGE_PAUSED_TO_READY:
@@ -776,7 +812,20 @@ gst_audio_rate_change_state (GstElement * element, GstStateChange transition)
       break;
   }
 
-  return GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+
+  switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      if (audiorate->silence_mem) {
+        gst_memory_unref (audiorate->silence_mem);
+        audiorate->silence_mem = NULL;
+      }
+      break;
+    default:
+      break;
+  }
+
+  return ret;
 }
 
 static gboolean
@@ -59,6 +59,10 @@ struct _GstAudioRate
   GstSegment sink_segment;
   /* we output TIME format on the src */
   GstSegment src_segment;
+
+  /* read-only silence shared by all gap buffers */
+  GstMemory *silence_mem;
+  GstAudioFormat silence_format;
 };
 
 G_END_DECLS
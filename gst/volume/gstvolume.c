@@ -36,6 +36,13 @@
  * (peak values are around -6 dB and RMS around -9 dB) compared to
  * the same pipeline without the volume element.
  *
+ * |[
+ * gst-launch-1.0 -v audiotestsrc ! audio/x-raw,channels=2 ! volume channel-volumes="<1.0, 0.5>" ! autoaudiosink
+ * ]|
+ *  This pipeline attenuates the right channel by 6 dB and leaves the left
+ * channel untouched. The per-channel volumes are applied on top of the
+ * #GstVolume:volume property, including any control bindings on it.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -79,6 +86,10 @@
 #define VOLUME_MAX_INT32             G_MAXINT32
 #define VOLUME_MIN_INT32             G_MININT32
 
+/* number of frames for which per-sample gains are expanded at once when
+ * processing multi-channel audio with varying or per-channel gains */
+#define VOLUME_BLOCK_FRAMES          256
+
 #define GST_CAT_DEFAULT gst_volume_debug
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
 
@@ -96,7 +107,8 @@ enum
 {
   PROP_0,
   PROP_MUTE,
-  PROP_VOLUME
+  PROP_VOLUME,
+  PROP_CHANNEL_VOLUMES
 };
 
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
@@ -170,6 +182,7 @@ volume_choose_func (GstVolume * self, const GstAudioInfo * info)
 
   self->process = NULL;
   self->process_controlled = NULL;
+  self->have_controlled_2ch = FALSE;
 
   format = GST_AUDIO_INFO_FORMAT (info);
 
@@ -203,6 +216,7 @@ volume_choose_func (GstVolume * self, const GstAudioInfo * info)
         self->process = volume_process_int16;
       }
       self->process_controlled = volume_process_controlled_int16_clamp;
+      self->have_controlled_2ch = TRUE;
       break;
     case GST_AUDIO_FORMAT_S8:
       /* only clamp if the gain is greater than 1.0 */
@@ -212,10 +226,12 @@ volume_choose_func (GstVolume * self, const GstAudioInfo * info)
         self->process = volume_process_int8;
       }
       self->process_controlled = volume_process_controlled_int8_clamp;
+      self->have_controlled_2ch = TRUE;
       break;
     case GST_AUDIO_FORMAT_F32:
       self->process = volume_process_float;
       self->process_controlled = volume_process_controlled_float;
+      self->have_controlled_2ch = TRUE;
       break;
     case GST_AUDIO_FORMAT_F64:
       self->process = volume_process_double;
@@ -268,6 +284,7 @@ volume_update_volume (GstVolume * self, const GstAudioInfo * info,
    * else in the middle of a buffer.
    */
   passthrough &= !gst_object_has_active_control_bindings (GST_OBJECT (self));
+  passthrough &= !self->have_channel_volumes;
 
   GST_DEBUG_OBJECT (self, "set passthrough %d", passthrough);
 
@@ -278,6 +295,37 @@ volume_update_volume (GstVolume * self, const GstAudioInfo * info,
   return res;
 }
 
+/* Called with the object lock */
+static void
+volume_update_channel_volumes (GstVolume * self, const GstAudioInfo * info)
+{
+  guint channels = GST_AUDIO_INFO_CHANNELS (info);
+  guint i;
+
+  if (self->current_channels != channels) {
+    g_free (self->current_channel_volumes);
+    self->current_channel_volumes = g_new (gdouble, channels);
+    self->current_channels = channels;
+  }
+
+  /* channels without a configured volume are left as they are */
+  self->have_channel_volumes = FALSE;
+  for (i = 0; i < channels; i++) {
+    if (i < self->n_channel_volumes)
+      self->current_channel_volumes[i] = self->channel_volumes[i];
+    else
+      self->current_channel_volumes[i] = 1.0;
+
+    if (self->current_channel_volumes[i] != 1.0)
+      self->have_channel_volumes = TRUE;
+  }
+
+  self->channel_volumes_changed = FALSE;
+
+  GST_DEBUG_OBJECT (self, "have channel volumes %d",
+      self->have_channel_volumes);
+}
+
 /* Element class */
 
 static void
@@ -292,6 +340,14 @@ gst_volume_dispose (GObject * object)
     volume->tracklist = NULL;
   }
 
+  g_free (volume->channel_volumes);
+  volume->channel_volumes = NULL;
+  volume->n_channel_volumes = 0;
+
+  g_free (volume->current_channel_volumes);
+  volume->current_channel_volumes = NULL;
+  volume->current_channels = 0;
+
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
 
@@ -323,6 +379,22 @@ gst_volume_class_init (GstVolumeClass * klass)
           0.0, VOLUME_MAX_DOUBLE, DEFAULT_PROP_VOLUME,
           G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVolume:channel-volumes:
+   *
+   * Volume factors for each channel, applied on top of #GstVolume:volume.
+   * Channels without an entry in the array keep their volume.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_CHANNEL_VOLUMES,
+      gst_param_spec_array ("channel-volumes", "Channel Volumes",
+          "Volume factors for each channel, 1.0=100%",
+          g_param_spec_double ("channel-volume", "Channel Volume",
+              "Volume factor of a channel", 0.0, VOLUME_MAX_DOUBLE,
+              DEFAULT_PROP_VOLUME, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS),
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (element_class, "Volume",
       "Filter/Effect/Audio",
       "Set volume on audio/raw streams", "Andy Wingo <wingo@pobox.com>");
@@ -533,6 +605,29 @@ volume_process_controlled_int24_clamp (GstVolume * self, gpointer bytes,
   guint num_samples = n_bytes / (sizeof (gint8) * 3 * channels);
   gdouble vol, val;
 
+  if (channels == 1) {
+    gint32 samples[VOLUME_BLOCK_FRAMES];
+
+    /* unpack into the upper 24 bits of 32 bit samples so that the saturation
+     * of the int32 kernel clamps to the 24 bit range */
+    while (num_samples > 0) {
+      guint n = MIN (num_samples, VOLUME_BLOCK_FRAMES);
+      gint8 *in = data;
+
+      for (i = 0; i < n; i++, in += 3)
+        samples[i] = (gint32) (((guint32) get_unaligned_i24 (in)) << 8);
+
+      volume_orc_process_controlled_int32_1ch (samples, volume, n);
+
+      for (i = 0; i < n; i++)
+        write_unaligned_u24 (data, samples[i] >> 8);
+
+      volume += n;
+      num_samples -= n;
+    }
+    return;
+  }
+
   for (i = 0; i < num_samples; i++) {
     vol = *volume++;
     for (j = 0; j < channels; j++) {
@@ -639,6 +734,63 @@ volume_process_controlled_int8_clamp (GstVolume * self, gpointer bytes,
   }
 }
 
+/* Apply one gain per frame in @volumes, multiplied with the per-channel
+ * gains. Mono and stereo without per-channel gains map directly to the
+ * vectorized kernels, everything else is processed in blocks of
+ * VOLUME_BLOCK_FRAMES for which the per-sample gains are expanded first, so
+ * that the single channel kernels can be used for any channel count.
+ * @planes are the planes of a mapped #GstAudioBuffer */
+static void
+volume_process_controlled_frames (GstVolume * self, gpointer * planes,
+    const gdouble * volumes, guint n_frames)
+{
+  const GstAudioInfo *info = GST_AUDIO_FILTER_INFO (self);
+  guint channels = GST_AUDIO_INFO_CHANNELS (info);
+  guint bps = GST_AUDIO_INFO_WIDTH (info) / 8;
+  gboolean interleaved =
+      GST_AUDIO_INFO_LAYOUT (info) == GST_AUDIO_LAYOUT_INTERLEAVED;
+  const gdouble *channel_volumes = self->current_channel_volumes;
+  guint offset, i, j;
+
+  if (!self->have_channel_volumes && (channels == 1 || (channels == 2
+              && interleaved && self->have_controlled_2ch))) {
+    self->process_controlled (self, planes[0], (gdouble *) volumes, channels,
+        n_frames * bps * channels);
+    return;
+  }
+
+  if (self->gains_count < VOLUME_BLOCK_FRAMES * channels) {
+    self->gains_count = VOLUME_BLOCK_FRAMES * channels;
+    self->gains = g_renew (gdouble, self->gains, self->gains_count);
+  }
+
+  for (offset = 0; offset < n_frames; offset += VOLUME_BLOCK_FRAMES) {
+    guint n = MIN (VOLUME_BLOCK_FRAMES, n_frames - offset);
+    gdouble *gains = self->gains;
+
+    if (interleaved) {
+      for (i = 0; i < n; i++) {
+        gdouble vol = volumes[offset + i];
+
+        for (j = 0; j < channels; j++)
+          *gains++ = vol * channel_volumes[j];
+      }
+
+      self->process_controlled (self,
+          (guint8 *) planes[0] + offset * bps * channels, self->gains, 1,
+          n * bps * channels);
+    } else {
+      for (j = 0; j < channels; j++) {
+        for (i = 0; i < n; i++)
+          gains[i] = volumes[offset + i] * channel_volumes[j];
+
+        self->process_controlled (self, (guint8 *) planes[j] + offset * bps,
+            gains, 1, n * bps);
+      }
+    }
+  }
+}
+
 /* GstBaseTransform vmethod implementations */
 
 /* get notified of caps and plug in the correct process function */
@@ -653,6 +805,7 @@ volume_setup (GstAudioFilter * filter, const GstAudioInfo * info)
   GST_OBJECT_LOCK (self);
   volume = self->volume;
   mute = self->mute;
+  volume_update_channel_volumes (self, info);
   GST_OBJECT_UNLOCK (self);
 
   res = volume_update_volume (self, info, volume, mute);
@@ -678,6 +831,10 @@ volume_stop (GstBaseTransform * base)
   self->mutes = NULL;
   self->mutes_count = 0;
 
+  g_free (self->gains);
+  self->gains = NULL;
+  self->gains_count = 0;
+
   return GST_CALL_PARENT_WITH_DEFAULT (GST_BASE_TRANSFORM_CLASS, stop, (base),
       TRUE);
 }
@@ -689,6 +846,7 @@ volume_before_transform (GstBaseTransform * base, GstBuffer * buffer)
   GstVolume *self = GST_VOLUME (base);
   gdouble volume;
   gboolean mute;
+  gboolean channel_volumes_changed;
 
   timestamp = GST_BUFFER_TIMESTAMP (buffer);
   timestamp =
@@ -704,9 +862,13 @@ volume_before_transform (GstBaseTransform * base, GstBuffer * buffer)
   GST_OBJECT_LOCK (self);
   volume = self->volume;
   mute = self->mute;
+  channel_volumes_changed = self->channel_volumes_changed;
+  if (channel_volumes_changed && self->negotiated)
+    volume_update_channel_volumes (self, GST_AUDIO_FILTER_INFO (self));
   GST_OBJECT_UNLOCK (self);
 
-  if ((volume != self->current_volume) || (mute != self->current_mute)) {
+  if ((volume != self->current_volume) || (mute != self->current_mute)
+      || channel_volumes_changed) {
     /* the volume or mute was updated, update our internal state before
      * we continue processing. */
     volume_update_volume (self, GST_AUDIO_FILTER_INFO (self), volume, mute);
@@ -722,8 +884,9 @@ volume_transform_ip (GstBaseTransform * base, GstBuffer * outbuf)
 {
   GstAudioFilter *filter = GST_AUDIO_FILTER_CAST (base);
   GstVolume *self = GST_VOLUME (base);
-  GstMapInfo map;
+  GstAudioBuffer abuf;
   GstClockTime ts;
+  guint i;
 
   if (G_UNLIKELY (!self->negotiated))
     goto not_negotiated;
@@ -732,7 +895,8 @@ volume_transform_ip (GstBaseTransform * base, GstBuffer * outbuf)
   if (GST_BUFFER_FLAG_IS_SET (outbuf, GST_BUFFER_FLAG_GAP))
     return GST_FLOW_OK;
 
-  gst_buffer_map (outbuf, &map, GST_MAP_READWRITE);
+  if (!gst_audio_buffer_map (&abuf, &filter->info, outbuf, GST_MAP_READWRITE))
+    goto map_failed;
   ts = GST_BUFFER_TIMESTAMP (outbuf);
   ts = gst_segment_to_stream_time (&base->segment, GST_FORMAT_TIME, ts);
 
@@ -744,9 +908,7 @@ volume_transform_ip (GstBaseTransform * base, GstBuffer * outbuf)
 
     if (mute_cb || (volume_cb && !self->current_mute)) {
       gint rate = GST_AUDIO_INFO_RATE (&filter->info);
-      gint width = GST_AUDIO_FORMAT_INFO_WIDTH (filter->info.finfo) / 8;
-      gint channels = GST_AUDIO_INFO_CHANNELS (&filter->info);
-      guint nsamples = map.size / (width * channels);
+      guint nsamples = abuf.n_samples;
       GstClockTime interval = gst_util_uint64_scale_int (1, GST_SECOND, rate);
       gboolean have_mutes = FALSE;
       gboolean have_volumes = FALSE;
@@ -784,8 +946,8 @@ volume_transform_ip (GstBaseTransform * base, GstBuffer * outbuf)
         self->mutes_count = 0;
       }
 
-      self->process_controlled (self, map.data, self->volumes, channels,
-          map.size);
+      volume_process_controlled_frames (self, abuf.planes, self->volumes,
+          nsamples);
 
       goto done;
     } else if (volume_cb) {
@@ -794,14 +956,26 @@ volume_transform_ip (GstBaseTransform * base, GstBuffer * outbuf)
   }
 
   if (self->current_volume == 0.0 || self->current_mute) {
-    orc_memset (map.data, 0, map.size);
+    for (i = 0; i < abuf.n_planes; i++)
+      orc_memset (abuf.planes[i], 0, GST_AUDIO_BUFFER_PLANE_SIZE (&abuf));
     GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_GAP);
+  } else if (self->have_channel_volumes) {
+    guint nsamples = abuf.n_samples;
+
+    if (self->volumes_count < nsamples) {
+      self->volumes = g_realloc (self->volumes, sizeof (gdouble) * nsamples);
+      self->volumes_count = nsamples;
+    }
+    volume_orc_memset_f64 (self->volumes, self->current_volume, nsamples);
+    volume_process_controlled_frames (self, abuf.planes, self->volumes,
+        nsamples);
   } else if (self->current_volume != 1.0) {
-    self->process (self, map.data, map.size);
+    for (i = 0; i < abuf.n_planes; i++)
+      self->process (self, abuf.planes[i], GST_AUDIO_BUFFER_PLANE_SIZE (&abuf));
   }
 
 done:
-  gst_buffer_unmap (outbuf, &map);
+  gst_audio_buffer_unmap (&abuf);
 
   return GST_FLOW_OK;
 
@@ -812,6 +986,12 @@ not_negotiated:
         ("No format was negotiated"), (NULL));
     return GST_FLOW_NOT_NEGOTIATED;
   }
+map_failed:
+  {
+    GST_ELEMENT_ERROR (self, STREAM, FORMAT, (NULL),
+        ("failed to map buffer"));
+    return GST_FLOW_ERROR;
+  }
 }
 
 static void
@@ -831,6 +1011,20 @@ volume_set_property (GObject * object, guint prop_id, const GValue * value,
       self->volume = g_value_get_double (value);
       GST_OBJECT_UNLOCK (self);
       break;
+    case PROP_CHANNEL_VOLUMES:{
+      guint i, n = gst_value_array_get_size (value);
+
+      GST_OBJECT_LOCK (self);
+      g_free (self->channel_volumes);
+      self->channel_volumes = n ? g_new (gdouble, n) : NULL;
+      self->n_channel_volumes = n;
+      for (i = 0; i < n; i++)
+        self->channel_volumes[i] =
+            g_value_get_double (gst_value_array_get_value (value, i));
+      self->channel_volumes_changed = TRUE;
+      GST_OBJECT_UNLOCK (self);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -854,6 +1048,20 @@ volume_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_double (value, self->volume);
       GST_OBJECT_UNLOCK (self);
       break;
+    case PROP_CHANNEL_VOLUMES:{
+      GValue v = G_VALUE_INIT;
+      guint i;
+
+      g_value_init (&v, G_TYPE_DOUBLE);
+      GST_OBJECT_LOCK (self);
+      for (i = 0; i < self->n_channel_volumes; i++) {
+        g_value_set_double (&v, self->channel_volumes[i]);
+        gst_value_array_append_value (value, &v);
+      }
+      GST_OBJECT_UNLOCK (self);
+      g_value_unset (&v);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -64,6 +64,22 @@ struct _GstVolume {
   guint mutes_count;
   gdouble *volumes;
   guint volumes_count;
+
+  /* per-channel gains, protected by the object lock */
+  gdouble *channel_volumes;
+  guint n_channel_volumes;
+  gboolean channel_volumes_changed;
+
+  /* per-channel gains for the negotiated channels, used when streaming */
+  gdouble *current_channel_volumes;
+  guint current_channels;
+  gboolean have_channel_volumes;
+  /* TRUE if process_controlled has a vectorized stereo kernel */
+  gboolean have_controlled_2ch;
+
+  /* per-sample gains of one block of frames */
+  gdouble *gains;
+  guint gains_count;
 };
 
 G_END_DECLS
@@ -714,6 +714,200 @@ GST_START_TEST (test_pull_sample_refcounts)
 
 GST_END_TEST;
 
+GST_START_TEST (test_pull_sample_reuse)
+{
+  GstElement *sink;
+  GstBuffer *buffer, *pushed[20];
+  GstSample *samples[20];
+  guint i;
+
+  sink = setup_appsink ();
+  /* only the samples may hold references to the buffers */
+  g_object_set (sink, "enable-last-sample", FALSE, NULL);
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  /* more samples than appsink caches, released one after the other */
+  for (i = 0; i < 20; i++) {
+    pushed[i] = gst_buffer_new_and_alloc (i + 1);
+    fail_unless (gst_pad_push (mysrcpad,
+            gst_buffer_ref (pushed[i])) == GST_FLOW_OK);
+
+    samples[i] = gst_app_sink_pull_sample (GST_APP_SINK (sink));
+    fail_unless (samples[i] != NULL);
+    fail_unless (gst_sample_get_buffer (samples[i]) == pushed[i]);
+    fail_unless (gst_sample_get_caps (samples[i]) != NULL);
+    gst_sample_unref (samples[i]);
+
+    /* the released sample doesn't keep the buffer alive */
+    ASSERT_MINI_OBJECT_REFCOUNT (pushed[i], "buffer", 1);
+    gst_buffer_unref (pushed[i]);
+  }
+
+  /* more samples than appsink caches, all held at the same time */
+  for (i = 0; i < 20; i++) {
+    pushed[i] = gst_buffer_new_and_alloc (i + 1);
+    fail_unless (gst_pad_push (mysrcpad,
+            gst_buffer_ref (pushed[i])) == GST_FLOW_OK);
+  }
+  for (i = 0; i < 20; i++) {
+    samples[i] = gst_app_sink_pull_sample (GST_APP_SINK (sink));
+    fail_unless (samples[i] != NULL);
+    fail_unless (gst_sample_get_buffer (samples[i]) == pushed[i]);
+  }
+  for (i = 0; i < 20; i++) {
+    gst_sample_unref (samples[i]);
+    ASSERT_MINI_OBJECT_REFCOUNT (pushed[i], "buffer", 1);
+    gst_buffer_unref (pushed[i]);
+  }
+
+  /* and reused again */
+  for (i = 0; i < 20; i++) {
+    buffer = gst_buffer_new_and_alloc (4);
+    fail_unless (gst_pad_push (mysrcpad,
+            gst_buffer_ref (buffer)) == GST_FLOW_OK);
+    samples[i] = gst_app_sink_pull_sample (GST_APP_SINK (sink));
+    fail_unless (gst_sample_get_buffer (samples[i]) == buffer);
+    fail_unless (gst_sample_get_buffer_list (samples[i]) == NULL);
+    gst_buffer_unref (buffer);
+  }
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_appsink (sink);
+
+  /* samples can outlive appsink */
+  for (i = 0; i < 20; i++)
+    gst_sample_unref (samples[i]);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_pull_samples)
+{
+  GstElement *sink;
+  GstBuffer *buffer;
+  GstSample *samples[3];
+  guint i, n;
+
+  sink = setup_appsink ();
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  for (i = 0; i < 5; i++) {
+    buffer = gst_buffer_new_and_alloc (i + 1);
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  n = gst_app_sink_try_pull_samples (GST_APP_SINK (sink), samples, 3, 0);
+  fail_unless_equals_int (n, 3);
+  for (i = 0; i < n; i++) {
+    fail_unless (gst_buffer_get_size (gst_sample_get_buffer (samples[i])) ==
+        i + 1);
+    fail_unless (gst_sample_get_caps (samples[i]) != NULL);
+  }
+  /* all samples are in use, so they must be different */
+  fail_unless (samples[0] != samples[1] && samples[1] != samples[2]);
+  for (i = 0; i < n; i++)
+    gst_sample_unref (samples[i]);
+
+  n = gst_app_sink_try_pull_samples (GST_APP_SINK (sink), samples, 3, 0);
+  fail_unless_equals_int (n, 2);
+  for (i = 0; i < n; i++) {
+    fail_unless (gst_buffer_get_size (gst_sample_get_buffer (samples[i])) ==
+        i + 4);
+    gst_sample_unref (samples[i]);
+  }
+
+  n = gst_app_sink_try_pull_samples (GST_APP_SINK (sink), samples, 3, 0);
+  fail_unless_equals_int (n, 0);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_appsink (sink);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_pull_buffer)
+{
+  GstElement *sink;
+  GstBuffer *buffer;
+  guint i;
+
+  sink = setup_appsink ();
+  gst_app_sink_set_buffer_list_support (GST_APP_SINK (sink), TRUE);
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  buffer = gst_buffer_new_and_alloc (4);
+  fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  fail_unless (gst_pad_push_list (mysrcpad,
+          create_buffer_list ()) == GST_FLOW_OK);
+
+  buffer = gst_app_sink_try_pull_buffer (GST_APP_SINK (sink), 0);
+  fail_unless (buffer != NULL);
+  fail_unless_equals_int (gst_buffer_get_size (buffer), 4);
+  gst_buffer_unref (buffer);
+
+  /* the buffers of the list are returned one by one */
+  for (i = 0; i < G_N_ELEMENTS (values); i++) {
+    buffer = gst_app_sink_try_pull_buffer (GST_APP_SINK (sink), 0);
+    fail_unless (buffer != NULL);
+    gst_check_buffer_data (buffer, &values[i], sizeof (gint));
+    gst_buffer_unref (buffer);
+  }
+
+  buffer = gst_app_sink_try_pull_buffer (GST_APP_SINK (sink), 0);
+  fail_unless (buffer == NULL);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_appsink (sink);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_lock_free_drop)
+{
+  GstElement *sink;
+  GstBuffer *buffer;
+  GstSample *sample;
+  guint i;
+
+  sink = setup_appsink ();
+  g_object_set (sink, "lock-free", TRUE, "max-buffers", 2, "drop", TRUE, NULL);
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  /* the first buffer activates the caps */
+  buffer = gst_buffer_new_and_alloc (1);
+  fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  sample = gst_app_sink_try_pull_sample (GST_APP_SINK (sink), 0);
+  fail_unless (sample != NULL);
+  fail_unless (gst_sample_get_caps (sample) != NULL);
+  gst_sample_unref (sample);
+
+  /* the following buffers are queued without the lock until the queue is
+   * full, then the oldest ones are dropped */
+  for (i = 2; i <= 5; i++) {
+    buffer = gst_buffer_new_and_alloc (i);
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  for (i = 4; i <= 5; i++) {
+    sample = gst_app_sink_try_pull_sample (GST_APP_SINK (sink), 0);
+    fail_unless (sample != NULL);
+    fail_unless_equals_int (gst_buffer_get_size (gst_sample_get_buffer
+            (sample)), i);
+    gst_sample_unref (sample);
+  }
+
+  fail_unless (gst_app_sink_try_pull_sample (GST_APP_SINK (sink), 0) == NULL);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_appsink (sink);
+}
+
+GST_END_TEST;
+
 static Suite *
 appsink_suite (void)
 {
@@ -735,6 +929,10 @@ appsink_suite (void)
   tcase_add_test (tc_chain, test_pull_preroll);
   tcase_add_test (tc_chain, test_do_not_care_preroll);
   tcase_add_test (tc_chain, test_pull_sample_refcounts);
+  tcase_add_test (tc_chain, test_pull_sample_reuse);
+  tcase_add_test (tc_chain, test_pull_samples);
+  tcase_add_test (tc_chain, test_pull_buffer);
+  tcase_add_test (tc_chain, test_lock_free_drop);
 
   return s;
 }
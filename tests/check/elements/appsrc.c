@@ -1061,6 +1061,180 @@ GST_START_TEST (test_appsrc_custom_segment_twice)
 
 GST_END_TEST;
 
+static GstBufferList *received_list;
+
+static GstFlowReturn
+chainlist_store_func (GstPad * pad, GstObject * parent, GstBufferList * list)
+{
+  g_mutex_lock (&check_mutex);
+  fail_unless (received_list == NULL);
+  received_list = list;
+  g_cond_signal (&check_cond);
+  g_mutex_unlock (&check_mutex);
+
+  return GST_FLOW_OK;
+}
+
+GST_START_TEST (test_appsrc_push_buffer_frames)
+{
+  static const gsize offsets[] = { 2, 5, 5, 9 };
+  static const gsize sizes[] = { 3, 0, 4, 3 };
+  static const gsize outside[] = { 4, 13 };
+  static const gsize decreasing[] = { 4, 3 };
+  GstElement *src;
+  GstBuffer *buffer;
+  GstMapInfo map, sub_map;
+  guint8 data[12];
+  guint i;
+
+  for (i = 0; i < sizeof (data); i++)
+    data[i] = i;
+
+  src = setup_appsrc ();
+  gst_pad_set_chain_list_function (mysinkpad, chainlist_store_func);
+  received_list = NULL;
+
+  ASSERT_SET_STATE (src, GST_STATE_PLAYING, GST_STATE_CHANGE_SUCCESS);
+
+  buffer = gst_buffer_new_wrapped (g_memdup (data, sizeof (data)),
+      sizeof (data));
+  GST_BUFFER_PTS (buffer) = 10 * GST_SECOND;
+  GST_BUFFER_DURATION (buffer) = GST_SECOND;
+  GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DISCONT);
+
+  /* offsets outside of the buffer are rejected */
+  fail_unless_equals_int (gst_app_src_push_buffer_frames (GST_APP_SRC (src),
+          gst_buffer_ref (buffer), outside, 2), GST_FLOW_ERROR);
+  fail_unless_equals_int (gst_app_src_push_buffer_frames (GST_APP_SRC (src),
+          gst_buffer_ref (buffer), decreasing, 2), GST_FLOW_ERROR);
+
+  fail_unless_equals_int (gst_app_src_push_buffer_frames (GST_APP_SRC (src),
+          gst_buffer_ref (buffer), offsets, G_N_ELEMENTS (offsets)),
+      GST_FLOW_OK);
+
+  g_mutex_lock (&check_mutex);
+  while (received_list == NULL)
+    g_cond_wait (&check_cond, &check_mutex);
+  g_mutex_unlock (&check_mutex);
+
+  /* the frames arrive as one list and share the memory of the buffer */
+  fail_unless_equals_int (gst_buffer_list_length (received_list),
+      G_N_ELEMENTS (offsets));
+  fail_unless (gst_buffer_map (buffer, &map, GST_MAP_READ));
+  for (i = 0; i < G_N_ELEMENTS (offsets); i++) {
+    GstBuffer *sub = gst_buffer_list_get (received_list, i);
+
+    fail_unless_equals_int (gst_buffer_get_size (sub), sizes[i]);
+    if (sizes[i] == 0)
+      continue;
+    fail_unless (gst_buffer_map (sub, &sub_map, GST_MAP_READ));
+    fail_unless (sub_map.data == map.data + offsets[i]);
+    gst_buffer_unmap (sub, &sub_map);
+  }
+  gst_buffer_unmap (buffer, &map);
+
+  /* only the first frame carries timestamps and flags, even though it
+   * doesn't start at the beginning of the buffer */
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (gst_buffer_list_get
+          (received_list, 0)), 10 * GST_SECOND);
+  fail_unless_equals_uint64 (GST_BUFFER_DURATION (gst_buffer_list_get
+          (received_list, 0)), GST_SECOND);
+  fail_unless (GST_BUFFER_FLAG_IS_SET (gst_buffer_list_get (received_list, 0),
+          GST_BUFFER_FLAG_DISCONT));
+  for (i = 1; i < G_N_ELEMENTS (offsets); i++) {
+    GstBuffer *sub = gst_buffer_list_get (received_list, i);
+
+    fail_if (GST_BUFFER_PTS_IS_VALID (sub));
+    fail_if (GST_BUFFER_DURATION_IS_VALID (sub));
+    fail_if (GST_BUFFER_FLAG_IS_SET (sub, GST_BUFFER_FLAG_DISCONT));
+  }
+  fail_unless_equals_uint64 (gst_app_src_get_current_level_bytes (GST_APP_SRC
+          (src)), 0);
+
+  gst_buffer_list_unref (received_list);
+  gst_buffer_unref (buffer);
+
+  ASSERT_SET_STATE (src, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_appsrc (src);
+}
+
+GST_END_TEST;
+
+#define LOCK_FREE_THREADS 4
+#define LOCK_FREE_BUFFERS 250
+
+typedef struct
+{
+  GstAppSrc *src;
+  guint id;
+} PushThreadData;
+
+static gpointer
+lock_free_push_thread (gpointer user_data)
+{
+  PushThreadData *data = user_data;
+  guint i;
+
+  for (i = 0; i < LOCK_FREE_BUFFERS; i++) {
+    GstBuffer *buf = gst_buffer_new_and_alloc (1);
+
+    GST_BUFFER_OFFSET (buf) = data->id * LOCK_FREE_BUFFERS + i;
+    fail_unless_equals_int (gst_app_src_push_buffer (data->src, buf),
+        GST_FLOW_OK);
+  }
+
+  return NULL;
+}
+
+GST_START_TEST (test_appsrc_lock_free_push)
+{
+  GstElement *src;
+  GThread *threads[LOCK_FREE_THREADS];
+  PushThreadData data[LOCK_FREE_THREADS];
+  guint64 last_offset[LOCK_FREE_THREADS];
+  GList *l;
+  guint i;
+
+  src = setup_appsrc ();
+  /* unlimited queue, every push can take the lock-free path */
+  g_object_set (src, "lock-free", TRUE, "max-bytes", (guint64) 0, NULL);
+
+  ASSERT_SET_STATE (src, GST_STATE_PLAYING, GST_STATE_CHANGE_SUCCESS);
+
+  for (i = 0; i < LOCK_FREE_THREADS; i++) {
+    data[i].src = GST_APP_SRC (src);
+    data[i].id = i;
+    threads[i] = g_thread_new ("push", lock_free_push_thread, &data[i]);
+  }
+  for (i = 0; i < LOCK_FREE_THREADS; i++)
+    g_thread_join (threads[i]);
+
+  g_mutex_lock (&check_mutex);
+  while (g_list_length (buffers) < LOCK_FREE_THREADS * LOCK_FREE_BUFFERS)
+    g_cond_wait (&check_cond, &check_mutex);
+  g_mutex_unlock (&check_mutex);
+
+  /* all buffers arrived and the ones of each thread are in order */
+  for (i = 0; i < LOCK_FREE_THREADS; i++)
+    last_offset[i] = GST_BUFFER_OFFSET_NONE;
+  for (l = buffers; l; l = l->next) {
+    guint64 offset = GST_BUFFER_OFFSET (l->data);
+    guint thread_id = offset / LOCK_FREE_BUFFERS;
+
+    fail_unless (thread_id < LOCK_FREE_THREADS);
+    if (last_offset[thread_id] != GST_BUFFER_OFFSET_NONE)
+      fail_unless (offset == last_offset[thread_id] + 1);
+    last_offset[thread_id] = offset;
+  }
+  fail_unless_equals_uint64 (gst_app_src_get_current_level_bytes (GST_APP_SRC
+          (src)), 0);
+
+  ASSERT_SET_STATE (src, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_appsrc (src);
+}
+
+GST_END_TEST;
+
 static Suite *
 appsrc_suite (void)
 {
@@ -1074,6 +1248,8 @@ appsrc_suite (void)
   tcase_add_test (tc_chain, test_appsrc_push_buffer_list);
   tcase_add_test (tc_chain, test_appsrc_period_with_custom_segment);
   tcase_add_test (tc_chain, test_appsrc_custom_segment_twice);
+  tcase_add_test (tc_chain, test_appsrc_lock_free_push);
+  tcase_add_test (tc_chain, test_appsrc_push_buffer_frames);
 
   if (RUNNING_ON_VALGRIND)
     tcase_add_loop_test (tc_chain, test_appsrc_block_deadlock, 0, 5);
@@ -1947,6 +1947,145 @@ GST_START_TEST (test_change_output_caps_mid_output_buffer)
 }
 
 GST_END_TEST;
+
+static GstBuffer *
+mix_test_sources (guint n_threads, guint n_sources)
+{
+  GstElement *bin, *audiomixer, *capsfilter, *sink;
+  GstBus *bus;
+  GstMessage *msg;
+  GstCaps *caps;
+  GstBuffer *result;
+  guint i;
+
+  bin = gst_pipeline_new ("pipeline");
+  audiomixer = gst_element_factory_make ("audiomixer", "audiomixer");
+  g_object_set (audiomixer, "n-threads", n_threads, NULL);
+  capsfilter = gst_element_factory_make ("capsfilter", NULL);
+  caps = gst_caps_new_simple ("audio/x-raw",
+      "format", G_TYPE_STRING, GST_AUDIO_NE (S16),
+      "layout", G_TYPE_STRING, "interleaved",
+      "rate", G_TYPE_INT, 44100, "channels", G_TYPE_INT, 2, NULL);
+  g_object_set (capsfilter, "caps", caps, NULL);
+  gst_caps_unref (caps);
+  sink = gst_element_factory_make ("fakesink", "sink");
+  g_object_set (sink, "signal-handoffs", TRUE, NULL);
+  g_signal_connect (sink, "handoff", (GCallback) handoff_buffer_cb, NULL);
+  gst_bin_add_many (GST_BIN (bin), audiomixer, capsfilter, sink, NULL);
+  fail_unless (gst_element_link_many (audiomixer, capsfilter, sink, NULL));
+
+  for (i = 0; i < n_sources; i++) {
+    GstElement *src = gst_element_factory_make ("audiotestsrc", NULL);
+    GstPad *srcpad, *sinkpad;
+
+    g_object_set (src, "num-buffers", 4, "volume", 0.05, "freq",
+        100.0 * (i + 1), NULL);
+    gst_bin_add (GST_BIN (bin), src);
+
+    sinkpad = gst_element_get_request_pad (audiomixer, "sink_%u");
+    /* exercise the volume path on every other pad */
+    if (i % 2)
+      g_object_set (sinkpad, "volume", 0.5, NULL);
+    srcpad = gst_element_get_static_pad (src, "src");
+    fail_unless (gst_pad_link (srcpad, sinkpad) == GST_PAD_LINK_OK);
+    gst_object_unref (srcpad);
+    gst_object_unref (sinkpad);
+  }
+
+  gst_buffer_replace (&handoff_buffer, NULL);
+
+  bus = gst_element_get_bus (bin);
+  fail_if (gst_element_set_state (bin,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE);
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  gst_element_set_state (bin, GST_STATE_NULL);
+  gst_object_unref (bus);
+  gst_object_unref (bin);
+
+  fail_unless (handoff_buffer != NULL);
+  result = handoff_buffer;
+  handoff_buffer = NULL;
+
+  return result;
+}
+
+/* Mixing with several threads must give the same result as mixing on the
+ * aggregator thread alone */
+GST_START_TEST (test_n_threads)
+{
+  GstBuffer *single, *threaded;
+  GstMapInfo map1, map2;
+
+  single = mix_test_sources (1, 16);
+  threaded = mix_test_sources (4, 16);
+
+  gst_buffer_map (single, &map1, GST_MAP_READ);
+  gst_buffer_map (threaded, &map2, GST_MAP_READ);
+  fail_unless_equals_int (map1.size, map2.size);
+  fail_unless (memcmp (map1.data, map2.data, map1.size) == 0);
+  gst_buffer_unmap (single, &map1);
+  gst_buffer_unmap (threaded, &map2);
+
+  gst_buffer_unref (single);
+  gst_buffer_unref (threaded);
+}
+
+GST_END_TEST;
+
+/* Digitally silent input is not mixed, the output is a GAP buffer */
+GST_START_TEST (test_silent_input)
+{
+  GstElement *bin, *audiomixer, *sink;
+  GstBus *bus;
+  GstMessage *msg;
+  GstMapInfo map;
+  gsize i;
+
+  bin = gst_pipeline_new ("pipeline");
+  audiomixer = gst_element_factory_make ("audiomixer", "audiomixer");
+  sink = gst_element_factory_make ("fakesink", "sink");
+  g_object_set (sink, "signal-handoffs", TRUE, NULL);
+  g_signal_connect (sink, "handoff", (GCallback) handoff_buffer_cb, NULL);
+  gst_bin_add_many (GST_BIN (bin), audiomixer, sink, NULL);
+  fail_unless (gst_element_link (audiomixer, sink));
+
+  for (i = 0; i < 2; i++) {
+    GstElement *src = gst_element_factory_make ("audiotestsrc", NULL);
+
+    g_object_set (src, "num-buffers", 4, NULL);
+    gst_util_set_object_arg (G_OBJECT (src), "wave", "silence");
+    gst_bin_add (GST_BIN (bin), src);
+    fail_unless (gst_element_link (src, audiomixer));
+  }
+
+  gst_buffer_replace (&handoff_buffer, NULL);
+
+  bus = gst_element_get_bus (bin);
+  fail_if (gst_element_set_state (bin,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE);
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  gst_element_set_state (bin, GST_STATE_NULL);
+  gst_object_unref (bus);
+  gst_object_unref (bin);
+
+  fail_unless (handoff_buffer != NULL);
+  fail_unless (GST_BUFFER_FLAG_IS_SET (handoff_buffer, GST_BUFFER_FLAG_GAP));
+  gst_buffer_map (handoff_buffer, &map, GST_MAP_READ);
+  fail_unless (map.size > 0);
+  for (i = 0; i < map.size; i++)
+    fail_unless_equals_int (map.data[i], 0);
+  gst_buffer_unmap (handoff_buffer, &map);
+  gst_clear_buffer (&handoff_buffer);
+}
+
+GST_END_TEST;
+
 static Suite *
 audiomixer_suite (void)
 {
@@ -1975,6 +2114,8 @@ audiomixer_suite (void)
   tcase_add_checked_fixture (tc_chain, test_setup, test_teardown);
   tcase_add_test (tc_chain, test_change_output_caps);
   tcase_add_test (tc_chain, test_change_output_caps_mid_output_buffer);
+  tcase_add_test (tc_chain, test_n_threads);
+  tcase_add_test (tc_chain, test_silent_input);
 
   /* Use a longer timeout */
 #ifdef HAVE_VALGRIND
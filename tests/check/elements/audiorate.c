@@ -453,6 +453,84 @@ GST_START_TEST (test_large_discont)
 GST_END_TEST;
 
 
+GST_START_TEST (test_gap_shares_silence)
+{
+  GstElement *audiorate;
+  GstCaps *caps;
+  GstPad *srcpad, *sinkpad;
+  GstBuffer *buf, *fill1, *fill2;
+  GstMemory *mem1, *mem2;
+  GstMapInfo map;
+  gsize i;
+
+  audiorate = gst_check_setup_element ("audiorate");
+  caps = gst_caps_new_simple ("audio/x-raw",
+      "format", G_TYPE_STRING, GST_AUDIO_NE (F32),
+      "layout", G_TYPE_STRING, "interleaved",
+      "channels", G_TYPE_INT, 1, "rate", G_TYPE_INT, 44100, NULL);
+
+  srcpad = gst_check_setup_src_pad (audiorate, &srctemplate);
+  sinkpad = gst_check_setup_sink_pad (audiorate, &sinktemplate);
+
+  gst_pad_set_active (srcpad, TRUE);
+
+  gst_check_setup_events (srcpad, audiorate, caps, GST_FORMAT_TIME);
+
+  gst_pad_set_active (sinkpad, TRUE);
+
+  fail_unless (gst_element_set_state (audiorate,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "failed to set audiorate playing");
+
+  buf = gst_buffer_new_and_alloc (4);
+  GST_BUFFER_TIMESTAMP (buf) = 0;
+  gst_pad_push (srcpad, buf);
+
+  buf = gst_buffer_new_and_alloc (4);
+  GST_BUFFER_TIMESTAMP (buf) = 2 * GST_SECOND;
+  gst_pad_push (srcpad, buf);
+  fail_unless_equals_int (g_list_length (buffers), 4);
+
+  /* both fillers reference the same read-only silence */
+  fill1 = g_list_nth_data (buffers, 1);
+  fill2 = g_list_nth_data (buffers, 2);
+  fail_unless (GST_BUFFER_FLAG_IS_SET (fill1, GST_BUFFER_FLAG_GAP));
+  fail_unless (GST_BUFFER_FLAG_IS_SET (fill2, GST_BUFFER_FLAG_GAP));
+  fail_unless_equals_int (gst_buffer_n_memory (fill1), 1);
+  fail_unless_equals_int (gst_buffer_n_memory (fill2), 1);
+  mem1 = gst_buffer_peek_memory (fill1, 0);
+  mem2 = gst_buffer_peek_memory (fill2, 0);
+  fail_unless (GST_MEMORY_IS_READONLY (mem1));
+  fail_unless (mem1->parent != NULL);
+  fail_unless (mem1->parent == mem2->parent);
+
+  fail_unless (gst_buffer_map (fill2, &map, GST_MAP_READ));
+  for (i = 0; i < map.size; i++)
+    fail_unless (map.data[i] == 0);
+  gst_buffer_unmap (fill2, &map);
+
+  /* writing gets a private copy */
+  fill2 = gst_buffer_make_writable (gst_buffer_ref (fill2));
+  fail_unless (gst_buffer_map (fill2, &map, GST_MAP_WRITE));
+  map.data[0] = 0xff;
+  gst_buffer_unmap (fill2, &map);
+  fail_unless (gst_buffer_map (fill1, &map, GST_MAP_READ));
+  fail_unless (map.data[0] == 0);
+  gst_buffer_unmap (fill1, &map);
+  gst_buffer_unref (fill2);
+
+  gst_element_set_state (audiorate, GST_STATE_NULL);
+  gst_caps_unref (caps);
+
+  gst_check_drop_buffers ();
+  gst_check_teardown_sink_pad (audiorate);
+  gst_check_teardown_src_pad (audiorate);
+
+  gst_object_unref (audiorate);
+}
+
+GST_END_TEST;
+
 #define FIRST_CAPS \
   "audio/x-raw,format=S16LE,layout=interleaved,rate=48000,channels=1"
 #define SECOND_CAPS \
@@ -580,6 +658,7 @@ audiorate_suite (void)
   tcase_add_test (tc_chain, test_perfect_stream_inject90);
   tcase_add_test (tc_chain, test_perfect_stream_drop45_inject25);
   tcase_add_test (tc_chain, test_large_discont);
+  tcase_add_test (tc_chain, test_gap_shares_silence);
   tcase_add_test (tc_chain, test_rate_change_down);
 
   return s;
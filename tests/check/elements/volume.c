@@ -26,6 +26,7 @@
 
 #include <gst/base/gstbasetransform.h>
 #include <gst/check/gstcheck.h>
+#include <gst/audio/audio.h>
 #include <gst/audio/streamvolume.h>
 #include <gst/controller/gstinterpolationcontrolsource.h>
 #include <gst/controller/gstdirectcontrolbinding.h>
@@ -60,7 +61,7 @@ static GstPad *mysrcpad, *mysinkpad;
     "format = (string) "FORMATS1", "    \
     "channels = (int) [ 1, MAX ], "     \
     "rate = (int) [ 1,  MAX ], "        \
-    "layout = (string) interleaved"
+    "layout = (string) { interleaved, non-interleaved }"
 
 #define VOLUME_CAPS_STRING_S8           \
     "audio/x-raw, "                     \
@@ -104,6 +105,46 @@ static GstPad *mysrcpad, *mysinkpad;
     "rate = (int) 44100,"               \
     "layout = (string) interleaved"
 
+#define VOLUME_CAPS_STRING_S16_3CH      \
+    "audio/x-raw, "                     \
+    "format = (string) "FORMATS3", "   \
+    "channels = (int) 3, "              \
+    "channel-mask = (bitmask) 0x7, "    \
+    "rate = (int) 44100,"               \
+    "layout = (string) interleaved"
+
+#define VOLUME_CAPS_STRING_S24_3CH      \
+    "audio/x-raw, "                     \
+    "format = (string) "FORMATS4", "   \
+    "channels = (int) 3, "              \
+    "channel-mask = (bitmask) 0x7, "    \
+    "rate = (int) 44100,"               \
+    "layout = (string) interleaved"
+
+#define VOLUME_CAPS_STRING_S32_2CH      \
+    "audio/x-raw, "                     \
+    "format = (string) "FORMATS5", "   \
+    "channels = (int) 2, "              \
+    "channel-mask = (bitmask) 0x3, "    \
+    "rate = (int) 44100,"               \
+    "layout = (string) interleaved"
+
+#define VOLUME_CAPS_STRING_F32_2CH      \
+    "audio/x-raw, "                     \
+    "format = (string) "FORMATS6", "   \
+    "channels = (int) 2, "              \
+    "channel-mask = (bitmask) 0x3, "    \
+    "rate = (int) 44100,"               \
+    "layout = (string) interleaved"
+
+#define VOLUME_CAPS_STRING_S16_2CH_PLANAR \
+    "audio/x-raw, "                     \
+    "format = (string) "FORMATS3", "   \
+    "channels = (int) 2, "              \
+    "channel-mask = (bitmask) 0x3, "    \
+    "rate = (int) 44100,"               \
+    "layout = (string) non-interleaved"
+
 #define VOLUME_WRONG_CAPS_STRING        \
     "audio/x-raw, "                     \
     "format = (string) "FORMATS8", "   \
@@ -1644,6 +1685,240 @@ GST_START_TEST (test_mute_f64)
 
 GST_END_TEST;
 
+GST_START_TEST (test_channel_volumes_s16)
+{
+  GstElement *volume;
+  GstBuffer *inbuffer;
+  GstBuffer *outbuffer;
+  GstCaps *caps;
+  gint16 in[6] = { 1024, 1024, 1024, -512, -512, -512 };
+  gint16 out[6] = { 512, 256, 1024, -256, -128, -512 };
+  GstMapInfo map;
+
+  volume = setup_volume ();
+  g_object_set (G_OBJECT (volume), "volume", 0.5, NULL);
+  gst_util_set_object_arg (G_OBJECT (volume), "channel-volumes",
+      "<1.0, 0.5, 2.0>");
+  fail_unless (gst_element_set_state (volume,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  inbuffer = gst_buffer_new_and_alloc (12);
+  gst_buffer_fill (inbuffer, 0, in, 12);
+  caps = gst_caps_from_string (VOLUME_CAPS_STRING_S16_3CH);
+  gst_check_setup_events (mysrcpad, volume, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+  ASSERT_BUFFER_REFCOUNT (inbuffer, "inbuffer", 1);
+
+  fail_unless (gst_pad_push (mysrcpad, inbuffer) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 1);
+  fail_if ((outbuffer = (GstBuffer *) buffers->data) == NULL);
+  gst_buffer_map (outbuffer, &map, GST_MAP_READ);
+  fail_unless (memcmp (map.data, out, 12) == 0);
+  gst_buffer_unmap (outbuffer, &map);
+
+  /* cleanup */
+  cleanup_volume (volume);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_channel_volumes_s24)
+{
+  GstElement *volume;
+  GstBuffer *inbuffer;
+  GstBuffer *outbuffer;
+  GstCaps *caps;
+  gint32 in_32[6] = { 4194304, 4194304, 4194304, -4096, -4096, -4096 };
+  /* the third channel clamps */
+  gint32 out_32[6] = { 2097152, 1048576, 8388607, -2048, -1024, -8192 };
+  gint32 res_32[6];
+  guint8 in[18];
+  GstMapInfo map;
+  gint i;
+
+  for (i = 0; i < 6; i++)
+    write_unaligned_u24 (in + i * 3, in_32[i]);
+
+  volume = setup_volume ();
+  g_object_set (G_OBJECT (volume), "volume", 0.5, NULL);
+  gst_util_set_object_arg (G_OBJECT (volume), "channel-volumes",
+      "<1.0, 0.5, 4.0>");
+  fail_unless (gst_element_set_state (volume,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  inbuffer = gst_buffer_new_and_alloc (18);
+  gst_buffer_fill (inbuffer, 0, in, 18);
+  caps = gst_caps_from_string (VOLUME_CAPS_STRING_S24_3CH);
+  gst_check_setup_events (mysrcpad, volume, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+  ASSERT_BUFFER_REFCOUNT (inbuffer, "inbuffer", 1);
+
+  fail_unless (gst_pad_push (mysrcpad, inbuffer) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 1);
+  fail_if ((outbuffer = (GstBuffer *) buffers->data) == NULL);
+  gst_buffer_map (outbuffer, &map, GST_MAP_READ);
+  for (i = 0; i < 6; i++)
+    res_32[i] = get_unaligned_i24 (map.data + i * 3);
+  gst_buffer_unmap (outbuffer, &map);
+
+  for (i = 0; i < 6; i++)
+    fail_unless_equals_int (res_32[i], out_32[i]);
+
+  /* cleanup */
+  cleanup_volume (volume);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_channel_volumes_s32)
+{
+  GstElement *volume;
+  GstBuffer *inbuffer;
+  GstBuffer *outbuffer;
+  GstCaps *caps;
+  gint32 in[4] = { 1048576, 1048576, -65536, G_MAXINT32 / 2 + 1 };
+  /* the last sample clamps */
+  gint32 out[4] = { 524288, 2097152, -32768, G_MAXINT32 };
+  GstMapInfo map;
+
+  volume = setup_volume ();
+  gst_util_set_object_arg (G_OBJECT (volume), "channel-volumes",
+      "<0.5, 2.0>");
+  fail_unless (gst_element_set_state (volume,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  inbuffer = gst_buffer_new_and_alloc (16);
+  gst_buffer_fill (inbuffer, 0, in, 16);
+  caps = gst_caps_from_string (VOLUME_CAPS_STRING_S32_2CH);
+  gst_check_setup_events (mysrcpad, volume, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+  ASSERT_BUFFER_REFCOUNT (inbuffer, "inbuffer", 1);
+
+  fail_unless (gst_pad_push (mysrcpad, inbuffer) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 1);
+  fail_if ((outbuffer = (GstBuffer *) buffers->data) == NULL);
+  gst_buffer_map (outbuffer, &map, GST_MAP_READ);
+  fail_unless (memcmp (map.data, out, 16) == 0);
+  gst_buffer_unmap (outbuffer, &map);
+
+  /* cleanup */
+  cleanup_volume (volume);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_channel_volumes_f32)
+{
+  GstElement *volume;
+  GstBuffer *inbuffer;
+  GstBuffer *outbuffer;
+  GstCaps *caps;
+  gfloat in[4] = { 1.0, 1.0, -0.5, -0.5 };
+  gfloat out[4] = { 0.5, 0.125, -0.25, -0.0625 };
+  gfloat *res;
+  GstMapInfo map;
+  gint i;
+
+  volume = setup_volume ();
+  g_object_set (G_OBJECT (volume), "volume", 0.5, NULL);
+  gst_util_set_object_arg (G_OBJECT (volume), "channel-volumes",
+      "<1.0, 0.25>");
+  fail_unless (gst_element_set_state (volume,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  inbuffer = gst_buffer_new_and_alloc (16);
+  gst_buffer_fill (inbuffer, 0, in, 16);
+  caps = gst_caps_from_string (VOLUME_CAPS_STRING_F32_2CH);
+  gst_check_setup_events (mysrcpad, volume, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+  ASSERT_BUFFER_REFCOUNT (inbuffer, "inbuffer", 1);
+
+  fail_unless (gst_pad_push (mysrcpad, inbuffer) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 1);
+  fail_if ((outbuffer = (GstBuffer *) buffers->data) == NULL);
+  gst_buffer_map (outbuffer, &map, GST_MAP_READ);
+  res = (gfloat *) map.data;
+  for (i = 0; i < 4; i++)
+    fail_unless_equals_float (res[i], out[i]);
+  gst_buffer_unmap (outbuffer, &map);
+
+  /* cleanup */
+  cleanup_volume (volume);
+}
+
+GST_END_TEST;
+
+/* pushes two frames of planar stereo S16 with the planes in reverse order and
+ * a gap between them, and checks the planes against @out_l and @out_r */
+static void
+push_planar_s16 (GstAudioInfo * info, const gint16 out_l[2],
+    const gint16 out_r[2])
+{
+  GstBuffer *inbuffer, *outbuffer;
+  gint16 in[6] = { 1024, -512, 1000, 1000, 1024, -512 };
+  gsize offsets[2] = { 8, 0 };
+  GstMapInfo map;
+  gint16 *res;
+
+  inbuffer = gst_buffer_new_and_alloc (12);
+  gst_buffer_fill (inbuffer, 0, in, 12);
+  gst_buffer_add_audio_meta (inbuffer, info, 2, offsets);
+
+  fail_unless (gst_pad_push (mysrcpad, inbuffer) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 1);
+  fail_if ((outbuffer = (GstBuffer *) buffers->data) == NULL);
+  gst_buffer_map (outbuffer, &map, GST_MAP_READ);
+  res = (gint16 *) map.data;
+  fail_unless_equals_int (res[4], out_l[0]);
+  fail_unless_equals_int (res[5], out_l[1]);
+  fail_unless_equals_int (res[0], out_r[0]);
+  fail_unless_equals_int (res[1], out_r[1]);
+  /* the gap between the planes is left alone */
+  fail_unless_equals_int (res[2], 1000);
+  fail_unless_equals_int (res[3], 1000);
+  gst_buffer_unmap (outbuffer, &map);
+
+  gst_check_drop_buffers ();
+}
+
+GST_START_TEST (test_volume_s16_planar)
+{
+  GstElement *volume;
+  GstCaps *caps;
+  GstAudioInfo info;
+  const gint16 half[2] = { 512, -256 };
+  const gint16 quarter[2] = { 256, -128 };
+
+  volume = setup_volume ();
+  g_object_set (G_OBJECT (volume), "volume", 0.5, NULL);
+  gst_util_set_object_arg (G_OBJECT (volume), "channel-volumes",
+      "<1.0, 0.5>");
+  fail_unless (gst_element_set_state (volume,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  caps = gst_caps_from_string (VOLUME_CAPS_STRING_S16_2CH_PLANAR);
+  fail_unless (gst_audio_info_from_caps (&info, caps));
+  gst_check_setup_events (mysrcpad, volume, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+
+  /* per-channel gains */
+  push_planar_s16 (&info, half, quarter);
+
+  /* a single gain for all planes */
+  gst_util_set_object_arg (G_OBJECT (volume), "channel-volumes", "<>");
+  push_planar_s16 (&info, half, half);
+
+  /* cleanup */
+  cleanup_volume (volume);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_wrong_caps)
 {
   GstElement *volume;
@@ -1903,6 +2178,11 @@ volume_suite (void)
   tcase_add_test (tc_chain, test_double_f64);
   tcase_add_test (tc_chain, test_ten_f64);
   tcase_add_test (tc_chain, test_mute_f64);
+  tcase_add_test (tc_chain, test_channel_volumes_s16);
+  tcase_add_test (tc_chain, test_channel_volumes_s24);
+  tcase_add_test (tc_chain, test_channel_volumes_s32);
+  tcase_add_test (tc_chain, test_channel_volumes_f32);
+  tcase_add_test (tc_chain, test_volume_s16_planar);
   tcase_add_test (tc_chain, test_wrong_caps);
   tcase_add_test (tc_chain, test_passthrough);
   tcase_add_test (tc_chain, test_controller_usability);
@@ -28,6 +28,7 @@
 #include <fcntl.h>
 #include <gst/allocators/gstdmabuf.h>
 #include <gst/allocators/gstfdmemory.h>
+#include <gst/allocators/gstmemfdallocator.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -101,6 +102,174 @@ GST_START_TEST (test_fdmem)
 
 GST_END_TEST;
 
+static guint64
+get_stat (GstAllocator * alloc, const gchar * name)
+{
+  GstStructure *stats;
+  guint64 val = 0;
+
+  stats = gst_fd_allocator_get_stats (alloc);
+  fail_unless (gst_structure_get_uint64 (stats, name, &val));
+  gst_structure_free (stats);
+
+  return val;
+}
+
+GST_START_TEST (test_fdmem_cache_mapping)
+{
+  GstAllocator *alloc;
+  GstMemory *mem;
+  GstMapInfo info;
+  GError *error = NULL;
+  gpointer data;
+  int fd;
+
+  fd = g_file_open_tmp (NULL, NULL, &error);
+  fail_if (error);
+  fail_unless (ftruncate (fd, FILE_SIZE) == 0);
+
+  alloc = gst_fd_allocator_new ();
+  mem = gst_fd_allocator_alloc (alloc, fd, FILE_SIZE,
+      GST_FD_MEMORY_FLAG_CACHE_MAPPING | GST_FD_MEMORY_FLAG_DONT_CLOSE);
+
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_READ));
+  data = info.data;
+  gst_memory_unmap (mem, &info);
+
+  /* upgrading to write access reuses the mapping */
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_WRITE));
+  fail_unless (info.data == data);
+  info.data[0] = 'X';
+  gst_memory_unmap (mem, &info);
+
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_READ));
+  fail_unless (info.data == data);
+  fail_unless (info.data[0] == 'X');
+  gst_memory_unmap (mem, &info);
+
+  fail_unless_equals_uint64 (get_stat (alloc, "maps"), 3);
+  fail_unless_equals_uint64 (get_stat (alloc, "unmaps"), 3);
+  fail_unless_equals_uint64 (get_stat (alloc, "mmaps"), 1);
+  fail_unless_equals_uint64 (get_stat (alloc, "mprotects"), 0);
+  fail_unless_equals_uint64 (get_stat (alloc, "munmaps"), 0);
+
+  gst_memory_unref (mem);
+  fail_unless_equals_uint64 (get_stat (alloc, "munmaps"), 1);
+
+  fail_unless (g_close (fd, NULL) == 0);
+  gst_object_unref (alloc);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_dmabuf_sync_coalescing)
+{
+  char tmpfilename[] = "/tmp/dmabuf-test.XXXXXX";
+  int fd;
+  GstMemory *mem, *sub;
+  GstAllocator *alloc;
+  GstMapInfo info, sub_info;
+
+  fd = mkstemp (tmpfilename);
+  fail_unless (fd > 0);
+  fail_unless (g_unlink (tmpfilename) == 0);
+
+  alloc = gst_dmabuf_allocator_new ();
+  mem = gst_dmabuf_allocator_alloc (alloc, fd, FILE_SIZE);
+  sub = gst_memory_share (mem, 16, 16);
+
+  /* nested maps, also of shared memory, only sync once */
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_READ));
+  fail_unless (gst_memory_map (sub, &sub_info, GST_MAP_READ));
+  gst_memory_unmap (sub, &sub_info);
+  gst_memory_unmap (mem, &info);
+
+  fail_unless_equals_uint64 (get_stat (alloc, "syncs"), 2);
+  fail_unless_equals_uint64 (get_stat (alloc, "skipped-syncs"), 2);
+
+  /* sequential maps inside an open CPU access don't sync */
+  gst_dmabuf_memory_begin_cpu_access (mem, GST_MAP_READ);
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_READ));
+  gst_memory_unmap (mem, &info);
+  fail_unless (gst_memory_map (sub, &sub_info, GST_MAP_READ));
+  gst_memory_unmap (sub, &sub_info);
+  gst_dmabuf_memory_end_cpu_access (mem);
+
+  fail_unless_equals_uint64 (get_stat (alloc, "syncs"), 4);
+  fail_unless_equals_uint64 (get_stat (alloc, "skipped-syncs"), 6);
+
+  gst_memory_unref (sub);
+  gst_memory_unref (mem);
+  gst_object_unref (alloc);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_memfdmem)
+{
+  GstAllocator *alloc;
+  GstMemory *mem;
+  GstMapInfo info;
+
+  alloc = gst_memfd_allocator_new (GST_MEMFD_ALLOCATOR_FLAG_NONE, 1 << 20);
+  if (alloc == NULL) {
+    GST_INFO ("memfd not supported, skipping test");
+    return;
+  }
+
+  mem = gst_allocator_alloc (alloc, 1000, NULL);
+  fail_unless (mem);
+  fail_unless (gst_is_fd_memory (mem));
+  fail_unless (gst_is_memfd_memory (mem));
+  fail_unless_equals_int (mem->size, 1000);
+
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_WRITE));
+  memset (info.data, 'X', info.size);
+  gst_memory_unmap (mem, &info);
+
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_READ));
+  fail_unless (info.data[999] == 'X');
+  gst_memory_unmap (mem, &info);
+  gst_memory_unref (mem);
+
+  /* same size class, the pooled file is reused with its contents */
+  mem = gst_allocator_alloc (alloc, 900, NULL);
+  fail_unless (mem);
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_READ));
+  fail_unless (info.data[0] == 'X');
+  gst_memory_unmap (mem, &info);
+
+  /* once the fd was handed out the file is not reused anymore */
+  fail_unless (gst_fd_memory_get_fd (mem) >= 0);
+  gst_memory_unref (mem);
+
+  mem = gst_allocator_alloc (alloc, 900, NULL);
+  fail_unless (mem);
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_READ));
+  fail_unless (info.data[0] == 0);
+  gst_memory_unmap (mem, &info);
+
+  /* sealed memory is read-only and is not pooled again */
+  if (gst_memfd_memory_seal (mem)) {
+    fail_unless (GST_MEMORY_IS_READONLY (mem));
+    fail_if (gst_memory_map (mem, &info, GST_MAP_WRITE));
+    fail_unless (gst_memory_map (mem, &info, GST_MAP_READ));
+    gst_memory_unmap (mem, &info);
+    gst_memory_unref (mem);
+
+    mem = gst_allocator_alloc (alloc, 900, NULL);
+    fail_unless (mem);
+    fail_if (GST_MEMORY_IS_READONLY (mem));
+    fail_unless (gst_memory_map (mem, &info, GST_MAP_WRITE));
+    gst_memory_unmap (mem, &info);
+  }
+  gst_memory_unref (mem);
+
+  gst_object_unref (alloc);
+}
+
+GST_END_TEST;
+
 static Suite *
 allocators_suite (void)
 {
@@ -110,6 +279,9 @@ allocators_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_dmabuf);
   tcase_add_test (tc_chain, test_fdmem);
+  tcase_add_test (tc_chain, test_fdmem_cache_mapping);
+  tcase_add_test (tc_chain, test_dmabuf_sync_coalescing);
+  tcase_add_test (tc_chain, test_memfdmem);
 
   return s;
 }
@@ -1528,6 +1528,63 @@ GST_START_TEST (test_audio_make_raw_caps)
 
 GST_END_TEST;
 
+GST_START_TEST (test_interleave_samples)
+{
+  const guint widths[] = { 8, 16, 24, 32, 64 };
+  const guint channels[] = { 1, 2, 3, 4, 6, 8, 11, 64, 130 };
+  const gsize n_frames = 1001;
+  guint w, n, c, bps;
+  gsize f;
+
+  for (w = 0; w < G_N_ELEMENTS (widths); w++) {
+    bps = widths[w] / 8;
+
+    for (n = 0; n < G_N_ELEMENTS (channels); n++) {
+      guint n_channels = channels[n];
+      /* leave the first and last channel of the output alone */
+      guint out_channels = n_channels + 2;
+      gpointer *planes = g_new (gpointer, n_channels);
+      gpointer *result = g_new (gpointer, n_channels);
+      guint8 *interleaved = g_malloc (n_frames * out_channels * bps);
+
+      memset (interleaved, 0xaa, n_frames * out_channels * bps);
+      for (c = 0; c < n_channels; c++) {
+        planes[c] = g_malloc (n_frames * bps);
+        result[c] = g_malloc0 (n_frames * bps);
+        for (f = 0; f < n_frames * bps; f++)
+          ((guint8 *) planes[c])[f] = g_random_int ();
+      }
+
+      gst_audio_interleave_samples (widths[w], interleaved + bps,
+          out_channels, planes, n_channels, n_frames);
+
+      for (f = 0; f < n_frames; f++) {
+        guint8 *frame = interleaved + f * out_channels * bps;
+
+        fail_unless (frame[0] == 0xaa);
+        fail_unless (frame[(out_channels - 1) * bps] == 0xaa);
+        for (c = 0; c < n_channels; c++)
+          fail_unless (memcmp (frame + (c + 1) * bps,
+                  (guint8 *) planes[c] + f * bps, bps) == 0);
+      }
+
+      gst_audio_deinterleave_samples (widths[w], result, n_channels,
+          interleaved + bps, out_channels, n_frames);
+
+      for (c = 0; c < n_channels; c++) {
+        fail_unless (memcmp (result[c], planes[c], n_frames * bps) == 0);
+        g_free (planes[c]);
+        g_free (result[c]);
+      }
+      g_free (planes);
+      g_free (result);
+      g_free (interleaved);
+    }
+  }
+}
+
+GST_END_TEST;
+
 static Suite *
 audio_suite (void)
 {
@@ -1564,6 +1621,7 @@ audio_suite (void)
   tcase_add_test (tc_chain, test_audio_buffer_and_audio_meta);
   tcase_add_test (tc_chain, test_audio_info_from_caps);
   tcase_add_test (tc_chain, test_audio_make_raw_caps);
+  tcase_add_test (tc_chain, test_interleave_samples);
 
   return s;
 }
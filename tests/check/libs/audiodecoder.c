@@ -74,6 +74,7 @@ struct _GstAudioDecoderTester
   gboolean setoutputformat_on_decoding;
   gboolean output_too_many_frames;
   gboolean delay_decoding;
+  gboolean use_pool;
   GstBuffer *prev_buf;
 };
 
@@ -166,14 +167,24 @@ gst_audio_decoder_tester_handle_frame (GstAudioDecoder * dec,
       /* the output is SE32LE stereo 44100 Hz */
       size = 2 * 4;
       g_assert (size == sizeof (guint64));
-      data = g_malloc0 (size);
 
-      if (map.size) {
-        g_assert_cmpint (map.size, >=, sizeof (guint64));
-        memcpy (data, map.data, sizeof (guint64));
-      }
+      if (tester->use_pool) {
+        output_buffer = gst_audio_decoder_allocate_output_buffer (dec, size);
+        gst_buffer_memset (output_buffer, 0, 0, size);
+        if (map.size) {
+          g_assert_cmpint (map.size, >=, sizeof (guint64));
+          gst_buffer_fill (output_buffer, 0, map.data, sizeof (guint64));
+        }
+      } else {
+        data = g_malloc0 (size);
 
-      output_buffer = gst_buffer_new_wrapped (data, size);
+        if (map.size) {
+          g_assert_cmpint (map.size, >=, sizeof (guint64));
+          memcpy (data, map.data, sizeof (guint64));
+        }
+
+        output_buffer = gst_buffer_new_wrapped (data, size);
+      }
 
       gst_buffer_unmap (cur_buf, &map);
 
@@ -314,6 +325,50 @@ GST_START_TEST (audiodecoder_playback)
 GST_END_TEST;
 
 
+GST_START_TEST (audiodecoder_output_pool)
+{
+  GstAudioDecoderTester *tester;
+  GstStructure *stats;
+  GstBuffer *buffer;
+  guint64 i, pooled, recycled, unpooled;
+
+  GstHarness *h = setup_audiodecodertester (NULL, NULL);
+
+  tester = (GstAudioDecoderTester *) h->element;
+  tester->use_pool = TRUE;
+  /* output is already configured, the pool is set up on renegotiation */
+  gst_audio_decoder_set_max_frame_size (GST_AUDIO_DECODER (tester),
+      sizeof (guint64));
+
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    GstMapInfo map;
+
+    fail_unless (gst_harness_push (h, create_test_buffer (i)) == GST_FLOW_OK);
+
+    buffer = gst_harness_pull (h);
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    fail_unless_equals_int (map.size, sizeof (guint64));
+    fail_unless_equals_uint64 (i, *(guint64 *) map.data);
+    gst_buffer_unmap (buffer, &map);
+
+    /* returns the buffer to the pool */
+    gst_buffer_unref (buffer);
+  }
+
+  stats = gst_audio_decoder_get_pool_stats (GST_AUDIO_DECODER (tester));
+  fail_unless (gst_structure_get_uint64 (stats, "pooled", &pooled));
+  fail_unless (gst_structure_get_uint64 (stats, "recycled", &recycled));
+  fail_unless (gst_structure_get_uint64 (stats, "unpooled", &unpooled));
+  fail_unless_equals_uint64 (pooled, NUM_BUFFERS);
+  fail_unless_equals_uint64 (recycled, NUM_BUFFERS - 1);
+  fail_unless_equals_uint64 (unpooled, 0);
+  gst_structure_free (stats);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static void
 check_audiodecoder_negotiation (GstHarness * h)
 {
@@ -1144,6 +1199,7 @@ gst_audiodecoder_suite (void)
 
   suite_add_tcase (s, tc);
   tcase_add_test (tc, audiodecoder_playback);
+  tcase_add_test (tc, audiodecoder_output_pool);
   tcase_add_test (tc, audiodecoder_negotiation_with_buffer);
 
   tcase_add_test (tc, audiodecoder_negotiation_with_gap_event);
@@ -41,6 +41,9 @@ typedef struct _GstAudioEncoderTesterClass GstAudioEncoderTesterClass;
 struct _GstAudioEncoderTester
 {
   GstAudioEncoder parent;
+
+  gboolean use_pool;
+  guint pool_max_buffers;
 };
 
 struct _GstAudioEncoderTesterClass
@@ -76,10 +79,43 @@ gst_audio_encoder_tester_set_format (GstAudioEncoder * enc, GstAudioInfo * info)
   return TRUE;
 }
 
+static gboolean
+gst_audio_encoder_tester_decide_allocation (GstAudioEncoder * enc,
+    GstQuery * query)
+{
+  GstAudioEncoderTester *tester = (GstAudioEncoderTester *) enc;
+  GstBufferPool *pool;
+  GstStructure *config;
+  GstCaps *caps;
+  guint size, min, max;
+
+  if (!GST_AUDIO_ENCODER_CLASS
+      (gst_audio_encoder_tester_parent_class)->decide_allocation (enc, query))
+    return FALSE;
+
+  if (tester->pool_max_buffers == 0
+      || gst_query_get_n_allocation_pools (query) == 0)
+    return TRUE;
+
+  /* limit the number of buffers in the pool */
+  gst_query_parse_nth_allocation_pool (query, 0, &pool, &size, &min, &max);
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_get_params (config, &caps, NULL, NULL, NULL);
+  gst_buffer_pool_config_set_params (config, caps, size, min,
+      tester->pool_max_buffers);
+  fail_unless (gst_buffer_pool_set_config (pool, config));
+  gst_query_set_nth_allocation_pool (query, 0, pool, size, min,
+      tester->pool_max_buffers);
+  gst_object_unref (pool);
+
+  return TRUE;
+}
+
 static GstFlowReturn
 gst_audio_encoder_tester_handle_frame (GstAudioEncoder * enc,
     GstBuffer * buffer)
 {
+  GstAudioEncoderTester *tester = (GstAudioEncoderTester *) enc;
   guint8 *data;
   GstMapInfo map;
   guint64 input_num;
@@ -92,10 +128,16 @@ gst_audio_encoder_tester_handle_frame (GstAudioEncoder * enc,
   input_num = *((guint64 *) map.data);
   gst_buffer_unmap (buffer, &map);
 
-  data = g_malloc (sizeof (guint64));
-  *(guint64 *) data = input_num;
+  if (tester->use_pool) {
+    output_buffer =
+        gst_audio_encoder_allocate_output_buffer (enc, sizeof (guint64));
+    gst_buffer_fill (output_buffer, 0, &input_num, sizeof (guint64));
+  } else {
+    data = g_malloc (sizeof (guint64));
+    *(guint64 *) data = input_num;
 
-  output_buffer = gst_buffer_new_wrapped (data, sizeof (guint64));
+    output_buffer = gst_buffer_new_wrapped (data, sizeof (guint64));
+  }
   GST_BUFFER_PTS (output_buffer) = GST_BUFFER_PTS (buffer);
   GST_BUFFER_DURATION (output_buffer) = GST_BUFFER_DURATION (buffer);
 
@@ -126,6 +168,8 @@ gst_audio_encoder_tester_class_init (GstAudioEncoderTesterClass * klass)
   audioencoder_class->stop = gst_audio_encoder_tester_stop;
   audioencoder_class->handle_frame = gst_audio_encoder_tester_handle_frame;
   audioencoder_class->set_format = gst_audio_encoder_tester_set_format;
+  audioencoder_class->decide_allocation =
+      gst_audio_encoder_tester_decide_allocation;
 }
 
 static void
@@ -228,6 +272,94 @@ GST_START_TEST (audioencoder_playback)
 
 GST_END_TEST;
 
+static void
+check_pool_stats (GstAudioEncoder * enc, guint64 expected_pooled,
+    guint64 expected_recycled, guint64 expected_unpooled)
+{
+  GstStructure *stats;
+  guint64 pooled, recycled, unpooled;
+
+  stats = gst_audio_encoder_get_pool_stats (enc);
+  fail_unless (gst_structure_get_uint64 (stats, "pooled", &pooled));
+  fail_unless (gst_structure_get_uint64 (stats, "recycled", &recycled));
+  fail_unless (gst_structure_get_uint64 (stats, "unpooled", &unpooled));
+  fail_unless_equals_uint64 (pooled, expected_pooled);
+  fail_unless_equals_uint64 (recycled, expected_recycled);
+  fail_unless_equals_uint64 (unpooled, expected_unpooled);
+  gst_structure_free (stats);
+}
+
+GST_START_TEST (audioencoder_output_pool)
+{
+  GstAudioEncoderTester *tester;
+  GstBuffer *buffer;
+  guint64 i;
+
+  GstHarness *h = setup_audioencodertester ();
+
+  tester = (GstAudioEncoderTester *) h->element;
+  tester->use_pool = TRUE;
+  gst_audio_encoder_set_max_frame_size (GST_AUDIO_ENCODER (tester),
+      sizeof (guint64));
+
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    GstMapInfo map;
+
+    fail_unless (gst_harness_push (h, create_test_buffer (i)) == GST_FLOW_OK);
+
+    buffer = gst_harness_pull (h);
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    fail_unless_equals_int (map.size, sizeof (guint64));
+    fail_unless_equals_uint64 (i, *(guint64 *) map.data);
+    gst_buffer_unmap (buffer, &map);
+
+    /* returns the buffer to the pool */
+    gst_buffer_unref (buffer);
+  }
+
+  check_pool_stats (GST_AUDIO_ENCODER (tester), NUM_BUFFERS, NUM_BUFFERS - 1,
+      0);
+
+  /* the maximum frame size is kept when the encoder is reset */
+  fail_unless_equals_int (gst_element_set_state (h->element, GST_STATE_READY),
+      GST_STATE_CHANGE_SUCCESS);
+  fail_unless_equals_uint64 (gst_audio_encoder_get_max_frame_size
+      (GST_AUDIO_ENCODER (tester)), sizeof (guint64));
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (audioencoder_output_pool_exhausted)
+{
+  GstAudioEncoderTester *tester;
+  guint64 i;
+
+  GstHarness *h = setup_audioencodertester ();
+
+  tester = (GstAudioEncoderTester *) h->element;
+  tester->use_pool = TRUE;
+  tester->pool_max_buffers = 1;
+  gst_audio_encoder_set_max_frame_size (GST_AUDIO_ENCODER (tester),
+      sizeof (guint64));
+
+  /* the harness keeps all output buffers queued, so the pool runs empty
+   * after the first one and the encoder must not block on it */
+  for (i = 0; i < 3; i++)
+    fail_unless (gst_harness_push (h, create_test_buffer (i)) == GST_FLOW_OK);
+  check_pool_stats (GST_AUDIO_ENCODER (tester), 1, 0, 2);
+
+  /* once the buffers are released the pool is used again */
+  for (i = 0; i < 3; i++)
+    gst_buffer_unref (gst_harness_pull (h));
+  fail_unless (gst_harness_push (h, create_test_buffer (3)) == GST_FLOW_OK);
+  check_pool_stats (GST_AUDIO_ENCODER (tester), 2, 1, 2);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
 
 GST_START_TEST (audioencoder_flush_events)
 {
@@ -403,6 +535,8 @@ gst_audioencoder_suite (void)
 
   suite_add_tcase (s, tc);
   tcase_add_test (tc, audioencoder_playback);
+  tcase_add_test (tc, audioencoder_output_pool);
+  tcase_add_test (tc, audioencoder_output_pool_exhausted);
 
   tcase_add_test (tc, audioencoder_tags_before_eos);
   tcase_add_test (tc, audioencoder_events_before_eos);
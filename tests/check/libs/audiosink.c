@@ -25,6 +25,7 @@
 #endif
 
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
 #include <gst/audio/gstaudiosink.h>
 
 #define GST_TYPE_AUDIO_FOO_SINK           (gst_audio_foo_sink_get_type())
@@ -43,6 +44,10 @@ struct _GstAudioFooSink
   GstAudioSink parent;
 
   guint num_clear_all_call;
+
+  /* ATOMIC, number of written samples with value 2 */
+  gint num_marked_samples;
+  gint rate;
 };
 
 struct _GstAudioFooSinkClass
@@ -61,6 +66,43 @@ gst_audio_foo_sink_clear_all (GstAudioSink * sink)
   self->num_clear_all_call++;
 }
 
+static gboolean
+gst_audio_foo_sink_prepare (GstAudioSink * sink, GstAudioRingBufferSpec * spec)
+{
+  GstAudioFooSink *self = GST_AUDIO_FOO_SINK (sink);
+
+  self->rate = GST_AUDIO_INFO_RATE (&spec->info);
+
+  return TRUE;
+}
+
+static gboolean
+gst_audio_foo_sink_unprepare (GstAudioSink * sink)
+{
+  return TRUE;
+}
+
+/* consumes mono S16 data in real time like a device would */
+static gint
+gst_audio_foo_sink_write (GstAudioSink * sink, gpointer data, guint length)
+{
+  GstAudioFooSink *self = GST_AUDIO_FOO_SINK (sink);
+  const gint16 *samples = data;
+  guint i, n_samples = length / sizeof (gint16);
+  gint marked = 0;
+
+  for (i = 0; i < n_samples; i++) {
+    if (samples[i] == 2)
+      marked++;
+  }
+  g_atomic_int_add (&self->num_marked_samples, marked);
+
+  g_usleep (gst_util_uint64_scale_int (n_samples, G_USEC_PER_SEC,
+          self->rate));
+
+  return length;
+}
+
 static void
 gst_audio_foo_sink_init (GstAudioFooSink * src)
 {
@@ -77,6 +119,9 @@ gst_audio_foo_sink_class_init (GstAudioFooSinkClass * klass)
       "AudioFooSink", "Sink/Audio",
       "Audio Sink Unit Test element", "Foo Bar <foo@bar.com>");
 
+  audiosink_class->prepare = gst_audio_foo_sink_prepare;
+  audiosink_class->unprepare = gst_audio_foo_sink_unprepare;
+  audiosink_class->write = gst_audio_foo_sink_write;
   audiosink_class->extension->clear_all = gst_audio_foo_sink_clear_all;
 }
 
@@ -107,6 +152,133 @@ GST_START_TEST (test_class_extension)
 
 GST_END_TEST;
 
+GST_START_TEST (test_low_latency)
+{
+  GstAudioFooSink *foosink = NULL;
+  GstAudioRingBuffer *ringbuffer;
+  gboolean low_latency = TRUE;
+
+  foosink = g_object_new (GST_TYPE_AUDIO_FOO_SINK, NULL);
+  fail_unless (foosink != NULL);
+
+  g_object_get (foosink, "low-latency", &low_latency, NULL);
+  fail_if (low_latency);
+  g_object_set (foosink, "low-latency", TRUE, NULL);
+  g_object_get (foosink, "low-latency", &low_latency, NULL);
+  fail_unless (low_latency);
+
+  fail_unless (gst_element_set_state (GST_ELEMENT (foosink),
+          GST_STATE_READY) == GST_STATE_CHANGE_SUCCESS);
+
+  ringbuffer = GST_AUDIO_BASE_SINK (foosink)->ringbuffer;
+  fail_unless (ringbuffer != NULL);
+
+  /* spinning is only configured once the ringbuffer is acquired */
+  fail_unless_equals_int (gst_audio_ring_buffer_get_spin_count (ringbuffer),
+      0);
+  gst_audio_ring_buffer_set_spin_count (ringbuffer, 16);
+  fail_unless_equals_int (gst_audio_ring_buffer_get_spin_count (ringbuffer),
+      16);
+
+  gst_element_set_state (GST_ELEMENT (foosink), GST_STATE_NULL);
+  gst_clear_object (&foosink);
+}
+
+GST_END_TEST;
+
+/* 10ms, one segment with the default latency-time */
+#define GROW_BUFFER_SAMPLES 441
+#define GROW_NUM_BUFFERS 20
+
+static GstBuffer *
+create_s16_buffer (gint16 value)
+{
+  GstBuffer *buf;
+  GstMapInfo map;
+  guint i;
+
+  buf = gst_buffer_new_allocate (NULL, GROW_BUFFER_SAMPLES * sizeof (gint16),
+      NULL);
+  gst_buffer_map (buf, &map, GST_MAP_WRITE);
+  for (i = 0; i < GROW_BUFFER_SAMPLES; i++)
+    ((gint16 *) map.data)[i] = value;
+  gst_buffer_unmap (buf, &map);
+
+  return buf;
+}
+
+GST_START_TEST (test_low_latency_grow)
+{
+  GstHarness *h;
+  GstElement *sink;
+  GstAudioFooSink *foosink;
+  GstAudioRingBuffer *ringbuffer;
+  GstSegment segment;
+  guint64 buffer_time;
+  gint64 deadline;
+  guint i;
+
+  sink = g_object_new (GST_TYPE_AUDIO_FOO_SINK, "sync", FALSE,
+      "low-latency", TRUE, NULL);
+  foosink = GST_AUDIO_FOO_SINK (sink);
+  h = gst_harness_new_with_element (sink, "sink", NULL);
+  gst_harness_set_src_caps_str (h, "audio/x-raw, format=(string)S16LE, "
+      "layout=(string)interleaved, rate=(int)44100, channels=(int)1");
+
+  ringbuffer = GST_AUDIO_BASE_SINK (sink)->ringbuffer;
+
+  /* render with large gaps to build up jitter while streaming, without a
+   * flush the ringbuffer is played out and then grows */
+  fail_unless_equals_int (gst_harness_push (h, create_s16_buffer (2)),
+      GST_FLOW_OK);
+  buffer_time = ringbuffer->spec.buffer_time;
+  for (i = 0; i < 5; i++) {
+    g_usleep (60 * 1000);
+    fail_unless_equals_int (gst_harness_push (h, create_s16_buffer (2)),
+        GST_FLOW_OK);
+  }
+  fail_unless (ringbuffer->spec.buffer_time > buffer_time);
+  fail_unless (ringbuffer->spec.buffer_time <=
+      GST_AUDIO_BASE_SINK (sink)->buffer_time);
+
+  /* none of the samples that were queued when it grew got lost */
+  deadline = g_get_monotonic_time () + 5 * G_USEC_PER_SEC;
+  while (g_atomic_int_get (&foosink->num_marked_samples) <
+      GROW_BUFFER_SAMPLES * 6 && g_get_monotonic_time () < deadline)
+    g_usleep (10 * 1000);
+
+  fail_unless_equals_int (g_atomic_int_get (&foosink->num_marked_samples),
+      GROW_BUFFER_SAMPLES * 6);
+
+  /* after a flush, push more than fits in the ringbuffer, commit has to wait
+   * for the device and nothing may be dropped */
+  fail_unless (gst_harness_push_event (h, gst_event_new_flush_start ()));
+  fail_unless (gst_harness_push_event (h, gst_event_new_flush_stop (TRUE)));
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_harness_push_event (h, gst_event_new_segment (&segment)));
+  g_atomic_int_set (&foosink->num_marked_samples, 0);
+
+  for (i = 0; i < GROW_NUM_BUFFERS; i++) {
+    fail_unless_equals_int (gst_harness_push (h, create_s16_buffer (2)),
+        GST_FLOW_OK);
+  }
+  fail_unless (ringbuffer->spec.buffer_time <=
+      GST_AUDIO_BASE_SINK (sink)->buffer_time);
+
+  deadline = g_get_monotonic_time () + 5 * G_USEC_PER_SEC;
+  while (g_atomic_int_get (&foosink->num_marked_samples) <
+      GROW_BUFFER_SAMPLES * GROW_NUM_BUFFERS &&
+      g_get_monotonic_time () < deadline)
+    g_usleep (10 * 1000);
+
+  fail_unless_equals_int (g_atomic_int_get (&foosink->num_marked_samples),
+      GROW_BUFFER_SAMPLES * GROW_NUM_BUFFERS);
+
+  gst_harness_teardown (h);
+  gst_object_unref (sink);
+}
+
+GST_END_TEST;
 
 static Suite *
 audiosink_suite (void)
@@ -116,6 +288,8 @@ audiosink_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_class_extension);
+  tcase_add_test (tc_chain, test_low_latency);
+  tcase_add_test (tc_chain, test_low_latency_grow);
 
   return s;
 }
@@ -154,6 +154,52 @@ GST_START_TEST (count_in_out)
 
 GST_END_TEST;
 
+GST_START_TEST (count_in_out_qos_throttled)
+{
+  GstElement *elem;
+  GstPad *srcpad, *sinkpad;
+  GstBuffer *buffer;
+  GstCaps *caps;
+
+  /* setup up */
+  elem = gst_check_setup_element ("testscope");
+  srcpad = gst_check_setup_src_pad (elem, &srctemplate);
+  sinkpad = gst_check_setup_sink_pad (elem, &sinktemplate);
+  gst_pad_set_active (srcpad, TRUE);
+  gst_pad_set_active (sinkpad, TRUE);
+
+  fail_unless (gst_element_set_state (elem,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  caps = gst_caps_from_string (CAPS);
+  gst_check_setup_events (srcpad, elem, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+
+  /* downstream can only handle half of the frames, but nothing is late */
+  fail_unless (gst_pad_push_event (sinkpad,
+          gst_event_new_qos (GST_QOS_TYPE_THROTTLE, 2.0, -GST_SECOND,
+              GST_SECOND)));
+
+  /* push 1s audio, expect every 2nd of the 30 video-frames */
+  buffer = gst_buffer_new_and_alloc (44100 * 2 * sizeof (gint16));
+  fail_unless (gst_pad_push (srcpad, buffer) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 15);
+
+  /* clean up */
+  g_list_foreach (buffers, (GFunc) gst_mini_object_unref, NULL);
+  g_list_free (buffers);
+  buffers = NULL;
+
+  gst_pad_set_active (srcpad, FALSE);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_check_teardown_src_pad (elem);
+  gst_check_teardown_sink_pad (elem);
+  gst_check_teardown_element (elem);
+}
+
+GST_END_TEST;
+
 static void
 baseaudiovisualizer_init (void)
 {
@@ -170,6 +216,7 @@ baseaudiovisualizer_suite (void)
   tcase_add_checked_fixture (tc_chain, baseaudiovisualizer_init, NULL);
 
   tcase_add_test (tc_chain, count_in_out);
+  tcase_add_test (tc_chain, count_in_out_qos_throttled);
 
   return s;
 }
@@ -521,6 +521,318 @@ GST_START_TEST (test_f64_22050hz)
 
 GST_END_TEST;
 
+GST_START_TEST (test_f32_batch)
+{
+  /* a power of two and a mixed radix length */
+  static const gint lengths[] = { 2048, 1000 };
+  gint i, c, len;
+  guint l;
+  gfloat *in, *frame;
+  GstFFTF32Complex *out, *ref;
+  GstFFTF32 *ctx;
+
+  for (l = 0; l < G_N_ELEMENTS (lengths); l++) {
+    len = lengths[l];
+    in = g_new (gfloat, 4 * len);
+    frame = g_new (gfloat, len);
+    out = g_new (GstFFTF32Complex, 4 * (len / 2 + 1));
+    ref = g_new (GstFFTF32Complex, len / 2 + 1);
+    ctx = gst_fft_f32_new (len, FALSE);
+
+    for (i = 0; i < 4 * len; i++)
+      in[i] = sin (i * 0.37) + 0.3 * cos (i * 1.7);
+
+    /* 4 interleaved channels */
+    gst_fft_f32_fft_batch (ctx, in, 4, 1, 4, GST_FFT_WINDOW_HANN, out);
+
+    for (c = 0; c < 4; c++) {
+      for (i = 0; i < len; i++)
+        frame[i] = in[4 * i + c];
+      gst_fft_f32_window (ctx, frame, GST_FFT_WINDOW_HANN);
+      gst_fft_f32_fft (ctx, frame, ref);
+
+      for (i = 0; i < len / 2 + 1; i++) {
+        fail_unless (fabs (out[c * (len / 2 + 1) + i].r - ref[i].r) < 1e-2);
+        fail_unless (fabs (out[c * (len / 2 + 1) + i].i - ref[i].i) < 1e-2);
+      }
+    }
+
+    /* 3 frames with 50% overlap */
+    gst_fft_f32_fft_batch (ctx, in, 1, len / 2, 3, GST_FFT_WINDOW_RECTANGULAR,
+        out);
+
+    for (c = 0; c < 3; c++) {
+      gst_fft_f32_fft (ctx, in + c * (len / 2), ref);
+
+      for (i = 0; i < len / 2 + 1; i++) {
+        fail_unless (out[c * (len / 2 + 1) + i].r == ref[i].r);
+        fail_unless (out[c * (len / 2 + 1) + i].i == ref[i].i);
+      }
+    }
+
+    gst_fft_f32_free (ctx);
+    g_free (in);
+    g_free (frame);
+    g_free (out);
+    g_free (ref);
+  }
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_f64_batch)
+{
+  /* a power of two and a mixed radix length */
+  static const gint lengths[] = { 2048, 1000 };
+  gint i, c, len;
+  guint l;
+  gdouble *in, *frame;
+  GstFFTF64Complex *out, *ref;
+  GstFFTF64 *ctx;
+
+  for (l = 0; l < G_N_ELEMENTS (lengths); l++) {
+    len = lengths[l];
+    in = g_new (gdouble, 4 * len);
+    frame = g_new (gdouble, len);
+    out = g_new (GstFFTF64Complex, 4 * (len / 2 + 1));
+    ref = g_new (GstFFTF64Complex, len / 2 + 1);
+    ctx = gst_fft_f64_new (len, FALSE);
+
+    for (i = 0; i < 4 * len; i++)
+      in[i] = sin (i * 0.37) + 0.3 * cos (i * 1.7);
+
+    /* 4 interleaved channels */
+    gst_fft_f64_fft_batch (ctx, in, 4, 1, 4, GST_FFT_WINDOW_HANN, out);
+
+    for (c = 0; c < 4; c++) {
+      for (i = 0; i < len; i++)
+        frame[i] = in[4 * i + c];
+      gst_fft_f64_window (ctx, frame, GST_FFT_WINDOW_HANN);
+      gst_fft_f64_fft (ctx, frame, ref);
+
+      for (i = 0; i < len / 2 + 1; i++) {
+        fail_unless (fabs (out[c * (len / 2 + 1) + i].r - ref[i].r) < 1e-9);
+        fail_unless (fabs (out[c * (len / 2 + 1) + i].i - ref[i].i) < 1e-9);
+      }
+    }
+
+    /* 3 frames with 50% overlap */
+    gst_fft_f64_fft_batch (ctx, in, 1, len / 2, 3, GST_FFT_WINDOW_RECTANGULAR,
+        out);
+
+    for (c = 0; c < 3; c++) {
+      gst_fft_f64_fft (ctx, in + c * (len / 2), ref);
+
+      for (i = 0; i < len / 2 + 1; i++) {
+        fail_unless (out[c * (len / 2 + 1) + i].r == ref[i].r);
+        fail_unless (out[c * (len / 2 + 1) + i].i == ref[i].i);
+      }
+    }
+
+    gst_fft_f64_free (ctx);
+    g_free (in);
+    g_free (frame);
+    g_free (out);
+    g_free (ref);
+  }
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_f32_pow2_roundtrip)
+{
+  GstFFTF32Complex *freq;
+  GstFFTF32 *fwd, *inv;
+  gfloat *in, *out;
+  gint i, len;
+
+  /* even and odd powers of two, the latter end with a radix-2 stage */
+  for (len = 8; len <= 8192; len *= 2) {
+    in = g_new (gfloat, len);
+    out = g_new (gfloat, len);
+    freq = g_new (GstFFTF32Complex, len / 2 + 1);
+    fwd = gst_fft_f32_new (len, FALSE);
+    inv = gst_fft_f32_new (len, TRUE);
+
+    for (i = 0; i < len; i++)
+      in[i] = sin (i * 0.37) + 0.3 * cos (i * 1.7);
+
+    gst_fft_f32_fft (fwd, in, freq);
+    gst_fft_f32_inverse_fft (inv, freq, out);
+
+    /* iFFT (FFT (x)) = x * len */
+    for (i = 0; i < len; i++)
+      fail_unless (fabs (out[i] - len * in[i]) < 1e-4 * len,
+          "sample %d of length %d: %g != %g", i, len, out[i], len * in[i]);
+
+    gst_fft_f32_free (fwd);
+    gst_fft_f32_free (inv);
+    g_free (in);
+    g_free (out);
+    g_free (freq);
+  }
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_f32_pow2_kiss)
+{
+  GstFFTF32Complex *freq, *ref;
+  GstFFTF32 *fwd, *inv, *kfwd, *kinv;
+  gfloat *in, *out, *kin, *kout;
+  gint i, len;
+
+  /* Lengths of 3 * len use the mixed radix FFT. The DFT of a signal zero
+   * padded to 3 * len has the DFT of the signal in every third bin, the
+   * inverse DFT of those bins repeats the inverse DFT of the signal. */
+  for (len = 8; len <= 4096; len *= 2) {
+    in = g_new (gfloat, len);
+    out = g_new (gfloat, len);
+    kin = g_new0 (gfloat, 3 * len);
+    kout = g_new (gfloat, 3 * len);
+    freq = g_new (GstFFTF32Complex, len / 2 + 1);
+    ref = g_new0 (GstFFTF32Complex, 3 * len / 2 + 1);
+    fwd = gst_fft_f32_new (len, FALSE);
+    inv = gst_fft_f32_new (len, TRUE);
+    kfwd = gst_fft_f32_new (3 * len, FALSE);
+    kinv = gst_fft_f32_new (3 * len, TRUE);
+
+    for (i = 0; i < len; i++)
+      kin[i] = in[i] = sin (i * 0.37) + 0.3 * cos (i * 1.7);
+
+    gst_fft_f32_fft (fwd, in, freq);
+    gst_fft_f32_fft (kfwd, kin, ref);
+
+    for (i = 0; i < len / 2 + 1; i++) {
+      fail_unless (fabs (freq[i].r - ref[3 * i].r) < 1e-4 * len,
+          "bin %d of length %d: %g != %g", i, len, freq[i].r, ref[3 * i].r);
+      fail_unless (fabs (freq[i].i - ref[3 * i].i) < 1e-4 * len,
+          "bin %d of length %d: %g != %g", i, len, freq[i].i, ref[3 * i].i);
+    }
+
+    memset (ref, 0, (3 * len / 2 + 1) * sizeof (GstFFTF32Complex));
+    for (i = 0; i < len / 2 + 1; i++)
+      ref[3 * i] = freq[i];
+
+    gst_fft_f32_inverse_fft (inv, freq, out);
+    gst_fft_f32_inverse_fft (kinv, ref, kout);
+
+    for (i = 0; i < len; i++)
+      fail_unless (fabs (out[i] - kout[i]) < 1e-4 * len,
+          "sample %d of length %d: %g != %g", i, len, out[i], kout[i]);
+
+    gst_fft_f32_free (fwd);
+    gst_fft_f32_free (inv);
+    gst_fft_f32_free (kfwd);
+    gst_fft_f32_free (kinv);
+    g_free (in);
+    g_free (out);
+    g_free (kin);
+    g_free (kout);
+    g_free (freq);
+    g_free (ref);
+  }
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_f64_pow2_roundtrip)
+{
+  GstFFTF64Complex *freq;
+  GstFFTF64 *fwd, *inv;
+  gdouble *in, *out;
+  gint i, len;
+
+  /* even and odd powers of two, the latter end with a radix-2 stage */
+  for (len = 8; len <= 8192; len *= 2) {
+    in = g_new (gdouble, len);
+    out = g_new (gdouble, len);
+    freq = g_new (GstFFTF64Complex, len / 2 + 1);
+    fwd = gst_fft_f64_new (len, FALSE);
+    inv = gst_fft_f64_new (len, TRUE);
+
+    for (i = 0; i < len; i++)
+      in[i] = sin (i * 0.37) + 0.3 * cos (i * 1.7);
+
+    gst_fft_f64_fft (fwd, in, freq);
+    gst_fft_f64_inverse_fft (inv, freq, out);
+
+    /* iFFT (FFT (x)) = x * len */
+    for (i = 0; i < len; i++)
+      fail_unless (fabs (out[i] - len * in[i]) < 1e-12 * len,
+          "sample %d of length %d: %g != %g", i, len, out[i], len * in[i]);
+
+    gst_fft_f64_free (fwd);
+    gst_fft_f64_free (inv);
+    g_free (in);
+    g_free (out);
+    g_free (freq);
+  }
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_f64_pow2_kiss)
+{
+  GstFFTF64Complex *freq, *ref;
+  GstFFTF64 *fwd, *inv, *kfwd, *kinv;
+  gdouble *in, *out, *kin, *kout;
+  gint i, len;
+
+  /* Lengths of 3 * len use the mixed radix FFT. The DFT of a signal zero
+   * padded to 3 * len has the DFT of the signal in every third bin, the
+   * inverse DFT of those bins repeats the inverse DFT of the signal. */
+  for (len = 8; len <= 4096; len *= 2) {
+    in = g_new (gdouble, len);
+    out = g_new (gdouble, len);
+    kin = g_new0 (gdouble, 3 * len);
+    kout = g_new (gdouble, 3 * len);
+    freq = g_new (GstFFTF64Complex, len / 2 + 1);
+    ref = g_new0 (GstFFTF64Complex, 3 * len / 2 + 1);
+    fwd = gst_fft_f64_new (len, FALSE);
+    inv = gst_fft_f64_new (len, TRUE);
+    kfwd = gst_fft_f64_new (3 * len, FALSE);
+    kinv = gst_fft_f64_new (3 * len, TRUE);
+
+    for (i = 0; i < len; i++)
+      kin[i] = in[i] = sin (i * 0.37) + 0.3 * cos (i * 1.7);
+
+    gst_fft_f64_fft (fwd, in, freq);
+    gst_fft_f64_fft (kfwd, kin, ref);
+
+    for (i = 0; i < len / 2 + 1; i++) {
+      fail_unless (fabs (freq[i].r - ref[3 * i].r) < 1e-12 * len,
+          "bin %d of length %d: %g != %g", i, len, freq[i].r, ref[3 * i].r);
+      fail_unless (fabs (freq[i].i - ref[3 * i].i) < 1e-12 * len,
+          "bin %d of length %d: %g != %g", i, len, freq[i].i, ref[3 * i].i);
+    }
+
+    memset (ref, 0, (3 * len / 2 + 1) * sizeof (GstFFTF64Complex));
+    for (i = 0; i < len / 2 + 1; i++)
+      ref[3 * i] = freq[i];
+
+    gst_fft_f64_inverse_fft (inv, freq, out);
+    gst_fft_f64_inverse_fft (kinv, ref, kout);
+
+    for (i = 0; i < len; i++)
+      fail_unless (fabs (out[i] - kout[i]) < 1e-12 * len,
+          "sample %d of length %d: %g != %g", i, len, out[i], kout[i]);
+
+    gst_fft_f64_free (fwd);
+    gst_fft_f64_free (inv);
+    gst_fft_f64_free (kfwd);
+    gst_fft_f64_free (kinv);
+    g_free (in);
+    g_free (out);
+    g_free (kin);
+    g_free (kout);
+    g_free (freq);
+    g_free (ref);
+  }
+}
+
+GST_END_TEST;
+
 static Suite *
 fft_suite (void)
 {
@@ -541,6 +853,12 @@ fft_suite (void)
   tcase_add_test (tc_chain, test_f64_0hz);
   tcase_add_test (tc_chain, test_f64_11025hz);
   tcase_add_test (tc_chain, test_f64_22050hz);
+  tcase_add_test (tc_chain, test_f32_batch);
+  tcase_add_test (tc_chain, test_f64_batch);
+  tcase_add_test (tc_chain, test_f32_pow2_roundtrip);
+  tcase_add_test (tc_chain, test_f32_pow2_kiss);
+  tcase_add_test (tc_chain, test_f64_pow2_roundtrip);
+  tcase_add_test (tc_chain, test_f64_pow2_kiss);
 
   return s;
 }
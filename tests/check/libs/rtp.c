@@ -2175,6 +2175,320 @@ GST_START_TEST (test_rtp_buffer_extlen_wraparound)
 
 GST_END_TEST;
 
+GST_START_TEST (test_rtp_buffer_list_map)
+{
+  GstBufferList *list;
+  GstRTPBufferList rtplist = GST_RTP_BUFFER_LIST_INIT;
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstBuffer *buf;
+  guint16 next;
+  guint i;
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < 4; i++) {
+    buf = gst_rtp_buffer_new_allocate (8, 0, 0);
+    gst_rtp_buffer_map (buf, GST_MAP_WRITE, &rtp);
+    gst_rtp_buffer_set_marker (&rtp, i == 3);
+    gst_rtp_buffer_unmap (&rtp);
+    gst_buffer_list_add (list, buf);
+  }
+  /* not an RTP packet */
+  buf = gst_buffer_new_allocate (NULL, 4, NULL);
+  gst_buffer_memset (buf, 0, 0, 4);
+  gst_buffer_list_insert (list, 2, buf);
+
+  fail_if (gst_rtp_buffer_list_map (list, GST_MAP_WRITE, &rtplist));
+  fail_unless (rtplist.list == list);
+  fail_unless_equals_int (rtplist.n_packets, 5);
+  fail_unless (rtplist.packets[2].buffer == NULL);
+  for (i = 0; i < 5; i++) {
+    if (i != 2)
+      fail_unless (rtplist.packets[i].buffer == gst_buffer_list_get (list, i));
+  }
+
+  /* the invalid packet does not consume a seqnum */
+  next = gst_rtp_buffer_list_set_headers (&rtplist, 0x12345678, 96, 0xfffe,
+      90000);
+  fail_unless_equals_int (next, 2);
+  gst_rtp_buffer_list_unmap (&rtplist);
+  fail_unless (rtplist.list == NULL);
+
+  buf = gst_buffer_list_get (list, 4);
+  fail_unless (gst_rtp_buffer_map (buf, GST_MAP_READ, &rtp));
+  fail_unless_equals_int (gst_rtp_buffer_get_seq (&rtp), 1);
+  fail_unless_equals_int (gst_rtp_buffer_get_ssrc (&rtp), 0x12345678);
+  fail_unless_equals_int (gst_rtp_buffer_get_timestamp (&rtp), 90000);
+  fail_unless_equals_int (gst_rtp_buffer_get_payload_type (&rtp), 96);
+  fail_unless (gst_rtp_buffer_get_marker (&rtp));
+  gst_rtp_buffer_unmap (&rtp);
+
+  buf = gst_buffer_list_get (list, 0);
+  fail_unless (gst_rtp_buffer_map (buf, GST_MAP_READ, &rtp));
+  fail_unless_equals_int (gst_rtp_buffer_get_seq (&rtp), 0xfffe);
+  fail_if (gst_rtp_buffer_get_marker (&rtp));
+  gst_rtp_buffer_unmap (&rtp);
+
+  /* the packet array is reused for smaller lists */
+  gst_buffer_list_remove (list, 2, 3);
+  fail_unless (gst_rtp_buffer_list_map (list, GST_MAP_READ, &rtplist));
+  fail_unless_equals_int (rtplist.n_packets, 2);
+  fail_unless_equals_int (GST_READ_UINT16_BE ((guint8 *)
+          rtplist.packets[1].data[0] + 2), 0xffff);
+  gst_rtp_buffer_list_unmap (&rtplist);
+  gst_rtp_buffer_list_clear (&rtplist);
+
+  gst_buffer_list_unref (list);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_rtp_buffer_extension_index)
+{
+  GstBuffer *buf;
+  GstMapInfo map;
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstRTPExtensionIndex index;
+  guint8 val[] = { 0x11, 0x22, 0x33 };
+  guint8 *data;
+  guint size;
+
+  /* header-only first memory with spare room, payload in a second memory */
+  buf = gst_buffer_new_allocate (NULL, 64, NULL);
+  gst_buffer_map (buf, &map, GST_MAP_WRITE);
+  memset (map.data, 0, RTP_HEADER_LEN);
+  map.data[0] = 0x80;
+  gst_buffer_unmap (buf, &map);
+  gst_buffer_set_size (buf, RTP_HEADER_LEN);
+  gst_buffer_append_memory (buf, gst_allocator_alloc (NULL, 8, NULL));
+
+  fail_unless (gst_rtp_buffer_map (buf, GST_MAP_READWRITE, &rtp));
+  fail_unless (gst_rtp_buffer_reserve_extension_data (&rtp, 0xBEDE, 2));
+  /* only one extension can be reserved */
+  fail_if (gst_rtp_buffer_reserve_extension_data (&rtp, 0xBEDE, 2));
+
+  /* the header memory was grown in place */
+  fail_unless_equals_int (gst_buffer_n_memory (buf), 2);
+  fail_unless_equals_int (gst_buffer_get_size (buf), RTP_HEADER_LEN + 12 + 8);
+  fail_unless (gst_rtp_buffer_get_extension (&rtp));
+  fail_unless_equals_int (gst_rtp_buffer_get_payload_len (&rtp), 8);
+  fail_unless (gst_rtp_buffer_index_extensions (&rtp, &index));
+  fail_if (gst_rtp_buffer_get_indexed_extension (&rtp, &index, 1, NULL, NULL));
+
+  /* both extensions fit in the reserved space */
+  fail_unless (gst_rtp_buffer_add_extension_onebyte_header (&rtp, 1, val, 2));
+  fail_unless (gst_rtp_buffer_add_extension_onebyte_header (&rtp, 2, val, 3));
+  fail_unless_equals_int (gst_buffer_n_memory (buf), 2);
+  fail_unless_equals_int (gst_buffer_get_size (buf), RTP_HEADER_LEN + 12 + 8);
+
+  fail_unless (gst_rtp_buffer_index_extensions (&rtp, &index));
+  fail_unless (gst_rtp_buffer_get_indexed_extension (&rtp, &index, 1,
+          (gpointer *) & data, &size));
+  fail_unless_equals_int (size, 2);
+  fail_unless_equals_int (data[0], 0x11);
+  fail_unless (gst_rtp_buffer_get_indexed_extension (&rtp, &index, 2,
+          (gpointer *) & data, &size));
+  fail_unless_equals_int (size, 3);
+  fail_unless_equals_int (data[2], 0x33);
+  fail_if (gst_rtp_buffer_get_indexed_extension (&rtp, &index, 3, NULL, NULL));
+
+  /* rewrite in place */
+  data[2] = 0x44;
+  fail_unless (gst_rtp_buffer_get_extension_onebyte_header (&rtp, 2, 0,
+          (gpointer *) & data, &size));
+  fail_unless_equals_int (data[2], 0x44);
+  gst_rtp_buffer_unmap (&rtp);
+  gst_buffer_unref (buf);
+
+  /* two bytes headers */
+  buf = gst_rtp_buffer_new_allocate (4, 0, 0);
+  fail_unless (gst_rtp_buffer_map (buf, GST_MAP_READWRITE, &rtp));
+  fail_unless (gst_rtp_buffer_add_extension_twobytes_header (&rtp, 0, 100,
+          val, 3));
+  fail_unless (gst_rtp_buffer_index_extensions (&rtp, &index));
+  fail_unless (gst_rtp_buffer_get_indexed_extension (&rtp, &index, 100,
+          (gpointer *) & data, &size));
+  fail_unless_equals_int (size, 3);
+  fail_unless_equals_int (data[1], 0x22);
+  gst_rtp_buffer_unmap (&rtp);
+  gst_buffer_unref (buf);
+
+  /* two bytes headers in reserved space */
+  buf = gst_buffer_new_allocate (NULL, 64, NULL);
+  gst_buffer_map (buf, &map, GST_MAP_WRITE);
+  memset (map.data, 0, RTP_HEADER_LEN);
+  map.data[0] = 0x80;
+  gst_buffer_unmap (buf, &map);
+  gst_buffer_set_size (buf, RTP_HEADER_LEN);
+  gst_buffer_append_memory (buf, gst_allocator_alloc (NULL, 8, NULL));
+
+  fail_unless (gst_rtp_buffer_map (buf, GST_MAP_READWRITE, &rtp));
+  fail_unless (gst_rtp_buffer_reserve_extension_data (&rtp,
+          (0x100 << 4) | 5, 3));
+  /* the appbits have to match */
+  fail_if (gst_rtp_buffer_add_extension_twobytes_header (&rtp, 4, 100,
+          val, 3));
+  fail_unless (gst_rtp_buffer_add_extension_twobytes_header (&rtp, 5, 100,
+          val, 3));
+  fail_unless (gst_rtp_buffer_add_extension_twobytes_header (&rtp, 5, 101,
+          val, 2));
+  fail_unless_equals_int (gst_buffer_n_memory (buf), 2);
+  fail_unless_equals_int (gst_buffer_get_size (buf), RTP_HEADER_LEN + 16 + 8);
+
+  fail_unless (gst_rtp_buffer_index_extensions (&rtp, &index));
+  fail_unless (gst_rtp_buffer_get_indexed_extension (&rtp, &index, 100,
+          (gpointer *) & data, &size));
+  fail_unless_equals_int (size, 3);
+  fail_unless_equals_int (data[2], 0x33);
+  fail_unless (gst_rtp_buffer_get_indexed_extension (&rtp, &index, 101,
+          (gpointer *) & data, &size));
+  fail_unless_equals_int (size, 2);
+  fail_unless_equals_int (data[1], 0x22);
+  gst_rtp_buffer_unmap (&rtp);
+  gst_buffer_unref (buf);
+
+  /* no extension */
+  buf = gst_rtp_buffer_new_allocate (4, 0, 0);
+  fail_unless (gst_rtp_buffer_map (buf, GST_MAP_READ, &rtp));
+  fail_if (gst_rtp_buffer_index_extensions (&rtp, &index));
+  fail_if (gst_rtp_buffer_get_indexed_extension (&rtp, &index, 1, NULL, NULL));
+  gst_rtp_buffer_unmap (&rtp);
+  gst_buffer_unref (buf);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_rtcp_packet_iter_builder)
+{
+  guint8 data[256];
+  guint8 small[8];
+  guint8 fci[4] = { 0x12, 0x34, 0x00, 0x01 };
+  GstRTCPBuilder builder;
+  GstRTCPPacketIter iter;
+  GstRTCPPacketView view;
+  GstRTCPSDESType type;
+  GstRTCPXRType xr_type;
+  const guint8 *items, *item, *block;
+  guint offset, item_offset, items_size;
+  guint32 ssrc, media_ssrc, jitter;
+  gint32 packetslost;
+  guint16 length;
+  guint8 len, *xr;
+  gsize size;
+
+  gst_rtcp_builder_init (&builder, data, sizeof (data));
+  fail_unless (gst_rtcp_builder_add_rr (&builder, 0x11));
+  fail_unless (gst_rtcp_builder_add_rb (&builder, 0x22, 1, -2, 3, 4, 5, 6));
+  fail_unless (gst_rtcp_builder_add_rb (&builder, 0x33, 7, 8, 9, 10, 11, 12));
+  fail_unless (gst_rtcp_builder_add_sdes_item (&builder, 0x11,
+          GST_RTCP_SDES_CNAME, (const guint8 *) "a@b", 3));
+  fail_unless (gst_rtcp_builder_add_sdes_item (&builder, 0x11,
+          GST_RTCP_SDES_NAME, (const guint8 *) "x", 1));
+  fail_unless (gst_rtcp_builder_add_sdes_item (&builder, 0x22,
+          GST_RTCP_SDES_CNAME, (const guint8 *) "c", 1));
+  fail_unless (gst_rtcp_builder_add_fb (&builder, GST_RTCP_TYPE_RTPFB,
+          GST_RTCP_RTPFB_TYPE_NACK, 0x11, 0x22, fci, 1));
+  xr = gst_rtcp_builder_add_packet (&builder, GST_RTCP_TYPE_XR, 0, 4);
+  fail_unless (xr != NULL);
+  GST_WRITE_UINT32_BE (xr, 0x11);
+  xr[4] = GST_RTCP_XR_TYPE_RRT;
+  GST_WRITE_UINT16_BE (xr + 6, 2);
+  GST_WRITE_UINT64_BE (xr + 8, 1234);
+  size = gst_rtcp_builder_finish (&builder);
+  fail_unless_equals_int (size, 56 + 28 + 16 + 20);
+
+  /* the result is a valid compound packet for the existing API */
+  fail_unless (gst_rtcp_buffer_validate_data (data, size));
+
+  gst_rtcp_packet_iter_init (&iter, data, size, FALSE);
+
+  fail_unless (gst_rtcp_packet_iter_next (&iter, &view));
+  fail_unless_equals_int (view.type, GST_RTCP_TYPE_RR);
+  fail_unless_equals_int (view.count, 2);
+  fail_unless_equals_int (gst_rtcp_packet_view_get_ssrc (&view), 0x11);
+  fail_unless (gst_rtcp_packet_view_get_rb (&view, 0, &ssrc, NULL,
+          &packetslost, NULL, NULL, NULL, NULL));
+  fail_unless_equals_int (ssrc, 0x22);
+  fail_unless_equals_int (packetslost, -2);
+  fail_unless (gst_rtcp_packet_view_get_rb (&view, 1, &ssrc, NULL, NULL,
+          NULL, &jitter, NULL, NULL));
+  fail_unless_equals_int (ssrc, 0x33);
+  fail_unless_equals_int (jitter, 10);
+  fail_if (gst_rtcp_packet_view_get_rb (&view, 2, NULL, NULL, NULL, NULL,
+          NULL, NULL, NULL));
+
+  fail_unless (gst_rtcp_packet_iter_next (&iter, &view));
+  fail_unless_equals_int (view.type, GST_RTCP_TYPE_SDES);
+  fail_unless_equals_int (view.count, 2);
+  offset = 0;
+  fail_unless (gst_rtcp_packet_view_sdes_next_chunk (&view, &offset, &ssrc,
+          &items, &items_size));
+  fail_unless_equals_int (ssrc, 0x11);
+  item_offset = 0;
+  fail_unless (gst_rtcp_sdes_items_next (items, items_size, &item_offset,
+          &type, &len, &item));
+  fail_unless_equals_int (type, GST_RTCP_SDES_CNAME);
+  fail_unless_equals_int (len, 3);
+  fail_unless (memcmp (item, "a@b", 3) == 0);
+  fail_unless (gst_rtcp_sdes_items_next (items, items_size, &item_offset,
+          &type, &len, &item));
+  fail_unless_equals_int (type, GST_RTCP_SDES_NAME);
+  fail_if (gst_rtcp_sdes_items_next (items, items_size, &item_offset,
+          NULL, NULL, NULL));
+  fail_unless (gst_rtcp_packet_view_sdes_next_chunk (&view, &offset, &ssrc,
+          &items, &items_size));
+  fail_unless_equals_int (ssrc, 0x22);
+  fail_unless_equals_int (items_size, 3);
+  fail_if (gst_rtcp_packet_view_sdes_next_chunk (&view, &offset, NULL, NULL,
+          NULL));
+
+  fail_unless (gst_rtcp_packet_iter_next (&iter, &view));
+  fail_unless_equals_int (view.type, GST_RTCP_TYPE_RTPFB);
+  fail_unless_equals_int (view.count, GST_RTCP_RTPFB_TYPE_NACK);
+  fail_unless (gst_rtcp_packet_view_get_fb (&view, &ssrc, &media_ssrc,
+          &items, &length));
+  fail_unless_equals_int (ssrc, 0x11);
+  fail_unless_equals_int (media_ssrc, 0x22);
+  fail_unless_equals_int (length, 1);
+  fail_unless (memcmp (items, fci, 4) == 0);
+
+  fail_unless (gst_rtcp_packet_iter_next (&iter, &view));
+  fail_unless_equals_int (view.type, GST_RTCP_TYPE_XR);
+  offset = 0;
+  fail_unless (gst_rtcp_packet_view_xr_next_block (&view, &offset, &xr_type,
+          NULL, &block, &length));
+  fail_unless_equals_int (xr_type, GST_RTCP_XR_TYPE_RRT);
+  fail_unless_equals_int (length, 2);
+  fail_unless_equals_int (GST_READ_UINT64_BE (block), 1234);
+  fail_if (gst_rtcp_packet_view_xr_next_block (&view, &offset, NULL, NULL,
+          NULL, NULL));
+
+  fail_if (gst_rtcp_packet_iter_next (&iter, &view));
+  fail_unless (gst_rtcp_packet_iter_is_valid (&iter));
+
+  /* trailing bytes make the compound packet invalid */
+  gst_rtcp_packet_iter_init (&iter, data, size - 1, FALSE);
+  while (gst_rtcp_packet_iter_next (&iter, &view));
+  fail_if (gst_rtcp_packet_iter_is_valid (&iter));
+
+  /* a compound packet must start with SR or RR */
+  gst_rtcp_packet_iter_init (&iter, data + 56, size - 56, FALSE);
+  fail_if (gst_rtcp_packet_iter_next (&iter, &view));
+  fail_if (gst_rtcp_packet_iter_is_valid (&iter));
+  gst_rtcp_packet_iter_init (&iter, data + 56, size - 56, TRUE);
+  fail_unless (gst_rtcp_packet_iter_next (&iter, &view));
+
+  /* not enough space */
+  gst_rtcp_builder_init (&builder, small, sizeof (small));
+  fail_unless (gst_rtcp_builder_add_rr (&builder, 0x11));
+  fail_if (gst_rtcp_builder_add_rb (&builder, 0x22, 0, 0, 0, 0, 0, 0));
+  fail_if (gst_rtcp_builder_add_sdes_item (&builder, 0x11,
+          GST_RTCP_SDES_CNAME, NULL, 0));
+  fail_unless_equals_int (gst_rtcp_builder_finish (&builder), 8);
+  fail_unless (gst_rtcp_buffer_validate_data (small, 8));
+}
+
+GST_END_TEST;
+
 static Suite *
 rtp_suite (void)
 {
@@ -2229,6 +2543,9 @@ rtp_suite (void)
 
   tcase_add_test (tc_chain, test_rtcp_compound_padding);
   tcase_add_test (tc_chain, test_rtp_buffer_extlen_wraparound);
+  tcase_add_test (tc_chain, test_rtp_buffer_list_map);
+  tcase_add_test (tc_chain, test_rtp_buffer_extension_index);
+  tcase_add_test (tc_chain, test_rtcp_packet_iter_builder);
 
   return s;
 }
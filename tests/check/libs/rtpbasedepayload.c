@@ -188,6 +188,74 @@ gst_rtp_dummy_depay_set_caps (GstRTPBaseDepayload * filter, GstCaps * caps)
   return TRUE;
 }
 
+/* GstRtpDummyListDepay, handles input lists at once and aggregates output */
+
+typedef struct _GstRtpDummyListDepay GstRtpDummyListDepay;
+typedef struct _GstRtpDummyListDepayClass GstRtpDummyListDepayClass;
+
+struct _GstRtpDummyListDepay
+{
+  GstRtpDummyDepay depay;
+
+  guint n_lists;
+  guint n_packets;
+  guint n_discont;
+};
+
+struct _GstRtpDummyListDepayClass
+{
+  GstRtpDummyDepayClass parent_class;
+};
+
+GType gst_rtp_dummy_list_depay_get_type (void);
+
+G_DEFINE_TYPE (GstRtpDummyListDepay, gst_rtp_dummy_list_depay,
+    GST_TYPE_RTP_DUMMY_DEPAY);
+
+static GstFlowReturn
+gst_rtp_dummy_list_depay_process_list (GstRTPBaseDepayload * depayload,
+    GstRTPBufferList * rtplist)
+{
+  GstRtpDummyListDepay *self = (GstRtpDummyListDepay *) depayload;
+  guint i;
+
+  self->n_lists++;
+
+  for (i = 0; i < rtplist->n_packets; i++) {
+    GstRTPBuffer *rtp = &rtplist->packets[i];
+
+    if (rtp->buffer == NULL)
+      continue;
+
+    self->n_packets++;
+    if (GST_BUFFER_IS_DISCONT (rtp->buffer))
+      self->n_discont++;
+
+    gst_rtp_base_depayload_push (depayload,
+        gst_rtp_buffer_get_payload_buffer (rtp));
+  }
+
+  return GST_FLOW_OK;
+}
+
+static void
+gst_rtp_dummy_list_depay_class_init (GstRtpDummyListDepayClass * klass)
+{
+  GstRTPBaseDepayloadClass *gstrtpbasedepayload_class;
+
+  gstrtpbasedepayload_class = GST_RTP_BASE_DEPAYLOAD_CLASS (klass);
+
+  gstrtpbasedepayload_class->process_list =
+      gst_rtp_dummy_list_depay_process_list;
+}
+
+static void
+gst_rtp_dummy_list_depay_init (GstRtpDummyListDepay * depay)
+{
+  gst_rtp_base_depayload_set_aggregate_output_enabled (GST_RTP_BASE_DEPAYLOAD
+      (depay), TRUE);
+}
+
 /* Helper functions and global state */
 
 static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
@@ -1540,6 +1608,71 @@ GST_START_TEST (rtp_base_depayload_flow_return_push_list_func)
 
 GST_END_TEST;
 
+static GstPadProbeReturn
+count_lists_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  guint *n_lists = user_data;
+
+  (*n_lists)++;
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* a depayloader implementing process_list gets the whole input list after the
+ * seqnum checks, and everything it pushes goes out as a single list */
+GST_START_TEST (rtp_base_depayload_process_list_test)
+{
+  GstHarness *h;
+  GstRtpDummyListDepay *depay;
+  GstBufferList *list;
+  GstBuffer *buffer;
+  guint seqnums[] = { 100, 101, 101, 103 };
+  guint n_lists = 0;
+  guint i;
+
+  depay = g_object_new (gst_rtp_dummy_list_depay_get_type (), NULL);
+  fail_unless (gst_rtp_base_depayload_is_aggregate_output_enabled
+      (GST_RTP_BASE_DEPAYLOAD (depay)));
+  h = gst_harness_new_with_element (GST_ELEMENT_CAST (depay), "sink", "src");
+  gst_harness_set_src_caps_str (h, "application/x-rtp");
+  gst_pad_add_probe (h->sinkpad, GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      count_lists_probe, &n_lists, NULL);
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < G_N_ELEMENTS (seqnums); i++) {
+    buffer = gst_rtp_buffer_new_allocate (4, 0, 0);
+    rtp_buffer_set (buffer, "seq", seqnums[i], "ssrc", 0x11, NULL);
+    GST_BUFFER_PTS (buffer) = i * GST_SECOND;
+    gst_buffer_list_add (list, buffer);
+  }
+  /* not an RTP packet */
+  gst_buffer_list_add (list, gst_buffer_new_allocate (NULL, 4, NULL));
+
+  fail_unless_equals_int (gst_pad_push_list (h->srcpad, list), GST_FLOW_OK);
+
+  /* the duplicate and the invalid packet are not handed over, the packet after
+   * the gap is flagged */
+  fail_unless_equals_int (depay->n_lists, 1);
+  fail_unless_equals_int (depay->n_packets, 3);
+  fail_unless_equals_int (depay->n_discont, 1);
+
+  fail_unless_equals_int (n_lists, 1);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), 3);
+  for (i = 0; i < 3; i++) {
+    buffer = gst_harness_pull (h);
+    fail_unless_equals_int (gst_buffer_get_size (buffer), 4);
+    /* only the first output gets the timestamp of the list */
+    if (i == 0)
+      fail_unless_equals_uint64 (GST_BUFFER_PTS (buffer), 0);
+    gst_buffer_unref (buffer);
+  }
+
+  g_object_unref (depay);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtp_basepayloading_suite (void)
 {
@@ -1577,6 +1710,8 @@ rtp_basepayloading_suite (void)
   tcase_add_test (tc_chain, rtp_base_depayload_flow_return_push_func);
   tcase_add_test (tc_chain, rtp_base_depayload_flow_return_push_list_func);
 
+  tcase_add_test (tc_chain, rtp_base_depayload_process_list_test);
+
   return s;
 }
 
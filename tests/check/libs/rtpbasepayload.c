@@ -1854,6 +1854,45 @@ GST_START_TEST (rtp_base_payload_property_source_info_test)
 
 GST_END_TEST;
 
+/* the dummy payloader only allocates an RTP header and appends the input
+ * buffer to it. such header-only output buffers are recycled from a pool once
+ * downstream releases them, which is reported in the stats property. */
+GST_START_TEST (rtp_base_payload_header_pool_test)
+{
+  GstHarness *h;
+  GstRtpDummyPay *pay;
+  GstBuffer *buffer;
+  GstStructure *stats;
+  guint64 hits, misses;
+  guint i;
+
+  pay = rtp_dummy_pay_new ();
+  h = gst_harness_new_with_element (GST_ELEMENT_CAST (pay), "sink", "src");
+  gst_harness_set_src_caps_str (h, "application/x-rtp");
+
+  for (i = 0; i < 5; i++) {
+    buffer = gst_buffer_new_allocate (NULL, 100, NULL);
+    GST_BUFFER_PTS (buffer) = i * GST_SECOND;
+    buffer = gst_harness_push_and_pull (h, buffer);
+    fail_unless_equals_int (gst_buffer_get_size (buffer), 12 + 100);
+    validate_buffer1 (buffer, "csrc-count", 0, NULL);
+    gst_buffer_unref (buffer);
+  }
+
+  g_object_get (pay, "stats", &stats, NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "header-pool-hits", &hits));
+  fail_unless (gst_structure_get_uint64 (stats, "header-pool-misses",
+          &misses));
+  fail_unless_equals_uint64 (misses, 1);
+  fail_unless_equals_uint64 (hits, 4);
+  gst_structure_free (stats);
+
+  g_object_unref (pay);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 /* push a single buffer to the payloader which should successfully payload it
  * into an RTP packet. besides the payloaded RTP packet there should be the
  * three events initial events: stream-start, caps and segment. because of that
@@ -2052,6 +2091,7 @@ rtp_basepayloading_suite (void)
   tcase_add_test (tc_chain, rtp_base_payload_property_ptime_multiple_test);
   tcase_add_test (tc_chain, rtp_base_payload_property_stats_test);
   tcase_add_test (tc_chain, rtp_base_payload_property_source_info_test);
+  tcase_add_test (tc_chain, rtp_base_payload_header_pool_test);
   tcase_add_test (tc_chain, rtp_base_payload_property_twcc_ext_id_test);
 
   tcase_add_test (tc_chain, rtp_base_payload_framerate_attribute);
@@ -685,6 +685,74 @@ GST_START_TEST (test_rtsp_message)
 
 GST_END_TEST;
 
+GST_START_TEST (test_rtsp_message_header_index)
+{
+  GstRTSPMessage msg = { 0, };
+  GstRTSPMessage *copy = NULL;
+  gchar *val = NULL;
+  guint i;
+
+  /* the index follows removals */
+  fail_unless_equals_int (gst_rtsp_message_init_request (&msg,
+          GST_RTSP_OPTIONS, "rtsp://foo.bar:8554/test"), GST_RTSP_OK);
+  fail_unless_equals_int (gst_rtsp_message_add_header (&msg,
+          GST_RTSP_HDR_CSEQ, "1"), GST_RTSP_OK);
+  fail_unless_equals_int (gst_rtsp_message_take_header (&msg,
+          GST_RTSP_HDR_SESSION, g_strdup ("a")), GST_RTSP_OK);
+  fail_unless_equals_int (gst_rtsp_message_add_header (&msg,
+          GST_RTSP_HDR_SESSION, "b"), GST_RTSP_OK);
+  fail_unless_equals_int (gst_rtsp_message_get_header (&msg,
+          GST_RTSP_HDR_SESSION, &val, 1), GST_RTSP_OK);
+  fail_unless_equals_string (val, "b");
+  fail_unless_equals_int (gst_rtsp_message_remove_header (&msg,
+          GST_RTSP_HDR_SESSION, 0), GST_RTSP_OK);
+  fail_unless_equals_int (gst_rtsp_message_get_header (&msg,
+          GST_RTSP_HDR_SESSION, &val, 0), GST_RTSP_OK);
+  fail_unless_equals_string (val, "b");
+  fail_unless_equals_int (gst_rtsp_message_remove_header_by_name (&msg,
+          "CSeq", -1), GST_RTSP_OK);
+  fail_unless_equals_int (gst_rtsp_message_get_header (&msg,
+          GST_RTSP_HDR_CSEQ, &val, 0), GST_RTSP_ENOTIMPL);
+  fail_unless_equals_int (gst_rtsp_message_get_header_by_name (&msg,
+          "session", &val, 0), GST_RTSP_OK);
+  fail_unless_equals_string (val, "b");
+  fail_unless_equals_int (gst_rtsp_message_get_header (&msg,
+          GST_RTSP_HDR_TRANSPORT, &val, 0), GST_RTSP_ENOTIMPL);
+
+  /* headers replaced after a removal are copied separately and freed with
+   * the header, also when the message is copied */
+  for (i = 0; i < 1000; i++) {
+    gchar *cseq = g_strdup_printf ("%u", i);
+
+    fail_unless_equals_int (gst_rtsp_message_remove_header (&msg,
+            GST_RTSP_HDR_CSEQ, -1), i == 0 ? GST_RTSP_ENOTIMPL : GST_RTSP_OK);
+    fail_unless_equals_int (gst_rtsp_message_add_header (&msg,
+            GST_RTSP_HDR_CSEQ, cseq), GST_RTSP_OK);
+    fail_unless_equals_int (gst_rtsp_message_remove_header_by_name (&msg,
+            "X-Custom", -1), i == 0 ? GST_RTSP_ENOTIMPL : GST_RTSP_OK);
+    fail_unless_equals_int (gst_rtsp_message_add_header_by_name (&msg,
+            "X-Custom", cseq), GST_RTSP_OK);
+    g_free (cseq);
+  }
+  fail_unless_equals_int (gst_rtsp_message_get_header (&msg,
+          GST_RTSP_HDR_CSEQ, &val, 0), GST_RTSP_OK);
+  fail_unless_equals_string (val, "999");
+  fail_unless_equals_int (gst_rtsp_message_get_header (&msg,
+          GST_RTSP_HDR_CSEQ, &val, 1), GST_RTSP_ENOTIMPL);
+  fail_unless_equals_int (gst_rtsp_message_get_header_by_name (&msg,
+          "x-custom", &val, 0), GST_RTSP_OK);
+  fail_unless_equals_string (val, "999");
+
+  fail_unless_equals_int (gst_rtsp_message_copy (&msg, &copy), GST_RTSP_OK);
+  gst_rtsp_message_unset (&msg);
+  fail_unless_equals_int (gst_rtsp_message_get_header_by_name (copy,
+          "x-custom", &val, 0), GST_RTSP_OK);
+  fail_unless_equals_string (val, "999");
+  gst_rtsp_message_free (copy);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_rtsp_message_auth_credentials)
 {
   GstRTSPMessage *msg;
@@ -1017,6 +1085,7 @@ rtsp_suite (void)
   tcase_add_test (tc_chain, test_rtsp_range_clock);
   tcase_add_test (tc_chain, test_rtsp_range_convert);
   tcase_add_test (tc_chain, test_rtsp_message);
+  tcase_add_test (tc_chain, test_rtsp_message_header_index);
   tcase_add_test (tc_chain, test_rtsp_message_auth_credentials);
   tcase_add_test (tc_chain, test_rtsp_message_auth_credentials_boxed);
 
@@ -774,6 +774,8 @@ GST_START_TEST (test_rtspconnection_backlog)
   GstRTSPResult res = GST_RTSP_OK;
   guint num_queued;
   guint num_sent;
+  GstStructure *stats;
+  guint64 writes, messages_written, bytes_written;
 
   create_connection (&conn1, &conn2);
   sock = g_socket_connection_get_socket (conn1);
@@ -830,6 +832,18 @@ GST_START_TEST (test_rtspconnection_backlog)
     num_sent--;
   }
 
+  /* the queued messages were written from the backlog */
+  stats = gst_rtsp_watch_get_backlog_stats (watch);
+  fail_unless (gst_structure_get_uint64 (stats, "writes", &writes));
+  fail_unless (gst_structure_get_uint64 (stats, "messages-written",
+          &messages_written));
+  fail_unless (gst_structure_get_uint64 (stats, "bytes-written",
+          &bytes_written));
+  fail_unless (writes > 0);
+  fail_unless (messages_written > 0);
+  fail_unless (bytes_written >= messages_written * 1024);
+  gst_structure_free (stats);
+
   g_source_destroy ((GSource *) watch);
   fail_unless (gst_rtsp_connection_close (rtsp_conn) == GST_RTSP_OK);
   fail_unless (gst_rtsp_connection_free (rtsp_conn) == GST_RTSP_OK);
@@ -928,6 +942,220 @@ GST_START_TEST (test_rtspconnection_send_receive_content_length)
 
 GST_END_TEST;
 
+GST_START_TEST (test_rtspconnection_receive_data)
+{
+  GSocketConnection *input_conn = NULL;
+  GSocketConnection *output_conn = NULL;
+  GSocket *input_sock;
+  GSocket *output_sock;
+  GstRTSPConnection *rtsp_output_conn;
+  GstRTSPConnection *rtsp_input_conn;
+  GstRTSPMessage *msg;
+  GstBuffer *buffer;
+  guint8 channel;
+  gchar body[] = "message body";
+
+  create_connection (&input_conn, &output_conn);
+  input_sock = g_socket_connection_get_socket (input_conn);
+  fail_unless (input_sock != NULL);
+  output_sock = g_socket_connection_get_socket (output_conn);
+  fail_unless (output_sock != NULL);
+
+  fail_unless (gst_rtsp_connection_create_from_socket (input_sock, "127.0.0.1",
+          4444, NULL, &rtsp_input_conn) == GST_RTSP_OK);
+  fail_unless (rtsp_input_conn != NULL);
+
+  fail_unless (gst_rtsp_connection_create_from_socket (output_sock, "127.0.0.1",
+          4444, NULL, &rtsp_output_conn) == GST_RTSP_OK);
+  fail_unless (rtsp_output_conn != NULL);
+
+  /* send data message followed by a request */
+  fail_unless (gst_rtsp_message_new_data (&msg, 3) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_message_set_body (msg, (guint8 *) body,
+          sizeof (body)) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_send (rtsp_output_conn, msg,
+          NULL) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_message_free (msg) == GST_RTSP_OK);
+  msg = NULL;
+
+  fail_unless (gst_rtsp_message_new_request (&msg, GST_RTSP_OPTIONS,
+          "example.org") == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_send (rtsp_output_conn, msg,
+          NULL) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_message_free (msg) == GST_RTSP_OK);
+  msg = NULL;
+
+  /* the data is returned as a buffer without building a message */
+  fail_unless (gst_rtsp_message_new (&msg) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_receive_data_usec (rtsp_input_conn, msg,
+          &channel, &buffer, 0) == GST_RTSP_OK);
+  fail_unless (buffer != NULL);
+  fail_unless_equals_int (channel, 3);
+  fail_unless_equals_int (gst_buffer_get_size (buffer), sizeof (body));
+  fail_unless (gst_buffer_memcmp (buffer, 0, body, sizeof (body)) == 0);
+  fail_unless (gst_rtsp_message_get_type (msg) == GST_RTSP_MESSAGE_INVALID);
+  gst_buffer_unref (buffer);
+
+  /* other messages are returned as before */
+  fail_unless (gst_rtsp_connection_receive_data_usec (rtsp_input_conn, msg,
+          &channel, &buffer, 0) == GST_RTSP_OK);
+  fail_unless (buffer == NULL);
+  fail_unless (gst_rtsp_message_get_type (msg) == GST_RTSP_MESSAGE_REQUEST);
+  fail_unless (gst_rtsp_message_free (msg) == GST_RTSP_OK);
+  msg = NULL;
+
+  fail_unless (gst_rtsp_connection_close (rtsp_input_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_free (rtsp_input_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_close (rtsp_output_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_free (rtsp_output_conn) == GST_RTSP_OK);
+
+  g_object_unref (input_conn);
+  g_object_unref (output_conn);
+}
+
+GST_END_TEST;
+
+typedef struct
+{
+  guint received;
+  guint8 channels[3];
+  gsize sizes[3];
+  gboolean body_matches;
+  guint errors;
+  GstRTSPResult error_result;
+  guint closed;
+} DataReceivedData;
+
+static GstRTSPResult
+data_received (GstRTSPWatch * watch, guint8 channel, GstBuffer * buffer,
+    gpointer user_data)
+{
+  DataReceivedData *data = user_data;
+  static const gchar body[] = "message body";
+
+  fail_unless (data->received < G_N_ELEMENTS (data->channels));
+
+  data->channels[data->received] = channel;
+  data->sizes[data->received] = gst_buffer_get_size (buffer);
+  if (data->received == 0)
+    data->body_matches = gst_buffer_get_size (buffer) == sizeof (body) &&
+        gst_buffer_memcmp (buffer, 0, body, sizeof (body)) == 0;
+  data->received++;
+
+  /* refuse the data on channel 7, this must stop the watch */
+  if (channel == 7)
+    return GST_RTSP_ERROR;
+
+  return GST_RTSP_OK;
+}
+
+static GstRTSPResult
+data_error (GstRTSPWatch * watch, GstRTSPResult result, gpointer user_data)
+{
+  DataReceivedData *data = user_data;
+
+  data->errors++;
+  data->error_result = result;
+  return GST_RTSP_OK;
+}
+
+static GstRTSPResult
+data_closed (GstRTSPWatch * watch, gpointer user_data)
+{
+  DataReceivedData *data = user_data;
+
+  data->closed++;
+  return GST_RTSP_OK;
+}
+
+static GstRTSPWatchFuncs data_watch_funcs = {
+  NULL,
+  NULL,
+  data_closed,
+  data_error,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  data_received
+};
+
+GST_START_TEST (test_rtspconnection_watch_data_received)
+{
+  GSocketConnection *input_conn = NULL;
+  GSocketConnection *output_conn = NULL;
+  GSocket *input_sock;
+  GOutputStream *ostream;
+  GstRTSPConnection *rtsp_input_conn;
+  GstRTSPWatch *watch;
+  DataReceivedData data = { 0, };
+  static const gchar body[] = "message body";
+  static const guint8 empty_frame[] = { '$', 5, 0, 0 };
+  static const guint8 refused_frame[] = { '$', 7, 0, 2, 0xaa, 0xbb };
+  static const guint8 ignored_frame[] = { '$', 9, 0, 1, 0xcc };
+  guint8 header[4];
+
+  create_connection (&input_conn, &output_conn);
+  input_sock = g_socket_connection_get_socket (input_conn);
+  fail_unless (input_sock != NULL);
+
+  fail_unless (gst_rtsp_connection_create_from_socket (input_sock, "127.0.0.1",
+          4444, NULL, &rtsp_input_conn) == GST_RTSP_OK);
+  fail_unless (rtsp_input_conn != NULL);
+
+  watch = gst_rtsp_watch_new (rtsp_input_conn, &data_watch_funcs, &data, NULL);
+  fail_unless (watch != NULL);
+  fail_unless (gst_rtsp_watch_attach (watch, NULL) > 0);
+  g_source_unref ((GSource *) watch);
+
+  /* a frame with a body, an empty frame, a frame that is refused by the
+   * callback and one that must not be delivered anymore */
+  header[0] = '$';
+  header[1] = 3;
+  header[2] = 0;
+  header[3] = sizeof (body);
+  ostream = g_io_stream_get_output_stream (G_IO_STREAM (output_conn));
+  fail_unless (g_output_stream_write_all (ostream, header, sizeof (header),
+          NULL, NULL, NULL));
+  fail_unless (g_output_stream_write_all (ostream, body, sizeof (body),
+          NULL, NULL, NULL));
+  fail_unless (g_output_stream_write_all (ostream, empty_frame,
+          sizeof (empty_frame), NULL, NULL, NULL));
+  fail_unless (g_output_stream_write_all (ostream, refused_frame,
+          sizeof (refused_frame), NULL, NULL, NULL));
+  fail_unless (g_output_stream_write_all (ostream, ignored_frame,
+          sizeof (ignored_frame), NULL, NULL, NULL));
+
+  while (data.closed == 0)
+    g_main_context_iteration (NULL, TRUE);
+  /* nothing is read anymore after the error */
+  while (g_main_context_iteration (NULL, FALSE));
+
+  fail_unless_equals_int (data.received, 3);
+  fail_unless_equals_int (data.channels[0], 3);
+  fail_unless_equals_int (data.sizes[0], sizeof (body));
+  fail_unless (data.body_matches);
+  fail_unless_equals_int (data.channels[1], 5);
+  fail_unless_equals_int (data.sizes[1], 0);
+  fail_unless_equals_int (data.channels[2], 7);
+  fail_unless_equals_int (data.sizes[2], 2);
+
+  /* the error from the callback was reported and stopped reading */
+  fail_unless_equals_int (data.errors, 1);
+  fail_unless_equals_int (data.error_result, GST_RTSP_ERROR);
+  fail_unless_equals_int (data.closed, 1);
+
+  g_source_destroy ((GSource *) watch);
+  fail_unless (gst_rtsp_connection_close (rtsp_input_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_free (rtsp_input_conn) == GST_RTSP_OK);
+
+  g_object_unref (input_conn);
+  g_object_unref (output_conn);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtspconnection_suite (void)
 {
@@ -944,6 +1172,8 @@ rtspconnection_suite (void)
   tcase_add_test (tc_chain, test_rtspconnection_backlog);
   tcase_add_test (tc_chain, test_rtspconnection_ip);
   tcase_add_test (tc_chain, test_rtspconnection_send_receive_content_length);
+  tcase_add_test (tc_chain, test_rtspconnection_receive_data);
+  tcase_add_test (tc_chain, test_rtspconnection_watch_data_received);
 
   return s;
 }
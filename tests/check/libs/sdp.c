@@ -657,6 +657,75 @@ GST_START_TEST (caps_from_media_really_const)
   gst_sdp_message_free (message);
 }
 
+GST_END_TEST
+GST_START_TEST (lazy_parse)
+{
+  GstSDPLazyMessage *lazy;
+  GstSDPMessage *message;
+  const GstSDPMedia *media;
+  GBytes *bytes;
+  const gchar *val;
+  gsize len;
+  guint i, j, nth;
+
+  bytes = g_bytes_new_static (sdp_rtcp_fb, strlen (sdp_rtcp_fb));
+  fail_unless (gst_sdp_lazy_message_new_from_bytes (bytes,
+          &lazy) == GST_SDP_OK);
+  fail_unless_equals_int (gst_sdp_lazy_message_medias_len (lazy), 1);
+
+  /* session level */
+  fail_unless (gst_sdp_lazy_message_peek_attribute (lazy, -1, "maxptime", 0,
+          &val, &len));
+  fail_unless_equals_int (len, 2);
+  fail_unless (strncmp (val, "60", len) == 0);
+  fail_unless_equals_string (gst_sdp_lazy_message_get_attribute_val (lazy, -1,
+          "sendrecv", 0), "");
+  fail_unless (gst_sdp_lazy_message_get_attribute_val (lazy, -1, "rtpmap",
+          0) == NULL);
+  val = gst_sdp_lazy_message_peek_line (lazy, -1, 's', 0, &len);
+  fail_unless (val != NULL && len == 1 && val[0] == '-');
+
+  /* media level */
+  val = gst_sdp_lazy_message_peek_line (lazy, 0, 'm', 0, &len);
+  fail_unless (val != NULL);
+  fail_unless (strncmp (val, "video 1 UDP/TLS/RTP/SAVPF 100 101 102",
+          len) == 0);
+  val = gst_sdp_lazy_message_peek_line (lazy, 0, 'c', 0, &len);
+  fail_unless (val != NULL);
+  fail_unless (strncmp (val, "IN IP4 1.1.1.1", len) == 0);
+  fail_unless (gst_sdp_lazy_message_peek_line (lazy, 0, 'c', 1, &len) == NULL);
+  fail_unless_equals_string (gst_sdp_lazy_message_get_attribute_val (lazy, 0,
+          "rtpmap", 1), "101 VP9/90000");
+  fail_unless (gst_sdp_lazy_message_get_attribute_val (lazy, 0, "rtpmap",
+          3) == NULL);
+  val = gst_sdp_lazy_message_get_attribute_val (lazy, 0, "rtcp-fb", 3);
+  fail_unless_equals_string (val, "101 nack pli");
+  fail_unless (gst_sdp_lazy_message_get_attribute_val (lazy, 0, "rtcp-fb",
+          3) == val);
+  fail_unless (gst_sdp_lazy_message_get_attribute_val (lazy, 0, "maxptime",
+          0) == NULL);
+  fail_unless (gst_sdp_lazy_message_get_attribute_val (lazy, 1, "rtpmap",
+          0) == NULL);
+
+  /* every attribute is found with the same value as the full parser */
+  gst_sdp_message_new_from_text (sdp_rtcp_fb, &message);
+  media = gst_sdp_message_get_media (message, 0);
+  for (i = 0; i < gst_sdp_media_attributes_len (media); i++) {
+    const GstSDPAttribute *attr = gst_sdp_media_get_attribute (media, i);
+
+    for (j = 0, nth = 0; j < i; j++) {
+      if (strcmp (gst_sdp_media_get_attribute (media, j)->key, attr->key) == 0)
+        nth++;
+    }
+    fail_unless_equals_string (gst_sdp_lazy_message_get_attribute_val (lazy,
+            0, attr->key, nth), attr->value);
+  }
+  gst_sdp_message_free (message);
+
+  gst_sdp_lazy_message_free (lazy);
+  g_bytes_unref (bytes);
+}
+
 GST_END_TEST
 /*
  * End of test cases
@@ -681,6 +750,7 @@ sdp_suite (void)
   tcase_add_test (tc_chain, media_from_caps_rtcp_fb_pt_100);
   tcase_add_test (tc_chain, media_from_caps_rtcp_fb_pt_101);
   tcase_add_test (tc_chain, media_from_caps_extmap_pt_100);
+  tcase_add_test (tc_chain, lazy_parse);
 
   return s;
 }
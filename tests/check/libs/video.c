@@ -3928,6 +3928,57 @@ GST_START_TEST (test_video_make_raw_caps)
 
 GST_END_TEST;
 
+GST_START_TEST (test_video_pool_huge_pages)
+{
+  GstBufferPool *pool;
+  GstStructure *config;
+  GstVideoInfo info;
+  GstVideoMeta *meta;
+  GstBuffer *buffer;
+  GstMapInfo map;
+  GstCaps *caps;
+  guint i;
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, 1000, 1000);
+  caps = gst_video_info_to_caps (&info);
+
+  pool = gst_video_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, caps, info.size, 2, 0);
+  gst_buffer_pool_config_add_option (config, GST_BUFFER_POOL_OPTION_VIDEO_META);
+  gst_buffer_pool_config_add_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES);
+  fail_unless (gst_buffer_pool_set_config (pool, config));
+  fail_unless (gst_buffer_pool_set_active (pool, TRUE));
+
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buffer,
+          NULL) == GST_FLOW_OK);
+
+  /* lines and planes start on cache lines */
+  meta = gst_buffer_get_video_meta (buffer);
+  fail_unless (meta != NULL);
+  for (i = 0; i < meta->n_planes; i++) {
+    fail_unless (meta->stride[i] % 64 == 0);
+    fail_unless (meta->offset[i] % 64 == 0);
+  }
+
+  fail_unless (gst_buffer_map (buffer, &map, GST_MAP_WRITE));
+  fail_unless (map.size >= info.size);
+  /* the huge page size depends on the system, the mapping starts on a page
+   * in any case */
+  fail_unless (((guintptr) map.data & 4095) == 0);
+  fail_unless (map.data[0] == 0);
+  map.data[map.size - 1] = 0xff;
+  gst_buffer_unmap (buffer, &map);
+
+  gst_buffer_unref (buffer);
+  fail_unless (gst_buffer_pool_set_active (pool, FALSE));
+  gst_object_unref (pool);
+  gst_caps_unref (caps);
+}
+
+GST_END_TEST;
+
 static Suite *
 video_suite (void)
 {
@@ -3981,6 +4032,7 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_meta_align);
   tcase_add_test (tc_chain, test_video_flags);
   tcase_add_test (tc_chain, test_video_make_raw_caps);
+  tcase_add_test (tc_chain, test_video_pool_huge_pages);
 
   return s;
 }
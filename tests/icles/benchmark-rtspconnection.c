@@ -0,0 +1,614 @@
+/* GStreamer RTSP connection benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Sets up a number of loopback connections, either plain or HTTP tunnelled,
+ * between blocking GstRTSPConnection clients and a GstRTSPWatch based server
+ * and measures:
+ *
+ *  - request/response round trips (OPTIONS), messages/s and latency
+ *  - interleaved data sent by the server through the watch backlog and
+ *    received by the clients with gst_rtsp_connection_receive_data_usec(),
+ *    messages/s, MB/s and latency
+ *
+ * A request/response round trip counts as one message. Allocations are
+ * counted process wide (client and server side) by wrapping malloc when
+ * building against glibc.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+
+#include <gst/gst.h>
+#include <gst/rtsp/rtsp.h>
+#include <gio/gio.h>
+
+#define DEFAULT_CONNECTIONS 16
+#define DEFAULT_REQUESTS 2000
+#define DEFAULT_PACKETS 10000
+#define DEFAULT_PACKET_SIZE 1400
+
+#define BACKLOG_BYTES (256 * 1024)
+#define TIMEOUT (10 * G_USEC_PER_SEC)
+
+#ifdef __GLIBC__
+#define HAVE_ALLOC_COUNT 1
+
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t nmemb, size_t size);
+extern void *__libc_realloc (void *ptr, size_t size);
+
+static gint n_allocs;
+
+void *
+malloc (size_t size)
+{
+  g_atomic_int_inc (&n_allocs);
+  return __libc_malloc (size);
+}
+
+void *
+calloc (size_t nmemb, size_t size)
+{
+  g_atomic_int_inc (&n_allocs);
+  return __libc_calloc (nmemb, size);
+}
+
+void *
+realloc (void *ptr, size_t size)
+{
+  g_atomic_int_inc (&n_allocs);
+  return __libc_realloc (ptr, size);
+}
+#endif
+
+typedef struct _Bench Bench;
+
+typedef struct
+{
+  Bench *bench;
+  GSocketConnection *socket_conn;
+  GstRTSPConnection *conn;
+  GstRTSPWatch *watch;
+  GThread *producer;
+} ServerConn;
+
+typedef struct
+{
+  Bench *bench;
+  GstRTSPConnection *conn;
+  GArray *latencies;
+  guint64 bytes;
+  guint messages;
+  gboolean failed;
+} ClientConn;
+
+struct _Bench
+{
+  gint n_connections;
+  gint n_requests;
+  gint n_packets;
+  gint packet_size;
+  gboolean tunneled;
+
+  GstMemory *payload;
+
+  /* server */
+  GMainContext *context;
+  GMainLoop *loop;
+  GThread *thread;
+  guint16 port;
+  GMutex lock;
+  GCond cond;
+  gboolean started;
+  GPtrArray *server_conns;
+  GHashTable *tunnels;
+
+  ClientConn *clients;
+};
+
+static void
+server_conn_free (ServerConn * sc)
+{
+  if (sc->producer)
+    g_thread_join (sc->producer);
+  if (sc->watch) {
+    g_source_destroy ((GSource *) sc->watch);
+    gst_rtsp_watch_unref (sc->watch);
+  }
+  gst_rtsp_connection_free (sc->conn);
+  g_object_unref (sc->socket_conn);
+  g_free (sc);
+}
+
+static gpointer
+producer_func (gpointer user_data)
+{
+  ServerConn *sc = user_data;
+  Bench *bench = sc->bench;
+  GstRTSPMessage msg = { 0 };
+  GstRTSPResult res = GST_RTSP_OK;
+  GstBuffer *buf;
+  gint64 ts;
+  gint i;
+
+  for (i = 0; i < bench->n_packets && res == GST_RTSP_OK; i++) {
+    /* timestamp followed by the shared payload */
+    ts = g_get_monotonic_time ();
+    buf = gst_buffer_new_allocate (NULL, sizeof (ts), NULL);
+    gst_buffer_fill (buf, 0, &ts, sizeof (ts));
+    gst_buffer_append_memory (buf, gst_memory_ref (bench->payload));
+
+    gst_rtsp_message_init_data (&msg, 0);
+    gst_rtsp_message_take_body_buffer (&msg, buf);
+    while ((res = gst_rtsp_watch_send_message (sc->watch, &msg,
+                NULL)) == GST_RTSP_ENOMEM)
+      gst_rtsp_watch_wait_backlog_usec (sc->watch, TIMEOUT);
+    gst_rtsp_message_unset (&msg);
+  }
+  if (res != GST_RTSP_OK)
+    g_printerr ("producer: failed to send data: %d\n", res);
+
+  return NULL;
+}
+
+static GstRTSPResult
+message_received (GstRTSPWatch * watch, GstRTSPMessage * message,
+    gpointer user_data)
+{
+  ServerConn *sc = user_data;
+  GstRTSPMessage response = { 0 };
+
+  if (message->type != GST_RTSP_MESSAGE_REQUEST)
+    return GST_RTSP_OK;
+
+  gst_rtsp_message_init_response (&response, GST_RTSP_STS_OK, NULL, message);
+  gst_rtsp_watch_send_message (watch, &response, NULL);
+  gst_rtsp_message_unset (&response);
+
+  if (message->type_data.request.method == GST_RTSP_PLAY && !sc->producer)
+    sc->producer = g_thread_new ("producer", producer_func, sc);
+
+  return GST_RTSP_OK;
+}
+
+static GstRTSPStatusCode
+tunnel_start (GstRTSPWatch * watch, gpointer user_data)
+{
+  ServerConn *sc = user_data;
+
+  g_hash_table_insert (sc->bench->tunnels,
+      g_strdup (gst_rtsp_connection_get_tunnelid (sc->conn)), sc);
+
+  return GST_RTSP_STS_OK;
+}
+
+static GstRTSPResult
+tunnel_complete (GstRTSPWatch * watch, gpointer user_data)
+{
+  ServerConn *sc = user_data;
+  ServerConn *get;
+  GstRTSPResult res;
+
+  get = g_hash_table_lookup (sc->bench->tunnels,
+      gst_rtsp_connection_get_tunnelid (sc->conn));
+  if (get == NULL)
+    return GST_RTSP_ERROR;
+
+  /* merge the POST channel into the GET connection, the POST watch is not
+   * needed anymore after this */
+  res = gst_rtsp_connection_do_tunnel (get->conn, sc->conn);
+  if (res == GST_RTSP_OK)
+    gst_rtsp_watch_reset (get->watch);
+  g_source_destroy ((GSource *) watch);
+
+  return res;
+}
+
+static GstRTSPWatchFuncs server_funcs = {
+  message_received,
+  NULL,
+  NULL,
+  NULL,
+  tunnel_start,
+  tunnel_complete
+};
+
+static gboolean
+incoming_callback (GSocketService * service, GSocketConnection * connection,
+    GObject * source_object, gpointer user_data)
+{
+  Bench *bench = user_data;
+  ServerConn *sc;
+
+  sc = g_new0 (ServerConn, 1);
+  sc->bench = bench;
+  sc->socket_conn = g_object_ref (connection);
+  if (gst_rtsp_connection_create_from_socket (g_socket_connection_get_socket
+          (connection), "127.0.0.1", bench->port, NULL,
+          &sc->conn) != GST_RTSP_OK) {
+    g_object_unref (sc->socket_conn);
+    g_free (sc);
+    return FALSE;
+  }
+
+  sc->watch = gst_rtsp_watch_new (sc->conn, &server_funcs, sc, NULL);
+  gst_rtsp_watch_set_send_backlog (sc->watch, BACKLOG_BYTES, 0);
+  gst_rtsp_watch_attach (sc->watch, bench->context);
+  g_ptr_array_add (bench->server_conns, sc);
+
+  return TRUE;
+}
+
+static gboolean
+server_started (gpointer user_data)
+{
+  Bench *bench = user_data;
+
+  g_mutex_lock (&bench->lock);
+  bench->started = TRUE;
+  g_cond_signal (&bench->cond);
+  g_mutex_unlock (&bench->lock);
+
+  return G_SOURCE_REMOVE;
+}
+
+static gpointer
+server_thread_func (gpointer user_data)
+{
+  Bench *bench = user_data;
+  GSocketService *service;
+  GSource *source;
+
+  g_main_context_push_thread_default (bench->context);
+
+  service = g_socket_service_new ();
+  bench->port =
+      g_socket_listener_add_any_inet_port (G_SOCKET_LISTENER (service), NULL,
+      NULL);
+  g_signal_connect (service, "incoming", G_CALLBACK (incoming_callback), bench);
+  g_socket_service_start (service);
+
+  /* signal from within the loop so that it can't be quit before it runs */
+  source = g_idle_source_new ();
+  g_source_set_callback (source, server_started, bench, NULL);
+  g_source_attach (source, bench->context);
+  g_source_unref (source);
+
+  g_main_loop_run (bench->loop);
+
+  g_socket_service_stop (service);
+  g_socket_listener_close (G_SOCKET_LISTENER (service));
+  g_object_unref (service);
+
+  g_main_context_pop_thread_default (bench->context);
+
+  return NULL;
+}
+
+static gpointer
+client_request_func (gpointer user_data)
+{
+  ClientConn *cc = user_data;
+  GstRTSPMessage request = { 0 };
+  GstRTSPMessage response = { 0 };
+  gchar cseq[16];
+  gint64 start;
+  gint i;
+
+  for (i = 0; i < cc->bench->n_requests; i++) {
+    gst_rtsp_message_init_request (&request, GST_RTSP_OPTIONS, "*");
+    g_snprintf (cseq, sizeof (cseq), "%d", i + 1);
+    gst_rtsp_message_add_header (&request, GST_RTSP_HDR_CSEQ, cseq);
+
+    start = g_get_monotonic_time ();
+    if (gst_rtsp_connection_send_usec (cc->conn, &request,
+            TIMEOUT) != GST_RTSP_OK
+        || gst_rtsp_connection_receive_usec (cc->conn, &response,
+            TIMEOUT) != GST_RTSP_OK) {
+      gst_rtsp_message_unset (&request);
+      cc->failed = TRUE;
+      break;
+    }
+    start = g_get_monotonic_time () - start;
+    g_array_append_val (cc->latencies, start);
+
+    gst_rtsp_message_unset (&response);
+    gst_rtsp_message_unset (&request);
+    cc->messages++;
+  }
+
+  return NULL;
+}
+
+static gpointer
+client_data_func (gpointer user_data)
+{
+  ClientConn *cc = user_data;
+  GstRTSPMessage request = { 0 };
+  GstRTSPMessage message = { 0 };
+  GstBuffer *buffer;
+  guint8 channel;
+  gint64 ts;
+
+  gst_rtsp_message_init_request (&request, GST_RTSP_PLAY, "*");
+  gst_rtsp_message_add_header (&request, GST_RTSP_HDR_CSEQ, "1");
+  if (gst_rtsp_connection_send_usec (cc->conn, &request,
+          TIMEOUT) != GST_RTSP_OK) {
+    gst_rtsp_message_unset (&request);
+    cc->failed = TRUE;
+    return NULL;
+  }
+  gst_rtsp_message_unset (&request);
+
+  while (cc->messages < cc->bench->n_packets) {
+    if (gst_rtsp_connection_receive_data_usec (cc->conn, &message, &channel,
+            &buffer, TIMEOUT) != GST_RTSP_OK) {
+      cc->failed = TRUE;
+      break;
+    }
+    if (buffer == NULL) {
+      /* the PLAY response */
+      gst_rtsp_message_unset (&message);
+      continue;
+    }
+
+    gst_buffer_extract (buffer, 0, &ts, sizeof (ts));
+    ts = g_get_monotonic_time () - ts;
+    g_array_append_val (cc->latencies, ts);
+
+    cc->bytes += gst_buffer_get_size (buffer);
+    cc->messages++;
+    gst_buffer_unref (buffer);
+  }
+
+  return NULL;
+}
+
+static gint
+compare_latency (gconstpointer a, gconstpointer b)
+{
+  gint64 la = *(const gint64 *) a;
+  gint64 lb = *(const gint64 *) b;
+
+  return la < lb ? -1 : la > lb ? 1 : 0;
+}
+
+static gboolean
+run_phase (Bench * bench, const gchar * name, GThreadFunc func)
+{
+  GThread **threads;
+  GArray *latencies;
+  guint64 bytes = 0;
+  guint64 messages = 0;
+  guint64 writes = 0;
+  guint64 written = 0;
+  gboolean failed = FALSE;
+  gint64 start, elapsed;
+#ifdef HAVE_ALLOC_COUNT
+  gint allocs;
+#endif
+  gdouble secs;
+  guint i;
+
+  threads = g_new0 (GThread *, bench->n_connections);
+  latencies = g_array_new (FALSE, FALSE, sizeof (gint64));
+
+  for (i = 0; i < bench->n_connections; i++) {
+    g_array_set_size (bench->clients[i].latencies, 0);
+    bench->clients[i].bytes = 0;
+    bench->clients[i].messages = 0;
+  }
+
+#ifdef HAVE_ALLOC_COUNT
+  allocs = g_atomic_int_get (&n_allocs);
+#endif
+  start = g_get_monotonic_time ();
+  for (i = 0; i < bench->n_connections; i++)
+    threads[i] = g_thread_new (name, func, &bench->clients[i]);
+  for (i = 0; i < bench->n_connections; i++)
+    g_thread_join (threads[i]);
+  elapsed = g_get_monotonic_time () - start;
+#ifdef HAVE_ALLOC_COUNT
+  allocs = g_atomic_int_get (&n_allocs) - allocs;
+#endif
+
+  for (i = 0; i < bench->n_connections; i++) {
+    ClientConn *cc = &bench->clients[i];
+
+    g_array_append_vals (latencies, cc->latencies->data, cc->latencies->len);
+    bytes += cc->bytes;
+    messages += cc->messages;
+    failed |= cc->failed;
+  }
+
+  /* the server side watches are only used for sending in the data phase */
+  for (i = 0; i < bench->server_conns->len; i++) {
+    ServerConn *sc = g_ptr_array_index (bench->server_conns, i);
+    GstStructure *stats;
+    guint64 val;
+
+    if (!sc->producer)
+      continue;
+
+    stats = gst_rtsp_watch_get_backlog_stats (sc->watch);
+    if (gst_structure_get_uint64 (stats, "writes", &val))
+      writes += val;
+    if (gst_structure_get_uint64 (stats, "messages-written", &val))
+      written += val;
+    gst_structure_free (stats);
+  }
+
+  g_array_sort (latencies, compare_latency);
+  secs = MAX (elapsed, 1) / (gdouble) G_USEC_PER_SEC;
+
+  g_print ("%-8s %-8s %4d conns: %10.0f msg/s %9.2f MB/s", bench->tunneled ?
+      "tunnel" : "plain", name, bench->n_connections, messages / secs,
+      bytes / secs / (1024.0 * 1024.0));
+  if (latencies->len > 0) {
+    g_print (" p50 %6" G_GINT64_FORMAT " us p99 %6" G_GINT64_FORMAT " us",
+        g_array_index (latencies, gint64, latencies->len / 2),
+        g_array_index (latencies, gint64,
+            MIN (latencies->len - 1, latencies->len * 99 / 100)));
+  }
+#ifdef HAVE_ALLOC_COUNT
+  g_print (" %6.2f allocs/msg", messages ? allocs / (gdouble) messages : 0.0);
+#else
+  g_print (" allocs/msg n/a");
+#endif
+  if (written > 0)
+    g_print (" %5.2f msgs/write", written / (gdouble) writes);
+  g_print ("%s\n", failed ? " (FAILED)" : "");
+
+  g_array_unref (latencies);
+  g_free (threads);
+
+  return !failed;
+}
+
+static gboolean
+run_benchmark (Bench * bench)
+{
+  gchar *url_str;
+  GstRTSPUrl *url;
+  gboolean ret = FALSE;
+  gint i;
+
+  bench->context = g_main_context_new ();
+  bench->loop = g_main_loop_new (bench->context, FALSE);
+  bench->server_conns =
+      g_ptr_array_new_with_free_func ((GDestroyNotify) server_conn_free);
+  bench->tunnels = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+      NULL);
+  bench->started = FALSE;
+  bench->thread = g_thread_new ("server", server_thread_func, bench);
+
+  g_mutex_lock (&bench->lock);
+  while (!bench->started)
+    g_cond_wait (&bench->cond, &bench->lock);
+  g_mutex_unlock (&bench->lock);
+
+  url_str = g_strdup_printf ("rtsp://127.0.0.1:%u/bench", bench->port);
+  gst_rtsp_url_parse (url_str, &url);
+  g_free (url_str);
+
+  bench->clients = g_new0 (ClientConn, bench->n_connections);
+  for (i = 0; i < bench->n_connections; i++) {
+    ClientConn *cc = &bench->clients[i];
+
+    cc->bench = bench;
+    cc->latencies = g_array_new (FALSE, FALSE, sizeof (gint64));
+    gst_rtsp_connection_create (url, &cc->conn);
+    gst_rtsp_connection_set_tunneled (cc->conn, bench->tunneled);
+    if (gst_rtsp_connection_connect_usec (cc->conn, TIMEOUT) != GST_RTSP_OK) {
+      g_printerr ("failed to connect client %d\n", i);
+      goto done;
+    }
+  }
+
+  ret = run_phase (bench, "request", client_request_func);
+  if (ret)
+    ret = run_phase (bench, "data", client_data_func);
+
+done:
+  for (i = 0; i < bench->n_connections; i++) {
+    ClientConn *cc = &bench->clients[i];
+
+    if (cc->conn) {
+      gst_rtsp_connection_close (cc->conn);
+      gst_rtsp_connection_free (cc->conn);
+    }
+    if (cc->latencies)
+      g_array_unref (cc->latencies);
+  }
+  g_free (bench->clients);
+  gst_rtsp_url_free (url);
+
+  g_main_loop_quit (bench->loop);
+  g_thread_join (bench->thread);
+
+  /* producers may still be blocked on the backlog when a client failed */
+  for (i = 0; i < bench->server_conns->len; i++) {
+    ServerConn *sc = g_ptr_array_index (bench->server_conns, i);
+
+    gst_rtsp_watch_set_flushing (sc->watch, TRUE);
+  }
+  g_hash_table_unref (bench->tunnels);
+  g_ptr_array_unref (bench->server_conns);
+  g_main_loop_unref (bench->loop);
+  g_main_context_unref (bench->context);
+
+  return ret;
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *err = NULL;
+  GOptionContext *ctx;
+  Bench bench = { 0 };
+  gboolean ret;
+  GOptionEntry options[] = {
+    {"connections", 'c', 0, G_OPTION_ARG_INT, &bench.n_connections,
+        "Number of concurrent connections", NULL},
+    {"requests", 'r', 0, G_OPTION_ARG_INT, &bench.n_requests,
+        "Number of requests per connection", NULL},
+    {"packets", 'p', 0, G_OPTION_ARG_INT, &bench.n_packets,
+        "Number of interleaved packets per connection", NULL},
+    {"size", 's', 0, G_OPTION_ARG_INT, &bench.packet_size,
+        "Size of the interleaved packets", NULL},
+    {NULL}
+  };
+
+  bench.n_connections = DEFAULT_CONNECTIONS;
+  bench.n_requests = DEFAULT_REQUESTS;
+  bench.n_packets = DEFAULT_PACKETS;
+  bench.packet_size = DEFAULT_PACKET_SIZE;
+
+  ctx = g_option_context_new ("");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  bench.n_connections = MAX (bench.n_connections, 1);
+  /* every packet starts with the send timestamp */
+  bench.packet_size = CLAMP (bench.packet_size, (gint) sizeof (gint64), 65535);
+  bench.payload = gst_allocator_alloc (NULL,
+      bench.packet_size - sizeof (gint64), NULL);
+  g_mutex_init (&bench.lock);
+  g_cond_init (&bench.cond);
+
+  bench.tunneled = FALSE;
+  ret = run_benchmark (&bench);
+  bench.tunneled = TRUE;
+  ret &= run_benchmark (&bench);
+
+  gst_memory_unref (bench.payload);
+  g_mutex_clear (&bench.lock);
+  g_cond_clear (&bench.cond);
+
+  return ret ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+/* GStreamer RTSP message parsing benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Writes requests with typical headers into a loopback socket and parses
+ * them with gst_rtsp_connection_receive_usec(). For every request the
+ * common fields are looked up and the headers are serialized again, as a
+ * server does for its response. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <gst/gst.h>
+#include <gst/rtsp/rtsp.h>
+#include <gio/gio.h>
+
+#define DEFAULT_MESSAGES 100000
+#define BATCH 64
+#define TIMEOUT (10 * G_USEC_PER_SEC)
+
+static const gchar request[] =
+    "GET_PARAMETER rtsp://127.0.0.1/bench RTSP/1.0\r\n"
+    "CSeq: 42\r\n"
+    "User-Agent: GStreamer\r\n"
+    "Session: xnb_NpaKEc;timeout=60\r\n"
+    "Transport: RTP/AVP/TCP;unicast;interleaved=0-1\r\n"
+    "Content-Length: 0\r\n" "X-Custom: value\r\n" "\r\n";
+
+static gint n_messages = DEFAULT_MESSAGES;
+
+static gpointer
+writer_func (gpointer user_data)
+{
+  GOutputStream *out = user_data;
+  GError *err = NULL;
+  GString *batch;
+  gint i, n;
+
+  batch = g_string_new (NULL);
+  for (i = 0; i < BATCH; i++)
+    g_string_append (batch, request);
+
+  for (i = 0; i < n_messages; i += BATCH) {
+    n = MIN (BATCH, n_messages - i);
+    if (!g_output_stream_write_all (out, batch->str, n * strlen (request),
+            NULL, NULL, &err)) {
+      g_printerr ("failed to write requests: %s\n", err->message);
+      g_clear_error (&err);
+      break;
+    }
+  }
+
+  g_string_free (batch, TRUE);
+
+  return NULL;
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *err = NULL;
+  GOptionContext *ctx;
+  GSocketListener *listener;
+  GSocketClient *client;
+  GSocketConnection *client_conn, *server_conn;
+  GstRTSPConnection *conn;
+  GstRTSPMessage msg = { 0 };
+  GstRTSPResult res = GST_RTSP_OK;
+  GThread *writer;
+  GString *str;
+  gchar *val;
+  guint16 port;
+  gint64 start, elapsed;
+  gint i;
+  GOptionEntry options[] = {
+    {"messages", 'n', 0, G_OPTION_ARG_INT, &n_messages,
+        "Number of requests to parse", NULL},
+    {NULL}
+  };
+
+  ctx = g_option_context_new ("");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  listener = g_socket_listener_new ();
+  port = g_socket_listener_add_any_inet_port (listener, NULL, &err);
+  if (port == 0) {
+    g_printerr ("failed to listen: %s\n", err->message);
+    g_clear_error (&err);
+    return 1;
+  }
+
+  client = g_socket_client_new ();
+  client_conn = g_socket_client_connect_to_host (client, "127.0.0.1", port,
+      NULL, &err);
+  if (client_conn == NULL) {
+    g_printerr ("failed to connect: %s\n", err->message);
+    g_clear_error (&err);
+    return 1;
+  }
+  server_conn = g_socket_listener_accept (listener, NULL, NULL, &err);
+  if (server_conn == NULL) {
+    g_printerr ("failed to accept: %s\n", err->message);
+    g_clear_error (&err);
+    return 1;
+  }
+
+  gst_rtsp_connection_create_from_socket (g_socket_connection_get_socket
+      (server_conn), "127.0.0.1", port, NULL, &conn);
+
+  str = g_string_sized_new (512);
+
+  writer = g_thread_new ("writer", writer_func,
+      g_io_stream_get_output_stream (G_IO_STREAM (client_conn)));
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < n_messages; i++) {
+    res = gst_rtsp_connection_receive_usec (conn, &msg, TIMEOUT);
+    if (res != GST_RTSP_OK)
+      break;
+
+    if (gst_rtsp_message_get_header (&msg, GST_RTSP_HDR_CSEQ, &val,
+            0) != GST_RTSP_OK
+        || gst_rtsp_message_get_header (&msg, GST_RTSP_HDR_SESSION, &val,
+            0) != GST_RTSP_OK
+        || gst_rtsp_message_get_header (&msg, GST_RTSP_HDR_CONTENT_LENGTH,
+            &val, 0) != GST_RTSP_OK) {
+      res = GST_RTSP_EPARSE;
+      break;
+    }
+
+    g_string_truncate (str, 0);
+    gst_rtsp_message_append_headers (&msg, str);
+    gst_rtsp_message_unset (&msg);
+  }
+  elapsed = MAX (g_get_monotonic_time () - start, 1);
+
+  if (res != GST_RTSP_OK) {
+    gst_rtsp_message_unset (&msg);
+    g_printerr ("failed to parse request %d: %d\n", i, res);
+  }
+
+  g_print ("%d requests in %.3f s: %.0f requests/s, %.2f us/request\n", i,
+      elapsed / (gdouble) G_USEC_PER_SEC,
+      i * (gdouble) G_USEC_PER_SEC / elapsed, elapsed / (gdouble) MAX (i, 1));
+
+  /* closing the socket unblocks the writer if parsing stopped early */
+  gst_rtsp_connection_free (conn);
+  g_socket_close (g_socket_connection_get_socket (server_conn), NULL);
+  g_thread_join (writer);
+
+  g_string_free (str, TRUE);
+  g_object_unref (server_conn);
+  g_object_unref (client_conn);
+  g_object_unref (client);
+  g_socket_listener_close (listener);
+  g_object_unref (listener);
+
+  return res == GST_RTSP_OK ? 0 : 1;
+}